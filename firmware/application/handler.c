@@ -7,6 +7,20 @@
 #include "handler.h"
 static HandlerContext_t Context;
 
+/**
+ * HandlerGetTelStatus()
+ *     Description:
+ *         Get the TEL status that the handler last set
+ *     Params:
+ *         void
+ *     Returns:
+ *         uint8_t - The IBUS_TEL_STATUS_*
+ */
+uint8_t HandlerGetTelStatus()
+{
+    return Context.telStatus;
+}
+
 /**
  * HandlerInit()
  *     Description:
@@ -32,7 +46,6 @@ void HandlerInit(BT_t *bt, IBus_t *ibus)
     Context.uiMode = ConfigGetUIMode();
     Context.seekMode = HANDLER_CDC_SEEK_MODE_NONE;
     Context.lmDimmerChecksum = 0x00;
-    Context.mflButtonStatus = HANDLER_MFL_STATUS_OFF;
     Context.telStatus = IBUS_TEL_STATUS_NONE;
     Context.btBootState = HANDLER_BT_BOOT_OK;
     memset(&Context.gmState, 0, sizeof(HandlerBodyModuleStatus_t));
@@ -60,6 +73,9 @@ void HandlerInit(BT_t *bt, IBus_t *ibus)
         &Context,
         HANDLER_INT_POWEROFF
     );
+    InputInit();
+    RenderModelInit(bt);
+    DisplayArbiterInit();
     HandlerBTInit(&Context);
     HandlerIBusInit(&Context);
     if (Context.uiMode == CONFIG_UI_CD53 ||
@@ -12,12 +12,15 @@
 #include "lib/bt/bt_bc127.h"
 #include "lib/bt/bt_bm83.h"
 #include "lib/bt.h"
+#include "lib/display_arbiter.h"
 #include "lib/log.h"
 #include "lib/event.h"
 #include "lib/ibus.h"
+#include "lib/render_model.h"
 #include "lib/timer.h"
 #include "lib/utils.h"
 
+uint8_t HandlerGetTelStatus();
 void HandlerInit(BT_t *, IBus_t *);
 void HandlerUICloseConnection(void *, unsigned char *);
 void HandlerUIInitiateConnection(void *, unsigned char *);
@@ -60,7 +60,7 @@ void HandlerBTInit(HandlerContext_t *context)
         context,
         TIMER_TASK_DISABLED
     );
-    if (context->bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
         EventRegisterCallback(
             BT_EVENT_BOOT,
             &HandlerBTBC127Boot,
@@ -164,16 +164,19 @@ void HandlerBTCallStatus(void *ctx, uint8_t *data)
     ) {
         BTCommandPlay(context->bt);
     }
-    // Tell the vehicle what the call status is
+    // Tell the vehicle what the call status is, ahead of any display
+    // traffic that is already queued
+    IBusSetTXPriority(context->ibus, IBUS_TX_PRIORITY_HIGH);
     uint8_t statusChange = HandlerSetIBusTELStatus(
         context,
         HANDLER_TEL_STATUS_SET
     );
+    IBusSetTXPriority(context->ibus, IBUS_TX_PRIORITY_NORMAL);
     if (statusChange == 0) {
         return;
     }
     LogDebug(LOG_SOURCE_SYSTEM, "Call > TCU");
-    if (context->bt->type == BT_BTM_TYPE_BM83) {
+    if (BTGetType(context->bt) == BT_BTM_TYPE_BM83) {
         uint8_t micGain = ConfigGetSetting(CONFIG_SETTING_MIC_GAIN);
         while (micGain > 0) {
             if (context->telStatus == IBUS_TEL_STATUS_ACTIVE_POWER_CALL_HANDSFREE) {
@@ -235,7 +238,9 @@ void HandlerBTCallStatus(void *ctx, uint8_t *data)
             if (strlen(context->bt->callerId) > 0 &&
                 context->uiMode != CONFIG_UI_CD53
             ) {
+                IBusSetTXPriority(context->ibus, IBUS_TX_PRIORITY_HIGH);
                 IBusCommandTELStatusText(context->ibus, context->bt->callerId, 0);
+                IBusSetTXPriority(context->ibus, IBUS_TX_PRIORITY_NORMAL);
             }
             if (volume > CONFIG_SETTING_TEL_VOL_OFFSET_MAX) {
                 volume = CONFIG_SETTING_TEL_VOL_OFFSET_MAX;
@@ -322,7 +327,7 @@ void HandlerBTDeviceFound(void *ctx, uint8_t *data)
         context->ibus->ignitionStatus > IBUS_IGNITION_OFF
     ) {
         LogDebug(LOG_SOURCE_SYSTEM, "Handler: No Device -- Attempt connection");
-        if (context->bt->type == BT_BTM_TYPE_BC127) {
+        if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
             uint8_t preferredDevice[BT_MAC_ID_LEN] = {0};
             ConfigGetBytes(
                 CONFIG_SETTING_LAST_CONNECTED_DEVICE_MAC,
@@ -370,9 +375,9 @@ void HandlerBTDeviceFound(void *ctx, uint8_t *data)
 
 
 /**
- * HandlerBTCallStatus()
+ * HandlerBTCallerID()
  *     Description:
- *         Handle caller ID updates
+ *         Send the caller ID to the cluster ahead of queued display traffic
  *     Params:
  *         void *ctx - The context provided at registration
  *         uint8_t *tmp - Any event data
@@ -384,7 +389,9 @@ void HandlerBTCallerID(void *ctx, uint8_t *data)
     HandlerContext_t *context = (HandlerContext_t *) ctx;
     if (context->telStatus == IBUS_TEL_STATUS_ACTIVE_POWER_CALL_HANDSFREE) {
         LogDebug(LOG_SOURCE_SYSTEM, "Call > ID: %s", context->bt->callerId);
+        IBusSetTXPriority(context->ibus, IBUS_TX_PRIORITY_HIGH);
         IBusCommandTELStatusText(context->ibus, context->bt->callerId, 0);
+        IBusSetTXPriority(context->ibus, IBUS_TX_PRIORITY_NORMAL);
     }
 }
 
@@ -414,7 +421,7 @@ void HandlerBTDeviceLinkConnected(void *ctx, uint8_t *data)
             context->bt->activeDevice.a2dpId != 0
         ) {
             // Raise the volume one step to trigger the absolute volume notification
-            if (context->bt->type == BT_BTM_TYPE_BC127) {
+            if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
                 BC127CommandVolume(
                     context->bt,
                     context->bt->activeDevice.a2dpId,
@@ -436,7 +443,7 @@ void HandlerBTDeviceLinkConnected(void *ctx, uint8_t *data)
             ) {
                 BTCommandPlay(context->bt);
             }
-            if (context->bt->type == BT_BTM_TYPE_BM83) {
+            if (BTGetType(context->bt) == BT_BTM_TYPE_BM83) {
                 // Request Device Name if it is empty
                 char tmp[BT_DEVICE_NAME_LEN] = {0};
                 if (memcmp(tmp, context->bt->activeDevice.deviceName, BT_DEVICE_NAME_LEN) == 0) {
@@ -454,14 +461,14 @@ void HandlerBTDeviceLinkConnected(void *ctx, uint8_t *data)
         if (linkType == BT_LINK_TYPE_HFP) {
             HandlerSetIBusTELStatus(context, HANDLER_TEL_STATUS_FORCE);
             if (hfpConfigStatus == CONFIG_SETTING_OFF) {
-                if (context->bt->type == BT_BTM_TYPE_BM83) {
+                if (BTGetType(context->bt) == BT_BTM_TYPE_BM83) {
                     BM83CommandDisconnect(context->bt, BM83_CMD_DISCONNECT_PARAM_HF);
                 } else {
                     BC127CommandClose(context->bt, context->bt->activeDevice.hfpId);
                 }
             } else {
                 IBusCommandTELSetLED(context->ibus, IBUS_TEL_LED_STATUS_GREEN);
-                if (context->bt->type == BT_BTM_TYPE_BC127) {
+                if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
                     // Set the device character set to UTF-8
                     BC127CommandATSet(context->bt, "CSCS", "\"UTF-8\"");
                     // Explicitly enable Calling Line Identification (Caller ID)
@@ -501,7 +508,7 @@ void HandlerBTDeviceDisconnected(void *ctx, uint8_t *data)
     HandlerContext_t *context = (HandlerContext_t *) ctx;
     // Reset the metadata so we do not display incorrect data
     BTClearMetadata(context->bt);
-    if (context->bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
         BC127ClearPairingErrors(context->bt);
     }
     if (context->ibus->ignitionStatus > IBUS_IGNITION_OFF) {
@@ -536,7 +543,7 @@ void HandlerBTPlaybackStatus(void *ctx, uint8_t *data)
     HandlerContext_t *context = (HandlerContext_t *) ctx;
     // If this is the first status update
     if (context->btStartupIsRun == 0) {
-        if (context->bt->type == BT_BTM_TYPE_BC127) {
+        if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
             if (context->bt->playbackStatus == BT_AVRCP_STATUS_PLAYING) {
                 // Request Metadata
                 BTCommandGetMetadata(context->bt);
@@ -806,7 +813,7 @@ void HandlerTimerBTVolumeManagement(void *ctx)
     if (ConfigGetSetting(CONFIG_SETTING_MANAGE_VOLUME) == CONFIG_SETTING_ON &&
         context->volumeMode != HANDLER_VOLUME_MODE_LOWERED &&
         context->bt->activeDevice.a2dpId != 0 &&
-        context->bt->type != BT_BTM_TYPE_BM83 &&
+        BTGetType(context->bt) != BT_BTM_TYPE_BM83 &&
         context->bt->activeDevice.a2dpVolume != 0
     ) {
         if (context->bt->activeDevice.a2dpVolume < 127) {
@@ -849,9 +856,12 @@ void HandlerTimerBTVolumeManagement(void *ctx)
     if (lowerVolumeOnReverse == CONFIG_SETTING_ON &&
         context->bt->activeDevice.a2dpId != 0
     ) {
-        uint32_t timeSinceUpdate = now - context->gearLastStatus;
+        uint8_t gearPosition = VehicleGetSignal(VEHICLE_SIGNAL_GEAR_POSITION);
+        uint32_t timeSinceUpdate = now - VehicleGetSignalUpdated(
+            VEHICLE_SIGNAL_GEAR_POSITION
+        );
         if (context->volumeMode == HANDLER_VOLUME_MODE_LOWERED &&
-            context->ibus->gearPosition != IBUS_IKE_GEAR_REVERSE &&
+            gearPosition != IBUS_IKE_GEAR_REVERSE &&
             timeSinceUpdate >= HANDLER_WAIT_REV_VOL
         ) {
             LogWarning(
@@ -861,7 +871,7 @@ void HandlerTimerBTVolumeManagement(void *ctx)
             HandlerSetVolume(context, HANDLER_VOLUME_DIRECTION_UP);
         }
         if (context->volumeMode == HANDLER_VOLUME_MODE_NORMAL &&
-            context->ibus->gearPosition == IBUS_IKE_GEAR_REVERSE &&
+            gearPosition == IBUS_IKE_GEAR_REVERSE &&
             timeSinceUpdate >= HANDLER_WAIT_REV_VOL
         ) {
             LogWarning(
@@ -13,6 +13,7 @@
 #include "../lib/log.h"
 #include "../lib/event.h"
 #include "../lib/ibus.h"
+#include "../lib/render_model.h"
 #include "../lib/timer.h"
 #include "../lib/utils.h"
 #include "../ui/bmbt.h"
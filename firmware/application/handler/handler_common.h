@@ -78,8 +78,6 @@
 #define HANDLER_LM_EVENT_PARKING_ON 0x06
 #define HANDLER_LCM_TRIGGER_OFF 0
 #define HANDLER_LCM_TRIGGER_ON 1
-#define HANDLER_MFL_STATUS_OFF 0
-#define HANDLER_MFL_STATUS_SPEAK_HOLD 1
 #define HANDLER_POWER_OFF 0
 #define HANDLER_POWER_ON 1
 #define HANDLER_POWER_TIMEOUT_MILLIS 61000
@@ -120,7 +118,6 @@ typedef struct HandlerContext_t {
     uint8_t btBootState: 2;
     uint8_t btAutoplay: 1;
     uint8_t ibusModulePingState: 4;
-    uint8_t mflButtonStatus: 1;
     uint8_t seekMode: 2;
     uint8_t volumeMode: 1;
     uint8_t gtStatus: 1;
@@ -139,7 +136,6 @@ typedef struct HandlerContext_t {
     uint8_t bm83PowerStateTimerId;
     uint32_t cdChangerLastPoll;
     uint32_t cdChangerLastStatus;
-    uint32_t gearLastStatus;
     uint32_t lmLastIOStatus;
     uint32_t lmLastStatusSet;
     uint32_t pdcLastStatus;
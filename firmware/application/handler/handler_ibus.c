@@ -6,6 +6,21 @@
  */
 #include "handler_ibus.h"
 
+static const InputBinding_t HandlerIBusInputBindings[] = {
+    {
+        INPUT_SOURCE_MFL,
+        IBUS_MFL_BTN_VOICE,
+        INPUT_GESTURE_HOLD,
+        &HandlerIBusInputMFLVoiceHold
+    },
+    {
+        INPUT_SOURCE_MFL,
+        IBUS_MFL_BTN_VOICE,
+        INPUT_GESTURE_RELEASE,
+        &HandlerIBusInputMFLVoiceRelease
+    }
+};
+
 void HandlerIBusInit(HandlerContext_t *context)
 {
     EventRegisterCallback(
@@ -79,8 +94,8 @@ void HandlerIBusInit(HandlerContext_t *context)
         context
     );
     EventRegisterCallback(
-        IBUS_EVENT_MFLButton,
-        &HandlerIBusMFLButton,
+        UIEvent_InputGesture,
+        &HandlerIBusInputGesture,
         context
     );
     EventRegisterCallback(
@@ -118,9 +133,10 @@ void HandlerIBusInit(HandlerContext_t *context)
         &HandlerIBusRADMessageReceived,
         context
     );
-    EventRegisterCallback(
-        IBUS_EVENT_SENSOR_VALUE_UPDATE,
-        &HandlerIBusSensorValueUpdate,
+    VehicleSubscribe(
+        VEHICLE_SIGNAL_GEAR_POSITION,
+        0,
+        &HandlerIBusGearPositionUpdate,
         context
     );
     EventRegisterCallback(
@@ -389,7 +405,7 @@ void HandlerIBusCDCStatus(void *ctx, uint8_t *pkt)
                        context->gtStatus == HANDLER_GT_STATUS_UNCHECKED
             ) {
                 // Request the Navigation Identity
-                IBusCommandDIAGetIdentity(context->ibus, IBUS_DEVICE_GT);
+                DiagnosticsRequest(IBUS_DEVICE_GT, DIAGNOSTICS_JOB_IDENTITY);
                 context->gtStatus = HANDLER_GT_STATUS_CHECKED;
             }
         }
@@ -624,7 +640,7 @@ void HandlerIBusGTDIAIdentityResponse(void *ctx, uint8_t *type)
         }
     }
     // Request the OS Identity (Color or Monochrome Nav)
-    IBusCommandDIAGetOSIdentity(context->ibus, IBUS_DEVICE_GT);
+    DiagnosticsRequest(IBUS_DEVICE_GT, DIAGNOSTICS_JOB_OS_IDENTITY);
 }
 
 /**
@@ -773,7 +789,7 @@ void HandlerIBusIKEIgnitionStatus(void *ctx, uint8_t *pkt)
             // Set the BT module connectable
             BTCommandSetConnectable(context->bt, BT_STATE_ON);
             BTCommandList(context->bt);
-            if (context->bt->type == BT_BTM_TYPE_BC127) {
+            if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
                 // Play a tone to wake up the WM8804 / PCM5122
                 BC127CommandTone(context->bt, "V 0 N C6 L 4");
                 // Request BC127 state
@@ -910,6 +926,82 @@ void HandlerIBusIKEVehicleConfig(void *ctx, uint8_t *pkt)
     }
 }
 
+/**
+ * HandlerIBusInputGesture()
+ *     Description:
+ *         Run the handler action bound to a button gesture
+ *     Params:
+ *         void *ctx - The context provided at registration
+ *         uint8_t *data - The InputGesture_t
+ *     Returns:
+ *         void
+ */
+void HandlerIBusInputGesture(void *ctx, uint8_t *data)
+{
+    InputDispatch(
+        HandlerIBusInputBindings,
+        sizeof(HandlerIBusInputBindings) / sizeof(InputBinding_t),
+        ctx,
+        (InputGesture_t *) data
+    );
+}
+
+/**
+ * HandlerIBusInputMFLVoiceHold()
+ *     Description:
+ *         Toggle voice recognition when the MFL voice button is held
+ *     Params:
+ *         void *ctx - The context provided at registration
+ *         InputGesture_t *gesture - The gesture
+ *     Returns:
+ *         void
+ */
+void HandlerIBusInputMFLVoiceHold(void *ctx, InputGesture_t *gesture)
+{
+    HandlerContext_t *context = (HandlerContext_t *) ctx;
+    if (ConfigGetSetting(CONFIG_SETTING_HFP) == CONFIG_SETTING_ON) {
+        BTCommandToggleVoiceRecognition(context->bt);
+    }
+}
+
+/**
+ * HandlerIBusInputMFLVoiceRelease()
+ *     Description:
+ *         Answer, end or toggle playback when the MFL voice button is
+ *         released. With HFP on, the release that ends a hold is ignored
+ *         since the hold already started voice recognition.
+ *     Params:
+ *         void *ctx - The context provided at registration
+ *         InputGesture_t *gesture - The gesture
+ *     Returns:
+ *         void
+ */
+void HandlerIBusInputMFLVoiceRelease(void *ctx, InputGesture_t *gesture)
+{
+    HandlerContext_t *context = (HandlerContext_t *) ctx;
+    if (ConfigGetSetting(CONFIG_SETTING_HFP) == CONFIG_SETTING_ON) {
+        if (gesture->type == INPUT_GESTURE_HOLD_RELEASE) {
+            return;
+        }
+        if (context->bt->callStatus == BT_CALL_ACTIVE ||
+            context->bt->callStatus == BT_CALL_OUTGOING
+        ) {
+            BTCommandCallEnd(context->bt);
+            return;
+        } else if (context->bt->callStatus == BT_CALL_INCOMING) {
+            BTCommandCallAccept(context->bt);
+            return;
+        }
+    }
+    if (context->ibus->cdChangerFunction == IBUS_CDC_FUNC_PLAYING) {
+        if (context->bt->playbackStatus == BT_AVRCP_STATUS_PLAYING) {
+            BTCommandPause(context->bt);
+        } else {
+            BTCommandPlay(context->bt);
+        }
+    }
+}
+
 /**
  * HandlerIBusLMIdentResponse()
  *     Description:
@@ -1154,7 +1246,7 @@ void HandlerIBusLMDimmerStatus(void *ctx, uint8_t *pkt)
     if (ConfigGetLightingFeaturesActive() == CONFIG_SETTING_ON) {
         uint8_t checksum = IBusGetLMDimmerChecksum(pkt);
         if (checksum != context->lmDimmerChecksum) {
-            IBusCommandDIAGetIOStatus(context->ibus, IBUS_DEVICE_LCM);
+            DiagnosticsRequest(IBUS_DEVICE_LCM, DIAGNOSTICS_JOB_IO_STATUS);
             context->lmDimmerChecksum = checksum;
         }
         context->lmLastIOStatus = TimerGetMillis();
@@ -1195,7 +1287,7 @@ void HandlerIBusLMRedundantData(void *ctx, uint8_t *pkt)
             vehicleId[4]
         );
         // Request light module ident
-        IBusCommandDIAGetIdentity(context->ibus, IBUS_DEVICE_LCM);
+        DiagnosticsRequest(IBUS_DEVICE_LCM, DIAGNOSTICS_JOB_IDENTITY);
         // Save the new VIN
         ConfigSetVehicleIdentity(vehicleId);
         // Request the vehicle configuration
@@ -1212,58 +1304,7 @@ void HandlerIBusLMRedundantData(void *ctx, uint8_t *pkt)
         }
     } else if (ConfigGetLMVariant() == CONFIG_SETTING_OFF) {
         // Identify the LM if we do not have an ID for it
-        IBusCommandDIAGetIdentity(context->ibus, IBUS_DEVICE_LCM);
-    }
-}
-
-/**
- * HandlerIBusMFLButton()
- *     Description:
- *         Act upon MFL button presses when in CD Changer mode (when BT is active)
- *     Params:
- *         void *ctx - The context provided at registration
- *         uint8_t *pkt - The packet
- *     Returns:
- *         void
- */
-void HandlerIBusMFLButton(void *ctx, uint8_t *pkt)
-{
-    HandlerContext_t *context = (HandlerContext_t *) ctx;
-    uint8_t mflButton = pkt[IBUS_PKT_DB1];
-    if (ConfigGetSetting(CONFIG_SETTING_HFP) == CONFIG_SETTING_ON) {
-        if (mflButton == IBUS_MFL_BTN_EVENT_VOICE_PRESS) {
-            context->mflButtonStatus = HANDLER_MFL_STATUS_OFF;
-        }
-        if (mflButton == IBUS_MFL_BTN_EVENT_VOICE_REL &&
-            context->mflButtonStatus == HANDLER_MFL_STATUS_OFF
-        ) {
-            if (context->bt->callStatus == BT_CALL_ACTIVE) {
-                BTCommandCallEnd(context->bt);
-            } else if (context->bt->callStatus == BT_CALL_INCOMING) {
-                BTCommandCallAccept(context->bt);
-            } else if (context->bt->callStatus == BT_CALL_OUTGOING) {
-                BTCommandCallEnd(context->bt);
-            } else if (context->ibus->cdChangerFunction == IBUS_CDC_FUNC_PLAYING) {
-                if (context->bt->playbackStatus == BT_AVRCP_STATUS_PLAYING) {
-                    BTCommandPause(context->bt);
-                } else {
-                    BTCommandPlay(context->bt);
-                }
-            }
-        } else if (mflButton == IBUS_MFL_BTN_EVENT_VOICE_HOLD) {
-            context->mflButtonStatus = HANDLER_MFL_STATUS_SPEAK_HOLD;
-            BTCommandToggleVoiceRecognition(context->bt);
-        }
-    } else {
-        if (mflButton == IBUS_MFL_BTN_EVENT_VOICE_REL) {
-            if (context->ibus->cdChangerFunction == IBUS_CDC_FUNC_PLAYING) {
-                if (context->bt->playbackStatus == BT_AVRCP_STATUS_PLAYING) {
-                    BTCommandPause(context->bt);
-                } else {
-                    BTCommandPlay(context->bt);
-                }
-            }
-        }
+        DiagnosticsRequest(IBUS_DEVICE_LCM, DIAGNOSTICS_JOB_IDENTITY);
     }
 }
 
@@ -1314,7 +1355,7 @@ void HandlerIBusModuleStatusRequest(void *ctx, uint8_t *pkt)
 void HandlerIBusPDCSensorUpdate(void *ctx, uint8_t *pkt)
 {
     HandlerContext_t *context = (HandlerContext_t *) ctx;
-    if (context->ibus->gearPosition == IBUS_IKE_GEAR_REVERSE) {
+    if (VehicleGetSignal(VEHICLE_SIGNAL_GEAR_POSITION) == IBUS_IKE_GEAR_REVERSE) {
         context->pdcLastStatus = TimerGetMillis();
     }
 
@@ -1530,40 +1571,39 @@ void HandlerIBusRADMessageReceived(void *ctx, uint8_t *type)
 }
 
 /**
- * HandlerIBusSensorValueUpdate()
+ * HandlerIBusGearPositionUpdate()
  *     Description:
- *         Parse Sensor Status
+ *         Start or stop polling the PDC as the transmission moves in and out
+ *         of reverse. Only called when the gear position changes.
  *     Params:
  *         void *ctx - The context provided at registration
- *         uint8_t *type - The Update Type
+ *         uint8_t *signal - The vehicle signal ID
  *     Returns:
  *         void
  */
-void HandlerIBusSensorValueUpdate(void *ctx, uint8_t *type)
+void HandlerIBusGearPositionUpdate(void *ctx, uint8_t *signal)
 {
     HandlerContext_t *context = (HandlerContext_t *) ctx;
-    if (*type == IBUS_SENSOR_VALUE_GEAR_POS) {
-        context->gearLastStatus = TimerGetMillis();
-        if (context->ibus->gearPosition == IBUS_IKE_GEAR_REVERSE &&
-            context->pdcActive == 0 &&
-            ConfigGetSetting(CONFIG_SETTING_COMFORT_PDC) != CONFIG_SETTING_OFF
-        ) {
-            context->pdcActive = 1;
-            IBusCommandPDCGetSensorStatus(context->ibus);
-            TimerRegisterScheduledTask(
-                &HandlerTimerIBusPDCDistance,
-                context,
-                HANDLER_INT_PDC_DISTANCE
-            );
-        }
-        if (context->ibus->gearPosition != IBUS_IKE_GEAR_REVERSE &&
-            context->pdcActive == 1
-        ) {
-            TimerUnregisterScheduledTask(&HandlerTimerIBusPDCDistance);
-            context->pdcActive = 0;
-            HandlerIBusPDCSensorUpdate(ctx, 0);
-            context->pdcLastStatus = 0;
-        }
+    uint8_t gearPosition = VehicleGetSignal(VEHICLE_SIGNAL_GEAR_POSITION);
+    if (gearPosition == IBUS_IKE_GEAR_REVERSE &&
+        context->pdcActive == 0 &&
+        ConfigGetSetting(CONFIG_SETTING_COMFORT_PDC) != CONFIG_SETTING_OFF
+    ) {
+        context->pdcActive = 1;
+        IBusCommandPDCGetSensorStatus(context->ibus);
+        TimerRegisterScheduledTask(
+            &HandlerTimerIBusPDCDistance,
+            context,
+            HANDLER_INT_PDC_DISTANCE
+        );
+    }
+    if (gearPosition != IBUS_IKE_GEAR_REVERSE &&
+        context->pdcActive == 1
+    ) {
+        TimerUnregisterScheduledTask(&HandlerTimerIBusPDCDistance);
+        context->pdcActive = 0;
+        HandlerIBusPDCSensorUpdate(ctx, 0);
+        context->pdcLastStatus = 0;
     }
 }
 
@@ -1675,9 +1715,9 @@ void HandlerIBusModuleStatusResponse(void *ctx, uint8_t *pkt)
         ) {
             // Request the Graphics Terminal Identity
             if (module == IBUS_DEVICE_VM) {
-                IBusCommandDIAGetIdentity(context->ibus, IBUS_DEVICE_VM);
+                DiagnosticsRequest(IBUS_DEVICE_VM, DIAGNOSTICS_JOB_IDENTITY);
             } else {
-                IBusCommandDIAGetIdentity(context->ibus, IBUS_DEVICE_GT);
+                DiagnosticsRequest(IBUS_DEVICE_GT, DIAGNOSTICS_JOB_IDENTITY);
             }
         }
     } else if (module == IBUS_DEVICE_MID) {
@@ -1783,7 +1823,7 @@ void HandlerTimerIBusLCMIOStatus(void *ctx)
         uint32_t now = TimerGetMillis();
         uint32_t timeDiff = now - context->lmLastIOStatus;
         if (timeDiff >= 30000 && HandlerIBusGetIsIgnitionStatusOn(context) == 1) {
-            IBusCommandDIAGetIOStatus(context->ibus, IBUS_DEVICE_LCM);
+            DiagnosticsRequest(IBUS_DEVICE_LCM, DIAGNOSTICS_JOB_IO_STATUS);
             context->lmLastIOStatus = now;
         }
     }
@@ -9,9 +9,12 @@
 #include "handler_common.h"
 #include "handler_common.h"
 #include "../lib/bt.h"
+#include "../lib/diagnostics.h"
 #include "../lib/log.h"
 #include "../lib/event.h"
 #include "../lib/ibus.h"
+#include "../lib/input.h"
+#include "../lib/render_model.h"
 #include "../lib/timer.h"
 #include "../lib/utils.h"
 #include "../ui/bmbt.h"
@@ -25,17 +28,20 @@ void HandlerIBusBMBTButtonPress(void *, uint8_t *);
 void HandlerIBusCDCStatus(void *, uint8_t *);
 void HandlerIBusDSPConfigSet(void *, uint8_t *);
 void HandlerIBusFirstMessageReceived(void *, uint8_t *);
+void HandlerIBusGearPositionUpdate(void *, uint8_t *);
 void HandlerIBusGMDoorsFlapsStatusResponse(void *, uint8_t *);
 void HandlerIBusGTDIAIdentityResponse(void *, uint8_t *);
 void HandlerIBusGTDIAOSIdentityResponse(void *, uint8_t *);
 void HandlerIBusIKEIgnitionStatus(void *, uint8_t *);
 void HandlerIBusIKESpeedRPMUpdate(void *, uint8_t *);
 void HandlerIBusIKEVehicleConfig(void *, uint8_t *);
+void HandlerIBusInputMFLVoiceHold(void *, InputGesture_t *);
+void HandlerIBusInputMFLVoiceRelease(void *, InputGesture_t *);
 void HandlerIBusLMLightStatus(void *, uint8_t *);
 void HandlerIBusLMDimmerStatus(void *, uint8_t *);
 void HandlerIBusLMIdentResponse(void *, uint8_t *);
 void HandlerIBusLMRedundantData(void *, uint8_t *);
-void HandlerIBusMFLButton(void *, uint8_t *);
+void HandlerIBusInputGesture(void *, uint8_t *);
 void HandlerIBusModuleStatusResponse(void *, uint8_t *);
 void HandlerIBusModuleStatusRequest(void *, uint8_t *);
 void HandlerIBusPDCSensorUpdate(void *, uint8_t *);
@@ -43,7 +49,6 @@ void HandlerIBusPDCStatus(void *, uint8_t *);
 void HandlerIBusRADMessageReceived(void *, uint8_t *);
 void HandlerIBusVMDIAIdentityResponse(void *, uint8_t *);
 void HandlerIBusVolumeChange(void *, uint8_t *);
-void HandlerIBusSensorValueUpdate(void *, uint8_t *);
 void HandlerIBusTELVolumeChange(void *, uint8_t *);
 void HandlerTimerIBusCDCAnnounce(void *);
 void HandlerTimerIBusCDCSendStatus(void *);
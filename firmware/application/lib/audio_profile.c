@@ -0,0 +1,262 @@
+/*
+ * File: audio_profile.c
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Named sets of the audio settings (DAC volumes, microphone and DSP
+ *     input) that are stored together and applied in one operation
+ */
+#include "audio_profile.h"
+static uint8_t AudioProfileActive = AUDIO_PROFILE_NONE;
+
+/**
+ * AudioProfileGetAddress()
+ *     Description:
+ *         Get the EEPROM address of a profile record
+ *     Params:
+ *         uint8_t profile - The profile
+ *     Returns:
+ *         uint16_t - The address
+ */
+static uint16_t AudioProfileGetAddress(uint8_t profile)
+{
+    return AUDIO_PROFILE_EEPROM_START + (profile * AUDIO_PROFILE_RECORD_SIZE);
+}
+
+/**
+ * AudioProfileApply()
+ *     Description:
+ *         Apply a stored profile. Every setting is written back to the config
+ *         in a single batch and only the modules whose settings changed are
+ *         sent commands: the DAC over I2C, the BC127 microphone config over
+ *         UART and the DSP input over the IBus.
+ *     Params:
+ *         BT_t *bt - The BT context
+ *         IBus_t *ibus - The IBus context
+ *         uint8_t profile - The profile to apply
+ *         uint8_t telStatus - The TEL status the handler last set, which
+ *             decides whether the DAC is at the telephone volume
+ *     Returns:
+ *         uint8_t - 1 if the profile was applied, 0 if it is not stored
+ */
+uint8_t AudioProfileApply(
+    BT_t *bt,
+    IBus_t *ibus,
+    uint8_t profile,
+    uint8_t telStatus
+) {
+    AudioProfile_t record;
+    uint8_t config[AUDIO_PROFILE_CONFIG_SIZE];
+    if (AudioProfileGet(profile, &record) == 0) {
+        return 0;
+    }
+    ConfigGetBytes(AUDIO_PROFILE_CONFIG_START, config, AUDIO_PROFILE_CONFIG_SIZE);
+    uint8_t *dacVolume = &config[CONFIG_SETTING_DAC_AUDIO_VOL - AUDIO_PROFILE_CONFIG_START];
+    uint8_t *dacTelVolume = &config[CONFIG_SETTING_DAC_TEL_TCU_MODE_VOL - AUDIO_PROFILE_CONFIG_START];
+    uint8_t *micGain = &config[CONFIG_SETTING_MIC_GAIN - AUDIO_PROFILE_CONFIG_START];
+    uint8_t *micBias = &config[CONFIG_SETTING_MIC_BIAS - AUDIO_PROFILE_CONFIG_START];
+    uint8_t *micPreamp = &config[CONFIG_SETTING_MIC_PREAMP - AUDIO_PROFILE_CONFIG_START];
+    uint8_t *dspInput = &config[CONFIG_SETTING_DSP_INPUT_SRC - AUDIO_PROFILE_CONFIG_START];
+    uint8_t dacChanged = *dacVolume != record.dacVolume;
+    uint8_t dacTelChanged = *dacTelVolume != record.dacTelVolume;
+    uint8_t micChanged = *micGain != record.micGain ||
+        *micBias != record.micBias ||
+        *micPreamp != record.micPreamp;
+    uint8_t dspChanged = *dspInput != record.dspInput;
+    *dacVolume = record.dacVolume;
+    *dacTelVolume = record.dacTelVolume;
+    *micGain = record.micGain;
+    *micBias = record.micBias;
+    *micPreamp = record.micPreamp;
+    *dspInput = record.dspInput;
+    ConfigSetBytes(AUDIO_PROFILE_CONFIG_START, config, AUDIO_PROFILE_CONFIG_SIZE);
+    if (telStatus != IBUS_TEL_STATUS_ACTIVE_POWER_CALL_HANDSFREE) {
+        if (dacChanged == 1) {
+            PCM51XXSetVolume(record.dacVolume);
+        }
+    } else if (dacTelChanged == 1) {
+        PCM51XXSetVolume(record.dacTelVolume);
+    }
+    // The BM83 takes its microphone gain from the config when a call starts
+    if (micChanged == 1 && BTGetType(bt) == BT_BTM_TYPE_BC127) {
+        BC127CommandSetMicGain(bt, record.micGain, record.micBias, record.micPreamp);
+    }
+    if (dspChanged == 1) {
+        if (record.dspInput == CONFIG_SETTING_DSP_INPUT_SPDIF) {
+            IBusCommandDSPSetMode(ibus, IBUS_DSP_CONFIG_SET_INPUT_SPDIF);
+        } else if (record.dspInput == CONFIG_SETTING_DSP_INPUT_ANALOG) {
+            IBusCommandDSPSetMode(ibus, IBUS_DSP_CONFIG_SET_INPUT_RADIO);
+        }
+    }
+    AudioProfileActive = profile;
+    LogInfo(LOG_SOURCE_SYSTEM, "Audio Profile: %s", record.name);
+    return 1;
+}
+
+/**
+ * AudioProfileDelete()
+ *     Description:
+ *         Remove a stored profile
+ *     Params:
+ *         uint8_t profile - The profile to remove
+ *     Returns:
+ *         uint8_t - 1 if the profile was removed, 0 if it is out of range
+ */
+uint8_t AudioProfileDelete(uint8_t profile)
+{
+    if (profile >= AUDIO_PROFILE_COUNT) {
+        return 0;
+    }
+    EEPROMWriteByte(AudioProfileGetAddress(profile), 0xFF);
+    if (AudioProfileActive == profile) {
+        AudioProfileActive = AUDIO_PROFILE_NONE;
+    }
+    return 1;
+}
+
+/**
+ * AudioProfileFind()
+ *     Description:
+ *         Find a profile by its number or name
+ *     Params:
+ *         char *name - The profile number (1 based) or name
+ *     Returns:
+ *         uint8_t - The profile or AUDIO_PROFILE_NONE
+ */
+uint8_t AudioProfileFind(char *name)
+{
+    AudioProfile_t records[AUDIO_PROFILE_COUNT];
+    uint8_t profile;
+    if (strlen(name) == 1 && name[0] >= '1' && name[0] < '1' + AUDIO_PROFILE_COUNT) {
+        return name[0] - '1';
+    }
+    EEPROMReadBytes(
+        AUDIO_PROFILE_EEPROM_START,
+        (unsigned char *) records,
+        sizeof(records)
+    );
+    for (profile = 0; profile < AUDIO_PROFILE_COUNT; profile++) {
+        if (records[profile].magic == AUDIO_PROFILE_MAGIC) {
+            records[profile].name[AUDIO_PROFILE_NAME_SIZE - 1] = '\0';
+            if (UtilsStricmp(records[profile].name, name) == 0) {
+                return profile;
+            }
+        }
+    }
+    return AUDIO_PROFILE_NONE;
+}
+
+/**
+ * AudioProfileGet()
+ *     Description:
+ *         Read a stored profile
+ *     Params:
+ *         uint8_t profile - The profile to read
+ *         AudioProfile_t *record - The record to read into
+ *     Returns:
+ *         uint8_t - 1 if the profile is stored, 0 otherwise
+ */
+uint8_t AudioProfileGet(uint8_t profile, AudioProfile_t *record)
+{
+    if (profile >= AUDIO_PROFILE_COUNT) {
+        return 0;
+    }
+    EEPROMReadBytes(
+        AudioProfileGetAddress(profile),
+        (unsigned char *) record,
+        sizeof(AudioProfile_t)
+    );
+    if (record->magic != AUDIO_PROFILE_MAGIC) {
+        return 0;
+    }
+    record->name[AUDIO_PROFILE_NAME_SIZE - 1] = '\0';
+    return 1;
+}
+
+/**
+ * AudioProfileGetActive()
+ *     Description:
+ *         Get the profile applied last
+ *     Params:
+ *         void
+ *     Returns:
+ *         uint8_t - The profile or AUDIO_PROFILE_NONE if no profile was
+ *             applied or saved since boot
+ */
+uint8_t AudioProfileGetActive()
+{
+    return AudioProfileActive;
+}
+
+/**
+ * AudioProfilePrint()
+ *     Description:
+ *         Log the stored profiles
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void AudioProfilePrint()
+{
+    AudioProfile_t records[AUDIO_PROFILE_COUNT];
+    uint8_t profile;
+    EEPROMReadBytes(
+        AUDIO_PROFILE_EEPROM_START,
+        (unsigned char *) records,
+        sizeof(records)
+    );
+    for (profile = 0; profile < AUDIO_PROFILE_COUNT; profile++) {
+        AudioProfile_t *record = &records[profile];
+        if (record->magic != AUDIO_PROFILE_MAGIC) {
+            LogRaw("%d: Empty\r\n", profile + 1);
+            continue;
+        }
+        record->name[AUDIO_PROFILE_NAME_SIZE - 1] = '\0';
+        LogRaw(
+            "%d: %s%s DAC: %02X TCU: %02X Mic: %02X Bias: %d Preamp: %d DSP: %d\r\n",
+            profile + 1,
+            record->name,
+            profile == AudioProfileActive ? " *" : "",
+            record->dacVolume,
+            record->dacTelVolume,
+            record->micGain,
+            record->micBias,
+            record->micPreamp,
+            record->dspInput
+        );
+    }
+}
+
+/**
+ * AudioProfileSave()
+ *     Description:
+ *         Store the current audio settings as a profile
+ *     Params:
+ *         uint8_t profile - The profile to store to
+ *         char *name - The profile name, cut to fit
+ *     Returns:
+ *         uint8_t - 1 if the profile was stored, 0 if it is out of range
+ */
+uint8_t AudioProfileSave(uint8_t profile, char *name)
+{
+    AudioProfile_t record;
+    if (profile >= AUDIO_PROFILE_COUNT) {
+        return 0;
+    }
+    memset(&record, 0, sizeof(AudioProfile_t));
+    record.magic = AUDIO_PROFILE_MAGIC;
+    UtilsStrncpy(record.name, name, AUDIO_PROFILE_NAME_SIZE);
+    record.dacVolume = ConfigGetSetting(CONFIG_SETTING_DAC_AUDIO_VOL);
+    record.dacTelVolume = ConfigGetSetting(CONFIG_SETTING_DAC_TEL_TCU_MODE_VOL);
+    record.micGain = ConfigGetSetting(CONFIG_SETTING_MIC_GAIN);
+    record.micBias = ConfigGetSetting(CONFIG_SETTING_MIC_BIAS);
+    record.micPreamp = ConfigGetSetting(CONFIG_SETTING_MIC_PREAMP);
+    record.dspInput = ConfigGetSetting(CONFIG_SETTING_DSP_INPUT_SRC);
+    EEPROMWritePage(
+        AudioProfileGetAddress(profile),
+        (unsigned char *) &record,
+        sizeof(AudioProfile_t)
+    );
+    AudioProfileActive = profile;
+    return 1;
+}
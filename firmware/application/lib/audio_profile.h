@@ -0,0 +1,80 @@
+/*
+ * File: audio_profile.h
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Named sets of the audio settings (DAC volumes, microphone and DSP
+ *     input) that are stored together and applied in one operation
+ */
+#ifndef AUDIO_PROFILE_H
+#define AUDIO_PROFILE_H
+#include <stdint.h>
+#include <string.h>
+#include "bt.h"
+#include "config.h"
+#include "eeprom.h"
+#include "ibus.h"
+#include "log.h"
+#include "pcm51xx.h"
+#include "utils.h"
+/*
+ * EEPROM 0xC0 - 0xFF, a single page so all of the profiles are read in one
+ * go.
+ *
+ * Record layout:
+ *     0      - AUDIO_PROFILE_MAGIC
+ *     1 - 8  - Name, null terminated
+ *     9      - CONFIG_SETTING_DAC_AUDIO_VOL
+ *     10     - CONFIG_SETTING_DAC_TEL_TCU_MODE_VOL
+ *     11     - CONFIG_SETTING_MIC_GAIN
+ *     12     - CONFIG_SETTING_MIC_BIAS
+ *     13     - CONFIG_SETTING_MIC_PREAMP
+ *     14     - CONFIG_SETTING_DSP_INPUT_SRC
+ *     15     - Reserved
+ */
+#define AUDIO_PROFILE_EEPROM_START 0x00C0
+#define AUDIO_PROFILE_RECORD_SIZE 16
+#define AUDIO_PROFILE_COUNT 4
+#define AUDIO_PROFILE_MAGIC 0xA5
+#define AUDIO_PROFILE_NAME_SIZE 8
+#define AUDIO_PROFILE_NONE 0xFF
+// The settings a profile carries all sit in this run of config addresses,
+// so they are written back together
+#define AUDIO_PROFILE_CONFIG_START CONFIG_SETTING_DAC_TEL_TCU_MODE_VOL
+#define AUDIO_PROFILE_CONFIG_END CONFIG_SETTING_DSP_INPUT_SRC
+#define AUDIO_PROFILE_CONFIG_SIZE (AUDIO_PROFILE_CONFIG_END - AUDIO_PROFILE_CONFIG_START + 1)
+
+/**
+ * AudioProfile_t
+ *     Description:
+ *         An audio profile as it is laid out in the EEPROM
+ *     Fields:
+ *         magic - AUDIO_PROFILE_MAGIC if the record is in use
+ *         name - The profile name
+ *         dacVolume - The DAC volume for music
+ *         dacTelVolume - The DAC volume for calls in TCU mode
+ *         micGain - The microphone gain
+ *         micBias - The microphone bias
+ *         micPreamp - The microphone pre-amp
+ *         dspInput - The DSP input
+ *         reserved - Pads the record to AUDIO_PROFILE_RECORD_SIZE
+ */
+typedef struct AudioProfile_t {
+    uint8_t magic;
+    char name[AUDIO_PROFILE_NAME_SIZE];
+    uint8_t dacVolume;
+    uint8_t dacTelVolume;
+    uint8_t micGain;
+    uint8_t micBias;
+    uint8_t micPreamp;
+    uint8_t dspInput;
+    uint8_t reserved;
+} AudioProfile_t;
+
+uint8_t AudioProfileApply(BT_t *, IBus_t *, uint8_t, uint8_t);
+uint8_t AudioProfileDelete(uint8_t);
+uint8_t AudioProfileFind(char *);
+uint8_t AudioProfileGet(uint8_t, AudioProfile_t *);
+uint8_t AudioProfileGetActive();
+void AudioProfilePrint();
+uint8_t AudioProfileSave(uint8_t, char *);
+#endif /* AUDIO_PROFILE_H */
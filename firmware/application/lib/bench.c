@@ -0,0 +1,218 @@
+/*
+ * File: bench.c
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     On-device micro-benchmarks for the hot paths of the firmware. Results
+ *     are emitted in a machine readable format so that they can be compared
+ *     against a stored baseline by utility/bench_compare.py
+ */
+#include "bench.h"
+
+/**
+ * BenchContext_t
+ *     Description:
+ *         State shared by the benchmark operations
+ *     Fields:
+ *         bt - A pointer to the Bluetooth module object
+ *         ibus - A pointer to the IBus object
+ *         queue - A scratch queue so we do not disturb the UART queues
+ *         text - Scratch output buffer for the text functions
+ *         localeIdx - The next locale string to look up
+ */
+typedef struct BenchContext_t {
+    BT_t *bt;
+    IBus_t *ibus;
+    CharQueue_t queue;
+    char text[BT_METADATA_FIELD_SIZE];
+    uint16_t localeIdx;
+} BenchContext_t;
+
+/**
+ * BenchTest_t
+ *     Description:
+ *         A named benchmark operation
+ *     Fields:
+ *         name - The name that results are reported under
+ *         op - The function that performs a single operation
+ */
+typedef struct BenchTest_t {
+    char *name;
+    void (*op)(BenchContext_t *);
+} BenchTest_t;
+
+static BenchContext_t benchCtx;
+// Cycles per operation spent in the measurement loop itself
+static uint32_t benchOverheadCycles;
+
+// IHK -> IKE status frame. No handler consumes it, so only the parse path runs
+static const uint8_t BENCH_IBUS_FRAME[] = {0x5B, 0x05, 0x80, 0x83, 0x00, 0x00, 0x5D};
+// BM83 command ACK event -- parsed fully but never acknowledged or handled
+static const uint8_t BENCH_BM83_FRAME[] = {0xAA, 0x00, 0x02, 0x00, 0x00, 0xFE};
+// A BC127 notification that walks the full message comparison ladder
+static const char BENCH_BC127_MSG[] = "AVRCP_BROWSING_OPEN 13 10 A4E975123ABC\r";
+static const char BENCH_UTF8_TEXT[] = "Sigur R\xC3\xB3s - Hopp\xC3\xADpolla (\xE2\x80\x9CLive\xE2\x80\x9D)";
+
+static void BenchOpNone(BenchContext_t *ctx)
+{
+}
+
+static void BenchOpCharQueue(BenchContext_t *ctx)
+{
+    uint8_t idx;
+    for (idx = 0; idx < 32; idx++) {
+        CharQueueAdd(&ctx->queue, idx);
+    }
+    for (idx = 0; idx < 32; idx++) {
+        CharQueueNext(&ctx->queue);
+    }
+}
+
+static void BenchOpIBusProcess(BenchContext_t *ctx)
+{
+    uint8_t idx;
+    for (idx = 0; idx < sizeof(BENCH_IBUS_FRAME); idx++) {
+        CharQueueAdd(&ctx->ibus->uart.rxQueue, BENCH_IBUS_FRAME[idx]);
+    }
+    for (idx = 0; idx < sizeof(BENCH_IBUS_FRAME); idx++) {
+        IBusProcess(ctx->ibus);
+    }
+}
+
+static void BenchOpBTProcess(BenchContext_t *ctx)
+{
+    uint8_t idx;
+    if (BTGetType(ctx->bt) == BT_BTM_TYPE_BC127) {
+        for (idx = 0; idx < sizeof(BENCH_BC127_MSG) - 1; idx++) {
+            CharQueueAdd(&ctx->bt->uart.rxQueue, BENCH_BC127_MSG[idx]);
+        }
+    } else {
+        for (idx = 0; idx < sizeof(BENCH_BM83_FRAME); idx++) {
+            CharQueueAdd(&ctx->bt->uart.rxQueue, BENCH_BM83_FRAME[idx]);
+        }
+    }
+    BTProcess(ctx->bt);
+}
+
+static void BenchOpNormalizeText(BenchContext_t *ctx)
+{
+    UtilsNormalizeText(ctx->text, BENCH_UTF8_TEXT, BT_METADATA_FIELD_SIZE);
+}
+
+static void BenchOpLocaleGetText(BenchContext_t *ctx)
+{
+    LocaleGetText(ctx->localeIdx);
+    if (ctx->localeIdx++ == LOCALE_STRING_MAX_INDEX) {
+        ctx->localeIdx = 0;
+    }
+}
+
+static void BenchOpEventTrigger(BenchContext_t *ctx)
+{
+    EventTriggerCallback(BENCH_EVENT_NOOP, 0);
+}
+
+static void BenchOpTimerTasks(BenchContext_t *ctx)
+{
+    TimerProcessScheduledTasks();
+}
+
+static const BenchTest_t BENCH_TESTS[] = {
+    {"CharQueue", &BenchOpCharQueue},
+    {"IBusProcess", &BenchOpIBusProcess},
+    {"BTProcess", &BenchOpBTProcess},
+    {"UtilsNormalizeText", &BenchOpNormalizeText},
+    {"LocaleGetText", &BenchOpLocaleGetText},
+    {"EventTriggerCallback", &BenchOpEventTrigger},
+    {"TimerProcessScheduledTasks", &BenchOpTimerTasks}
+};
+
+static const BenchTest_t BENCH_OVERHEAD = {"Overhead", &BenchOpNone};
+
+/**
+ * BenchMeasure()
+ *     Description:
+ *         Run the given operation in batches until BENCH_DURATION milliseconds
+ *         have elapsed. The start is aligned to a tick edge so the millisecond
+ *         resolution of the system timer does not skew the result. Cycles are
+ *         counted on the instruction clock and include the Timer1 interrupt,
+ *         which is present in normal operation as well.
+ *     Params:
+ *         const BenchTest_t *test - The benchmark to run
+ *     Returns:
+ *         BenchResult_t - The number of operations and time taken
+ */
+static BenchResult_t BenchMeasure(const BenchTest_t *test)
+{
+    BenchResult_t result = {0, 0, 0};
+    uint32_t start = TimerGetMillis();
+    while (TimerGetMillis() == start);
+    start = TimerGetMillis();
+    TimerCycleCounterStart();
+    do {
+        uint8_t idx;
+        for (idx = 0; idx < BENCH_BATCH_SIZE; idx++) {
+            test->op(&benchCtx);
+        }
+        result.ops += BENCH_BATCH_SIZE;
+        result.elapsed = TimerGetMillis() - start;
+    } while (result.elapsed < BENCH_DURATION);
+    result.cycles = TimerCycleCounterGet();
+    TimerCycleCounterStop();
+    return result;
+}
+
+/**
+ * BenchRun()
+ *     Description:
+ *         Run the benchmarks and print one line per benchmark in the format:
+ *         BENCH:<name>,<ops>,<elapsed ms>,<ns per op>,<cycles per op>
+ *         The cost of the measurement loop is calibrated first and removed
+ *         from the cycles per op figure. The run is bracketed by BENCH:BEGIN and BENCH:END lines so host
+ *         tools can find it in the log stream. Should be run with the bus
+ *         and Bluetooth module quiet, as the parsers share the live objects.
+ *     Params:
+ *         BT_t *bt - A pointer to the Bluetooth module object
+ *         IBus_t *ibus - A pointer to the IBus object
+ *         char *filter - Only run the benchmark with this name, 0 for all
+ *     Returns:
+ *         void
+ */
+void BenchRun(BT_t *bt, IBus_t *ibus, char *filter)
+{
+    uint8_t idx;
+    memset(&benchCtx, 0, sizeof(BenchContext_t));
+    benchCtx.bt = bt;
+    benchCtx.ibus = ibus;
+    benchCtx.queue = CharQueueInit();
+    LogRaw(
+        "%sBEGIN,%d,%02X\r\n",
+        BENCH_OUTPUT_PREFIX,
+        bt->type,
+        ConfigGetSetting(CONFIG_SETTING_LOG)
+    );
+    BenchResult_t overhead = BenchMeasure(&BENCH_OVERHEAD);
+    benchOverheadCycles = overhead.cycles / overhead.ops;
+    for (idx = 0; idx < sizeof(BENCH_TESTS) / sizeof(BenchTest_t); idx++) {
+        const BenchTest_t *test = &BENCH_TESTS[idx];
+        if (filter != 0 && UtilsStricmp(filter, test->name) != 0) {
+            continue;
+        }
+        BenchResult_t result = BenchMeasure(test);
+        uint32_t cycles = result.cycles / result.ops;
+        if (cycles > benchOverheadCycles) {
+            cycles = cycles - benchOverheadCycles;
+        } else {
+            cycles = 0;
+        }
+        LogRaw(
+            "%s%s,%lu,%lu,%lu,%lu\r\n",
+            BENCH_OUTPUT_PREFIX,
+            test->name,
+            (long unsigned int) result.ops,
+            (long unsigned int) result.elapsed,
+            (long unsigned int) ((result.elapsed * 1000000) / result.ops),
+            (long unsigned int) cycles
+        );
+    }
+    LogRaw("%sEND\r\n", BENCH_OUTPUT_PREFIX);
+}
@@ -0,0 +1,45 @@
+/*
+ * File: bench.h
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     On-device micro-benchmarks for the hot paths of the firmware. Results
+ *     are emitted in a machine readable format so that they can be compared
+ *     against a stored baseline by utility/bench_compare.py
+ */
+#ifndef BENCH_H
+#define BENCH_H
+#include <stdint.h>
+#include <string.h>
+#include "bt.h"
+#include "char_queue.h"
+#include "event.h"
+#include "ibus.h"
+#include "locale.h"
+#include "log.h"
+#include "timer.h"
+#include "utils.h"
+// Run each benchmark for at least this many milliseconds
+#define BENCH_DURATION 250
+// Operations to run between clock checks
+#define BENCH_BATCH_SIZE 16
+// No module registers callbacks for this event type
+#define BENCH_EVENT_NOOP 0xFF
+#define BENCH_OUTPUT_PREFIX "BENCH:"
+
+/**
+ * BenchResult_t
+ *     Description:
+ *         The outcome of a single benchmark run
+ *     Fields:
+ *         ops - The number of operations completed
+ *         elapsed - The number of milliseconds the operations took
+ *         cycles - The number of instruction cycles the operations took
+ */
+typedef struct BenchResult_t {
+    uint32_t ops;
+    uint32_t elapsed;
+    uint32_t cycles;
+} BenchResult_t;
+
+void BenchRun(BT_t *, IBus_t *, char *);
+#endif /* BENCH_H */
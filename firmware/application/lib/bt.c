@@ -29,6 +29,10 @@ BT_t BTInit()
     bt.metadataStatus = BT_METADATA_STATUS_CUR;
     bt.vrStatus = BT_VOICE_RECOG_OFF;
     bt.pairedDevicesCount = 0;
+    bt.pairedDevicesRevision = 0;
+    memset(bt.pairedDevicesIndex, 0, sizeof(bt.pairedDevicesIndex));
+    bt.cvc.validMask = 0;
+    bt.cvc.preset = BT_CVC_PRESET_NONE;
     bt.playbackStatus = BT_AVRCP_STATUS_PAUSED;
     bt.rxQueueAge = 0;
     bt.powerState = BT_STATE_OFF;
@@ -47,7 +51,7 @@ BT_t BTInit()
         UART_BAUD_115200,
         UART_PARITY_NONE
     );
-    if (bt.type == BT_BTM_TYPE_BM83) {
+    if (BTGetType(&bt) == BT_BTM_TYPE_BM83) {
         // The BM83 is not pairable by default
         bt.discoverable = BT_STATE_OFF;
     }
@@ -65,7 +69,7 @@ BT_t BTInit()
  */
 void BTCommandCallAccept(BT_t *bt)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         BC127CommandCallAnswer(bt);
     } else {
         BM83CommandCallAccept(bt);
@@ -83,7 +87,7 @@ void BTCommandCallAccept(BT_t *bt)
  */
 void BTCommandCallEnd(BT_t *bt)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         BC127CommandCallEnd(bt);
     } else {
         BM83CommandCallEnd(bt);
@@ -121,7 +125,7 @@ void BTCommandDial(BT_t *bt, const char *number, const char *name)
             number++;
         }
         cleannum[pos]=0;
-        if (bt->type == BT_BTM_TYPE_BC127) {
+        if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
             // @FIX
             char command[32];
             snprintf(command, 32, "CALL %d OUTGOING %s", bt->activeDevice.hfpId, cleannum);
@@ -144,7 +148,7 @@ void BTCommandDial(BT_t *bt, const char *number, const char *name)
 void BTCommandRedial(BT_t *bt)
 {
     if (bt->activeDevice.hfpId>0) {
-        if (bt->type == BT_BTM_TYPE_BC127) {
+        if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
             BC127CommandAT(bt,"+BLDN");
         } else {
             BM83CommandRedial(bt);
@@ -163,7 +167,7 @@ void BTCommandRedial(BT_t *bt)
  */
 void BTCommandConnect(BT_t *bt, BTPairedDevice_t *dev)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         // Set the MAC ID?
         BC127CommandProfileOpen(bt, "A2DP");
     } else {
@@ -186,7 +190,7 @@ void BTCommandConnect(BT_t *bt, BTPairedDevice_t *dev)
  */
 void BTCommandDisconnect(BT_t *bt)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         BC127CommandClose(bt, BT_CLOSE_ALL);
     } else {
         BM83CommandDisconnect(bt, BM83_CMD_DISCONNECT_PARAM_ALL);
@@ -204,7 +208,7 @@ void BTCommandDisconnect(BT_t *bt)
  */
 void BTCommandGetMetadata(BT_t *bt)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         BC127CommandGetMetadata(bt);
     } else {
         BM83CommandAVRCPGetElementAttributesAll(bt);
@@ -222,7 +226,7 @@ void BTCommandGetMetadata(BT_t *bt)
  */
 void BTCommandList(BT_t *bt)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         BC127CommandList(bt);
     } else {
         BM83CommandReadPairedDevices(bt);
@@ -240,7 +244,7 @@ void BTCommandList(BT_t *bt)
  */
 void BTCommandPause(BT_t *bt)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         BC127CommandPause(bt);
     } else {
         BM83CommandMusicControl(bt, BM83_CMD_ACTION_PAUSE);
@@ -258,7 +262,7 @@ void BTCommandPause(BT_t *bt)
  */
 void BTCommandPlay(BT_t *bt)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         BC127CommandPlay(bt);
     } else {
         BM83CommandMusicControl(bt, BM83_CMD_ACTION_PLAY);
@@ -276,7 +280,7 @@ void BTCommandPlay(BT_t *bt)
  */
 void BTCommandPlaybackTrackFastforwardStart(BT_t *bt)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         BC127CommandForwardSeekPress(bt);
     } else {
         BM83CommandMusicControl(bt, BM83_CMD_ACTION_FF);
@@ -294,7 +298,7 @@ void BTCommandPlaybackTrackFastforwardStart(BT_t *bt)
  */
 void BTCommandPlaybackTrackFastforwardStop(BT_t *bt)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         BC127CommandForwardSeekRelease(bt);
     } else {
         BM83CommandMusicControl(bt, BM83_CMD_ACTION_STOP_FF_RW);
@@ -312,7 +316,7 @@ void BTCommandPlaybackTrackFastforwardStop(BT_t *bt)
  */
 void BTCommandPlaybackTrackRewindStart(BT_t *bt)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         BC127CommandBackwardSeekPress(bt);
     } else {
         BM83CommandMusicControl(bt, BM83_CMD_ACTION_RW);
@@ -330,7 +334,7 @@ void BTCommandPlaybackTrackRewindStart(BT_t *bt)
  */
 void BTCommandPlaybackTrackRewindStop(BT_t *bt)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         BC127CommandBackwardSeekRelease(bt);
     } else {
         BM83CommandMusicControl(bt, BM83_CMD_ACTION_STOP_FF_RW);
@@ -348,7 +352,7 @@ void BTCommandPlaybackTrackRewindStop(BT_t *bt)
  */
 void BTCommandPlaybackTrackNext(BT_t *bt)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         BC127CommandForward(bt);
     } else {
         BM83CommandMusicControl(bt, BM83_CMD_ACTION_NEXT);
@@ -366,7 +370,7 @@ void BTCommandPlaybackTrackNext(BT_t *bt)
  */
 void BTCommandPlaybackTrackPrevious(BT_t *bt)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         BC127CommandBackward(bt);
     } else {
         BM83CommandMusicControl(bt, BM83_CMD_ACTION_PREVIOUS);
@@ -375,7 +379,7 @@ void BTCommandPlaybackTrackPrevious(BT_t *bt)
 
 void BTCommandProfileOpen(BT_t *bt)//, char *)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         //BC127CommandProfileOpen(bt);
     } else {
         //BM83CommandMusicControl(bt, BM83_CMD_ACTION_PREVIOUS);
@@ -393,7 +397,7 @@ void BTCommandProfileOpen(BT_t *bt)//, char *)
  */
 void BTCommandSetConnectable(BT_t *bt, uint8_t state)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         BC127CommandBtState(bt, state, bt->discoverable);
     } else {
         if (state == BT_STATE_ON) {
@@ -423,7 +427,7 @@ void BTCommandSetConnectable(BT_t *bt, uint8_t state)
  */
 void BTCommandSetDiscoverable(BT_t *bt, uint8_t state)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         BC127CommandBtState(bt, bt->connectable, state);
     } else {
         if (state == BT_STATE_ON) {
@@ -445,7 +449,7 @@ void BTCommandSetDiscoverable(BT_t *bt, uint8_t state)
  */
 void BTCommandToggleVoiceRecognition(BT_t *bt)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         UtilsStrncpy(bt->callerId, LocaleGetText(LOCALE_STRING_VOICE_ASSISTANT), BT_CALLER_ID_FIELD_SIZE);
         BC127CommandToggleVR(bt);
     } else {
@@ -485,7 +489,7 @@ uint8_t BTHasActiveMacId(BT_t *bt)
  */
 void BTProcess(BT_t *bt)
 {
-    if (bt->type == BT_BTM_TYPE_BC127) {
+    if (BTGetType(bt) == BT_BTM_TYPE_BC127) {
         BC127Process(bt);
     } else {
         BM83Process(bt);
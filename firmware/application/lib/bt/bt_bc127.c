@@ -306,6 +306,145 @@ void BC127CommandCVCParams(BT_t *bt, char *params)
     BC127SendCommand(bt, command);
 }
 
+/**
+ * BC127CommandCVCWrite()
+ *     Description:
+ *         Write a full set of CVC parameters for a band, sending only the
+ *         runs of parameters that differ from what the module holds. Runs
+ *         separated by BC127_CVC_MERGE_GAP parameters or less go out as one
+ *         command. A band we have not written since the module booted is
+ *         sent in full.
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t band - BT_CVC_BAND_NB or BT_CVC_BAND_WB
+ *         uint16_t *params - BT_CVC_PARAM_COUNT parameters
+ *     Returns:
+ *         uint8_t - The number of parameters sent
+ */
+uint8_t BC127CommandCVCWrite(BT_t *bt, uint8_t band, uint16_t *params)
+{
+    uint16_t *current = bt->cvc.params[band];
+    char *bandName = band == BT_CVC_BAND_WB ? "WB" : "NB";
+    uint8_t isKnown = (bt->cvc.validMask & (1 << band)) != 0;
+    uint8_t sent = 0;
+    uint8_t idx = 0;
+    while (idx < BT_CVC_PARAM_COUNT) {
+        if (isKnown == 1 && current[idx] == params[idx]) {
+            idx++;
+            continue;
+        }
+        uint8_t start = idx;
+        uint8_t end = BT_CVC_PARAM_COUNT;
+        if (isKnown == 1) {
+            uint8_t lookahead = idx + 1;
+            end = lookahead;
+            while (lookahead < BT_CVC_PARAM_COUNT &&
+                lookahead - end <= BC127_CVC_MERGE_GAP
+            ) {
+                if (current[lookahead] != params[lookahead]) {
+                    end = lookahead + 1;
+                }
+                lookahead++;
+            }
+        }
+        char values[BT_CVC_PARAM_COUNT * 5] = {0};
+        uint8_t offset = 0;
+        for (idx = start; idx < end; idx++) {
+            offset += snprintf(
+                &values[offset],
+                sizeof(values) - offset,
+                idx == start ? "%04X" : " %04X",
+                params[idx]
+            );
+            current[idx] = params[idx];
+        }
+        BC127CommandCVC(bt, bandName, start, end - start);
+        BC127CommandCVCParams(bt, values);
+        sent += end - start;
+        idx = end;
+    }
+    bt->cvc.validMask |= 1 << band;
+    return sent;
+}
+
+/**
+ * BC127CVCPresetLoad()
+ *     Description:
+ *         Write a CVC preset stored in the EEPROM to the module
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t preset - The preset to load
+ *     Returns:
+ *         uint8_t - 1 if the preset was loaded, 0 if it is not stored
+ */
+uint8_t BC127CVCPresetLoad(BT_t *bt, uint8_t preset)
+{
+    uint8_t data[BC127_CVC_PRESET_SIZE];
+    uint16_t params[BT_CVC_PARAM_COUNT];
+    uint8_t band;
+    uint8_t idx;
+    if (preset >= BC127_CVC_PRESET_COUNT) {
+        return 0;
+    }
+    EEPROMReadBytes(
+        BC127_CVC_PRESET_START + (preset * BC127_CVC_PRESET_SIZE),
+        data,
+        BC127_CVC_PRESET_SIZE
+    );
+    if (data[0] != BC127_CVC_PRESET_MAGIC) {
+        return 0;
+    }
+    for (band = 0; band < BT_CVC_BAND_COUNT; band++) {
+        uint8_t *values = &data[1 + (band * BT_CVC_PARAM_COUNT * 2)];
+        for (idx = 0; idx < BT_CVC_PARAM_COUNT; idx++) {
+            params[idx] = (values[idx * 2] << 8) | values[(idx * 2) + 1];
+        }
+        BC127CommandCVCWrite(bt, band, params);
+    }
+    bt->cvc.preset = preset;
+    return 1;
+}
+
+/**
+ * BC127CVCPresetSave()
+ *     Description:
+ *         Store the CVC parameters the module holds as a preset
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t preset - The preset to save to
+ *     Returns:
+ *         uint8_t - 1 if the preset was saved, 0 if we do not know the
+ *             parameters of both bands
+ */
+uint8_t BC127CVCPresetSave(BT_t *bt, uint8_t preset)
+{
+    uint8_t data[BC127_CVC_PRESET_SIZE];
+    uint8_t band;
+    uint8_t idx;
+    uint8_t bandsMask = (1 << BT_CVC_BAND_COUNT) - 1;
+    if (preset >= BC127_CVC_PRESET_COUNT ||
+        (bt->cvc.validMask & bandsMask) != bandsMask
+    ) {
+        return 0;
+    }
+    memset(data, 0xFF, sizeof(data));
+    data[0] = BC127_CVC_PRESET_MAGIC;
+    for (band = 0; band < BT_CVC_BAND_COUNT; band++) {
+        uint8_t *values = &data[1 + (band * BT_CVC_PARAM_COUNT * 2)];
+        for (idx = 0; idx < BT_CVC_PARAM_COUNT; idx++) {
+            values[idx * 2] = bt->cvc.params[band][idx] >> 8;
+            values[(idx * 2) + 1] = bt->cvc.params[band][idx] & 0xFF;
+        }
+    }
+    EEPROMWritePage(
+        BC127_CVC_PRESET_START + (preset * BC127_CVC_PRESET_SIZE),
+        data,
+        BC127_CVC_PRESET_SIZE
+    );
+    bt->cvc.preset = preset;
+    return 1;
+}
+
  /**
   * BC127CommandBtState()
   *     Description:
@@ -823,35 +962,20 @@ void BC127CommandSetMicGain(
     unsigned char micPreamp
 ) {
     unsigned char gain = micGain + 0xC0;
-    unsigned char cvcPreamp = 0x00;
+    uint16_t cvcPreamp = 0x00;
     if (micPreamp == 0x01) {
         cvcPreamp = 0x80;
     }
-    BC127CommandCVC(bt, "NB", 0, 14);
-    char params[70] = {0};
-    snprintf(
-        params,
-        70,
-        "2280 0000 1A00 %02X00 0000 %02X%02X 0000 0000 0000 0000 0000 0020 0000 %02X%02X",
-        cvcPreamp,
-        cvcPreamp,
-        gain,
-        cvcPreamp,
-        gain
-    );
-    BC127CommandCVCParams(bt, params);
-    BC127CommandCVC(bt, "WB", 0, 14);
-    snprintf(
-        params,
-        70,
-        "2284 0000 1A00 %02X00 0000 %02X%02X 0000 0000 0000 0000 0000 0020 0000 %02X%02X",
-        cvcPreamp,
-        cvcPreamp,
-        gain,
-        cvcPreamp,
-        gain
-    );
-    BC127CommandCVCParams(bt, params);
+    uint16_t micConfig = (cvcPreamp << 8) | gain;
+    // See BC127CommandCVCParams() for the layout
+    uint16_t params[BT_CVC_PARAM_COUNT] = {
+        0x2280, 0x0000, 0x1A00, cvcPreamp << 8, 0x0000, micConfig, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0020, 0x0000, micConfig
+    };
+    BC127CommandCVCWrite(bt, BT_CVC_BAND_NB, params);
+    params[0] = 0x2284;
+    BC127CommandCVCWrite(bt, BT_CVC_BAND_WB, params);
+    bt->cvc.preset = BT_CVC_PRESET_NONE;
     // Mic Gain comes in as an array index, so add 1
     // before configuring the analog microphone gain
     micGain = micGain + 1;
@@ -1409,6 +1533,8 @@ void BC127ProcessEventBuild(BT_t *bt, char **msgBuf)
     bt->activeDevice = BTConnectionInit();
     bt->callStatus = BT_CALL_INACTIVE;
     bt->metadataStatus = BT_METADATA_STATUS_CUR;
+    // The module has its stored CVC configuration again
+    bt->cvc.validMask = 0;
     LogDebug(LOG_SOURCE_BT, "BT: Boot Complete");
     EventTriggerCallback(BT_EVENT_BOOT, 0);
     EventTriggerCallback(BT_EVENT_PLAYBACK_STATUS_CHANGE, 0);
@@ -1498,7 +1624,8 @@ void BC127ProcessEventLink(BT_t *bt, char **msgBuf)
         char *deviceName = BTPairedDeviceGetName(bt, bt->activeDevice.macId);
         if (deviceName != 0) {
             UtilsStrncpy(bt->activeDevice.deviceName, deviceName, BT_DEVICE_NAME_LEN);
-        } else {
+        } else if (BTDeviceNameStoreGet(bt->activeDevice.macId, bt->activeDevice.deviceName) == 0) {
+            // We have never seen this device, so ask for its name
             BC127CommandGetDeviceName(bt, msgBuf[4]);
         }
         isNew = 1;
@@ -1637,7 +1764,8 @@ void BC127ProcessEventOpenOk(BT_t *bt, char **msgBuf)
         char *deviceName = BTPairedDeviceGetName(bt, bt->activeDevice.macId);
         if (deviceName != 0) {
             UtilsStrncpy(bt->activeDevice.deviceName, deviceName, BT_DEVICE_NAME_LEN);
-        } else {
+        } else if (BTDeviceNameStoreGet(bt->activeDevice.macId, bt->activeDevice.deviceName) == 0) {
+            // We have never seen this device, so ask for its name
             BC127CommandGetDeviceName(bt, msgBuf[3]);
         }
         bt->status = BT_STATUS_CONNECTED;
@@ -1760,7 +1888,11 @@ void BC127Process(BT_t *bt)
         // occurence of the delimiter, causes issues with any functions used going forward
         char tmpMsg[messageLength];
         strcpy(tmpMsg, msg);
-        char *msgBuf[delimCount];
+        uint16_t msgBufSize = delimCount;
+        if (msgBufSize < BC127_MSG_MIN_FIELDS) {
+            msgBufSize = BC127_MSG_MIN_FIELDS;
+        }
+        char *msgBuf[msgBufSize];
         char delimeter[] = " ";
         char *p = strtok(tmpMsg, delimeter);
         i = 0;
@@ -1768,7 +1900,13 @@ void BC127Process(BT_t *bt)
             msgBuf[i++] = p;
             p = strtok(0x00, delimeter);
         }
+        // Point missing fields at an empty string, so that short or
+        // malformed messages never hand the handlers a wild pointer
+        while (i < msgBufSize) {
+            msgBuf[i++] = "";
+        }
         LogDebug(LOG_SOURCE_BT, "BT: R: '%s'", msg);
+        TraceBegin(TRACE_POINT_BT_RX, msg[0]);
         if (strcmp(msgBuf[0], "A2DP_STREAM_SUSPEND") == 0) {
             BC127ProcessEventA2DPStreamSuspend(bt, msgBuf);
         } else if (strcmp(msgBuf[0], "ABS_VOL") == 0) {
@@ -1812,6 +1950,7 @@ void BC127Process(BT_t *bt)
         } else if (strcmp(msgBuf[0], "STATE") == 0) {
             BC127ProcessEventState(bt, msgBuf);
         }
+        TraceEnd();
         // Reset the age of the Rx queue
         bt->rxQueueAge = 0;
     } else if (CharQueueGetSize(&bt->uart.rxQueue) > 0) {
@@ -1849,6 +1988,7 @@ void BC127SendCommand(BT_t *bt, char *command)
         data[idx] = command[idx];
     }
     data[idx++] = BC127_MSG_END_CHAR;
+    TracePoint(TRACE_POINT_BT_TX, data[0]);
     UARTSendData(&bt->uart, data, cmdLength);
 }
 
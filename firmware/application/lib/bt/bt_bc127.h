@@ -13,6 +13,7 @@
 #include "../log.h"
 #include "../event.h"
 #include "../timer.h"
+#include "../trace.h"
 #include "../uart.h"
 #include "../utils.h"
 #include "bt_common.h"
@@ -20,6 +21,20 @@
 #define BC127_AUDIO_I2S "0"
 #define BC127_AUDIO_SPDIF "2"
 #define BC127_CLOSE_ALL 255
+// Changed parameters this close together are sent as one run
+#define BC127_CVC_MERGE_GAP 3
+/*
+ * CVC presets, one EEPROM page each, for A/B comparisons in the car.
+ *
+ * Preset layout:
+ *     0       - BC127_CVC_PRESET_MAGIC
+ *     1 - 28  - Narrow-band parameters, big endian
+ *     29 - 56 - Wide-band parameters, big endian
+ */
+#define BC127_CVC_PRESET_START 0x0400
+#define BC127_CVC_PRESET_SIZE EEPROM_PAGE_SIZE
+#define BC127_CVC_PRESET_COUNT 2
+#define BC127_CVC_PRESET_MAGIC 0xC5
 #define BC127_DEVICE_NAME_LEN 64
 #define BC127_DEVICE_NAME_OFFSET 19
 #define BC127_MAX_DEVICE_PAIRED 8
@@ -30,6 +45,8 @@
 #define BC127_MSG_END_CHAR 0x0D
 #define BC127_MSG_LF_CHAR 0x0A
 #define BC127_MSG_DELIMETER 0x20
+// Handlers index up to this many fields without checking the field count
+#define BC127_MSG_MIN_FIELDS 8
 #define BC127_SHORT_NAME_MAX_LEN 8
 #define BC127_PROFILE_COUNT 9
 #define BC127_RX_QUEUE_TIMEOUT 750
@@ -65,6 +82,9 @@ void BC127CommandCallReject(BT_t *);
 void BC127CommandClose(BT_t *, uint8_t);
 void BC127CommandCVC(BT_t *, char *, uint8_t, uint8_t);
 void BC127CommandCVCParams(BT_t *, char *);
+uint8_t BC127CommandCVCWrite(BT_t *, uint8_t, uint16_t *);
+uint8_t BC127CVCPresetLoad(BT_t *, uint8_t);
+uint8_t BC127CVCPresetSave(BT_t *, uint8_t);
 void BC127CommandForward(BT_t *);
 void BC127CommandForwardSeekPress(BT_t *);
 void BC127CommandForwardSeekRelease(BT_t *);
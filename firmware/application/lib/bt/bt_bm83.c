@@ -575,9 +575,9 @@ void BM83ProcessEventAVCSpecificRsp(BT_t *bt, uint8_t *data, uint16_t length)
             ) {
                 // Clear the available capabilities
                 memset(&bt->activeDevice.avrcpCaps, 0, sizeof(BTConnectionAVRCPCapabilities_t));
-                uint8_t length = data[BM83_FRAME_DB12];
+                uint8_t capCount = data[BM83_FRAME_DB12];
                 uint8_t i = 0;
-                for (i = 0; i < length; i++) {
+                for (i = 0; i < capCount && BM83_FRAME_DB13 + i < length; i++) {
                     switch (data[BM83_FRAME_DB13 + i]) {
                         case BM83_AVRCP_EVT_PLAYBACK_STATUS_CHANGED:
                             bt->activeDevice.avrcpCaps.playbackChanged = 1;
@@ -609,6 +609,7 @@ void BM83ProcessEventAVCSpecificRsp(BT_t *bt, uint8_t *data, uint16_t length)
                 BM83ProcessDataGetAllAttributes(
                     bt,
                     data,
+                    length,
                     attributeCount,
                     BM83_FRAME_DB12
                 );
@@ -684,6 +685,7 @@ void BM83ProcessEventAVCVendorDependentRsp(BT_t *bt, uint8_t *data, uint16_t len
             BM83ProcessDataGetAllAttributes(
                 bt,
                 data,
+                length,
                 attributeCount,
                 BM83_FRAME_DB7
             );
@@ -952,7 +954,8 @@ void BM83ProcessEventCallerID(BT_t *bt, uint8_t *data, uint16_t length)
 {
     char callerId[length + 1];
     uint16_t i = 0;
-    for (i = 0; i < length; i++) {
+    // The caller ID begins at DB1, after the database index
+    for (i = 0; i + BM83_FRAME_DB1 < length; i++) {
         callerId[i] = data[i + BM83_FRAME_DB1];
     }
     callerId[i] = 0;
@@ -1024,26 +1027,14 @@ void BM83ProcessEventReadLinkedDeviceInformation(BT_t *bt, uint8_t *data, uint16
             char nameData[BT_DEVICE_NAME_LEN + 1] = {0};
             char deviceName[BT_DEVICE_NAME_LEN + 1] = {0};
             uint8_t i = 0;
-            for (i = 0; i < length && i < BT_DEVICE_NAME_LEN; i++) {
+            for (i = 0; i + BM83_FRAME_DB2 < length && i < BT_DEVICE_NAME_LEN; i++) {
                 nameData[i] = data[i + BM83_FRAME_DB2];
             }
             UtilsNormalizeText(deviceName, nameData, BT_DEVICE_NAME_LEN + 1);
             LogDebug(LOG_SOURCE_BT, "Connected: %s", deviceName);
             UtilsStrncpy(bt->activeDevice.deviceName, deviceName, BT_DEVICE_NAME_LEN);
             // Copy the device name to its pairing record
-            BTPairedDevice_t *dev = 0;
-            for (i = 0; i < bt->pairedDevicesCount; i++) {
-                dev = &bt->pairedDevices[i];
-                if (dev != 0) {
-                    if (memcmp(dev->macId, bt->activeDevice.macId, BT_MAC_ID_LEN) == 0) {
-                        UtilsStrncpy(
-                            dev->deviceName, 
-                            deviceName, 
-                            BT_DEVICE_NAME_LEN
-                        );
-                    }
-                }
-            }
+            BTPairedDeviceSetName(bt, bt->activeDevice.macId, deviceName);
             EventTriggerCallback(BT_EVENT_DEVICE_CONNECTED, 0);
             break;
         }
@@ -1063,7 +1054,8 @@ void BM83ProcessEventReadPairedDeviceRecord(BT_t *bt, uint8_t *data, uint16_t le
 {
     uint8_t pairedDevices = data[BM83_FRAME_DB0];
     uint16_t dataPos = BM83_FRAME_DB1;
-    while (pairedDevices > 0) {
+    // Each record is the link priority followed by the MAC ID
+    while (pairedDevices > 0 && dataPos + BT_MAC_ID_LEN < length) {
         uint8_t macId[6] = {0};
         uint8_t number = data[dataPos++];
         int8_t i;
@@ -1130,6 +1122,7 @@ void BM83ProcessEventReportTypeCodec(BT_t *bt, uint8_t *data, uint16_t length)
 void BM83ProcessDataGetAllAttributes(
     BT_t *bt,
     uint8_t *data,
+    uint16_t length,
     uint8_t attributeCount,
     uint16_t bytePos
 ) {
@@ -1137,6 +1130,10 @@ void BM83ProcessDataGetAllAttributes(
     bt->metadataStatus = BT_METADATA_STATUS_CUR;
     uint8_t i = 0;
     for (i = 0; i < attributeCount; i++) {
+        // Stop if the attribute header does not fit in the frame
+        if (bytePos + BM83_AVRCP_ATTRIBUTE_HEADER_SIZE > length) {
+            break;
+        }
         // Skip the 0 pads
         bytePos = bytePos + 3;
         uint8_t attributeType = data[bytePos];
@@ -1145,12 +1142,18 @@ void BM83ProcessDataGetAllAttributes(
         uint16_t attributeLen = (data[bytePos + 1] & 0xFF) | (data[bytePos] << 8);
         // Skip over the length and to the beginning of the data
         bytePos = bytePos + 2;
+        // Never trust the attribute length beyond what the frame holds
+        if (attributeLen > length - bytePos) {
+            attributeLen = length - bytePos;
+        }
         char tempString[BT_METADATA_MAX_SIZE] = {0};
         switch (attributeType) {
             case BM83_AVRCP_DATA_ELEMENT_TYPE_TITLE: {
                 uint16_t j = 0;
                 for (j = 0; j < attributeLen; j++) {
-                    tempString[j] = data[bytePos];
+                    if (j < BT_METADATA_MAX_SIZE - 1) {
+                        tempString[j] = data[bytePos];
+                    }
                     bytePos++;
                 }
                 char text[BT_METADATA_MAX_SIZE] = {0};
@@ -1165,7 +1168,9 @@ void BM83ProcessDataGetAllAttributes(
             case BM83_AVRCP_DATA_ELEMENT_TYPE_ARTIST: {
                 uint16_t j = 0;
                 for (j = 0; j < attributeLen; j++) {
-                    tempString[j] = data[bytePos];
+                    if (j < BT_METADATA_MAX_SIZE - 1) {
+                        tempString[j] = data[bytePos];
+                    }
                     bytePos++;
                 }
                 char text[BT_METADATA_MAX_SIZE] = {0};
@@ -1180,7 +1185,9 @@ void BM83ProcessDataGetAllAttributes(
             case BM83_AVRCP_DATA_ELEMENT_TYPE_ALBUM: {
                 uint16_t j = 0;
                 for (j = 0; j < attributeLen; j++) {
-                    tempString[j] = data[bytePos];
+                    if (j < BT_METADATA_MAX_SIZE - 1) {
+                        tempString[j] = data[bytePos];
+                    }
                     bytePos++;
                 }
                 char text[BT_METADATA_MAX_SIZE] = {0};
@@ -1242,8 +1249,13 @@ void BM83Process(BT_t *bt)
             LogRawDebug(LOG_SOURCE_BT, "[%llu] DEBUG: BM83: RX: ", ts);
             uint16_t frameSize = frameLength + BM83_FRAME_CTRL_BYTE_COUNT;
             uint16_t dataLength = frameLength - 1;
-            uint8_t eventData[dataLength];
-            memset(eventData, 0, dataLength);
+            // Short frames are zero padded so fixed offset reads stay in bounds
+            uint16_t eventDataSize = dataLength;
+            if (eventDataSize < BM83_FRAME_DATA_MIN_SIZE) {
+                eventDataSize = BM83_FRAME_DATA_MIN_SIZE;
+            }
+            uint8_t eventData[eventDataSize];
+            memset(eventData, 0, eventDataSize);
             uint8_t event = 0x00;
             uint16_t i = 0;
             uint16_t j = 0;
@@ -1269,6 +1281,8 @@ void BM83Process(BT_t *bt)
                 uint8_t ack[] = {BM83_CMD_EVENT_ACK, event};
                 BM83SendCommand(bt, ack, sizeof(ack));
             }
+            // Start the trace after the acknowledgement, which every frame gets
+            TraceBegin(TRACE_POINT_BT_RX, event);
             if (event == BM83_EVT_AVC_SPECIFIC_RSP) {
                 BM83ProcessEventAVCSpecificRsp(bt, eventData, dataLength);
             }
@@ -1331,6 +1345,7 @@ void BM83Process(BT_t *bt)
             if (event == BM83_EVT_REPORT_TYPE_CODEC) {
                 BM83ProcessEventReportTypeCodec(bt, eventData, dataLength);
             }
+            TraceEnd();
         }
     }
     UARTReportErrors(&bt->uart);
@@ -1377,5 +1392,6 @@ void BM83SendCommand(
     checksum++;
     LogRawDebug(LOG_SOURCE_BT, "%02X\r\n", checksum);
     frame[frameSize - 1] = checksum;
+    TracePoint(TRACE_POINT_BT_TX, targetData[0]);
     UARTSendData(&bt->uart, frame, frameSize);
 }
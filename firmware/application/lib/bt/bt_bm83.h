@@ -8,12 +8,15 @@
 #define BM83_H
 #include <stdint.h>
 #include "bt_common.h"
+#include "../trace.h"
 
 extern int8_t BTBM83MicGainTable[];
 
 #define BM83_AVRCP_DATA_PLAYBACK_STATUS_PLAYING 0x01
 #define BM83_AVRCP_DATA_PLAYBACK_STATUS_PAUSED 0x02
 #define BM83_AVRCP_DATA_PLAYBACK_STATUS_NOW_PLAYING_CHANGED 0x09
+// Attribute ID (4), character set (2) and value length (2)
+#define BM83_AVRCP_ATTRIBUTE_HEADER_SIZE 8
 #define BM83_AVRCP_DATA_ELEMENT_TYPE_TITLE 0x01
 #define BM83_AVRCP_DATA_ELEMENT_TYPE_ARTIST 0x02
 #define BM83_AVRCP_DATA_ELEMENT_TYPE_ALBUM 0x03
@@ -50,6 +53,8 @@ extern int8_t BTBM83MicGainTable[];
 #define BM83_FRAME_DB11 11
 #define BM83_FRAME_DB12 12
 #define BM83_FRAME_DB13 13
+// Handlers read fixed offsets up to DB13, so event data is never smaller
+#define BM83_FRAME_DATA_MIN_SIZE 14
 
 #define BM83_FRAME_SIZE_MIN 0x05
 #define BM83_FRAME_CTRL_BYTE_COUNT 0x04
@@ -349,7 +354,7 @@ void BM83ProcessEventReadLinkedDeviceInformation(BT_t *, uint8_t *, uint16_t);
 void BM83ProcessEventReadPairedDeviceRecord(BT_t *, uint8_t *, uint16_t);
 void BM83ProcessEventReportLinkBackStatus(BT_t *, uint8_t *, uint16_t);
 void BM83ProcessEventReportTypeCodec(BT_t *, uint8_t *, uint16_t );
-void BM83ProcessDataGetAllAttributes(BT_t *, uint8_t *, uint8_t, uint16_t);
+void BM83ProcessDataGetAllAttributes(BT_t *, uint8_t *, uint16_t, uint8_t, uint16_t);
 /* RX / TX */
 void BM83Process(BT_t *);
 void BM83SendCommand(BT_t *, uint8_t *, size_t);
@@ -6,6 +6,165 @@
  */
 #include "bt_common.h"
 
+/**
+ * BTPairedDeviceHash()
+ *     Description:
+ *         Hash a MAC ID to its home bucket in the paired devices index
+ *     Params:
+ *         uint8_t *macId - The MAC ID
+ *     Returns:
+ *         uint8_t - The bucket
+ */
+static uint8_t BTPairedDeviceHash(uint8_t *macId)
+{
+    uint8_t hash = 0;
+    uint8_t idx;
+    for (idx = 0; idx < BT_MAC_ID_LEN; idx++) {
+        hash = (hash * 31) + macId[idx];
+    }
+    return hash & (BT_PAIRED_DEVICE_INDEX_SIZE - 1);
+}
+
+/**
+ * BTPairedDeviceIndexInsert()
+ *     Description:
+ *         Add a pairedDevices entry to the index, probing linearly from its
+ *         home bucket
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t deviceIdx - The index into pairedDevices
+ *     Returns:
+ *         void
+ */
+static void BTPairedDeviceIndexInsert(BT_t *bt, uint8_t deviceIdx)
+{
+    uint8_t bucket = BTPairedDeviceHash(bt->pairedDevices[deviceIdx].macId);
+    uint8_t probes;
+    for (probes = 0; probes < BT_PAIRED_DEVICE_INDEX_SIZE; probes++) {
+        if (bt->pairedDevicesIndex[bucket] == BT_PAIRED_DEVICE_INDEX_EMPTY) {
+            bt->pairedDevicesIndex[bucket] = deviceIdx + 1;
+            return;
+        }
+        bucket = (bucket + 1) & (BT_PAIRED_DEVICE_INDEX_SIZE - 1);
+    }
+}
+
+/**
+ * BTDeviceNameStoreGetAddress()
+ *     Description:
+ *         Get the EEPROM address of a device name record
+ *     Params:
+ *         uint8_t record - The record
+ *     Returns:
+ *         uint32_t - The address of the first byte of the record
+ */
+static uint32_t BTDeviceNameStoreGetAddress(uint8_t record)
+{
+    return BT_DEVICE_NAME_STORE_START +
+        ((uint32_t) record * BT_DEVICE_NAME_STORE_RECORD_SIZE);
+}
+
+/**
+ * BTDeviceNameStoreFind()
+ *     Description:
+ *         Find the stored name record for a MAC ID
+ *     Params:
+ *         uint8_t *macId - The MAC ID
+ *         uint8_t *freeRecord - Set to the first unused record, or
+ *             BT_PAIRED_DEVICE_NONE if every record is used
+ *     Returns:
+ *         uint8_t - The record, or BT_PAIRED_DEVICE_NONE if there is none
+ */
+static uint8_t BTDeviceNameStoreFind(uint8_t *macId, uint8_t *freeRecord)
+{
+    uint8_t header[1 + BT_MAC_ID_LEN];
+    uint8_t record;
+    *freeRecord = BT_PAIRED_DEVICE_NONE;
+    for (record = 0; record < BT_DEVICE_NAME_STORE_COUNT; record++) {
+        EEPROMReadBytes(BTDeviceNameStoreGetAddress(record), header, sizeof(header));
+        if (header[0] != BT_DEVICE_NAME_STORE_MAGIC) {
+            if (*freeRecord == BT_PAIRED_DEVICE_NONE) {
+                *freeRecord = record;
+            }
+        } else if (memcmp(&header[1], macId, BT_MAC_ID_LEN) == 0) {
+            return record;
+        }
+    }
+    return BT_PAIRED_DEVICE_NONE;
+}
+
+/**
+ * BTDeviceNameStoreGet()
+ *     Description:
+ *         Read the stored name of a device
+ *     Params:
+ *         uint8_t *macId - The MAC ID
+ *         char *deviceName - The buffer to write the name to, at least
+ *             BT_DEVICE_NAME_STORE_NAME_SIZE bytes
+ *     Returns:
+ *         uint8_t - 1 if a name was found, 0 otherwise
+ */
+uint8_t BTDeviceNameStoreGet(uint8_t *macId, char *deviceName)
+{
+    uint8_t freeRecord;
+    uint8_t record = BTDeviceNameStoreFind(macId, &freeRecord);
+    if (record == BT_PAIRED_DEVICE_NONE) {
+        return 0;
+    }
+    EEPROMReadBytes(
+        BTDeviceNameStoreGetAddress(record) + 1 + BT_MAC_ID_LEN,
+        (unsigned char *) deviceName,
+        BT_DEVICE_NAME_STORE_NAME_SIZE
+    );
+    deviceName[BT_DEVICE_NAME_STORE_NAME_SIZE - 1] = '\0';
+    return deviceName[0] != '\0';
+}
+
+/**
+ * BTDeviceNameStoreSave()
+ *     Description:
+ *         Store the name of a device, unless the stored name is the same.
+ *         When every record is used, the record the MAC ID hashes to is
+ *         replaced.
+ *     Params:
+ *         uint8_t *macId - The MAC ID
+ *         char *deviceName - The name
+ *     Returns:
+ *         void
+ */
+static void BTDeviceNameStoreSave(uint8_t *macId, char *deviceName)
+{
+    unsigned char data[BT_DEVICE_NAME_STORE_RECORD_SIZE];
+    uint8_t freeRecord;
+    if (strlen(deviceName) == 0) {
+        return;
+    }
+    uint8_t record = BTDeviceNameStoreFind(macId, &freeRecord);
+    if (record != BT_PAIRED_DEVICE_NONE) {
+        EEPROMReadBytes(BTDeviceNameStoreGetAddress(record), data, sizeof(data));
+        if (strncmp(
+            (char *) &data[1 + BT_MAC_ID_LEN],
+            deviceName,
+            BT_DEVICE_NAME_STORE_NAME_SIZE - 1
+        ) == 0) {
+            return;
+        }
+    } else if (freeRecord != BT_PAIRED_DEVICE_NONE) {
+        record = freeRecord;
+    } else {
+        record = BTPairedDeviceHash(macId) % BT_DEVICE_NAME_STORE_COUNT;
+    }
+    memset(data, 0, sizeof(data));
+    data[0] = BT_DEVICE_NAME_STORE_MAGIC;
+    memcpy(&data[1], macId, BT_MAC_ID_LEN);
+    UtilsStrncpy(
+        (char *) &data[1 + BT_MAC_ID_LEN],
+        deviceName,
+        BT_DEVICE_NAME_STORE_NAME_SIZE
+    );
+    EEPROMWritePage(BTDeviceNameStoreGetAddress(record), data, sizeof(data));
+}
+
 
 /**
  * BTClearActiveDevice()
@@ -24,7 +183,8 @@ void BTClearActiveDevice(BT_t *bt)
 /**
  * BTClearMetadata()
  *     Description:
- *        (Re)Initialize the metadata fields to blank
+ *        (Re)Initialize the metadata fields to blank and let the listeners
+ *        know through BT_EVENT_METADATA_CLEAR
  *     Params:
  *         BT_t *bt - A pointer to the module object
  *     Returns:
@@ -35,6 +195,7 @@ void BTClearMetadata(BT_t *bt)
     memset(bt->title, 0, BT_METADATA_FIELD_SIZE);
     memset(bt->artist, 0, BT_METADATA_FIELD_SIZE);
     memset(bt->album, 0, BT_METADATA_FIELD_SIZE);
+    EventTriggerCallback(BT_EVENT_METADATA_CLEAR, 0);
 }
 
 /**
@@ -51,7 +212,7 @@ void BTClearPairedDevices(BT_t *bt, uint8_t clearType)
     uint8_t idx;
     uint8_t found = 0;
     BTPairedDevice_t btActiveConn;
-    for (idx = 0; idx < bt->pairedDevicesCount; idx++) {
+    for (idx = 0; idx < BT_MAX_DEVICE_PAIRED; idx++) {
         BTPairedDevice_t *btConn = &bt->pairedDevices[idx];
         if (btConn != 0) {
             // Found the active device
@@ -65,6 +226,8 @@ void BTClearPairedDevices(BT_t *bt, uint8_t clearType)
         }
     }
     bt->pairedDevicesCount = 0;
+    bt->pairedDevicesRevision++;
+    memset(bt->pairedDevicesIndex, 0, sizeof(bt->pairedDevicesIndex));
     memset(bt->pairingErrors, 0, sizeof(bt->pairingErrors));
     if ((clearType != BT_TYPE_CLEAR_ALL) && (found == 1)) {
         BTPairedDeviceInit(bt, btActiveConn.macId, btActiveConn.deviceName, btActiveConn.number);
@@ -90,10 +253,61 @@ BTConnection_t BTConnectionInit()
 }
 
 
+/**
+ * BTPairedDeviceFind()
+ *     Description:
+ *         Look up a paired device by MAC ID through the index
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t *macId - The MAC ID
+ *     Returns:
+ *         uint8_t - The index into pairedDevices, or BT_PAIRED_DEVICE_NONE
+ */
+uint8_t BTPairedDeviceFind(BT_t *bt, uint8_t *macId)
+{
+    uint8_t bucket = BTPairedDeviceHash(macId);
+    uint8_t probes;
+    for (probes = 0; probes < BT_PAIRED_DEVICE_INDEX_SIZE; probes++) {
+        uint8_t entry = bt->pairedDevicesIndex[bucket];
+        if (entry == BT_PAIRED_DEVICE_INDEX_EMPTY) {
+            break;
+        }
+        if (memcmp(macId, bt->pairedDevices[entry - 1].macId, BT_MAC_ID_LEN) == 0) {
+            return entry - 1;
+        }
+        bucket = (bucket + 1) & (BT_PAIRED_DEVICE_INDEX_SIZE - 1);
+    }
+    return BT_PAIRED_DEVICE_NONE;
+}
+
+/**
+ * BTPairedDeviceIndexRebuild()
+ *     Description:
+ *         Rebuild the paired devices index from scratch. Used when an entry
+ *         is overwritten in place, since open addressing cannot simply drop
+ *         a key.
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *     Returns:
+ *         void
+ */
+void BTPairedDeviceIndexRebuild(BT_t *bt)
+{
+    uint8_t emptyMac[BT_MAC_ID_LEN] = {0};
+    uint8_t idx;
+    memset(bt->pairedDevicesIndex, 0, sizeof(bt->pairedDevicesIndex));
+    for (idx = 0; idx < BT_MAX_DEVICE_PAIRED; idx++) {
+        if (memcmp(bt->pairedDevices[idx].macId, emptyMac, BT_MAC_ID_LEN) != 0) {
+            BTPairedDeviceIndexInsert(bt, idx);
+        }
+    }
+}
+
 /**
  * BTPairedDeviceInit()
  *     Description:
- *         Initialize a pairing profile if one does not exist
+ *         Initialize a pairing profile if one does not exist. Devices added
+ *         without a name get the name we stored for them last time.
  *     Params:
  *         BT_t *bt
  *         char *macId
@@ -107,36 +321,41 @@ void BTPairedDeviceInit(
     char *deviceName,
     uint8_t deviceNumber
 ) {
-    uint8_t deviceExists = 0;
-    uint8_t idx;
-    for (idx = 0; idx < bt->pairedDevicesCount; idx++) {
-        BTPairedDevice_t *btDevice = &bt->pairedDevices[idx];
-        if (memcmp(macId, btDevice->macId, BT_MAC_ID_LEN) == 0) {
-            deviceExists = 1;
-            EventTriggerCallback(BT_EVENT_DEVICE_FOUND, (uint8_t *) macId);
-        }
+    if (BTPairedDeviceFind(bt, macId) != BT_PAIRED_DEVICE_NONE) {
+        BTPairedDeviceSetName(bt, macId, deviceName);
+        EventTriggerCallback(BT_EVENT_DEVICE_FOUND, (uint8_t *) macId);
+        return;
     }
     // Create a connection for this device since one does not exist
-    if (deviceExists == 0) {
-        BTPairedDevice_t pairedDevice;
-        memcpy(pairedDevice.macId, macId, BT_MAC_ID_LEN);
-        memset(pairedDevice.deviceName, 0, BT_DEVICE_NAME_LEN);
+    BTPairedDevice_t pairedDevice;
+    memcpy(pairedDevice.macId, macId, BT_MAC_ID_LEN);
+    memset(pairedDevice.deviceName, 0, BT_DEVICE_NAME_LEN);
+    if (strlen(deviceName) > 0) {
         UtilsStrncpy(pairedDevice.deviceName, deviceName, BT_DEVICE_NAME_LEN);
-        if (deviceNumber > 0 && deviceNumber <= BT_MAX_DEVICE_PAIRED) {
-            pairedDevice.number = deviceNumber;
-            LogDebug(LOG_SOURCE_BT, "Add PD: %d", deviceNumber - 1);
-            bt->pairedDevices[deviceNumber - 1] = pairedDevice;
-            bt->pairedDevicesCount++;
-            EventTriggerCallback(BT_EVENT_DEVICE_FOUND, (uint8_t *) macId);
-            LogDebug(LOG_SOURCE_BT, "BT: Rewrite Pairing Profile");
-        } else if (bt->pairedDevicesCount+1 < BT_MAX_DEVICE_PAIRED) {
-            pairedDevice.number = bt->pairedDevicesCount + 1;
-            bt->pairedDevices[bt->pairedDevicesCount++] = pairedDevice;
-            EventTriggerCallback(BT_EVENT_DEVICE_FOUND, (uint8_t *) macId);
-            LogDebug(LOG_SOURCE_BT, "BT: New Pairing Profile");
-        } else {
-            LogDebug(LOG_SOURCE_BT, "BT: Ignoring Pairing Profile");
-        }
+        BTDeviceNameStoreSave(macId, deviceName);
+    } else {
+        BTDeviceNameStoreGet(macId, pairedDevice.deviceName);
+    }
+    if (deviceNumber > 0 && deviceNumber <= BT_MAX_DEVICE_PAIRED) {
+        pairedDevice.number = deviceNumber;
+        LogDebug(LOG_SOURCE_BT, "Add PD: %d", deviceNumber - 1);
+        bt->pairedDevices[deviceNumber - 1] = pairedDevice;
+        bt->pairedDevicesCount++;
+        bt->pairedDevicesRevision++;
+        // The slot may have held another device
+        BTPairedDeviceIndexRebuild(bt);
+        EventTriggerCallback(BT_EVENT_DEVICE_FOUND, (uint8_t *) macId);
+        LogDebug(LOG_SOURCE_BT, "BT: Rewrite Pairing Profile");
+    } else if (bt->pairedDevicesCount+1 < BT_MAX_DEVICE_PAIRED) {
+        pairedDevice.number = bt->pairedDevicesCount + 1;
+        bt->pairedDevices[bt->pairedDevicesCount] = pairedDevice;
+        BTPairedDeviceIndexInsert(bt, bt->pairedDevicesCount);
+        bt->pairedDevicesCount++;
+        bt->pairedDevicesRevision++;
+        EventTriggerCallback(BT_EVENT_DEVICE_FOUND, (uint8_t *) macId);
+        LogDebug(LOG_SOURCE_BT, "BT: New Pairing Profile");
+    } else {
+        LogDebug(LOG_SOURCE_BT, "BT: Ignoring Pairing Profile");
     }
 }
 
@@ -152,13 +371,34 @@ void BTPairedDeviceInit(
  */
 char *BTPairedDeviceGetName(BT_t *bt, uint8_t *macId)
 {
-    char *deviceName = 0;
-    uint8_t idx;
-    for (idx = 0; idx <= bt->pairedDevicesCount; idx++) {
-        BTPairedDevice_t *btDevice = &bt->pairedDevices[idx];
-        if (memcmp(macId, btDevice->macId, 6) == 0) {
-            deviceName = btDevice->deviceName;
-        }
+    uint8_t deviceIdx = BTPairedDeviceFind(bt, macId);
+    if (deviceIdx == BT_PAIRED_DEVICE_NONE) {
+        return 0;
+    }
+    return bt->pairedDevices[deviceIdx].deviceName;
+}
+
+/**
+ * BTPairedDeviceSetName()
+ *     Description:
+ *         Update the name of a paired device and store it for the next boot
+ *     Params:
+ *         BT_t *bt
+ *         uint8_t *macId - The MAC ID of the device
+ *         char *deviceName - The name, ignored if empty
+ *     Returns:
+ *         void
+ */
+void BTPairedDeviceSetName(BT_t *bt, uint8_t *macId, char *deviceName)
+{
+    uint8_t deviceIdx = BTPairedDeviceFind(bt, macId);
+    if (deviceIdx == BT_PAIRED_DEVICE_NONE || strlen(deviceName) == 0) {
+        return;
+    }
+    BTPairedDevice_t *dev = &bt->pairedDevices[deviceIdx];
+    if (strncmp(dev->deviceName, deviceName, BT_DEVICE_NAME_LEN) != 0) {
+        UtilsStrncpy(dev->deviceName, deviceName, BT_DEVICE_NAME_LEN);
+        bt->pairedDevicesRevision++;
+        BTDeviceNameStoreSave(macId, deviceName);
     }
-    return deviceName;
 }
@@ -7,9 +7,11 @@
 #ifndef BT_COMMON_H
 #define BT_COMMON_H
 #include "../../mappings.h"
+#include "../eeprom.h"
 #include "../log.h"
 #include "../event.h"
 #include "../uart.h"
+#include "../utils.h"
 
 #define BT_AVRCP_ACTION_GET_METADATA 0
 #define BT_AVRCP_ACTION_SET_TRACK_CHANGE_NOTIF 1
@@ -19,6 +21,13 @@
 
 #define BT_BTM_TYPE_BC127 BOARD_VERSION_ONE
 #define BT_BTM_TYPE_BM83 BOARD_VERSION_TWO
+// Each board revision carries one BT module, so the type is a constant in
+// single revision builds
+#ifdef BOARD_VERSION_FIXED
+#define BTGetType(bt) (BOARD_VERSION_FIXED)
+#else
+#define BTGetType(bt) ((bt)->type)
+#endif
 
 #define BT_CALL_INACTIVE 0
 #define BT_CALL_ACTIVE 1
@@ -31,6 +40,12 @@
 #define BT_DIAL_BUFFER_FIELD_SIZE 32
 #define BT_CLOSE_ALL 255
 
+#define BT_CVC_BAND_NB 0
+#define BT_CVC_BAND_WB 1
+#define BT_CVC_BAND_COUNT 2
+#define BT_CVC_PARAM_COUNT 14
+#define BT_CVC_PRESET_NONE 0xFF
+
 #define BT_STATUS_OFF 0
 #define BT_STATUS_DISCONNECTED 1
 #define BT_STATUS_CONNECTED 2
@@ -56,6 +71,7 @@
 #define BT_EVENT_BTM_ADDRESS 15
 #define BT_EVENT_TIME_UPDATE 16
 #define BT_EVENT_DSP_STATUS 17
+#define BT_EVENT_METADATA_CLEAR 18
 
 #define BT_LEN_MAC_ID 6
 
@@ -86,9 +102,48 @@
 
 #define BT_MAC_ID_LEN 6
 
+// Open addressed MAC -> pairedDevices index. Keep it a power of two and at
+// least twice BT_MAX_DEVICE_PAIRED so probe runs stay short.
+#define BT_PAIRED_DEVICE_INDEX_SIZE 16
+#define BT_PAIRED_DEVICE_INDEX_EMPTY 0
+#define BT_PAIRED_DEVICE_NONE 0xFF
+/*
+ * Device names are kept in the EEPROM so they are known as soon as a device
+ * links up, instead of after a NAME round trip (BC127) or never for devices
+ * that are not connected (BM83). Records do not cross an EEPROM page.
+ *
+ * Record layout:
+ *     0      - BT_DEVICE_NAME_STORE_MAGIC
+ *     1 - 6  - MAC ID
+ *     7 - 31 - Name, null terminated
+ */
+#define BT_DEVICE_NAME_STORE_START 0x0100
+#define BT_DEVICE_NAME_STORE_RECORD_SIZE 32
+#define BT_DEVICE_NAME_STORE_COUNT 8
+#define BT_DEVICE_NAME_STORE_MAGIC 0xA7
+#define BT_DEVICE_NAME_STORE_NAME_SIZE (BT_DEVICE_NAME_STORE_RECORD_SIZE - 1 - BT_MAC_ID_LEN)
+
 #define BT_VOICE_RECOG_OFF 0
 #define BT_VOICE_RECOG_ON 1
 
+/**
+ * BTCVC_t
+ *     Description:
+ *         What we know of the CVC configuration in the module, so only the
+ *         parameters that change have to be sent to it
+ *     Fields:
+ *         params - The parameters last written, per band
+ *         validMask - Bit n is set once band n has been written in full
+ *             since the module booted, so params matches the module
+ *         preset - The preset last loaded, BT_CVC_PRESET_NONE if the
+ *             parameters were set some other way
+ */
+typedef struct BTCVC_t {
+    uint16_t params[BT_CVC_BAND_COUNT][BT_CVC_PARAM_COUNT];
+    uint8_t validMask;
+    uint8_t preset;
+} BTCVC_t;
+
 /**
  * BTPairedDevice_t
  *     Description:
@@ -174,6 +229,10 @@ typedef struct BTConnection_t {
  *         powerState - 2/1/0 1 Standby, On, Off
  *         pairedDevicesCount - The number of devices that have paired with us
  *            in all of time. The max is 8.
+ *         pairedDevicesRevision - Incremented whenever a pairing is added,
+ *             removed or renamed, so views of the list know to refresh
+ *         pairedDevicesIndex - Hash index of pairedDevices by MAC ID. Each
+ *             bucket holds the pairedDevices index + 1, 0 when empty.
  *         pairingErrors - The key indicates the profile in error and the value
  *             in error. This is used to track what profiles we need to re-attempt
  *             a connection with.
@@ -196,6 +255,8 @@ typedef struct BT_t {
     uint8_t scoStatus: 3;
     uint8_t powerState: 2;
     uint8_t pairedDevicesCount: 4;
+    uint8_t pairedDevicesRevision;
+    uint8_t pairedDevicesIndex[BT_PAIRED_DEVICE_INDEX_SIZE];
     uint8_t pairingErrors[BT_PROFILE_COUNT];
     uint32_t metadataTimestamp;
     uint32_t rxQueueAge;
@@ -204,6 +265,7 @@ typedef struct BT_t {
     char album[BT_METADATA_FIELD_SIZE];
     char callerId[BT_CALLER_ID_FIELD_SIZE];
     char dialBuffer[BT_DIAL_BUFFER_FIELD_SIZE];
+    BTCVC_t cvc;
     UART_t uart;
 } BT_t;
 
@@ -212,6 +274,10 @@ void BTClearActiveDevice(BT_t *);
 void BTClearMetadata(BT_t *);
 void BTClearPairedDevices(BT_t *, uint8_t);
 BTConnection_t BTConnectionInit();
+uint8_t BTDeviceNameStoreGet(uint8_t *, char *);
+uint8_t BTPairedDeviceFind(BT_t *, uint8_t *);
+void BTPairedDeviceIndexRebuild(BT_t *);
 void BTPairedDeviceInit(BT_t *, uint8_t *, char *, uint8_t);
 char *BTPairedDeviceGetName(BT_t *, uint8_t *);
+void BTPairedDeviceSetName(BT_t *, uint8_t *, char *);
 #endif /* BT_COMMON_H */
\ No newline at end of file
@@ -0,0 +1,326 @@
+/*
+ * File: codec.c
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Supervise the WM88XX and PCM51XX, reading their status a register block
+ *     at a time and recovering them when they fault
+ */
+#include "codec.h"
+static CodecContext_t Codec;
+
+static const char *CodecNames[CODEC_COUNT] = {
+    "WM88XX",
+    "PCM51XX"
+};
+
+static const char *CodecFaultNames[] = {
+    "None",
+    "Bus",
+    "Config",
+    "Unlock",
+    "Output"
+};
+
+static const char *CodecStateNames[] = {
+    "OK",
+    "Recovering",
+    "Failed"
+};
+
+/**
+ * CodecRecover()
+ *     Description:
+ *         Run the recovery action for the fault a codec is in
+ *     Params:
+ *         uint8_t codec - CODEC_WM88XX or CODEC_PCM51XX
+ *     Returns:
+ *         void
+ */
+static void CodecRecover(uint8_t codec)
+{
+    CodecStatus_t *status = &Codec.status[codec];
+    status->retries++;
+    switch (status->fault) {
+        case CODEC_FAULT_BUS:
+            // Polling runs the bus recovery if the last transfer failed
+            if (codec == CODEC_WM88XX) {
+                I2CPoll(WM88XX_I2C_ADDR);
+            } else {
+                I2CPoll(PCM51XX_I2C_ADDR);
+            }
+            break;
+        case CODEC_FAULT_CONFIG:
+            if (codec == CODEC_WM88XX) {
+                WM88XXConfigure();
+            } else {
+                PCM51XXRestore();
+            }
+            break;
+        case CODEC_FAULT_UNLOCK:
+            WM88XXRestartReceiver();
+            break;
+        case CODEC_FAULT_OUTPUT:
+            PCM51XXRestartOutput();
+            break;
+    }
+}
+
+/**
+ * CodecSetFault()
+ *     Description:
+ *         Handle a fault seen on a codec. A new fault is recorded and
+ *         recovered from. A codec already recovering gets another attempt
+ *         until it runs out of retries.
+ *     Params:
+ *         uint8_t codec - CODEC_WM88XX or CODEC_PCM51XX
+ *         uint8_t fault - The CODEC_FAULT_* seen
+ *     Returns:
+ *         void
+ */
+static void CodecSetFault(uint8_t codec, uint8_t fault)
+{
+    CodecStatus_t *status = &Codec.status[codec];
+    if (status->state == CODEC_STATE_FAILED && status->fault == fault) {
+        return;
+    }
+    if (status->state == CODEC_STATE_OK || status->fault != fault) {
+        if (status->state == CODEC_STATE_OK) {
+            status->faultTimestamp = TimerGetMillis();
+            status->faults++;
+        }
+        status->state = CODEC_STATE_RECOVERING;
+        status->fault = fault;
+        status->retries = 0;
+        LogWarning(
+            "CODEC: %s fault: %s",
+            CodecNames[codec],
+            CodecFaultNames[fault]
+        );
+    }
+    if (status->retries >= CODEC_RECOVERY_RETRIES) {
+        if (fault == CODEC_FAULT_UNLOCK) {
+            // The source went away, wait for it to lock again
+            LogInfo(LOG_SOURCE_SYSTEM, "CODEC: S/PDIF source lost");
+            Codec.wm88xxLocked = 0;
+            status->state = CODEC_STATE_OK;
+            status->fault = CODEC_FAULT_NONE;
+            status->retries = 0;
+            return;
+        }
+        LogError(
+            "CODEC: %s did not recover from %s fault",
+            CodecNames[codec],
+            CodecFaultNames[fault]
+        );
+        status->state = CODEC_STATE_FAILED;
+        return;
+    }
+    CodecRecover(codec);
+}
+
+/**
+ * CodecSetHealthy()
+ *     Description:
+ *         Mark a codec as healthy, recording how long the recovery took if it
+ *         was faulted
+ *     Params:
+ *         uint8_t codec - CODEC_WM88XX or CODEC_PCM51XX
+ *     Returns:
+ *         void
+ */
+static void CodecSetHealthy(uint8_t codec)
+{
+    CodecStatus_t *status = &Codec.status[codec];
+    if (status->state == CODEC_STATE_OK) {
+        return;
+    }
+    uint32_t elapsed = TimerGetMillis() - status->faultTimestamp;
+    if (elapsed > 0xFFFF) {
+        elapsed = 0xFFFF;
+    }
+    status->lastRecoveryMs = (uint16_t) elapsed;
+    if (status->lastRecoveryMs > status->maxRecoveryMs) {
+        status->maxRecoveryMs = status->lastRecoveryMs;
+    }
+    status->recoveries++;
+    LogInfo(
+        LOG_SOURCE_SYSTEM,
+        "CODEC: %s recovered from %s fault in %ums",
+        CodecNames[codec],
+        CodecFaultNames[status->fault],
+        status->lastRecoveryMs
+    );
+    status->state = CODEC_STATE_OK;
+    status->fault = CODEC_FAULT_NONE;
+    status->retries = 0;
+}
+
+/**
+ * CodecInit()
+ *     Description:
+ *         Start supervising the codecs. Must be called once the codecs have
+ *         been configured.
+ *     Params:
+ *         uint8_t wm88xxFitted - Set if the board carries a WM88XX
+ *     Returns:
+ *         void
+ */
+void CodecInit(uint8_t wm88xxFitted)
+{
+    memset(&Codec, 0, sizeof(CodecContext_t));
+    Codec.wm88xxFitted = wm88xxFitted;
+    Codec.step = wm88xxFitted ? CODEC_STEP_WM88XX_STATUS : CODEC_STEP_PCM51XX_CLOCKS;
+    TimerRegisterScheduledTask(&CodecTimerSupervise, 0, CODEC_SUPERVISOR_INT);
+}
+
+/**
+ * CodecPrintStatus()
+ *     Description:
+ *         Log the state, fault counters and last register block of each codec
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void CodecPrintStatus()
+{
+    uint8_t codec;
+    for (codec = 0; codec < CODEC_COUNT; codec++) {
+        CodecStatus_t *status = &Codec.status[codec];
+        if (codec == CODEC_WM88XX && Codec.wm88xxFitted == 0) {
+            LogRaw("%s: Not fitted\r\n", CodecNames[codec]);
+            continue;
+        }
+        LogRaw(
+            "%s: %s (%s) Faults: %u Recoveries: %u Last: %ums Max: %ums\r\n",
+            CodecNames[codec],
+            CodecStateNames[status->state],
+            CodecFaultNames[status->fault],
+            status->faults,
+            status->recoveries,
+            status->lastRecoveryMs,
+            status->maxRecoveryMs
+        );
+        LogRaw(
+            "    Registers: %02X %02X %02X %02X\r\n",
+            status->registers[0],
+            status->registers[1],
+            status->registers[2],
+            status->registers[3]
+        );
+    }
+    if (Codec.wm88xxFitted != 0) {
+        LogRaw(
+            "S/PDIF: %s\r\n",
+            Codec.wm88xxLocked ? "Locked" : "No Source"
+        );
+    }
+}
+
+/**
+ * CodecTimerSupervise()
+ *     Description:
+ *         Run one supervision step. Every step is a single short I2C
+ *         transaction, so a tick never holds the main loop for long.
+ *     Params:
+ *         void *ctx - Unused
+ *     Returns:
+ *         void
+ */
+void CodecTimerSupervise(void *ctx)
+{
+    unsigned char *registers;
+    int8_t result;
+    uint8_t step = Codec.step;
+    Codec.step++;
+    if (Codec.step >= CODEC_STEP_COUNT) {
+        Codec.step = Codec.wm88xxFitted ? CODEC_STEP_WM88XX_STATUS : CODEC_STEP_PCM51XX_CLOCKS;
+    }
+    switch (step) {
+        case CODEC_STEP_WM88XX_STATUS:
+            registers = Codec.status[CODEC_WM88XX].registers;
+            result = I2CReadBytes(
+                WM88XX_I2C_ADDR,
+                WM88XX_REGISTER_INTSTAT,
+                registers,
+                2
+            );
+            if (result != I2C_STATUS_OK) {
+                CodecSetFault(CODEC_WM88XX, CODEC_FAULT_BUS);
+            } else if ((registers[1] & WM88XX_SPDSTAT_UNLOCK) == 0) {
+                Codec.wm88xxLocked = 1;
+                if (Codec.status[CODEC_WM88XX].fault != CODEC_FAULT_CONFIG) {
+                    CodecSetHealthy(CODEC_WM88XX);
+                }
+            } else if (Codec.wm88xxLocked == 1) {
+                // Only a receiver that had a source can lose it
+                CodecSetFault(CODEC_WM88XX, CODEC_FAULT_UNLOCK);
+            } else if (Codec.status[CODEC_WM88XX].fault == CODEC_FAULT_BUS) {
+                CodecSetHealthy(CODEC_WM88XX);
+            }
+            break;
+        case CODEC_STEP_WM88XX_POWER:
+            registers = Codec.status[CODEC_WM88XX].registers;
+            result = I2CRead(WM88XX_I2C_ADDR, WM88XX_REGISTER_PWR, &registers[2]);
+            if (result != I2C_STATUS_OK) {
+                CodecSetFault(CODEC_WM88XX, CODEC_FAULT_BUS);
+            } else if (registers[2] != WM88XX_PWR_ON) {
+                // The part reset or lost its configuration
+                CodecSetFault(CODEC_WM88XX, CODEC_FAULT_CONFIG);
+            } else if (Codec.status[CODEC_WM88XX].fault != CODEC_FAULT_UNLOCK) {
+                CodecSetHealthy(CODEC_WM88XX);
+            }
+            break;
+        case CODEC_STEP_PCM51XX_CLOCKS:
+            registers = Codec.status[CODEC_PCM51XX].registers;
+            // Informational only, the clock state follows the source
+            result = I2CReadBytes(
+                PCM51XX_I2C_ADDR,
+                PCM51XX_REGISTER_FS_DETECT,
+                registers,
+                CODEC_REGISTER_COUNT
+            );
+            if (result != I2C_STATUS_OK) {
+                CodecSetFault(CODEC_PCM51XX, CODEC_FAULT_BUS);
+            }
+            break;
+        case CODEC_STEP_PCM51XX_VOLUME: {
+            unsigned char volume[2] = {0};
+            result = I2CReadBytes(
+                PCM51XX_I2C_ADDR,
+                PCM51XX_REGISTER_VOLL,
+                volume,
+                2
+            );
+            if (result != I2C_STATUS_OK) {
+                CodecSetFault(CODEC_PCM51XX, CODEC_FAULT_BUS);
+            } else if (
+                volume[0] != PCM51XXGetVolume() ||
+                volume[1] != PCM51XXGetVolume()
+            ) {
+                // The part reset and came back with its defaults
+                CodecSetFault(CODEC_PCM51XX, CODEC_FAULT_CONFIG);
+            } else if (Codec.status[CODEC_PCM51XX].fault != CODEC_FAULT_OUTPUT) {
+                CodecSetHealthy(CODEC_PCM51XX);
+            }
+            break;
+        }
+        case CODEC_STEP_PCM51XX_POWER: {
+            unsigned char powerState = 0;
+            result = I2CRead(
+                PCM51XX_I2C_ADDR,
+                PCM51XX_REGISTER_POWER_STATE,
+                &powerState
+            );
+            powerState &= PCM51XX_POWER_STATE_MASK;
+            if (result != I2C_STATUS_OK) {
+                CodecSetFault(CODEC_PCM51XX, CODEC_FAULT_BUS);
+            } else if (powerState == PCM51XX_POWER_STATE_SHORT) {
+                CodecSetFault(CODEC_PCM51XX, CODEC_FAULT_OUTPUT);
+            } else if (Codec.status[CODEC_PCM51XX].fault != CODEC_FAULT_CONFIG) {
+                CodecSetHealthy(CODEC_PCM51XX);
+            }
+            break;
+        }
+    }
+}
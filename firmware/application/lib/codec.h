@@ -0,0 +1,87 @@
+/*
+ * File: codec.h
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Supervise the WM88XX and PCM51XX, reading their status a register block
+ *     at a time and recovering them when they fault
+ */
+#ifndef CODEC_H
+#define CODEC_H
+#include <stdint.h>
+#include <string.h>
+#include "i2c.h"
+#include "log.h"
+#include "pcm51xx.h"
+#include "timer.h"
+#include "wm88xx.h"
+// Each tick runs one step, so a full pass takes CODEC_STEP_COUNT ticks
+#define CODEC_SUPERVISOR_INT 250
+#define CODEC_RECOVERY_RETRIES 3
+#define CODEC_REGISTER_COUNT 4
+#define CODEC_WM88XX 0
+#define CODEC_PCM51XX 1
+#define CODEC_COUNT 2
+#define CODEC_STATE_OK 0
+#define CODEC_STATE_RECOVERING 1
+// Out of retries, we keep reading but stop recovering until it comes back
+#define CODEC_STATE_FAILED 2
+#define CODEC_FAULT_NONE 0
+#define CODEC_FAULT_BUS 1
+#define CODEC_FAULT_CONFIG 2
+#define CODEC_FAULT_UNLOCK 3
+#define CODEC_FAULT_OUTPUT 4
+#define CODEC_STEP_WM88XX_STATUS 0
+#define CODEC_STEP_WM88XX_POWER 1
+#define CODEC_STEP_PCM51XX_CLOCKS 2
+#define CODEC_STEP_PCM51XX_VOLUME 3
+#define CODEC_STEP_PCM51XX_POWER 4
+#define CODEC_STEP_COUNT 5
+
+/**
+ * CodecStatus_t
+ *     Description:
+ *         The supervision state of a codec
+ *     Fields:
+ *         state - CODEC_STATE_*
+ *         fault - The CODEC_FAULT_* being recovered from
+ *         retries - The recovery attempts made for fault
+ *         registers - The last status block read from the codec
+ *         faults - The number of faults seen since boot
+ *         recoveries - The number of faults recovered from since boot
+ *         faultTimestamp - When fault was first seen
+ *         lastRecoveryMs - How long the last recovery took
+ *         maxRecoveryMs - The longest recovery since boot
+ */
+typedef struct CodecStatus_t {
+    uint8_t state;
+    uint8_t fault;
+    uint8_t retries;
+    unsigned char registers[CODEC_REGISTER_COUNT];
+    uint16_t faults;
+    uint16_t recoveries;
+    uint32_t faultTimestamp;
+    uint16_t lastRecoveryMs;
+    uint16_t maxRecoveryMs;
+} CodecStatus_t;
+
+/**
+ * CodecContext_t
+ *     Description:
+ *         The codec supervisor state
+ *     Fields:
+ *         wm88xxFitted - Set if the board carries a WM88XX
+ *         wm88xxLocked - Set once the S/PDIF receiver has locked to a source
+ *         step - The CODEC_STEP_* to run on the next tick
+ *         status - The state of each codec
+ */
+typedef struct CodecContext_t {
+    uint8_t wm88xxFitted;
+    uint8_t wm88xxLocked;
+    uint8_t step;
+    CodecStatus_t status[CODEC_COUNT];
+} CodecContext_t;
+
+void CodecInit(uint8_t);
+void CodecPrintStatus();
+void CodecTimerSupervise(void *);
+#endif /* CODEC_H */
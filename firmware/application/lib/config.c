@@ -568,7 +568,11 @@ void ConfigSetBootloaderMode(uint8_t bootloaderMode)
 /**
  * ConfigSetBytes()
  *     Description:
- *         Set a byte into the EEPROM and update cache
+ *         Set a run of bytes into the EEPROM and update cache. The run is
+ *         written a page at a time, so it costs one write cycle per EEPROM
+ *         page instead of one per byte. Pages that already hold the data
+ *         are not written. The cache holds the values the way
+ *         ConfigGetByte() reads them back, with 0xFF as 0x00.
  *     Params:
  *         uint8_t address - The address to read from
  *         const uint8_t *data - The data pointer
@@ -577,9 +581,26 @@ void ConfigSetBootloaderMode(uint8_t bootloaderMode)
 void ConfigSetBytes(uint8_t address, const uint8_t *data, uint8_t size)
 {
     uint8_t i = 0;
-    for (i = 0; i < size; i++) {
-        ConfigSetByte(address, data[i]);
-        address++;
+    while (i < size) {
+        uint8_t length = EEPROM_PAGE_SIZE - (address % EEPROM_PAGE_SIZE);
+        uint8_t changed = 0;
+        uint8_t j;
+        if (length > size - i) {
+            length = size - i;
+        }
+        for (j = 0; j < length; j++) {
+            if (ConfigGetByte(address + j) != data[i + j]) {
+                changed = 1;
+            }
+            if (address + j < CONFIG_SETTING_CACHE_SIZE) {
+                CONFIG_SETTING_CACHE[address + j] = data[i + j] == 0xFF ? 0x00 : data[i + j];
+            }
+        }
+        if (changed == 1) {
+            EEPROMWritePage(address, (unsigned char *) &data[i], length);
+        }
+        address += length;
+        i += length;
     }
 }
 
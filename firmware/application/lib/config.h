@@ -71,11 +71,19 @@
 #define CONFIG_SETTING_SELF_PLAY_ADDRESS 0x63
 #define CONFIG_SETTING_LAST_CONNECTED_DEVICE_ADDRESS 0x64
 #define CONFIG_SETTING_LAST_CONNECTED_DEVICE_MAC_ADDRESS 0x65 // 0x65 - 0x6A
+#define CONFIG_SETTING_TELEMETRY_FAST_RATE_ADDRESS 0x6B
+#define CONFIG_SETTING_TELEMETRY_SLOW_RATE_ADDRESS 0x6C
 
 /* Values 0xA0 - 0xB0: Informational & Counters */
 #define CONFIG_INFO_BC127_BOOT_FAIL_COUNTER_MSB_ADDRESS 0xA0
 #define CONFIG_INFO_BC127_BOOT_FAIL_COUNTER_LSB_ADDRESS 0xA1
 
+/* EEPROM 0x00C0 - 0x00FF: Audio profiles, see audio_profile.h */
+/* EEPROM 0x0100 - 0x01FF: Paired device names, see bt_common.h */
+/* EEPROM 0x0200 - 0x03FF: Diagnostics cache, see diagnostics.h */
+/* EEPROM 0x0400 - 0x047F: CVC presets, see bt_bc127.h */
+/* EEPROM 0x0480 - 0x3FFF: Telemetry ring, see telemetry.h */
+
 #define CONFIG_DEVICE_LOG_BT 2
 #define CONFIG_DEVICE_LOG_IBUS 3
 #define CONFIG_DEVICE_LOG_SYSTEM 4
@@ -162,6 +170,8 @@
 #define CONFIG_SETTING_SELF_PLAY CONFIG_SETTING_SELF_PLAY_ADDRESS
 #define CONFIG_SETTING_LAST_CONNECTED_DEVICE CONFIG_SETTING_LAST_CONNECTED_DEVICE_ADDRESS
 #define CONFIG_SETTING_LAST_CONNECTED_DEVICE_MAC CONFIG_SETTING_LAST_CONNECTED_DEVICE_MAC_ADDRESS
+#define CONFIG_SETTING_TELEMETRY_FAST_RATE CONFIG_SETTING_TELEMETRY_FAST_RATE_ADDRESS
+#define CONFIG_SETTING_TELEMETRY_SLOW_RATE CONFIG_SETTING_TELEMETRY_SLOW_RATE_ADDRESS
 /* Values 0xA0 - 0xB0: Informational & Counters */
 #define CONFIG_INFO_BC127_BOOT_FAIL_COUNTER_MSB CONFIG_INFO_BC127_BOOT_FAIL_COUNTER_MSB_ADDRESS
 #define CONFIG_INFO_BC127_BOOT_FAIL_COUNTER_LSB CONFIG_INFO_BC127_BOOT_FAIL_COUNTER_LSB_ADDRESS
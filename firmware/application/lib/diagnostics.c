@@ -0,0 +1,559 @@
+/*
+ * File: diagnostics.c
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Queue diagnostic (DIA) requests to the vehicle modules, send them when
+ *     the bus is quiet and cache identity replies in the EEPROM so they
+ *     survive ignition cycles
+ */
+#include "diagnostics.h"
+static DiagnosticsContext_t Diagnostics;
+
+// The modules we run diagnostic jobs against
+static const uint8_t DiagnosticsModules[DIAGNOSTICS_MODULE_COUNT] = {
+    IBUS_DEVICE_GT,
+    IBUS_DEVICE_LCM,
+    IBUS_DEVICE_RAD,
+    IBUS_DEVICE_VM
+};
+
+static const char *DiagnosticsJobNames[DIAGNOSTICS_JOB_COUNT] = {
+    "Identity",
+    "OS Identity",
+    "IO Status"
+};
+
+/**
+ * DiagnosticsGetModuleIndex()
+ *     Description:
+ *         Find the index of a module in DiagnosticsModules
+ *     Params:
+ *         uint8_t module - The IBus device ID
+ *     Returns:
+ *         uint8_t - The index, or DIAGNOSTICS_MODULE_NONE
+ */
+static uint8_t DiagnosticsGetModuleIndex(uint8_t module)
+{
+    uint8_t idx;
+    for (idx = 0; idx < DIAGNOSTICS_MODULE_COUNT; idx++) {
+        if (DiagnosticsModules[idx] == module) {
+            return idx;
+        }
+    }
+    return DIAGNOSTICS_MODULE_NONE;
+}
+
+/**
+ * DiagnosticsGetSlotAddress()
+ *     Description:
+ *         Get the EEPROM address of a cache slot
+ *     Params:
+ *         uint8_t slot - The cache slot
+ *     Returns:
+ *         uint32_t - The address of the first byte of the slot
+ */
+static uint32_t DiagnosticsGetSlotAddress(uint8_t slot)
+{
+    return DIAGNOSTICS_EEPROM_START + ((uint32_t) slot * DIAGNOSTICS_SLOT_SIZE);
+}
+
+/**
+ * DiagnosticsCacheFind()
+ *     Description:
+ *         Find the cached reply for a module and job in the given vehicle
+ *     Params:
+ *         uint8_t module - The IBus device ID
+ *         uint8_t job - The job
+ *         uint8_t *vin - The vehicle identity, or 0 to match any vehicle
+ *     Returns:
+ *         uint8_t - The slot, or DIAGNOSTICS_SLOT_COUNT if not cached
+ */
+static uint8_t DiagnosticsCacheFind(uint8_t module, uint8_t job, uint8_t *vin)
+{
+    uint8_t slot;
+    for (slot = 0; slot < DIAGNOSTICS_SLOT_COUNT; slot++) {
+        DiagnosticsCacheSlot_t *entry = &Diagnostics.slots[slot];
+        if (entry->job == job &&
+            entry->module == module &&
+            (vin == 0 || memcmp(entry->vin, vin, DIAGNOSTICS_VIN_SIZE) == 0)
+        ) {
+            return slot;
+        }
+    }
+    return DIAGNOSTICS_SLOT_COUNT;
+}
+
+/**
+ * DiagnosticsCacheFree()
+ *     Description:
+ *         Drop the reply in a cache slot so the slot can be reused
+ *     Params:
+ *         uint8_t slot - The cache slot
+ *     Returns:
+ *         void
+ */
+static void DiagnosticsCacheFree(uint8_t slot)
+{
+    EEPROMWriteByte(DiagnosticsGetSlotAddress(slot), 0x00);
+    memset(&Diagnostics.slots[slot], 0, sizeof(DiagnosticsCacheSlot_t));
+    Diagnostics.slots[slot].job = DIAGNOSTICS_JOB_NONE;
+}
+
+/**
+ * DiagnosticsCacheStore()
+ *     Description:
+ *         Store a reply frame. A reply for the same module and job replaces
+ *         the old one, otherwise a free slot is used, otherwise the slots are
+ *         reused in turn. An identity reply with a new part number means the
+ *         module was replaced, so all of its other replies are dropped too.
+ *     Params:
+ *         uint8_t module - The IBus device ID
+ *         uint8_t job - The job
+ *         uint8_t *pkt - The reply frame
+ *     Returns:
+ *         void
+ */
+static void DiagnosticsCacheStore(uint8_t module, uint8_t job, uint8_t *pkt)
+{
+    uint8_t page[DIAGNOSTICS_SLOT_SIZE];
+    uint8_t cached[DIAGNOSTICS_SLOT_SIZE];
+    uint8_t length = pkt[IBUS_PKT_LEN] + 2;
+    uint8_t vin[DIAGNOSTICS_VIN_SIZE];
+    uint8_t slot;
+    if (length > DIAGNOSTICS_SLOT_SIZE - DIAGNOSTICS_SLOT_HEADER_SIZE) {
+        return;
+    }
+    ConfigGetVehicleIdentity(vin);
+    memset(page, 0xFF, DIAGNOSTICS_SLOT_SIZE);
+    page[0] = DIAGNOSTICS_SLOT_MAGIC;
+    page[1] = module;
+    page[2] = job;
+    memcpy(&page[3], vin, DIAGNOSTICS_VIN_SIZE);
+    page[8] = length;
+    memcpy(&page[DIAGNOSTICS_SLOT_HEADER_SIZE], pkt, length);
+    slot = DiagnosticsCacheFind(module, job, 0);
+    if (slot != DIAGNOSTICS_SLOT_COUNT) {
+        EEPROMReadBytes(DiagnosticsGetSlotAddress(slot), cached, DIAGNOSTICS_SLOT_SIZE);
+        if (memcmp(cached, page, DIAGNOSTICS_SLOT_SIZE) == 0) {
+            // The module is answering the same as last time, so spare the
+            // EEPROM the write
+            return;
+        }
+        uint8_t partNumberIdx = DIAGNOSTICS_SLOT_HEADER_SIZE + DIAGNOSTICS_PART_NUMBER_OFFSET;
+        if (job == DIAGNOSTICS_JOB_IDENTITY &&
+            memcmp(&cached[partNumberIdx], &page[partNumberIdx], DIAGNOSTICS_PART_NUMBER_SIZE) != 0
+        ) {
+            LogWarning("DIA: %02X was replaced, dropping its cached replies", module);
+            for (slot = 0; slot < DIAGNOSTICS_SLOT_COUNT; slot++) {
+                if (Diagnostics.slots[slot].module == module) {
+                    DiagnosticsCacheFree(slot);
+                }
+            }
+            slot = DiagnosticsCacheFind(module, job, 0);
+        }
+    }
+    if (slot == DIAGNOSTICS_SLOT_COUNT) {
+        slot = DiagnosticsCacheFind(0, DIAGNOSTICS_JOB_NONE, 0);
+    }
+    if (slot == DIAGNOSTICS_SLOT_COUNT) {
+        slot = Diagnostics.nextEvict;
+        Diagnostics.nextEvict = (Diagnostics.nextEvict + 1) % DIAGNOSTICS_SLOT_COUNT;
+    }
+    EEPROMWritePage(DiagnosticsGetSlotAddress(slot), page, DIAGNOSTICS_SLOT_SIZE);
+    Diagnostics.slots[slot].module = module;
+    Diagnostics.slots[slot].job = job;
+    memcpy(Diagnostics.slots[slot].vin, vin, DIAGNOSTICS_VIN_SIZE);
+}
+
+/**
+ * DiagnosticsCacheReplay()
+ *     Description:
+ *         Decode a cached reply as if it had just been read off the bus
+ *     Params:
+ *         uint8_t slot - The cache slot
+ *     Returns:
+ *         uint8_t - 1 if the reply was replayed, 0 if the slot was unreadable
+ */
+static uint8_t DiagnosticsCacheReplay(uint8_t slot)
+{
+    uint8_t pkt[IBUS_MAX_MSG_LENGTH];
+    uint32_t address = DiagnosticsGetSlotAddress(slot);
+    uint8_t length = EEPROMReadByte(address + 8);
+    if (length < IBUS_MIN_MSG_LENGTH || length > IBUS_MAX_MSG_LENGTH) {
+        DiagnosticsCacheFree(slot);
+        return 0;
+    }
+    memset(pkt, 0, IBUS_MAX_MSG_LENGTH);
+    EEPROMReadBytes(address + DIAGNOSTICS_SLOT_HEADER_SIZE, pkt, length);
+    Diagnostics.replaying = 1;
+    IBusDispatchMessage(Diagnostics.ibus, pkt);
+    Diagnostics.replaying = 0;
+    return 1;
+}
+
+/**
+ * DiagnosticsIsJobReply()
+ *     Description:
+ *         Check that a frame has the shape of a reply to the given job
+ *     Params:
+ *         uint8_t job - The job
+ *         uint8_t *pkt - The frame
+ *     Returns:
+ *         uint8_t - 1 if the frame answers the job, 0 otherwise
+ */
+static uint8_t DiagnosticsIsJobReply(uint8_t job, uint8_t *pkt)
+{
+    uint8_t length = pkt[IBUS_PKT_LEN];
+    if (pkt[IBUS_PKT_DST] != IBUS_DEVICE_DIA ||
+        pkt[IBUS_PKT_CMD] != IBUS_CMD_DIA_DIAG_RESPONSE
+    ) {
+        return 0;
+    }
+    switch (job) {
+        case DIAGNOSTICS_JOB_IDENTITY:
+            return length >= DIAGNOSTICS_IDENTITY_MIN_LEN;
+        case DIAGNOSTICS_JOB_OS_IDENTITY:
+            return length >= DIAGNOSTICS_OS_IDENTITY_MIN_LEN &&
+                length <= DIAGNOSTICS_OS_IDENTITY_MAX_LEN;
+        case DIAGNOSTICS_JOB_IO_STATUS:
+            return length >= DIAGNOSTICS_IO_STATUS_MIN_LEN;
+    }
+    return 0;
+}
+
+/**
+ * DiagnosticsSend()
+ *     Description:
+ *         Put a job on the bus
+ *     Params:
+ *         uint8_t module - The IBus device ID
+ *         uint8_t job - The job
+ *     Returns:
+ *         void
+ */
+static void DiagnosticsSend(uint8_t module, uint8_t job)
+{
+    switch (job) {
+        case DIAGNOSTICS_JOB_IDENTITY:
+            IBusCommandDIAGetIdentity(Diagnostics.ibus, module);
+            break;
+        case DIAGNOSTICS_JOB_OS_IDENTITY:
+            IBusCommandDIAGetOSIdentity(Diagnostics.ibus, module);
+            break;
+        case DIAGNOSTICS_JOB_IO_STATUS:
+            IBusCommandDIAGetIOStatus(Diagnostics.ibus, module);
+            break;
+    }
+    Diagnostics.inFlightModule = module;
+    Diagnostics.inFlightJob = job;
+    Diagnostics.inFlightTimestamp = TimerGetMillis();
+}
+
+/**
+ * DiagnosticsInit()
+ *     Description:
+ *         Load the cache slot headers and start the request queue
+ *     Params:
+ *         IBus_t *ibus - The IBus to send requests on
+ *     Returns:
+ *         void
+ */
+void DiagnosticsInit(IBus_t *ibus)
+{
+    uint8_t header[DIAGNOSTICS_SLOT_HEADER_SIZE];
+    uint8_t slot;
+    memset(&Diagnostics, 0, sizeof(DiagnosticsContext_t));
+    Diagnostics.ibus = ibus;
+    Diagnostics.activeModule = DIAGNOSTICS_MODULE_NONE;
+    Diagnostics.inFlightJob = DIAGNOSTICS_JOB_NONE;
+    for (slot = 0; slot < DIAGNOSTICS_SLOT_COUNT; slot++) {
+        DiagnosticsCacheSlot_t *entry = &Diagnostics.slots[slot];
+        EEPROMReadBytes(DiagnosticsGetSlotAddress(slot), header, DIAGNOSTICS_SLOT_HEADER_SIZE);
+        entry->job = DIAGNOSTICS_JOB_NONE;
+        if (header[0] == DIAGNOSTICS_SLOT_MAGIC &&
+            header[2] < DIAGNOSTICS_JOB_COUNT &&
+            DiagnosticsGetModuleIndex(header[1]) != DIAGNOSTICS_MODULE_NONE
+        ) {
+            entry->module = header[1];
+            entry->job = header[2];
+            memcpy(entry->vin, &header[3], DIAGNOSTICS_VIN_SIZE);
+        }
+    }
+    EventRegisterCallback(
+        IBUS_EVENT_IKEIgnitionStatus,
+        &DiagnosticsIBusIgnitionStatus,
+        &Diagnostics
+    );
+    EventRegisterCallback(
+        IBUS_EVENT_DIA_RESPONSE,
+        &DiagnosticsIBusResponse,
+        &Diagnostics
+    );
+    TimerRegisterScheduledTask(
+        &DiagnosticsTimerProcess,
+        &Diagnostics,
+        DIAGNOSTICS_TIMER_INT
+    );
+}
+
+/**
+ * DiagnosticsCacheClear()
+ *     Description:
+ *         Drop every cached reply
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+void DiagnosticsCacheClear()
+{
+    uint8_t slot;
+    for (slot = 0; slot < DIAGNOSTICS_SLOT_COUNT; slot++) {
+        if (Diagnostics.slots[slot].job != DIAGNOSTICS_JOB_NONE) {
+            DiagnosticsCacheFree(slot);
+        }
+    }
+}
+
+/**
+ * DiagnosticsCachePrint()
+ *     Description:
+ *         Print the cached replies. For the modules that report an ASCII part
+ *         number the part number is shown, otherwise the raw frame.
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+void DiagnosticsCachePrint()
+{
+    uint8_t pkt[IBUS_MAX_MSG_LENGTH];
+    uint8_t vin[DIAGNOSTICS_VIN_SIZE];
+    uint8_t slot;
+    uint8_t idx;
+    ConfigGetVehicleIdentity(vin);
+    for (slot = 0; slot < DIAGNOSTICS_SLOT_COUNT; slot++) {
+        DiagnosticsCacheSlot_t *entry = &Diagnostics.slots[slot];
+        if (entry->job == DIAGNOSTICS_JOB_NONE) {
+            continue;
+        }
+        uint32_t address = DiagnosticsGetSlotAddress(slot);
+        uint8_t length = EEPROMReadByte(address + 8);
+        if (length > IBUS_MAX_MSG_LENGTH) {
+            length = IBUS_MAX_MSG_LENGTH;
+        }
+        EEPROMReadBytes(address + DIAGNOSTICS_SLOT_HEADER_SIZE, pkt, length);
+        LogRaw(
+            "%02X %-11s VIN %c%c%02X%02X%X%s: ",
+            entry->module,
+            DiagnosticsJobNames[entry->job],
+            entry->vin[0],
+            entry->vin[1],
+            entry->vin[2],
+            entry->vin[3],
+            entry->vin[4],
+            memcmp(entry->vin, vin, DIAGNOSTICS_VIN_SIZE) == 0 ? "" : " (other vehicle)"
+        );
+        if (entry->module == IBUS_DEVICE_GT && entry->job == DIAGNOSTICS_JOB_IDENTITY) {
+            LogRaw("P/N %c%c%c%c%c%c%c", pkt[4], pkt[5], pkt[6], pkt[7], pkt[8], pkt[9], pkt[10]);
+        } else {
+            for (idx = 0; idx < length; idx++) {
+                LogRaw("%02X ", pkt[idx]);
+            }
+        }
+        LogRaw("\r\n");
+    }
+}
+
+/**
+ * DiagnosticsRequest()
+ *     Description:
+ *         Queue a job for a module. Queuing a job that is already pending
+ *         does nothing, so callers can ask as often as they like. Identity
+ *         jobs are answered from the cache when we have a reply for this
+ *         vehicle. The module is still asked for its identity once per
+ *         ignition cycle, in the background, so a swapped module replaces
+ *         the stale reply and its handlers see the new one.
+ *     Params:
+ *         uint8_t module - The IBus device ID
+ *         uint8_t job - The job
+ *     Returns:
+ *         uint8_t - 0 if queued, 1 if the module or job is unknown
+ */
+uint8_t DiagnosticsRequest(uint8_t module, uint8_t job)
+{
+    uint8_t idx = DiagnosticsGetModuleIndex(module);
+    if (idx == DIAGNOSTICS_MODULE_NONE || job >= DIAGNOSTICS_JOB_COUNT) {
+        LogError("DIA: Unknown job %d for %02X", job, module);
+        return 1;
+    }
+    Diagnostics.pending[idx] |= 1 << job;
+    return 0;
+}
+
+/**
+ * DiagnosticsRequestLive()
+ *     Description:
+ *         Queue a job and send it to the bus even if the reply is cached. The
+ *         fresh reply replaces the cached one.
+ *     Params:
+ *         uint8_t module - The IBus device ID
+ *         uint8_t job - The job
+ *     Returns:
+ *         uint8_t - 0 if queued, 1 if the module or job is unknown
+ */
+uint8_t DiagnosticsRequestLive(uint8_t module, uint8_t job)
+{
+    uint8_t idx = DiagnosticsGetModuleIndex(module);
+    if (DiagnosticsRequest(module, job) != 0) {
+        return 1;
+    }
+    Diagnostics.bypassCache[idx] |= 1 << job;
+    if (job == DIAGNOSTICS_JOB_IDENTITY) {
+        Diagnostics.verified |= 1 << idx;
+    }
+    return 0;
+}
+
+/**
+ * DiagnosticsIBusIgnitionStatus()
+ *     Description:
+ *         Ask the modules for their identity again in the next ignition
+ *         cycle, since they may be swapped while the car is off
+ *     Params:
+ *         void *ctx - The context provided at registration
+ *         uint8_t *ignitionStatus - The ignition status
+ *     Returns:
+ *         void
+ */
+void DiagnosticsIBusIgnitionStatus(void *ctx, uint8_t *ignitionStatus)
+{
+    DiagnosticsContext_t *context = (DiagnosticsContext_t *) ctx;
+    if (*ignitionStatus == IBUS_IGNITION_OFF) {
+        context->verified = 0;
+    }
+}
+
+/**
+ * DiagnosticsIBusResponse()
+ *     Description:
+ *         Match a reply to the job we are waiting on and cache it if the job
+ *         is cacheable. Frames from the module that do not answer the job,
+ *         such as acknowledgements, are ignored and we keep waiting.
+ *     Params:
+ *         void *ctx - The context provided at registration
+ *         uint8_t *pkt - The reply frame
+ *     Returns:
+ *         void
+ */
+void DiagnosticsIBusResponse(void *ctx, uint8_t *pkt)
+{
+    DiagnosticsContext_t *context = (DiagnosticsContext_t *) ctx;
+    if (context->replaying == 1 ||
+        context->inFlightJob == DIAGNOSTICS_JOB_NONE ||
+        pkt[IBUS_PKT_SRC] != context->inFlightModule ||
+        DiagnosticsIsJobReply(context->inFlightJob, pkt) == 0
+    ) {
+        return;
+    }
+    uint8_t job = context->inFlightJob;
+    context->inFlightJob = DIAGNOSTICS_JOB_NONE;
+    if ((DIAGNOSTICS_JOB_CACHED_MASK & (1 << job)) != 0) {
+        DiagnosticsCacheStore(pkt[IBUS_PKT_SRC], job, pkt);
+    }
+}
+
+/**
+ * DiagnosticsTimerProcess()
+ *     Description:
+ *         Work through the queue one job at a time. All pending jobs for a
+ *         module go out back to back before we move on to the next module.
+ *         Jobs that need the bus wait until nothing else is in flight, our
+ *         transmit buffer is empty and the bus has been quiet for
+ *         DIAGNOSTICS_BUS_IDLE_MS.
+ *     Params:
+ *         void *ctx - The context provided at registration
+ *     Returns:
+ *         void
+ */
+void DiagnosticsTimerProcess(void *ctx)
+{
+    DiagnosticsContext_t *context = (DiagnosticsContext_t *) ctx;
+    uint32_t now = TimerGetMillis();
+    uint8_t idx;
+    if (context->inFlightJob != DIAGNOSTICS_JOB_NONE) {
+        if (now - context->inFlightTimestamp < DIAGNOSTICS_RESPONSE_TIMEOUT) {
+            return;
+        }
+        LogDebug(
+            LOG_SOURCE_IBUS,
+            "DIA: No reply from %02X to %s",
+            context->inFlightModule,
+            DiagnosticsJobNames[context->inFlightJob]
+        );
+        context->inFlightJob = DIAGNOSTICS_JOB_NONE;
+    }
+    if (context->activeModule == DIAGNOSTICS_MODULE_NONE ||
+        context->pending[context->activeModule] == 0
+    ) {
+        uint8_t start = context->activeModule == DIAGNOSTICS_MODULE_NONE
+            ? 0
+            : context->activeModule + 1;
+        context->activeModule = DIAGNOSTICS_MODULE_NONE;
+        for (idx = 0; idx < DIAGNOSTICS_MODULE_COUNT; idx++) {
+            uint8_t candidate = (start + idx) % DIAGNOSTICS_MODULE_COUNT;
+            if (context->pending[candidate] != 0) {
+                context->activeModule = candidate;
+                break;
+            }
+        }
+        if (context->activeModule == DIAGNOSTICS_MODULE_NONE) {
+            return;
+        }
+    }
+    idx = context->activeModule;
+    uint8_t module = DiagnosticsModules[idx];
+    uint8_t job = 0;
+    while ((context->pending[idx] & (1 << job)) == 0) {
+        job++;
+    }
+    uint8_t jobBit = 1 << job;
+    if ((DIAGNOSTICS_JOB_CACHED_MASK & jobBit) != 0 &&
+        (context->bypassCache[idx] & jobBit) == 0
+    ) {
+        uint8_t vin[DIAGNOSTICS_VIN_SIZE];
+        ConfigGetVehicleIdentity(vin);
+        uint8_t slot = DiagnosticsCacheFind(module, job, vin);
+        if (slot != DIAGNOSTICS_SLOT_COUNT) {
+            context->pending[idx] &= ~jobBit;
+            if (DiagnosticsCacheReplay(slot) == 1) {
+                LogDebug(
+                    LOG_SOURCE_IBUS,
+                    "DIA: %s of %02X served from cache",
+                    DiagnosticsJobNames[job],
+                    module
+                );
+                if (job == DIAGNOSTICS_JOB_IDENTITY &&
+                    (context->verified & (1 << idx)) == 0
+                ) {
+                    // Check the module is the one we cached once per
+                    // ignition, the reply replaces the cached one if not
+                    context->verified |= 1 << idx;
+                    context->pending[idx] |= jobBit;
+                    context->bypassCache[idx] |= jobBit;
+                }
+                return;
+            }
+            // The slot was unreadable, so ask the module
+            context->pending[idx] |= jobBit;
+        }
+    }
+    if (now - context->ibus->rxLastStamp < DIAGNOSTICS_BUS_IDLE_MS ||
+        context->ibus->txBufferWriteIdx != context->ibus->txBufferReadIdx
+    ) {
+        return;
+    }
+    context->pending[idx] &= ~jobBit;
+    context->bypassCache[idx] &= ~jobBit;
+    DiagnosticsSend(module, job);
+}
@@ -0,0 +1,118 @@
+/*
+ * File: diagnostics.h
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Queue diagnostic (DIA) requests to the vehicle modules, send them when
+ *     the bus is quiet and cache identity replies in the EEPROM so they
+ *     survive ignition cycles
+ */
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+#include <stdint.h>
+#include <string.h>
+#include "config.h"
+#include "eeprom.h"
+#include "event.h"
+#include "ibus.h"
+#include "log.h"
+#include "timer.h"
+#define DIAGNOSTICS_EEPROM_START 0x0200
+#define DIAGNOSTICS_SLOT_SIZE EEPROM_PAGE_SIZE
+#define DIAGNOSTICS_SLOT_COUNT 8
+/*
+ * Slot layout:
+ *     0     - DIAGNOSTICS_SLOT_MAGIC
+ *     1     - Module
+ *     2     - Job
+ *     3 - 7 - Vehicle identity (VIN) the reply was cached under
+ *     8     - Frame length
+ *     9 ... - The reply frame as read off the bus
+ */
+#define DIAGNOSTICS_SLOT_MAGIC 0xD1
+#define DIAGNOSTICS_SLOT_HEADER_SIZE 9
+#define DIAGNOSTICS_VIN_SIZE 5
+// The identity reply bytes that tell one module from another: the ASCII part
+// number of the GT, the part number and hardware, coding and diagnostic
+// indices of the others
+#define DIAGNOSTICS_PART_NUMBER_OFFSET 4
+#define DIAGNOSTICS_PART_NUMBER_SIZE 7
+#define DIAGNOSTICS_JOB_IDENTITY 0
+#define DIAGNOSTICS_JOB_OS_IDENTITY 1
+#define DIAGNOSTICS_JOB_IO_STATUS 2
+#define DIAGNOSTICS_JOB_COUNT 3
+// Identity replies only change when a module is replaced, IO status is live
+#define DIAGNOSTICS_JOB_CACHED_MASK ((1 << DIAGNOSTICS_JOB_IDENTITY) | (1 << DIAGNOSTICS_JOB_OS_IDENTITY))
+#define DIAGNOSTICS_JOB_NONE 0xFF
+// The shortest reply that answers each job. Anything shorter, such as the
+// 0x03 length acknowledgement of the LCM, is not a reply to the job.
+#define DIAGNOSTICS_IDENTITY_MIN_LEN (DIAGNOSTICS_PART_NUMBER_OFFSET + DIAGNOSTICS_PART_NUMBER_SIZE - 1)
+#define DIAGNOSTICS_OS_IDENTITY_MIN_LEN 0x0C
+#define DIAGNOSTICS_OS_IDENTITY_MAX_LEN 0x21
+#define DIAGNOSTICS_IO_STATUS_MIN_LEN 0x04
+#define DIAGNOSTICS_MODULE_COUNT 4
+#define DIAGNOSTICS_MODULE_NONE 0xFF
+// Only send when nothing has been received for this long
+#define DIAGNOSTICS_BUS_IDLE_MS 20
+#define DIAGNOSTICS_RESPONSE_TIMEOUT 1000
+#define DIAGNOSTICS_TIMER_INT 25
+
+/**
+ * DiagnosticsCacheSlot_t
+ *     Description:
+ *         The RAM copy of a cache slot header, so lookups do not read the
+ *         EEPROM
+ *     Fields:
+ *         module - The module the reply came from
+ *         job - The job the reply answered, DIAGNOSTICS_JOB_NONE if the slot
+ *             is free
+ *         vin - The vehicle identity it was cached under
+ */
+typedef struct DiagnosticsCacheSlot_t {
+    uint8_t module;
+    uint8_t job;
+    uint8_t vin[DIAGNOSTICS_VIN_SIZE];
+} DiagnosticsCacheSlot_t;
+
+/**
+ * DiagnosticsContext_t
+ *     Description:
+ *         The diagnostics service state
+ *     Fields:
+ *         ibus - The IBus to send requests on
+ *         pending - Per module, bit n is set if job n is queued
+ *         activeModule - The module being worked through, so all of its jobs
+ *             go out back to back
+ *         inFlightModule - The module we are waiting on a reply from
+ *         inFlightJob - The job we are waiting on a reply for
+ *         inFlightTimestamp - When the request went out
+ *         bypassCache - Per module, set to send the next identity job to the
+ *             bus even if we have it cached
+ *         replaying - Set while a cached reply is being decoded
+ *         verified - Bit n is set once module n has been asked for its
+ *             identity this ignition cycle
+ *         slots - The cache slot headers
+ *         nextEvict - The slot to reuse when all of them are taken
+ */
+typedef struct DiagnosticsContext_t {
+    IBus_t *ibus;
+    uint8_t pending[DIAGNOSTICS_MODULE_COUNT];
+    uint8_t activeModule;
+    uint8_t inFlightModule;
+    uint8_t inFlightJob;
+    uint32_t inFlightTimestamp;
+    uint8_t bypassCache[DIAGNOSTICS_MODULE_COUNT];
+    uint8_t replaying;
+    uint8_t verified;
+    DiagnosticsCacheSlot_t slots[DIAGNOSTICS_SLOT_COUNT];
+    uint8_t nextEvict;
+} DiagnosticsContext_t;
+
+void DiagnosticsInit(IBus_t *);
+void DiagnosticsCacheClear();
+void DiagnosticsCachePrint();
+uint8_t DiagnosticsRequest(uint8_t, uint8_t);
+uint8_t DiagnosticsRequestLive(uint8_t, uint8_t);
+void DiagnosticsIBusIgnitionStatus(void *, uint8_t *);
+void DiagnosticsIBusResponse(void *, uint8_t *);
+void DiagnosticsTimerProcess(void *);
+#endif /* DIAGNOSTICS_H */
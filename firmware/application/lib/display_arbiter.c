@@ -0,0 +1,191 @@
+/*
+ * File: display_arbiter.c
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Decide when to take a display back after the radio writes to it. The
+ *     radio's write cadence is tracked so we only redraw once our text would
+ *     stay up, and we back off from a radio that keeps overwriting us.
+ */
+#include "display_arbiter.h"
+static DisplayArbiter_t DisplayArbiters[DISPLAY_ARBITER_COUNT];
+
+static const char *DisplayArbiterNames[DISPLAY_ARBITER_COUNT] = {
+    "CD53",
+    "MID"
+};
+
+/**
+ * DisplayArbiterGetSettleTime()
+ *     Description:
+ *         Get how long the radio has to be quiet before our text would stay
+ *         up. A radio that writes in a steady rhythm has to miss a beat.
+ *     Params:
+ *         DisplayArbiter_t *arbiter - The arbiter
+ *     Returns:
+ *         uint16_t - The quiet time in milliseconds
+ */
+static uint16_t DisplayArbiterGetSettleTime(DisplayArbiter_t *arbiter)
+{
+    uint16_t settle = arbiter->cadence + (arbiter->cadence / 2);
+    if (settle < DISPLAY_ARBITER_SETTLE_MIN) {
+        return DISPLAY_ARBITER_SETTLE_MIN;
+    }
+    if (settle > DISPLAY_ARBITER_SETTLE_MAX) {
+        return DISPLAY_ARBITER_SETTLE_MAX;
+    }
+    return settle;
+}
+
+/**
+ * DisplayArbiterHasRadio()
+ *     Description:
+ *         Check if the radio holds a display. It does from its first write
+ *         until the display is handed back with UIEvent_DisplayClaim, and
+ *         the UI should not write the display in between, or the write
+ *         lands in the middle of the radio's burst.
+ *     Params:
+ *         uint8_t display - The DISPLAY_ARBITER_*
+ *     Returns:
+ *         uint8_t - 1 if the radio holds the display, 0 otherwise
+ */
+uint8_t DisplayArbiterHasRadio(uint8_t display)
+{
+    return DisplayArbiters[display].pending;
+}
+
+/**
+ * DisplayArbiterInit()
+ *     Description:
+ *         Reset the arbiters and start the claim timer
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void DisplayArbiterInit()
+{
+    uint8_t display;
+    memset(DisplayArbiters, 0, sizeof(DisplayArbiters));
+    for (display = 0; display < DISPLAY_ARBITER_COUNT; display++) {
+        DisplayArbiters[display].backoff = DISPLAY_ARBITER_BACKOFF_MIN;
+    }
+    TimerRegisterScheduledTask(
+        &DisplayArbiterTimerClaim,
+        0,
+        DISPLAY_ARBITER_TICK_INT
+    );
+}
+
+/**
+ * DisplayArbiterPrint()
+ *     Description:
+ *         Log the radio writes, redraws and back offs of each display
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void DisplayArbiterPrint()
+{
+    uint8_t display;
+    uint32_t now = TimerGetMillis();
+    for (display = 0; display < DISPLAY_ARBITER_COUNT; display++) {
+        DisplayArbiter_t *arbiter = &DisplayArbiters[display];
+        LogRaw(
+            "%s: Radio Writes: %u Redraws: %u Back Offs: %u Cadence: %ums%s\r\n",
+            DisplayArbiterNames[display],
+            arbiter->radioWrites,
+            arbiter->claims,
+            arbiter->backoffs,
+            arbiter->cadence,
+            now < arbiter->backoffUntil ? " (Backing Off)" : ""
+        );
+    }
+}
+
+/**
+ * DisplayArbiterRadioWrite()
+ *     Description:
+ *         Record the radio writing a display and owe it a redraw. If the
+ *         radio overwrote our last redraw right away, count it as lost and
+ *         back off once too many are lost in a row.
+ *     Params:
+ *         uint8_t display - The DISPLAY_ARBITER_*
+ *     Returns:
+ *         void
+ */
+void DisplayArbiterRadioWrite(uint8_t display)
+{
+    DisplayArbiter_t *arbiter = &DisplayArbiters[display];
+    uint32_t now = TimerGetMillis();
+    uint32_t gap = now - arbiter->lastRadioWrite;
+    if (arbiter->radioWrites == 0 || gap > DISPLAY_ARBITER_BURST_GAP) {
+        arbiter->cadence = 0;
+    } else if (arbiter->cadence == 0) {
+        arbiter->cadence = gap;
+    } else {
+        arbiter->cadence = ((arbiter->cadence * 3) + gap) / 4;
+    }
+    arbiter->lastRadioWrite = now;
+    arbiter->radioWrites++;
+    if (arbiter->lastClaim != 0 &&
+        arbiter->pending == 0 &&
+        now - arbiter->lastClaim < DISPLAY_ARBITER_PERSIST_TIME
+    ) {
+        arbiter->losses++;
+        if (arbiter->losses >= DISPLAY_ARBITER_MAX_LOSSES) {
+            arbiter->backoffUntil = now + arbiter->backoff;
+            arbiter->backoffs++;
+            arbiter->losses = 0;
+            LogDebug(
+                LOG_SOURCE_UI,
+                "Display: %s backing off for %lums",
+                DisplayArbiterNames[display],
+                arbiter->backoff
+            );
+            if (arbiter->backoff < DISPLAY_ARBITER_BACKOFF_MAX) {
+                arbiter->backoff *= 2;
+            }
+        }
+    }
+    arbiter->pending = 1;
+}
+
+/**
+ * DisplayArbiterTimerClaim()
+ *     Description:
+ *         Fire UIEvent_DisplayClaim for each display that is owed a redraw
+ *         once the radio has gone quiet, and forgive the losses of redraws
+ *         that stayed up
+ *     Params:
+ *         void *ctx - Unused
+ *     Returns:
+ *         void
+ */
+void DisplayArbiterTimerClaim(void *ctx)
+{
+    uint8_t display;
+    uint32_t now = TimerGetMillis();
+    for (display = 0; display < DISPLAY_ARBITER_COUNT; display++) {
+        DisplayArbiter_t *arbiter = &DisplayArbiters[display];
+        if (arbiter->pending == 0) {
+            if (arbiter->lastClaim != 0 &&
+                (arbiter->losses != 0 || arbiter->backoff != DISPLAY_ARBITER_BACKOFF_MIN) &&
+                now - arbiter->lastClaim >= DISPLAY_ARBITER_PERSIST_TIME
+            ) {
+                arbiter->losses = 0;
+                arbiter->backoff = DISPLAY_ARBITER_BACKOFF_MIN;
+            }
+            continue;
+        }
+        if (now < arbiter->backoffUntil ||
+            now - arbiter->lastRadioWrite < DisplayArbiterGetSettleTime(arbiter)
+        ) {
+            continue;
+        }
+        arbiter->pending = 0;
+        arbiter->lastClaim = now;
+        arbiter->claims++;
+        EventTriggerCallback(UIEvent_DisplayClaim, &display);
+    }
+}
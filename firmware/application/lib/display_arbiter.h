@@ -0,0 +1,67 @@
+/*
+ * File: display_arbiter.h
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Decide when to take a display back after the radio writes to it. The
+ *     radio's write cadence is tracked so we only redraw once our text would
+ *     stay up, and we back off from a radio that keeps overwriting us.
+ */
+#ifndef DISPLAY_ARBITER_H
+#define DISPLAY_ARBITER_H
+#include <stdint.h>
+#include <string.h>
+#include "../mappings.h"
+#include "event.h"
+#include "log.h"
+#include "timer.h"
+#define DISPLAY_ARBITER_CD53 0
+#define DISPLAY_ARBITER_MID 1
+#define DISPLAY_ARBITER_COUNT 2
+#define DISPLAY_ARBITER_TICK_INT 50
+// Radio writes further apart than this are not part of the same burst
+#define DISPLAY_ARBITER_BURST_GAP 2000
+// How long the radio has to be quiet before we redraw
+#define DISPLAY_ARBITER_SETTLE_MIN 100
+#define DISPLAY_ARBITER_SETTLE_MAX 1500
+// A redraw the radio overwrites sooner than this was wasted
+#define DISPLAY_ARBITER_PERSIST_TIME 1000
+#define DISPLAY_ARBITER_MAX_LOSSES 3
+#define DISPLAY_ARBITER_BACKOFF_MIN 5000
+#define DISPLAY_ARBITER_BACKOFF_MAX 60000
+
+/**
+ * DisplayArbiter_t
+ *     Description:
+ *         The arbitration state of a display shared with the radio
+ *     Fields:
+ *         pending - Set while a redraw is owed
+ *         losses - Redraws in a row that the radio overwrote right away
+ *         cadence - The average gap between radio writes in the current
+ *             burst, 0 if unknown
+ *         lastRadioWrite - When the radio last wrote the display
+ *         lastClaim - When we last redrew the display, 0 if never
+ *         backoffUntil - No redraws before this time
+ *         backoff - The length of the next back off
+ *         radioWrites - The radio writes seen since boot
+ *         claims - The redraws made since boot
+ *         backoffs - The times we backed off since boot
+ */
+typedef struct DisplayArbiter_t {
+    uint8_t pending;
+    uint8_t losses;
+    uint16_t cadence;
+    uint32_t lastRadioWrite;
+    uint32_t lastClaim;
+    uint32_t backoffUntil;
+    uint32_t backoff;
+    uint16_t radioWrites;
+    uint16_t claims;
+    uint16_t backoffs;
+} DisplayArbiter_t;
+
+uint8_t DisplayArbiterHasRadio(uint8_t);
+void DisplayArbiterInit();
+void DisplayArbiterPrint();
+void DisplayArbiterRadioWrite(uint8_t);
+void DisplayArbiterTimerClaim(void *);
+#endif /* DISPLAY_ARBITER_H */
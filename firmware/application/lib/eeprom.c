@@ -64,6 +64,26 @@ static unsigned char EEPROMSend(char data)
     return SPI1BUFL;
 }
 
+/**
+ * EEPROMSendAddress()
+ *     Description:
+ *         Send the address that a read or write sequence starts at
+ *     Params:
+ *         uint32_t address - The memory address
+ *     Returns:
+ *         void
+ */
+static void EEPROMSendAddress(uint32_t address)
+{
+    // The HW1 boards use a 1024kB EEPROM while the HW2 boards use a
+    // 128kB EEPROM. This means that we need not send as many address bytes
+    if (UtilsGetBoardVersion() == BOARD_VERSION_ONE) {
+        EEPROMSend(address >> 16 & 0xFF);
+    }
+    EEPROMSend(address >> 8 & 0xFF);
+    EEPROMSend(address & 0xFF);
+}
+
 /**
  * EEPROMEnableWrite()
  *     Description:
@@ -134,13 +154,7 @@ unsigned char EEPROMReadByte(uint32_t address)
     EEPROMIsReady();
     EEPROM_CS_PIN = 0;
     EEPROMSend(EEPROM_COMMAND_READ);
-    // The HW1 boards use a 1024kB EEPROM while the HW2 boards use a
-    // 128kB EEPROM. This means that we need not send as many address bytes
-    if (UtilsGetBoardVersion() == BOARD_VERSION_ONE) {
-        EEPROMSend(address >> 16 & 0xFF);
-    }
-    EEPROMSend(address >> 8 & 0xFF);
-    EEPROMSend(address & 0xFF);
+    EEPROMSendAddress(address);
     // Cast return of EEPROM send to an 8-bit byte, since the returned register
     // is always 16 bits
     unsigned char data = (unsigned char)((uint8_t )EEPROMSend(EEPROM_COMMAND_GET));
@@ -164,13 +178,62 @@ void EEPROMWriteByte(uint32_t address, unsigned char data)
     EEPROMEnableWrite();
     EEPROM_CS_PIN = 0;
     EEPROMSend(EEPROM_COMMAND_WRITE);
-    // The HW1 boards use a 1024kB EEPROM while the HW2 boards use a
-    // 128kB EEPROM. This means that we need not send as many address bytes
-    if (UtilsGetBoardVersion() == BOARD_VERSION_ONE) {
-        EEPROMSend(address >> 16 & 0xFF);
-    }
-    EEPROMSend(address >> 8 & 0xFF);
-    EEPROMSend(address & 0xFF);
+    EEPROMSendAddress(address);
     EEPROMSend(data);
     EEPROM_CS_PIN = 1;
 }
+
+/**
+ * EEPROMReadBytes()
+ *     Description:
+ *         Read a run of bytes in a single read sequence. The EEPROM moves on
+ *         to the next address by itself, so this costs one command and
+ *         address instead of one per byte.
+ *     Params:
+ *         uint32_t address - The memory address of the first byte
+ *         unsigned char *data - The buffer to read into
+ *         uint16_t length - The number of bytes to read
+ *     Returns:
+ *         void
+ */
+void EEPROMReadBytes(uint32_t address, unsigned char *data, uint16_t length)
+{
+    uint16_t idx;
+    EEPROMIsReady();
+    EEPROM_CS_PIN = 0;
+    EEPROMSend(EEPROM_COMMAND_READ);
+    EEPROMSendAddress(address);
+    for (idx = 0; idx < length; idx++) {
+        data[idx] = (unsigned char)((uint8_t) EEPROMSend(EEPROM_COMMAND_GET));
+    }
+    EEPROM_CS_PIN = 1;
+}
+
+/**
+ * EEPROMWritePage()
+ *     Description:
+ *         Write up to EEPROM_PAGE_SIZE bytes in a single write cycle. The
+ *         address counter wraps within the page, so the run must not cross
+ *         an EEPROM_PAGE_SIZE boundary.
+ *     Params:
+ *         uint32_t address - The memory address of the first byte
+ *         unsigned char *data - The bytes to write
+ *         uint8_t length - The number of bytes to write
+ *     Returns:
+ *         void
+ */
+void EEPROMWritePage(uint32_t address, unsigned char *data, uint8_t length)
+{
+    uint8_t idx;
+    if (length > EEPROM_PAGE_SIZE) {
+        length = EEPROM_PAGE_SIZE;
+    }
+    EEPROMEnableWrite();
+    EEPROM_CS_PIN = 0;
+    EEPROMSend(EEPROM_COMMAND_WRITE);
+    EEPROMSendAddress(address);
+    for (idx = 0; idx < length; idx++) {
+        EEPROMSend(data[idx]);
+    }
+    EEPROM_CS_PIN = 1;
+}
@@ -22,10 +22,15 @@
 #define EEPROM_COMMAND_RDSR 0x05 // Read the status register
 #define EEPROM_COMMAND_GET 0x00 // Dummy byte used to retrieve data
 #define EEPROM_STATUS_BUSY 0x01 // EEPROM Busy status response
+// The page size of the smaller (HW2) part. The HW1 part has larger pages
+// that are a multiple of this, so page writes work on both.
+#define EEPROM_PAGE_SIZE 64
 
 void EEPROMInit();
 void EEPROMErase();
 void EEPROMIsReady();
 unsigned char EEPROMReadByte(uint32_t);
 void EEPROMWriteByte(uint32_t, unsigned char);
+void EEPROMReadBytes(uint32_t, unsigned char *, uint16_t);
+void EEPROMWritePage(uint32_t, unsigned char *, uint8_t);
 #endif /* EEPROM_H */
@@ -13,22 +13,37 @@ uint8_t EVENT_CALLBACKS_COUNT = 0;
  *     Description:
  *         Adds a callback of event type to the event queue. Any triggers of
  *         this event type will result in the execution of the function,
- *         with the given context being passed through.
+ *         with the given context being passed through. Slots freed by
+ *         unregistering are reused before the queue grows.
  *     Params:
  *         uint8_t eventType
  *         void *callback - Pointer to the function to call when triggered
  *         void *context - The object to pass to the function. This needs to be
  *         cast to the appropriate type on the functions end.
  *     Returns:
- *         void
+ *         uint8_t - The index of the callback in the queue or
+ *             EVENT_CALLBACK_INVALID if the queue is full
  */
-void EventRegisterCallback(uint8_t eventType, void *callback, void *context)
+uint8_t EventRegisterCallback(uint8_t eventType, void *callback, void *context)
 {
-    Event_t cb;
-    cb.type = eventType;
-    cb.callback = callback;
-    cb.context = context;
-    EVENT_CALLBACKS[EVENT_CALLBACKS_COUNT++] = cb;
+    uint8_t idx;
+    for (idx = 0; idx < EVENT_CALLBACKS_COUNT; idx++) {
+        if (EVENT_CALLBACKS[idx].callback == 0) {
+            break;
+        }
+    }
+    if (idx == EVENT_MAX_CALLBACKS) {
+        LogError("FAILED TO REGISTER EVENT %d -- Allocations Full", eventType);
+        return EVENT_CALLBACK_INVALID;
+    }
+    volatile Event_t *cb = &EVENT_CALLBACKS[idx];
+    cb->type = eventType;
+    cb->context = context;
+    cb->callback = callback;
+    if (idx == EVENT_CALLBACKS_COUNT) {
+        EVENT_CALLBACKS_COUNT++;
+    }
+    return idx;
 }
 
 /**
@@ -49,13 +64,37 @@ uint8_t EventUnregisterCallback(uint8_t eventType, void *callback)
         if (cb->type == eventType &&
             cb->callback == callback
         ) {
-            memset((void *) cb, 0, sizeof(Event_t));
+            EventUnregisterCallbackById(idx);
             return 0;
         }
     }
     return 1;
 }
 
+/**
+ * EventUnregisterCallbackById()
+ *     Description:
+ *         Unregister a callback using the index EventRegisterCallback()
+ *         returned for it
+ *     Params:
+ *         uint8_t callbackId - The index of the callback in the queue
+ *     Returns:
+ *         void
+ */
+void EventUnregisterCallbackById(uint8_t callbackId)
+{
+    if (callbackId >= EVENT_CALLBACKS_COUNT) {
+        return;
+    }
+    memset((void *) &EVENT_CALLBACKS[callbackId], 0, sizeof(Event_t));
+    // Shrink the queue so triggers stop walking the free tail
+    while (EVENT_CALLBACKS_COUNT > 0 &&
+        EVENT_CALLBACKS[EVENT_CALLBACKS_COUNT - 1].callback == 0
+    ) {
+        EVENT_CALLBACKS_COUNT--;
+    }
+}
+
 /**
  * EventTriggerCallback()
  *     Description:
@@ -69,9 +108,11 @@ uint8_t EventUnregisterCallback(uint8_t eventType, void *callback)
 void EventTriggerCallback(uint8_t eventType, unsigned char *data)
 {
     uint8_t idx;
+    TracePoint(TRACE_POINT_EVENT, eventType);
     for (idx = 0; idx < EVENT_CALLBACKS_COUNT; idx++) {
         volatile Event_t *cb = &EVENT_CALLBACKS[idx];
-        if (cb->type == eventType) {
+        // Free slots are zeroed, so they match event type 0
+        if (cb->type == eventType && cb->callback != 0) {
             cb->callback(cb->context, data);
         }
     }
@@ -7,14 +7,18 @@
 #ifndef EVENT_H
 #define EVENT_H
 #define EVENT_MAX_CALLBACKS 192
+#define EVENT_CALLBACK_INVALID 0xFF
 #include <stdint.h>
 #include <string.h>
+#include "log.h"
+#include "trace.h"
 typedef struct Event_t {
     uint8_t type;
     void *context;
     void (*callback) (void *, unsigned char *);
 } Event_t;
-void EventRegisterCallback(uint8_t, void *, void *);
+uint8_t EventRegisterCallback(uint8_t, void *, void *);
 uint8_t EventUnregisterCallback(uint8_t, void *);
+void EventUnregisterCallbackById(uint8_t);
 void EventTriggerCallback(uint8_t, unsigned char *);
 #endif /* EVENT_H */
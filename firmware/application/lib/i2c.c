@@ -6,17 +6,18 @@
  */
 #include "i2c.h"
 static uint8_t I2CStatus;
+static I2CRecovery_t I2CRecovery;
 
 /**
- * I2CInit()
+ * I2CEnable()
  *     Description:
- *         Initialize the I2C connection
+ *         Configure the I2C3 module from scratch and enable it
  *     Params:
- *      void
+ *         void
  *     Returns:
  *         void
  */
-void I2CInit()
+static void I2CEnable()
 {
     I2C3_SDA_MODE = 1;
     I2C3_SCL_MODE = 1;
@@ -29,6 +30,78 @@ void I2CInit()
     I2C3CONLbits.DISSLW = 0;
     SetI2CMAEV(2, 0);
     I2C3CONLbits.I2CEN = 1;
+}
+
+/**
+ * I2CCountError()
+ *     Description:
+ *         Count a failure against its error class
+ *     Params:
+ *         int16_t error - The I2C_ERR_* that caused the failure
+ *     Returns:
+ *         void
+ */
+static void I2CCountError(int16_t error)
+{
+    uint8_t errorClass;
+    switch (error) {
+        case I2C_ERR_NAK:
+            errorClass = I2C_ERROR_CLASS_NAK;
+            break;
+        case I2C_ERR_BCL:
+        case I2C_ERR_IWCOL:
+        case I2C_ERR_TBF:
+            errorClass = I2C_ERROR_CLASS_COLLISION;
+            break;
+        case I2C_ERR_SCLLow:
+        case I2C_ERR_TimeoutHW:
+        case I2C_ERR_RcvTimeout:
+            errorClass = I2C_ERROR_CLASS_TIMEOUT;
+            break;
+        case I2C_ERR_Overflow:
+            errorClass = I2C_ERROR_CLASS_OVERFLOW;
+            break;
+        default:
+            errorClass = I2C_ERROR_CLASS_OTHER;
+            break;
+    }
+    if (I2CRecovery.errors[errorClass] < 0xFFFF) {
+        I2CRecovery.errors[errorClass]++;
+    }
+}
+
+/**
+ * I2CAbort()
+ *     Description:
+ *         Close a failed transaction and flag the bus for recovery
+ *     Params:
+ *         int16_t error - The I2C_ERR_* that caused the failure
+ *         int8_t status - The status to hand back to the caller
+ *     Returns:
+ *         int8_t - status
+ */
+static int8_t I2CAbort(int16_t error, int8_t status)
+{
+    I2CStop();
+    I2CStatus = I2C_STATUS_ERR;
+    I2CCountError(error);
+    return status;
+}
+
+/**
+ * I2CInit()
+ *     Description:
+ *         Initialize the I2C connection
+ *     Params:
+ *      void
+ *     Returns:
+ *         void
+ */
+void I2CInit()
+{
+    memset(&I2CRecovery, 0, sizeof(I2CRecovery_t));
+    I2CRecovery.backoff = I2C_RECOVERY_BACKOFF_MIN;
+    I2CEnable();
     // Set the ERR flag so we reset the bus state
     I2CStatus = I2C_STATUS_ERR;
 }
@@ -53,12 +126,17 @@ static uint16_t I2CReadByte(unsigned char ackFlag)
     }
     // Start receive
     I2C3CONLbits.RCEN = 1;
+    uint16_t cycles = 0;
     while (!I2C3STATbits.RBF) {
-
+        if (cycles > I2C_SCL_TIMEOUT) {
+            // The slave is holding SCL or never clocked the byte out
+            return I2C_ERR_RcvTimeout;
+        }
+        cycles++;
     }
     // Set ACK enabled so the slave knows it can send the data
     I2C3CONLbits.ACKEN = 1;
-    uint16_t cycles = 0;
+    cycles = 0;
     while (I2C3CONLbits.ACKEN) {
         if (cycles > I2C_SCL_TIMEOUT) {
             // SCL is stuck low and RCEN cannot be cleared, so we need to reset
@@ -112,7 +190,8 @@ static int8_t I2CWriteByte(unsigned char data)
 /**
  * I2CClearErrors()
  *     Description:
- *         Clear the receive enable, the Bus and Write collision flags
+ *         Clear the receive enable, the Bus and Write collision flags and the
+ *         receive overflow flag
  *     Params:
  *         void
  *     Returns:
@@ -123,6 +202,7 @@ void I2CClearErrors()
     I2C3CONLbits.RCEN = 0;
     I2C3STATbits.IWCOL = 0;
     I2C3STATbits.BCL = 0;
+    I2C3STATbits.I2COV = 0;
 }
 
 /**
@@ -139,15 +219,11 @@ int8_t I2CPoll(unsigned char deviceAddress)
 {
     int8_t retval;
     unsigned char slaveAddress = (deviceAddress << 1) | 0;
-    if (I2CStatus == I2C_STATUS_ERR) {
-        I2CClearErrors();
-        if (I2CRecoverBus() == I2C_STATUS_OK) {
-            I2CStatus = I2C_STATUS_OK;
-        } else {
-            return I2C_ERR_Hardware;
-        }
+    if (I2CRecover() != I2C_STATUS_OK) {
+        return I2C_ERR_Hardware;
     }
-    if (I2CStart() == I2C_STATUS_OK) {
+    retval = I2CStart();
+    if (retval == I2C_STATUS_OK) {
         retval = I2CWriteByte((char)slaveAddress);
         if (I2CStop() == I2C_STATUS_OK) {
             if (retval == I2C_ACK) {
@@ -159,87 +235,231 @@ int8_t I2CPoll(unsigned char deviceAddress)
     }
     // Set the error flag again since something bad happened
     I2CStatus = I2C_STATUS_ERR;
+    I2CCountError(retval);
     return I2C_ERR_CommFail;
 }
 
 /**
- * I2CRead()
+ * I2CPrintStatus()
  *     Description:
- *         Perform an I2C read request for a specific device and read it into a
- *         byte
+ *         Log the bus state along with the error and recovery counters
  *     Params:
- *         unsigned char deviceAdress - The device address to poll
- *         unsigned char registerAddress - The register to read
- *         unsigned char *buffer - The byte to store the read data to
+ *         void
+ *     Returns:
+ *         void
+ */
+void I2CPrintStatus()
+{
+    LogRaw(
+        "I2C: %s Backoff: %ums\r\n",
+        I2CStatus == I2C_STATUS_OK ? "OK" : "Needs Recovery",
+        I2CRecovery.backoff
+    );
+    LogRaw(
+        "    NAK: %u Collision: %u Timeout: %u Overflow: %u Other: %u\r\n",
+        I2CRecovery.errors[I2C_ERROR_CLASS_NAK],
+        I2CRecovery.errors[I2C_ERROR_CLASS_COLLISION],
+        I2CRecovery.errors[I2C_ERROR_CLASS_TIMEOUT],
+        I2CRecovery.errors[I2C_ERROR_CLASS_OVERFLOW],
+        I2CRecovery.errors[I2C_ERROR_CLASS_OTHER]
+    );
+    LogRaw(
+        "    Retries: %u (%u succeeded) Recoveries: %u (%u failed)\r\n",
+        I2CRecovery.retries,
+        I2CRecovery.retrySuccesses,
+        I2CRecovery.recoveries,
+        I2CRecovery.recoveryFailures
+    );
+}
+
+/**
+ * I2CReadAttempt()
+ *     Description:
+ *         Read consecutive registers from a device in a single transaction,
+ *         relying on the device to auto-increment the register address.
+ *         Every byte but the last is ACKed so the device keeps sending.
+ *     Params:
+ *         unsigned char deviceAdress - The device address to read from
+ *         unsigned char registerAddress - The first register to read
+ *         unsigned char *buffer - The buffer to store the read data to
+ *         uint8_t length - The number of registers to read
  *     Returns:
  *         int8_t - The read Status
  */
-int8_t I2CRead(
+static int8_t I2CReadAttempt(
     unsigned char deviceAdress,
     unsigned char registerAddress,
-    unsigned char *buffer
+    unsigned char *buffer,
+    uint8_t length
 ) {
-    if (I2CStatus == I2C_STATUS_ERR) {
-        return I2C_ERR_BusDirty;
-    }
-    if (I2CStart() != I2C_STATUS_OK) {
+    uint8_t idx;
+    int16_t retval = I2CStart();
+    if (retval != I2C_STATUS_OK) {
         // Failed to open bus
         I2CStatus = I2C_STATUS_ERR;
+        I2CCountError(retval);
         return I2C_ERR_CommFail;
     }
-    // Device Address + Read bit
+    // Device Address + Write bit
     uint8_t slaveAddress = (deviceAdress << 1) | 0x00;
-    int16_t retval = I2CWriteByte(slaveAddress);
+    retval = I2CWriteByte(slaveAddress);
     if (retval == I2C_ERR_NAK) {
         // Bad Slave Address or I2C slave device stopped responding
-        I2CStop();
-        I2CStatus = I2C_STATUS_ERR;
-        return I2C_ERR_BadAddr;
+        return I2CAbort(retval, I2C_ERR_BadAddr);
     } else if (retval < 0) {
-        I2CStop();
-        I2CStatus = I2C_STATUS_ERR;
-        return I2C_ERR_CommFail;
+        return I2CAbort(retval, I2C_ERR_CommFail);
     }
     // Register Addr
-    if (I2CWriteByte((char)registerAddress) != I2C_STATUS_OK) {
-        I2CStop();
-        I2CStatus = I2C_STATUS_ERR;
-        return I2C_ERR_CommFail;
+    retval = I2CWriteByte((char)registerAddress);
+    if (retval != I2C_ACK) {
+        return I2CAbort(retval, I2C_ERR_CommFail);
     }
     // Repeated start
-    if (I2CRestart() != I2C_STATUS_OK) {
-        I2CStop();
-        I2CStatus = I2C_STATUS_ERR;
-        return I2C_ERR_CommFail;
+    retval = I2CRestart();
+    if (retval != I2C_STATUS_OK) {
+        return I2CAbort(retval, I2C_ERR_CommFail);
     }
     // Device Address + Read bit
     slaveAddress = (deviceAdress << 1) | 0x01;
-    if (I2CWriteByte(slaveAddress) != I2C_STATUS_OK) {
-        I2CStop();
-        I2CStatus = I2C_STATUS_ERR;
-        return I2C_ERR_CommFail;
-    }
-    retval = I2CReadByte(I2C_NACK);
-    if (retval >= 0 && retval <= 255) {
-        *buffer = retval;
-    } else {
-        // Error while reading byte.  Close connection and set error flag.
-        I2CStop();
-        I2CStatus = I2C_STATUS_ERR;
-        return I2C_ERR_CommFail;
+    retval = I2CWriteByte(slaveAddress);
+    if (retval != I2C_ACK) {
+        return I2CAbort(retval, I2C_ERR_CommFail);
+    }
+    for (idx = 0; idx < length; idx++) {
+        unsigned char ackFlag = I2C_ACK;
+        if (idx == length - 1) {
+            ackFlag = I2C_NACK;
+        }
+        retval = I2CReadByte(ackFlag);
+        if (retval >= 0 && retval <= 255) {
+            buffer[idx] = retval;
+        } else {
+            // Error while reading byte.  Close connection and set error flag.
+            return I2CAbort(retval, I2C_ERR_CommFail);
+        }
     }
-    if (I2CStop() != I2C_STATUS_OK) {
+    retval = I2CStop();
+    if (retval != I2C_STATUS_OK) {
         // Failed to close bus
         I2CStatus = I2C_STATUS_ERR;
+        I2CCountError(retval);
         return I2C_ERR_CommFail;
     }
     return I2C_STATUS_OK;
 }
 
+/**
+ * I2CRead()
+ *     Description:
+ *         Perform an I2C read request for a specific device and read it into a
+ *         byte
+ *     Params:
+ *         unsigned char deviceAdress - The device address to poll
+ *         unsigned char registerAddress - The register to read
+ *         unsigned char *buffer - The byte to store the read data to
+ *     Returns:
+ *         int8_t - The read Status
+ */
+int8_t I2CRead(
+    unsigned char deviceAdress,
+    unsigned char registerAddress,
+    unsigned char *buffer
+) {
+    return I2CReadBytes(deviceAdress, registerAddress, buffer, 1);
+}
+
+/**
+ * I2CReadBytes()
+ *     Description:
+ *         Read consecutive registers from a device. A failed read recovers
+ *         the bus and is retried with a growing delay between attempts.
+ *     Params:
+ *         unsigned char deviceAdress - The device address to read from
+ *         unsigned char registerAddress - The first register to read
+ *         unsigned char *buffer - The buffer to store the read data to
+ *         uint8_t length - The number of registers to read
+ *     Returns:
+ *         int8_t - The read Status
+ */
+int8_t I2CReadBytes(
+    unsigned char deviceAdress,
+    unsigned char registerAddress,
+    unsigned char *buffer,
+    uint8_t length
+) {
+    uint8_t attempt;
+    int8_t status = I2C_ERR_BusDirty;
+    for (attempt = 0; attempt <= I2C_RETRY_COUNT; attempt++) {
+        if (attempt > 0) {
+            I2CRecovery.retries++;
+            TimerDelayMicroseconds(I2C_RETRY_BACKOFF_US << (attempt - 1));
+        }
+        if (I2CRecover() != I2C_STATUS_OK) {
+            return I2C_ERR_BusDirty;
+        }
+        status = I2CReadAttempt(deviceAdress, registerAddress, buffer, length);
+        if (status == I2C_STATUS_OK) {
+            if (attempt > 0) {
+                I2CRecovery.retrySuccesses++;
+            }
+            break;
+        }
+    }
+    return status;
+}
+
+/**
+ * I2CRecover()
+ *     Description:
+ *         Bring a dirty bus back. Stuck slaves are clocked out, the bus is
+ *         released with a stop condition and the I2C3 module is configured
+ *         from scratch. A failed recovery is not tried again until a backoff
+ *         passes, which doubles on each failure up to
+ *         I2C_RECOVERY_BACKOFF_MAX, so a dead bus costs next to nothing.
+ *     Params:
+ *         void
+ *     Returns:
+ *         int8_t - I2C_STATUS_OK if the bus is usable, I2C_ERR_BusDirty
+ *             otherwise
+ */
+int8_t I2CRecover()
+{
+    if (I2CStatus == I2C_STATUS_OK) {
+        return I2C_STATUS_OK;
+    }
+    if (I2CRecovery.state == I2C_RECOVERY_STATE_BACKOFF &&
+        TimerGetMillis() - I2CRecovery.timestamp < I2CRecovery.backoff
+    ) {
+        return I2C_ERR_BusDirty;
+    }
+    I2CRecovery.state = I2C_RECOVERY_STATE_CLOCK_OUT;
+    I2CClearErrors();
+    if (I2CRecoverBus() != I2C_STATUS_OK) {
+        I2CRecovery.recoveryFailures++;
+        I2CRecovery.state = I2C_RECOVERY_STATE_BACKOFF;
+        I2CRecovery.timestamp = TimerGetMillis();
+        if (I2CRecovery.backoff < I2C_RECOVERY_BACKOFF_MAX / 2) {
+            I2CRecovery.backoff = I2CRecovery.backoff * 2;
+        } else {
+            I2CRecovery.backoff = I2C_RECOVERY_BACKOFF_MAX;
+        }
+        return I2C_ERR_BusDirty;
+    }
+    I2CRecovery.state = I2C_RECOVERY_STATE_REINIT;
+    I2CEnable();
+    I2CRecovery.state = I2C_RECOVERY_STATE_IDLE;
+    I2CRecovery.backoff = I2C_RECOVERY_BACKOFF_MIN;
+    I2CRecovery.recoveries++;
+    I2CStatus = I2C_STATUS_OK;
+    return I2C_STATUS_OK;
+}
+
 /**
  * I2CRecoverBus()
  *     Description:
- *         Handle a bus recovery
+ *         Release the lines and clock SCL until a slave stuck mid-byte lets
+ *         go of SDA, then generate a stop condition. The I2C3 module is left
+ *         disabled, I2CRecover() reconfigures it.
  *     Params:
  *         void
  *     Returns:
@@ -250,43 +470,47 @@ int8_t I2CRecoverBus()
     int8_t status = I2C_STATUS_OK;
     uint8_t i = 0;
 
-    // Disable the bus and pull both lines high
+    // Disable the bus and release both lines. The lines are open drain,
+    // so they are driven low through the TRIS bits with the latches at 0 and
+    // float high on the pull-ups otherwise.
     I2C3CONLbits.I2CEN = 0;
-    I2C3_SDA = 1;
-    I2C3_SCL = 1;
+    I2C3_SDA = 0;
+    I2C3_SCL = 0;
+    I2C3_SDA_MODE = 1;
+    I2C3_SCL_MODE = 1;
 
     TimerDelayMicroseconds(10);
     if (I2C3_SCL_STATUS == 0) {
         status = I2C_ERR_SCLLow;
     } else {
-        // SCL is good -- toggle until SDA goes high.
-        while (i <= 10) {
+        // SCL is good -- clock out up to a full byte until SDA goes high.
+        while (i < I2C_RECOVERY_CLOCKS) {
             // Wait until SDA is high
-            if (I2C3_SCL_STATUS == 1) {
+            if (I2C3_SDA_STATUS == 1) {
                 break;
             }
-            I2C3_SCL = 0;
+            I2C3_SCL_MODE = 0;
             TimerDelayMicroseconds(10);
-            I2C3_SCL = 1;
+            I2C3_SCL_MODE = 1;
             TimerDelayMicroseconds(10);
             i++;
         }
-        if (I2C3_SCL_STATUS == 0 && I2C3_SDA_STATUS == 0) {
+        if (I2C3_SCL_STATUS == 0 || I2C3_SDA_STATUS == 0) {
              status = I2C_ERR_SDALow;
         } else {
-            // Restart the I2C bus by resetting the SDA / SCL lines
-            I2C3_SDA = 0;
+            // Generate a stop condition, SDA rising while SCL is high
+            I2C3_SDA_MODE = 0;
             TimerDelayMicroseconds(10);
-            I2C3_SDA = 1;
+            I2C3_SDA_MODE = 1;
             TimerDelayMicroseconds(10);
             status = I2C_STATUS_OK;
         }
     }
     if (status < 0) {
         LogError("I2C Error - Status is %d", status);
+        I2CCountError(status);
         return I2C_ERR_Hardware;
     }
-    I2C3CONLbits.I2CEN = 1;
     return I2C_STATUS_OK;
 }
 
@@ -388,7 +612,7 @@ int8_t I2CStop()
 }
 
 /**
- * I2CWrite()
+ * I2CWriteAttempt()
  *     Description:
  *         Write a byte to a given register on a given device
  *     Params:
@@ -398,50 +622,83 @@ int8_t I2CStop()
  *     Returns:
  *         int8_t The status
  */
-int8_t I2CWrite(
+static int8_t I2CWriteAttempt(
     unsigned char deviceAddress,
     unsigned char registerAddress,
     unsigned char data
 ) {
     int8_t retval;
     unsigned char slaveAddress;
-    if (I2CStatus == I2C_STATUS_ERR) {
-        // Ignore requests until Poll command is called to fix error
-        return I2C_ERR_BusDirty;
-    }
-    if (I2CStart() != 0) {
+    retval = I2CStart();
+    if (retval != I2C_STATUS_OK) {
         // Failed to open bus
         I2CStatus = I2C_STATUS_ERR;
+        I2CCountError(retval);
         return I2C_ERR_CommFail;
     }
     // Device Address + Write bit
-    slaveAddress = (deviceAddress << 1) | 0; 
+    slaveAddress = (deviceAddress << 1) | 0;
     retval = I2CWriteByte((char)slaveAddress);
     if (retval == I2C_ERR_NAK) {
         // Bad Slave Address or I2C slave device stopped responding
-        I2CStop();
-        I2CStatus = I2C_STATUS_ERR;
-        return I2C_ERR_BadAddr;
+        return I2CAbort(retval, I2C_ERR_BadAddr);
     } else if (retval < 0) {
-        I2CStop();
-        I2CStatus = I2C_STATUS_ERR;
-        return I2C_ERR_CommFail;
+        return I2CAbort(retval, I2C_ERR_CommFail);
     }
-    if (I2CWriteByte((char)registerAddress) != I2C_ACK) {
-        I2CStop();
-        I2CStatus = I2C_STATUS_ERR;
-        return I2C_ERR_CommFail;
+    retval = I2CWriteByte((char)registerAddress);
+    if (retval != I2C_ACK) {
+        return I2CAbort(retval, I2C_ERR_CommFail);
     }
-    if (I2CWriteByte(data) != I2C_ACK) {
+    retval = I2CWriteByte(data);
+    if (retval != I2C_ACK) {
         // Error while writing byte.  Close connection and set error flag.
-        I2CStop();
-        I2CStatus = I2C_STATUS_ERR;
-        return I2C_ERR_CommFail;
+        return I2CAbort(retval, I2C_ERR_CommFail);
     }
-    if (I2CStop() != I2C_STATUS_OK) {
+    retval = I2CStop();
+    if (retval != I2C_STATUS_OK) {
         // Failed to close bus
         I2CStatus = I2C_STATUS_ERR;
+        I2CCountError(retval);
         return I2C_ERR_CommFail;
     }
     return I2C_STATUS_OK;
 }
+
+/**
+ * I2CWrite()
+ *     Description:
+ *         Write a byte to a given register on a given device. A failed write
+ *         recovers the bus and is retried with a growing delay between
+ *         attempts.
+ *     Params:
+ *         unsigned char deviceAdress - The device address to write to
+ *         unsigned char registerAddress - The register to write
+ *         unsigned char data - The data to write
+ *     Returns:
+ *         int8_t The status
+ */
+int8_t I2CWrite(
+    unsigned char deviceAddress,
+    unsigned char registerAddress,
+    unsigned char data
+) {
+    uint8_t attempt;
+    int8_t status = I2C_ERR_BusDirty;
+    for (attempt = 0; attempt <= I2C_RETRY_COUNT; attempt++) {
+        if (attempt > 0) {
+            I2CRecovery.retries++;
+            TimerDelayMicroseconds(I2C_RETRY_BACKOFF_US << (attempt - 1));
+        }
+        if (I2CRecover() != I2C_STATUS_OK) {
+            return I2C_ERR_BusDirty;
+        }
+        status = I2CWriteAttempt(deviceAddress, registerAddress, data);
+        if (status == I2C_STATUS_OK) {
+            if (attempt > 0) {
+                I2CRecovery.retrySuccesses++;
+            }
+            break;
+        }
+    }
+    return status;
+}
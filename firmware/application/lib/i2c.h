@@ -6,6 +6,8 @@
  */
 #ifndef I2C_H
 #define I2C_H
+#include <stdint.h>
+#include <string.h>
 #include <xc.h>
 #include "../mappings.h"
 #include "log.h"
@@ -34,11 +36,56 @@
 #define I2C_STATUS_ERR 1
 #define I2C_SCL_TIMEOUT 2000
 #define I2C_SCL_WRITE_TIMEOUT 8000
+// Failed transactions are retried after 50us, then 100us
+#define I2C_RETRY_COUNT 2
+#define I2C_RETRY_BACKOFF_US 50
+// Nine clocks free a slave stuck anywhere in a byte and its ACK
+#define I2C_RECOVERY_CLOCKS 9
+#define I2C_RECOVERY_BACKOFF_MIN 10
+#define I2C_RECOVERY_BACKOFF_MAX 1000
+#define I2C_RECOVERY_STATE_IDLE 0
+#define I2C_RECOVERY_STATE_CLOCK_OUT 1
+#define I2C_RECOVERY_STATE_REINIT 2
+#define I2C_RECOVERY_STATE_BACKOFF 3
+#define I2C_ERROR_CLASS_NAK 0
+#define I2C_ERROR_CLASS_COLLISION 1
+#define I2C_ERROR_CLASS_TIMEOUT 2
+#define I2C_ERROR_CLASS_OVERFLOW 3
+#define I2C_ERROR_CLASS_OTHER 4
+#define I2C_ERROR_CLASS_COUNT 5
+
+/**
+ * I2CRecovery_t
+ *     Description:
+ *         The bus recovery state and error statistics
+ *     Fields:
+ *         state - I2C_RECOVERY_STATE_*
+ *         timestamp - When the last recovery failed
+ *         backoff - How long to wait after a failed recovery
+ *         errors - Failures seen, by I2C_ERROR_CLASS_*
+ *         retries - Transactions retried
+ *         retrySuccesses - Retries that went through
+ *         recoveries - Successful bus recoveries
+ *         recoveryFailures - Bus recoveries that found a line stuck low
+ */
+typedef struct I2CRecovery_t {
+    uint8_t state;
+    uint32_t timestamp;
+    uint16_t backoff;
+    uint16_t errors[I2C_ERROR_CLASS_COUNT];
+    uint16_t retries;
+    uint16_t retrySuccesses;
+    uint16_t recoveries;
+    uint16_t recoveryFailures;
+} I2CRecovery_t;
 
 void I2CInit();
 void I2CClearErrors();
 int8_t I2CPoll(unsigned char);
+void I2CPrintStatus();
 int8_t I2CRead(unsigned char, unsigned char, unsigned char *);
+int8_t I2CReadBytes(unsigned char, unsigned char, unsigned char *, uint8_t);
+int8_t I2CRecover();
 int8_t I2CRecoverBus();
 int8_t I2CRestart();
 int8_t I2CStart();
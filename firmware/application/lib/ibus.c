@@ -47,9 +47,6 @@ IBus_t IBusInit()
     ibus.lmDimmerVoltage = 0xFF;
     ibus.lmLoadRearVoltage = 0x00; // Rear load sensor voltage (LWR)
     ibus.lmPhotoVoltage = 0xFF; // Photosensor voltage (LSZ)
-    ibus.oilTemperature = 0x00;
-    ibus.coolantTemperature = 0x00;
-    ibus.ambientTemperature = 0x00;
     memset(ibus.ambientTemperatureCalculated, 0, 7);
     memset(ibus.telematicsLocale, 0, sizeof(ibus.telematicsLocale));
     memset(ibus.telematicsStreet, 0, sizeof(ibus.telematicsStreet));
@@ -64,6 +61,16 @@ IBus_t IBusInit()
     ibus.txBufferReadIdx = 0;
     ibus.txBufferReadbackIdx = 0;
     ibus.txBufferWriteIdx = 0;
+    memset(ibus.txTraceId, 0, sizeof(ibus.txTraceId));
+    ibus.txPriority = IBUS_TX_PRIORITY_NORMAL;
+    ibus.txPriorityReadbackIdx = 0;
+    ibus.txPriorityReadIdx = 0;
+    ibus.txPriorityWriteIdx = 0;
+    memset(ibus.txPriorityTraceId, 0, sizeof(ibus.txPriorityTraceId));
+    ibus.txPriorityStamp = 0;
+    ibus.txPriorityLatency = 0;
+    ibus.txPriorityLatencyMax = 0;
+    ibus.txPriorityCount = 0;
     ibus.txLastStamp = TimerGetMillis();
     return ibus;
 }
@@ -361,26 +368,23 @@ static void IBusHandleIKEMessage(IBus_t *ibus, uint8_t *pkt)
             ibus->ignitionStatus = ignitionStatus;
         }
     } else if (pkt[IBUS_PKT_CMD] == IBUS_CMD_IKE_SENSOR_RESP) {
-        ibus->gearPosition = pkt[IBUS_PKT_DB2] >> 4;
-        uint8_t valueType = IBUS_SENSOR_VALUE_GEAR_POS;
-        EventTriggerCallback(IBUS_EVENT_SENSOR_VALUE_UPDATE, &valueType);
+        VehicleSetSignal(VEHICLE_SIGNAL_GEAR_POSITION, pkt[IBUS_PKT_DB2] >> 4);
     } else if (pkt[IBUS_PKT_CMD] == IBUS_CMD_IKE_RESP_VEHICLE_CONFIG) {
         ibus->vehicleType = IBusGetVehicleType(pkt);
         EventTriggerCallback(IBUS_EVENT_IKE_VEHICLE_CONFIG, pkt);
     } else if (pkt[IBUS_PKT_CMD] == IBUS_CMD_IKE_SPEED_RPM_UPDATE) {
+        // Speed is sent in units of 2 km/h and RPM in units of 100
+        VehicleSetSignal(VEHICLE_SIGNAL_SPEED, pkt[IBUS_PKT_DB1] * 2);
+        VehicleSetSignal(VEHICLE_SIGNAL_RPM, pkt[IBUS_PKT_DB2] * 100);
         EventTriggerCallback(IBUS_EVENT_IKESpeedRPMUpdate, pkt);
     } else if (pkt[IBUS_PKT_CMD] == IBUS_CMD_IKE_TEMP_UPDATE) {
-        // Do not update the system if the value is the same
-        if (ibus->coolantTemperature != pkt[IBUS_PKT_DB2] && pkt[IBUS_PKT_DB2] <= 0x7F) {
-            ibus->coolantTemperature = pkt[IBUS_PKT_DB2];
-            uint8_t valueType = IBUS_SENSOR_VALUE_COOLANT_TEMP;
-            EventTriggerCallback(IBUS_EVENT_SENSOR_VALUE_UPDATE, &valueType);
+        // The IKE repeats this broadcast, the vehicle state drops repeats
+        if (pkt[IBUS_PKT_DB2] <= 0x7F) {
+            VehicleSetSignal(VEHICLE_SIGNAL_COOLANT_TEMP, pkt[IBUS_PKT_DB2]);
         }
         signed char tmp = pkt[IBUS_PKT_DB1];
-        if (ibus->ambientTemperature != tmp && tmp > -60 && tmp < 60) {
-            ibus->ambientTemperature = tmp;
-            uint8_t valueType = IBUS_SENSOR_VALUE_AMBIENT_TEMP;
-            EventTriggerCallback(IBUS_EVENT_SENSOR_VALUE_UPDATE, &valueType);
+        if (tmp > -60 && tmp < 60) {
+            VehicleSetSignal(VEHICLE_SIGNAL_AMBIENT_TEMP, tmp);
         }
     } else if (pkt[IBUS_PKT_CMD] == IBUS_CMD_IKE_OBC_TEXT) {
         char property = pkt[IBUS_PKT_DB1];
@@ -475,11 +479,7 @@ static void IBusHandleLCMMessage(IBus_t *ibus, uint8_t *pkt)
             }
             float rawTemperature = (pkt[23] * 0.00005) + (pkt[24] * 0.01275);
             uint8_t oilTemperature = 67.2529 * log(rawTemperature) + offset;
-            if (oilTemperature != ibus->oilTemperature) {
-                ibus->oilTemperature = oilTemperature;
-                uint8_t valueType = IBUS_SENSOR_VALUE_OIL_TEMP;
-                EventTriggerCallback(IBUS_EVENT_SENSOR_VALUE_UPDATE, &valueType);
-            }
+            VehicleSetSignal(VEHICLE_SIGNAL_OIL_TEMP, oilTemperature);
         }
     } else if (pkt[IBUS_PKT_DST] == IBUS_DEVICE_DIA &&
                pkt[IBUS_PKT_CMD] == IBUS_CMD_DIA_DIAG_RESPONSE &&
@@ -781,6 +781,95 @@ static uint8_t IBusValidateChecksum(uint8_t *msg)
     }
 }
 
+/**
+ * IBusDispatchMessage()
+ *     Description:
+ *         Hand a validated frame to the handler for its source system. Frames
+ *         replayed from a cache go through here too, so they are decoded
+ *         exactly like frames read off the bus.
+ *     Params:
+ *         IBus_t *ibus - The pointer to the IBus_t object
+ *         uint8_t *pkt - The frame, IBUS_MAX_MSG_LENGTH bytes and zero filled
+ *     Returns:
+ *         void
+ */
+void IBusDispatchMessage(IBus_t *ibus, uint8_t *pkt)
+{
+    uint8_t srcSystem = pkt[IBUS_PKT_SRC];
+    if (srcSystem == IBUS_DEVICE_BLUEBUS &&
+        pkt[IBUS_PKT_DST] == IBUS_DEVICE_LOC
+    ) {
+        IBusHandleBlueBusMessage(ibus, pkt);
+    }
+    if (srcSystem == IBUS_DEVICE_RAD) {
+        IBusHandleRADMessage(ibus, pkt);
+    }
+    if (srcSystem == IBUS_DEVICE_BMBT) {
+        IBusHandleBMBTMessage(ibus, pkt);
+    }
+    if (srcSystem == IBUS_DEVICE_IKE) {
+        IBusHandleIKEMessage(ibus, pkt);
+    }
+    if (srcSystem == IBUS_DEVICE_GT) {
+        IBusHandleGTMessage(ibus, pkt);
+    }
+    if (srcSystem == IBUS_DEVICE_LCM) {
+        IBusHandleLCMMessage(ibus, pkt);
+    }
+    if (srcSystem == IBUS_DEVICE_MID) {
+        IBusHandleMIDMessage(ibus, pkt);
+    }
+    if (srcSystem == IBUS_DEVICE_NAVE) {
+        IBusHandleNAVMessage(ibus, pkt);
+    }
+    if (srcSystem == IBUS_DEVICE_MFL) {
+        IBusHandleMFLMessage(ibus, pkt);
+    }
+    if (srcSystem == IBUS_DEVICE_DSP) {
+        IBusHandleDSPMessage(ibus, pkt);
+    }
+    if (srcSystem == IBUS_DEVICE_GM) {
+        IBusHandleGMMessage(ibus, pkt);
+    }
+    if (srcSystem == IBUS_DEVICE_EWS) {
+        IBusHandleEWSMessage(ibus, pkt);
+    }
+    if (srcSystem == IBUS_DEVICE_VM) {
+        IBusHandleVMMessage(ibus, pkt);
+    }
+    if (srcSystem == IBUS_DEVICE_PDC) {
+        IBusHandlePDCMessage(ibus, pkt);
+    }
+    if (pkt[IBUS_PKT_DST] == IBUS_DEVICE_TEL) {
+        IBusHandleTELMessage(ibus, pkt);
+    }
+    if (pkt[IBUS_PKT_DST] == IBUS_DEVICE_DIA &&
+        pkt[IBUS_PKT_CMD] == IBUS_CMD_DIA_DIAG_RESPONSE
+    ) {
+        EventTriggerCallback(IBUS_EVENT_DIA_RESPONSE, pkt);
+    }
+}
+
+/**
+ * IBusPrintTXStatus()
+ *     Description:
+ *         Log the priority frames sent and how long they took to reach the
+ *         bus after being queued
+ *     Params:
+ *         IBus_t *ibus
+ *     Returns:
+ *         void
+ */
+void IBusPrintTXStatus(IBus_t *ibus)
+{
+    LogRaw(
+        "IBus: Priority Frames: %u Last Latency: %ums Max Latency: %ums\r\n",
+        ibus->txPriorityCount,
+        ibus->txPriorityLatency,
+        ibus->txPriorityLatencyMax
+    );
+}
+
 /**
  * IBusProcess()
  *     Description:
@@ -798,8 +887,8 @@ void IBusProcess(IBus_t *ibus)
         ibus->rxBuffer[ibus->rxBufferIdx++] = CharQueueNext(&ibus->uart.rxQueue);
         if (ibus->rxBufferIdx > 1) {
             uint8_t msgLength = ibus->rxBuffer[1] + 2;
-            // Make sure we do not read more than the maximum packet length
-            if (msgLength > IBUS_MAX_MSG_LENGTH) {
+            // Make sure the packet length is within the protocol bounds
+            if (msgLength > IBUS_MAX_MSG_LENGTH || msgLength < IBUS_MIN_MSG_LENGTH) {
                 long long unsigned int ts = (long long unsigned int) TimerGetMillis();
                 LogRawDebug(
                     LOG_SOURCE_IBUS,
@@ -818,8 +907,11 @@ void IBusProcess(IBus_t *ibus)
                 CharQueueReset(&ibus->uart.rxQueue);
             } else if (msgLength == ibus->rxBufferIdx) {
                 uint8_t idx;
-                uint8_t pkt[msgLength];
-                memset(pkt, 0, msgLength);
+                uint8_t snifferType = SNIFFER_RECORD_RX;
+                // Handlers read fixed offsets for their command, so keep the
+                // packet buffer at full size and zero filled past msgLength
+                uint8_t pkt[IBUS_MAX_MSG_LENGTH];
+                memset(pkt, 0, IBUS_MAX_MSG_LENGTH);
                 long long unsigned int ts = (long long unsigned int) TimerGetMillis();
                 LogRawDebug(LOG_SOURCE_IBUS, "[%llu] DEBUG: IBus: RX[%d]: ", ts, msgLength);
                 for(idx = 0; idx < msgLength; idx++) {
@@ -828,63 +920,42 @@ void IBusProcess(IBus_t *ibus)
                 }
                 if (memcmp(ibus->txBuffer[ibus->txBufferReadbackIdx], pkt, msgLength) == 0) {
                     LogRawDebug(LOG_SOURCE_IBUS, "[SELF]");
+                    snifferType = SNIFFER_RECORD_ECHO;
                     memset(ibus->txBuffer[ibus->txBufferReadbackIdx], 0, msgLength);
                     if (ibus->txBufferReadbackIdx + 1 == IBUS_TX_BUFFER_SIZE) {
                         ibus->txBufferReadbackIdx = 0;
                     } else {
                         ibus->txBufferReadbackIdx++;
                     }
+                } else {
+                    // Priority frames skip the transmit buffer, so their echo
+                    // is matched against the priority frames sent so far. A
+                    // frame whose echo was lost is stepped over.
+                    uint8_t readbackIdx = ibus->txPriorityReadbackIdx;
+                    while (readbackIdx != ibus->txPriorityReadIdx) {
+                        uint8_t *sent = ibus->txPriorityBuffer[readbackIdx];
+                        if (readbackIdx + 1 == IBUS_TX_PRIORITY_BUFFER_SIZE) {
+                            readbackIdx = 0;
+                        } else {
+                            readbackIdx++;
+                        }
+                        if (memcmp(sent, pkt, msgLength) == 0) {
+                            LogRawDebug(LOG_SOURCE_IBUS, "[SELF]");
+                            snifferType = SNIFFER_RECORD_ECHO;
+                            ibus->txPriorityReadbackIdx = readbackIdx;
+                            break;
+                        }
+                    }
                 }
                 LogRawDebug(LOG_SOURCE_IBUS, "\r\n");
-                if (IBusValidateChecksum(pkt) == 1) {
-                    uint8_t srcSystem = pkt[IBUS_PKT_SRC];
-                    if (srcSystem == IBUS_DEVICE_BLUEBUS &&
-                        pkt[IBUS_PKT_DST] == IBUS_DEVICE_LOC
-                    ) {
-                        IBusHandleBlueBusMessage(ibus, pkt);
-                    }
-                    if (srcSystem == IBUS_DEVICE_RAD) {
-                        IBusHandleRADMessage(ibus, pkt);
-                    }
-                    if (srcSystem == IBUS_DEVICE_BMBT) {
-                        IBusHandleBMBTMessage(ibus, pkt);
-                    }
-                    if (srcSystem == IBUS_DEVICE_IKE) {
-                        IBusHandleIKEMessage(ibus, pkt);
-                    }
-                    if (srcSystem == IBUS_DEVICE_GT) {
-                        IBusHandleGTMessage(ibus, pkt);
-                    }
-                    if (srcSystem == IBUS_DEVICE_LCM) {
-                        IBusHandleLCMMessage(ibus, pkt);
-                    }
-                    if (srcSystem == IBUS_DEVICE_MID) {
-                        IBusHandleMIDMessage(ibus, pkt);
-                    }
-                    if (srcSystem == IBUS_DEVICE_NAVE) {
-                        IBusHandleNAVMessage(ibus, pkt);
-                    }
-                    if (srcSystem == IBUS_DEVICE_MFL) {
-                        IBusHandleMFLMessage(ibus, pkt);
-                    }
-                    if (srcSystem == IBUS_DEVICE_DSP) {
-                        IBusHandleDSPMessage(ibus, pkt);
-                    }
-                    if (srcSystem == IBUS_DEVICE_GM) {
-                        IBusHandleGMMessage(ibus, pkt);
-                    }
-                    if (srcSystem == IBUS_DEVICE_EWS) {
-                        IBusHandleEWSMessage(ibus, pkt);
-                    }
-                    if (srcSystem == IBUS_DEVICE_VM) {
-                        IBusHandleVMMessage(ibus, pkt);
-                    }
-                    if (srcSystem == IBUS_DEVICE_PDC) {
-                        IBusHandlePDCMessage(ibus, pkt);
-                    }
-                    if (pkt[IBUS_PKT_DST] == IBUS_DEVICE_TEL) {
-                        IBusHandleTELMessage(ibus, pkt);
-                    }
+                if (IBusValidateChecksum(pkt) == 0) {
+                    snifferType = SNIFFER_RECORD_RX_BAD_CHECKSUM;
+                }
+                SnifferAddFrame(snifferType, pkt, msgLength);
+                if (snifferType != SNIFFER_RECORD_RX_BAD_CHECKSUM) {
+                    TraceBegin(TRACE_POINT_IBUS_RX, pkt[IBUS_PKT_CMD]);
+                    IBusDispatchMessage(ibus, pkt);
+                    TraceEnd();
                 } else {
                     LogError(
                         "IBus: %02X -> %02X Length: %d - Invalid Checksum",
@@ -902,16 +973,26 @@ void IBusProcess(IBus_t *ibus)
             EventTriggerCallback(IBUS_EVENT_FirstMessageReceived, 0);
         }
         ibus->rxLastStamp = TimerGetMillis();
-    } else if (ibus->txBufferWriteIdx != ibus->txBufferReadIdx) {
-        // Flush the transmit buffer out to the bus
+    } else if (ibus->txBufferWriteIdx != ibus->txBufferReadIdx ||
+               ibus->txPriorityWriteIdx != ibus->txPriorityReadIdx
+    ) {
+        // Flush the transmit buffers out to the bus, priority frames first
         uint8_t txTimeout = IBUS_TX_TIMEOUT_OFF;
         uint8_t beginTxTimestamp = TimerGetMillis();
-        while (ibus->txBufferWriteIdx != ibus->txBufferReadIdx &&
+        while ((ibus->txBufferWriteIdx != ibus->txBufferReadIdx ||
+                ibus->txPriorityWriteIdx != ibus->txPriorityReadIdx) &&
                txTimeout != IBUS_TX_TIMEOUT_ON
         ) {
             uint32_t now = TimerGetMillis();
             if ((now - ibus->txLastStamp) >= IBUS_TX_BUFFER_WAIT) {
-                uint8_t msgLen = ibus->txBuffer[ibus->txBufferReadIdx][1] + 2;
+                uint8_t isPriority = ibus->txPriorityWriteIdx != ibus->txPriorityReadIdx;
+                uint8_t *msg = ibus->txBuffer[ibus->txBufferReadIdx];
+                uint16_t traceId = ibus->txTraceId[ibus->txBufferReadIdx];
+                if (isPriority == 1) {
+                    msg = ibus->txPriorityBuffer[ibus->txPriorityReadIdx];
+                    traceId = ibus->txPriorityTraceId[ibus->txPriorityReadIdx];
+                }
+                uint8_t msgLen = msg[1] + 2;
                 uint8_t idx;
                 /*
                  * Make sure that the STATUS pin on the TH3122 is low, indicating no
@@ -919,12 +1000,34 @@ void IBusProcess(IBus_t *ibus)
                  */
                 if (IBUS_UART_STATUS == 0) {
                     for (idx = 0; idx < msgLen; idx++) {
-                        ibus->uart.registers->uxtxreg = ibus->txBuffer[ibus->txBufferReadIdx][idx];
+                        ibus->uart.registers->uxtxreg = msg[idx];
                         // Wait for the data to leave the TX buffer
                         while ((ibus->uart.registers->uxsta & (1 << 9)) != 0);
                     }
                     txTimeout = IBUS_TX_TIMEOUT_DATA_SENT;
-                    if (ibus->txBufferReadIdx + 1 == IBUS_TX_BUFFER_SIZE) {
+                    SnifferAddFrame(SNIFFER_RECORD_TX, msg, msgLen);
+                    TracePointId(traceId, TRACE_POINT_IBUS_TX, msg[IBUS_PKT_CMD]);
+                    if (isPriority == 1) {
+                        if (ibus->txPriorityReadIdx + 1 == IBUS_TX_PRIORITY_BUFFER_SIZE) {
+                            ibus->txPriorityReadIdx = 0;
+                        } else {
+                            ibus->txPriorityReadIdx++;
+                        }
+                        ibus->txPriorityCount++;
+                        // Measure from the first frame of a burst being queued
+                        // until the last one is out
+                        if (ibus->txPriorityReadIdx == ibus->txPriorityWriteIdx) {
+                            ibus->txPriorityLatency = TimerGetMillis() - ibus->txPriorityStamp;
+                            if (ibus->txPriorityLatency > ibus->txPriorityLatencyMax) {
+                                ibus->txPriorityLatencyMax = ibus->txPriorityLatency;
+                            }
+                            LogDebug(
+                                LOG_SOURCE_IBUS,
+                                "IBus: Priority frames sent in %ums",
+                                ibus->txPriorityLatency
+                            );
+                        }
+                    } else if (ibus->txBufferReadIdx + 1 == IBUS_TX_BUFFER_SIZE) {
                         ibus->txBufferReadIdx = 0;
                     } else {
                         ibus->txBufferReadIdx++;
@@ -985,6 +1088,10 @@ void IBusSendCommand(
     const size_t dataSize
 ) {
     uint8_t idx, msgSize;
+    if (dataSize == 0 || dataSize > IBUS_MAX_MSG_LENGTH - 4) {
+        LogError("IBus: Refusing to send %d byte payload to %02X", (int) dataSize, dst);
+        return;
+    }
     msgSize = dataSize + 4;
     uint8_t msg[msgSize];
     msg[0] = src;
@@ -999,8 +1106,56 @@ void IBusSendCommand(
         crc ^= msg[idx];
     }
     msg[msgSize - 1] = crc;
+    if (ibus->txPriority == IBUS_TX_PRIORITY_HIGH) {
+        uint8_t nextIdx = ibus->txPriorityWriteIdx + 1;
+        if (nextIdx == IBUS_TX_PRIORITY_BUFFER_SIZE) {
+            nextIdx = 0;
+        }
+        // Fall back to the regular queue rather than drop the frame
+        if (nextIdx != ibus->txPriorityReadIdx) {
+            // Frames still queued for the same command to the same module
+            // would go out after this one and overwrite it, so drop them
+            uint8_t readIdx = ibus->txBufferReadIdx;
+            uint8_t keepIdx = ibus->txBufferReadIdx;
+            while (readIdx != ibus->txBufferWriteIdx) {
+                uint8_t *queued = ibus->txBuffer[readIdx];
+                if (queued[IBUS_PKT_DST] != dst || queued[IBUS_PKT_CMD] != data[0]) {
+                    if (keepIdx != readIdx) {
+                        memcpy(ibus->txBuffer[keepIdx], queued, IBUS_MAX_MSG_LENGTH);
+                        ibus->txTraceId[keepIdx] = ibus->txTraceId[readIdx];
+                    }
+                    if (keepIdx + 1 == IBUS_TX_BUFFER_SIZE) {
+                        keepIdx = 0;
+                    } else {
+                        keepIdx++;
+                    }
+                }
+                if (readIdx + 1 == IBUS_TX_BUFFER_SIZE) {
+                    readIdx = 0;
+                } else {
+                    readIdx++;
+                }
+            }
+            if (keepIdx != ibus->txBufferWriteIdx) {
+                LogDebug(LOG_SOURCE_IBUS, "IBus: Dropped queued %02X frames to %02X", data[0], dst);
+                ibus->txBufferWriteIdx = keepIdx;
+            }
+            if (ibus->txPriorityWriteIdx == ibus->txPriorityReadIdx) {
+                ibus->txPriorityStamp = TimerGetMillis();
+            }
+            memset(ibus->txPriorityBuffer[ibus->txPriorityWriteIdx], 0, IBUS_MAX_MSG_LENGTH);
+            memcpy(ibus->txPriorityBuffer[ibus->txPriorityWriteIdx], msg, msgSize);
+            TracePoint(TRACE_POINT_IBUS_QUEUE, data[0]);
+            ibus->txPriorityTraceId[ibus->txPriorityWriteIdx] = TraceGetId();
+            ibus->txPriorityWriteIdx = nextIdx;
+            return;
+        }
+    }
     // Store the data into a buffer, so we can spread out their transmission
     memcpy(ibus->txBuffer[ibus->txBufferWriteIdx], msg, msgSize);
+    // Carry the trace through the queue to the point the frame goes out
+    TracePoint(TRACE_POINT_IBUS_QUEUE, data[0]);
+    ibus->txTraceId[ibus->txBufferWriteIdx] = TraceGetId();
     if (ibus->txBufferWriteIdx + 1 == IBUS_TX_BUFFER_SIZE) {
         ibus->txBufferWriteIdx = 0;
     } else {
@@ -1030,6 +1185,24 @@ void IBusSetInternalIgnitionStatus(IBus_t *ibus, uint8_t ignitionStatus)
     ibus->ignitionStatus = ignitionStatus;
 }
 
+/**
+ * IBusSetTXPriority()
+ *     Description:
+ *         Set the queue that IBusSendCommand() puts frames on. High priority
+ *         frames go out ahead of everything already queued, and replace
+ *         queued frames with the same destination and command, so callers
+ *         must set the priority back to normal once they are done.
+ *     Params:
+ *         IBus_t *ibus
+ *         uint8_t priority - The IBUS_TX_PRIORITY_*
+ *     Returns:
+ *         void
+ */
+void IBusSetTXPriority(IBus_t *ibus, uint8_t priority)
+{
+    ibus->txPriority = priority;
+}
+
 /***
  * IBusGetLMCodingIndex()
  *     Description:
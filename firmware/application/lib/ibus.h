@@ -14,9 +14,12 @@
 #include "log.h"
 #include "event.h"
 #include "ibus.h"
+#include "sniffer.h"
 #include "timer.h"
+#include "trace.h"
 #include "uart.h"
 #include "utils.h"
+#include "vehicle.h"
 
 // Devices
 #define IBUS_DEVICE_GM 0x00 /* Body module */
@@ -121,6 +124,11 @@
 #define IBUS_DEVICE_BMBT_Button_TEL_Release 0x88
 #define IBUS_DEVICE_BMBT_BUTTON_PWR_PRESS 0x06
 #define IBUS_DEVICE_BMBT_BUTTON_PWR_RELEASE 0x86
+// The upper bits of a button byte carry the hold / release state
+#define IBUS_DEVICE_BMBT_BUTTON_ID_MASK 0x3F
+#define IBUS_DEVICE_BMBT_BUTTON_STATE_MASK 0xC0
+#define IBUS_DEVICE_BMBT_BUTTON_STATE_HOLD 0x40
+#define IBUS_DEVICE_BMBT_BUTTON_STATE_RELEASE 0x80
 #define IBUS_CMD_BMBT_BUTTON0 0x47
 #define IBUS_CMD_BMBT_BUTTON1 0x48
 
@@ -374,7 +382,6 @@
 #define IBUS_SENSOR_VALUE_AMBIENT_TEMP 0x02
 #define IBUS_SENSOR_VALUE_OIL_TEMP 0x03
 #define IBUS_SENSOR_VALUE_TEMP_UNIT 0x04
-#define IBUS_SENSOR_VALUE_GEAR_POS 0x05
 #define IBUS_SENSOR_VALUE_AMBIENT_TEMP_CALCULATED 0x06
 
 #define IBUS_SES_ZOOM_LEVELS 8
@@ -387,6 +394,13 @@
 #define IBUS_MFL_BTN_EVENT_VOICE_PRESS 0x80
 #define IBUS_MFL_BTN_EVENT_VOICE_HOLD 0x90
 #define IBUS_MFL_BTN_EVENT_VOICE_REL 0xA0
+#define IBUS_MFL_BTN_NEXT 0x01
+#define IBUS_MFL_BTN_PREV 0x08
+#define IBUS_MFL_BTN_VOICE 0x80
+#define IBUS_MFL_BTN_ID_MASK 0x89
+#define IBUS_MFL_BTN_STATE_MASK 0x30
+#define IBUS_MFL_BTN_STATE_HOLD 0x10
+#define IBUS_MFL_BTN_STATE_RELEASE 0x20
 
 #define IBUS_MFL_CMD_VOL_PRESS 0x32
 #define IBUS_MFL_BTN_VOL_UP 0x11
@@ -471,12 +485,18 @@
 #define IBUS_EVENT_VM_IDENT_RESP 75
 #define IBUS_EVENT_GT_MENU_BUFFER_UPDATE 76
 #define IBUS_EVENT_RAD_MESSAGE_RCV 77
+#define IBUS_EVENT_DIA_RESPONSE 78
 
 // Configuration and protocol definitions
 #define IBUS_MAX_MSG_LENGTH 47 // Src Len Dest Cmd Data[42 Byte Max] XOR
+#define IBUS_MIN_MSG_LENGTH 5 // Src Len Dest Cmd XOR
 #define IBUS_RAD_MAIN_AREA_WATERMARK 0x10
 #define IBUS_RX_BUFFER_SIZE 255 // 8-bit Max
 #define IBUS_TX_BUFFER_SIZE 16
+// Frames that have to beat queued display traffic, such as call status
+#define IBUS_TX_PRIORITY_BUFFER_SIZE 4
+#define IBUS_TX_PRIORITY_NORMAL 0
+#define IBUS_TX_PRIORITY_HIGH 1
 #define IBUS_RX_BUFFER_TIMEOUT 70 // At 9600 baud, we transmit ~1.5 byte/ms
 #define IBUS_TX_BUFFER_WAIT 7 // If we transmit faster, other modules may not hear us
 #define IBUS_TX_TIMEOUT_OFF 0
@@ -533,13 +553,21 @@ typedef struct IBus_t {
     uint8_t txBufferReadbackIdx;
     uint8_t txBufferReadIdx;
     uint8_t txBufferWriteIdx;
+    uint16_t txTraceId[IBUS_TX_BUFFER_SIZE];
+    uint8_t txPriority;
+    uint8_t txPriorityBuffer[IBUS_TX_PRIORITY_BUFFER_SIZE][IBUS_MAX_MSG_LENGTH];
+    uint8_t txPriorityReadbackIdx;
+    uint8_t txPriorityReadIdx;
+    uint8_t txPriorityWriteIdx;
+    uint16_t txPriorityTraceId[IBUS_TX_PRIORITY_BUFFER_SIZE];
+    uint32_t txPriorityStamp;
+    uint16_t txPriorityLatency;
+    uint16_t txPriorityLatencyMax;
+    uint16_t txPriorityCount;
     uint32_t rxLastStamp;
     uint32_t txLastStamp;
-    signed char ambientTemperature;
     char ambientTemperatureCalculated[7];
-    uint8_t coolantTemperature;
     uint8_t cdChangerFunction;
-    uint8_t gearPosition: 4;
     uint8_t gtVersion;
     uint8_t ignitionStatus: 4;
     uint8_t lmDimmerVoltage;
@@ -547,7 +575,6 @@ typedef struct IBus_t {
     uint8_t lmLoadRearVoltage;
     uint8_t lmPhotoVoltage;
     uint8_t lmVariant;
-    uint8_t oilTemperature;
     uint8_t vehicleType;
     IBusModuleStatus_t moduleStatus;
     IBusPDCSensorStatus_t pdcSensors;
@@ -558,9 +585,12 @@ typedef struct IBus_t {
 } IBus_t;
 
 IBus_t IBusInit();
+void IBusDispatchMessage(IBus_t *, uint8_t *);
+void IBusPrintTXStatus(IBus_t *);
 void IBusProcess(IBus_t *);
 void IBusSendCommand(IBus_t *, const uint8_t, const uint8_t, const uint8_t *, const size_t);
 void IBusSetInternalIgnitionStatus(IBus_t *, uint8_t);
+void IBusSetTXPriority(IBus_t *, uint8_t);
 uint8_t IBusGetLMCodingIndex(uint8_t *);
 uint8_t IBusGetLMDiagnosticIndex(uint8_t *);
 uint8_t IBusGetLMDimmerChecksum(uint8_t *);
@@ -0,0 +1,205 @@
+/*
+ * File: input.c
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Turn the raw MFL and BMBT button frames into gestures (press, tap,
+ *     hold, repeat and release after a hold) and dispatch them through
+ *     action tables
+ */
+#include "input.h"
+static InputButtonState_t InputButtons[INPUT_SOURCE_COUNT];
+
+/**
+ * InputEmit()
+ *     Description:
+ *         Send a gesture to the UIEvent_InputGesture listeners
+ *     Params:
+ *         uint8_t source - The INPUT_SOURCE_*
+ *         uint8_t type - The INPUT_GESTURE_*
+ *         uint8_t target - The device the frame was addressed to
+ *         uint32_t now - The time the frame arrived
+ *     Returns:
+ *         void
+ */
+static void InputEmit(uint8_t source, uint8_t type, uint8_t target, uint32_t now)
+{
+    InputButtonState_t *state = &InputButtons[source];
+    InputGesture_t gesture;
+    uint32_t duration = now - state->pressed;
+    if (duration > 0xFFFF) {
+        duration = 0xFFFF;
+    }
+    gesture.source = source;
+    gesture.button = state->button;
+    gesture.type = type;
+    gesture.target = target;
+    gesture.timestamp = now;
+    gesture.duration = (uint16_t) duration;
+    EventTriggerCallback(UIEvent_InputGesture, (unsigned char *) &gesture);
+}
+
+/**
+ * InputUpdate()
+ *     Description:
+ *         Classify a button frame against the button already down on the
+ *         source. The car repeats hold frames for as long as a button is
+ *         down, so only the first becomes a hold and the rest become
+ *         repeats, at most one every INPUT_REPEAT_INT. A release is a tap
+ *         unless a hold was seen.
+ *     Params:
+ *         uint8_t source - The INPUT_SOURCE_*
+ *         uint8_t button - The button ID
+ *         uint8_t type - INPUT_GESTURE_PRESS, INPUT_GESTURE_HOLD or
+ *             INPUT_GESTURE_RELEASE as read from the frame
+ *         uint8_t target - The device the frame was addressed to
+ *     Returns:
+ *         void
+ */
+static void InputUpdate(uint8_t source, uint8_t button, uint8_t type, uint8_t target)
+{
+    InputButtonState_t *state = &InputButtons[source];
+    uint32_t now = TimerGetMillis();
+    if (type == INPUT_GESTURE_PRESS || state->button != button) {
+        // A new button, or we missed the press of this one
+        state->button = button;
+        state->held = 0;
+        state->pressed = now;
+        if (type == INPUT_GESTURE_PRESS) {
+            InputEmit(source, INPUT_GESTURE_PRESS, target, now);
+            return;
+        }
+    }
+    if (type == INPUT_GESTURE_HOLD) {
+        if (state->held == 0) {
+            state->held = 1;
+            state->repeated = now;
+            InputEmit(source, INPUT_GESTURE_HOLD, target, now);
+        } else if (now - state->repeated >= INPUT_REPEAT_INT) {
+            state->repeated = now;
+            InputEmit(source, INPUT_GESTURE_REPEAT, target, now);
+        }
+    } else {
+        if (state->held == 1) {
+            InputEmit(source, INPUT_GESTURE_HOLD_RELEASE, target, now);
+        } else {
+            InputEmit(source, INPUT_GESTURE_TAP, target, now);
+        }
+        state->button = INPUT_BUTTON_NONE;
+        state->held = 0;
+    }
+}
+
+/**
+ * InputInit()
+ *     Description:
+ *         Start listening for button frames
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void InputInit()
+{
+    uint8_t source;
+    memset(InputButtons, 0, sizeof(InputButtons));
+    for (source = 0; source < INPUT_SOURCE_COUNT; source++) {
+        InputButtons[source].button = INPUT_BUTTON_NONE;
+    }
+    EventRegisterCallback(
+        IBUS_EVENT_BMBTButton,
+        &InputIBusBMBTButton,
+        0
+    );
+    EventRegisterCallback(
+        IBUS_EVENT_MFLButton,
+        &InputIBusMFLButton,
+        0
+    );
+}
+
+/**
+ * InputDispatch()
+ *     Description:
+ *         Run the action bound to a gesture in an action table. Tables are
+ *         searched in order and the first match wins.
+ *     Params:
+ *         const InputBinding_t *bindings - The action table
+ *         uint8_t count - The number of bindings in the table
+ *         void *ctx - The context to pass to the action
+ *         InputGesture_t *gesture - The gesture
+ *     Returns:
+ *         uint8_t - 1 if an action ran, 0 otherwise
+ */
+uint8_t InputDispatch(
+    const InputBinding_t *bindings,
+    uint8_t count,
+    void *ctx,
+    InputGesture_t *gesture
+) {
+    uint8_t idx;
+    for (idx = 0; idx < count; idx++) {
+        const InputBinding_t *binding = &bindings[idx];
+        if (binding->source == gesture->source &&
+            binding->button == gesture->button &&
+            (binding->gestures & gesture->type) != 0
+        ) {
+            binding->action(ctx, gesture);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * InputIBusBMBTButton()
+ *     Description:
+ *         Classify BoardMonitor button frames. Only the 0x48 frames carry a
+ *         hold / release state, the 0x47 soft buttons are left to the UI.
+ *     Params:
+ *         void *ctx - Unused
+ *         uint8_t *pkt - The IBus packet
+ *     Returns:
+ *         void
+ */
+void InputIBusBMBTButton(void *ctx, uint8_t *pkt)
+{
+    if (pkt[IBUS_PKT_CMD] != IBUS_CMD_BMBT_BUTTON1) {
+        return;
+    }
+    uint8_t button = pkt[IBUS_PKT_DB1] & IBUS_DEVICE_BMBT_BUTTON_ID_MASK;
+    uint8_t state = pkt[IBUS_PKT_DB1] & IBUS_DEVICE_BMBT_BUTTON_STATE_MASK;
+    uint8_t type = INPUT_GESTURE_PRESS;
+    if (state == IBUS_DEVICE_BMBT_BUTTON_STATE_HOLD) {
+        type = INPUT_GESTURE_HOLD;
+    } else if (state == IBUS_DEVICE_BMBT_BUTTON_STATE_RELEASE) {
+        type = INPUT_GESTURE_RELEASE;
+    }
+    InputUpdate(INPUT_SOURCE_BMBT, button, type, pkt[IBUS_PKT_DST]);
+}
+
+/**
+ * InputIBusMFLButton()
+ *     Description:
+ *         Classify steering wheel button frames. The R/T button reports the
+ *         telephone mode rather than a press, so it is left to the UI.
+ *     Params:
+ *         void *ctx - Unused
+ *         uint8_t *pkt - The IBus packet
+ *     Returns:
+ *         void
+ */
+void InputIBusMFLButton(void *ctx, uint8_t *pkt)
+{
+    uint8_t button = pkt[IBUS_PKT_DB1] & IBUS_MFL_BTN_ID_MASK;
+    uint8_t state = pkt[IBUS_PKT_DB1] & IBUS_MFL_BTN_STATE_MASK;
+    uint8_t type = INPUT_GESTURE_PRESS;
+    if (button == 0) {
+        return;
+    }
+    if (state == IBUS_MFL_BTN_STATE_HOLD) {
+        type = INPUT_GESTURE_HOLD;
+    } else if (state == IBUS_MFL_BTN_STATE_RELEASE) {
+        type = INPUT_GESTURE_RELEASE;
+    }
+    InputUpdate(INPUT_SOURCE_MFL, button, type, pkt[IBUS_PKT_DST]);
+}
@@ -0,0 +1,92 @@
+/*
+ * File: input.h
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Turn the raw MFL and BMBT button frames into gestures (press, tap,
+ *     hold, repeat and release after a hold) and dispatch them through
+ *     action tables
+ */
+#ifndef INPUT_H
+#define INPUT_H
+#include <stdint.h>
+#include <string.h>
+#include "../mappings.h"
+#include "event.h"
+#include "ibus.h"
+#include "timer.h"
+#define INPUT_SOURCE_MFL 0
+#define INPUT_SOURCE_BMBT 1
+#define INPUT_SOURCE_COUNT 2
+#define INPUT_BUTTON_NONE 0xFF
+// Gestures are bit flags so one binding can match several of them
+#define INPUT_GESTURE_PRESS 0x01
+#define INPUT_GESTURE_TAP 0x02
+#define INPUT_GESTURE_HOLD 0x04
+#define INPUT_GESTURE_REPEAT 0x08
+#define INPUT_GESTURE_HOLD_RELEASE 0x10
+#define INPUT_GESTURE_RELEASE (INPUT_GESTURE_TAP | INPUT_GESTURE_HOLD_RELEASE)
+// Hold frames closer together than this are folded into the last repeat
+#define INPUT_REPEAT_INT 200
+
+/**
+ * InputGesture_t
+ *     Description:
+ *         A button gesture, passed as the data of UIEvent_InputGesture
+ *     Fields:
+ *         source - INPUT_SOURCE_*
+ *         button - The button ID without its state bits, IBUS_MFL_BTN_* or
+ *             the IBUS_DEVICE_BMBT_Button_* press code
+ *         type - The INPUT_GESTURE_* seen
+ *         target - The device the frame was addressed to
+ *         timestamp - When the frame arrived
+ *         duration - How long the button has been down, in milliseconds
+ */
+typedef struct InputGesture_t {
+    uint8_t source;
+    uint8_t button;
+    uint8_t type;
+    uint8_t target;
+    uint32_t timestamp;
+    uint16_t duration;
+} InputGesture_t;
+
+/**
+ * InputBinding_t
+ *     Description:
+ *         An entry in an action table
+ *     Fields:
+ *         source - The INPUT_SOURCE_* to match
+ *         button - The button to match
+ *         gestures - The INPUT_GESTURE_* flags to match
+ *         (*action)(void *, InputGesture_t *) - Called with the table's
+ *             context and the gesture
+ */
+typedef struct InputBinding_t {
+    uint8_t source;
+    uint8_t button;
+    uint8_t gestures;
+    void (*action)(void *, InputGesture_t *);
+} InputBinding_t;
+
+/**
+ * InputButtonState_t
+ *     Description:
+ *         The button that is down on a source
+ *     Fields:
+ *         button - The button or INPUT_BUTTON_NONE
+ *         held - Set once the button has reported a hold
+ *         pressed - When the button went down
+ *         repeated - When the last hold or repeat was dispatched
+ */
+typedef struct InputButtonState_t {
+    uint8_t button;
+    uint8_t held;
+    uint32_t pressed;
+    uint32_t repeated;
+} InputButtonState_t;
+
+void InputInit();
+uint8_t InputDispatch(const InputBinding_t *, uint8_t, void *, InputGesture_t *);
+void InputIBusBMBTButton(void *, uint8_t *);
+void InputIBusMFLButton(void *, uint8_t *);
+#endif /* INPUT_H */
@@ -5,6 +5,25 @@
  *     Utilities for use with the on-board PCM5122 DAC
  */
 #include "pcm51xx.h"
+static unsigned char PCM51XXVolume = 0;
+static uint8_t PCM51XXVolumeWritten = 0;
+
+/**
+ * PCM51XXPowerUp()
+ *     Description:
+ *         Request that the PCM51XX leave power down and run
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+static void PCM51XXPowerUp()
+{
+    int8_t status = I2CWrite(PCM51XX_I2C_ADDR, PCM51XX_REGISTER_REQUEST_STBY_PWRDN, PCM51XX_REQUEST_RUN);
+    if (status != 0x00) {
+        LogError("PCM51XX failed to power up [%d]", status);
+    }
+}
 
 /**
  * PCM51XXInit()
@@ -22,7 +41,7 @@ void PCM51XXInit()
         LogError("PCM51XX Responded with %d during initialization", status);
     } else {
         LogDebug(LOG_SOURCE_SYSTEM, "PCM51XX Responded to Poll");
-        status = I2CWrite(PCM51XX_I2C_ADDR, PCM51XX_REGISTER_REQUEST_STBY_PWRDN, 0x01);
+        status = I2CWrite(PCM51XX_I2C_ADDR, PCM51XX_REGISTER_REQUEST_STBY_PWRDN, PCM51XX_REQUEST_POWERDOWN);
         if (status != 0x00) {
             LogError("PCM51XX failed to power down [%d]", status);
         }
@@ -30,26 +49,77 @@ void PCM51XXInit()
 }
 
 /**
- * PCM51XXPollTimer()
+ * PCM51XXGetVolume()
  *     Description:
- *         Periodically poll the PCM51XX
+ *         Get the volume we last wrote to the device, so it can be checked
+ *         against what the device reports
  *     Params:
- *         void *ctx - The context provided at registration
+ *         void
  *     Returns:
+ *         unsigned char - The volume register value
+ */
+unsigned char PCM51XXGetVolume()
+{
+    return PCM51XXVolume;
+}
+
+/**
+ * PCM51XXRestartOutput()
+ *     Description:
+ *         Take the PCM51XX through standby and back to run, which restarts
+ *         the output stage without touching the configuration
+ *     Params:
  *         void
+ *     Returns:
+ *         int8_t - The I2C status
  */
-void PCM51XXPollTimer(void *ctx)
+int8_t PCM51XXRestartOutput()
 {
-    int8_t status = I2CPoll(PCM51XX_I2C_ADDR);
+    int8_t status = I2CWrite(
+        PCM51XX_I2C_ADDR,
+        PCM51XX_REGISTER_REQUEST_STBY_PWRDN,
+        PCM51XX_REQUEST_STANDBY
+    );
+    if (status == 0x00) {
+        status = I2CWrite(
+            PCM51XX_I2C_ADDR,
+            PCM51XX_REGISTER_REQUEST_STBY_PWRDN,
+            PCM51XX_REQUEST_RUN
+        );
+    }
     if (status != 0x00) {
-        LogError("PCM51XX Responded with %d", status);
+        LogError("PCM51XX failed to restart the output [%d]", status);
+    }
+    return status;
+}
+
+/**
+ * PCM51XXRestore()
+ *     Description:
+ *         Power the PCM51XX back up after it reset and put back the volume
+ *         we last wrote to it, which may be the telephone volume rather
+ *         than the configured one. The configured volume is used if no
+ *         write has succeeded yet.
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void PCM51XXRestore()
+{
+    PCM51XXPowerUp();
+    if (PCM51XXVolumeWritten == 1) {
+        PCM51XXSetVolume(PCM51XXVolume);
+    } else {
+        PCM51XXSetVolume(ConfigGetSetting(CONFIG_SETTING_DAC_AUDIO_VOL));
     }
 }
 
 /**
  * PCM51XXSetVolume()
  *     Description:
- *         Set the PCM51XX Volume
+ *         Set the PCM51XX Volume. The volume is only recorded once both
+ *         channels were written.
  *     Params:
  *         void *ctx - The context provided at registration
  *     Returns:
@@ -61,9 +131,9 @@ void PCM51XXSetVolume(unsigned char volume)
     if (status != 0x00) {
         LogError("PCM51XX Responded with %d", status);
     } else {
-        status = I2CWrite(PCM51XX_I2C_ADDR, PCM51XX_REGISTER_VOLL, volume);
-        if (status != 0x00) {
-            LogError("PCM51XX failed to set VOLL [%d]", status);
+        int8_t leftStatus = I2CWrite(PCM51XX_I2C_ADDR, PCM51XX_REGISTER_VOLL, volume);
+        if (leftStatus != 0x00) {
+            LogError("PCM51XX failed to set VOLL [%d]", leftStatus);
         } else {
             LogDebug(LOG_SOURCE_SYSTEM, "PCM51XX VOLL Set to 0x%02X", volume);
         }
@@ -73,6 +143,10 @@ void PCM51XXSetVolume(unsigned char volume)
         } else {
             LogDebug(LOG_SOURCE_SYSTEM, "PCM51XX VOLR Set to 0x%02X", volume);
         }
+        if (leftStatus == 0x00 && status == 0x00) {
+            PCM51XXVolume = volume;
+            PCM51XXVolumeWritten = 1;
+        }
     }
 }
 
@@ -80,7 +154,7 @@ void PCM51XXSetVolume(unsigned char volume)
  * PCM51XXStartup()
  *     Description:
  *         Initialize our PCM51XX by powering it up and setting the volume
- *         registers. Additionally, begin the poll timer
+ *         registers
  *     Params:
  *         void
  *     Returns:
@@ -88,11 +162,7 @@ void PCM51XXSetVolume(unsigned char volume)
  */
 void PCM51XXStartup()
 {
-    int8_t status = I2CWrite(PCM51XX_I2C_ADDR, PCM51XX_REGISTER_REQUEST_STBY_PWRDN, 0x00);
-    if (status != 0x00) {
-        LogError("PCM51XX failed to power up [%d]", status);
-    }
+    PCM51XXPowerUp();
     unsigned char volume = ConfigGetSetting(CONFIG_SETTING_DAC_AUDIO_VOL);
     PCM51XXSetVolume(volume);
-    TimerRegisterScheduledTask(&PCM51XXPollTimer, 0, PCM51XX_POLL_INT);
 }
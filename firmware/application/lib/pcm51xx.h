@@ -14,9 +14,21 @@
 #define PCM51XX_REGISTER_ERROR_IGNORE 0x25
 #define PCM51XX_REGISTER_VOLL 0x3D
 #define PCM51XX_REGISTER_VOLR 0x3E
-#define PCM51XX_POLL_INT 5000
+// Detected sample rate, SCK ratio (MSB, LSB) and clock error status
+#define PCM51XX_REGISTER_FS_DETECT 0x5B
+#define PCM51XX_REGISTER_CLOCK_STATUS 0x5E
+#define PCM51XX_REGISTER_POWER_STATE 0x76
+#define PCM51XX_REQUEST_POWERDOWN 0x01
+#define PCM51XX_REQUEST_STANDBY 0x10
+#define PCM51XX_REQUEST_RUN 0x00
+#define PCM51XX_POWER_STATE_MASK 0x0F
+#define PCM51XX_POWER_STATE_RUN 0x05
+// The line output is shorted or loaded with too low an impedance
+#define PCM51XX_POWER_STATE_SHORT 0x06
 
 void PCM51XXInit();
-void PCM51XXPollTimer(void *);
+unsigned char PCM51XXGetVolume();
+int8_t PCM51XXRestartOutput();
+void PCM51XXRestore();
 void PCM51XXSetVolume(unsigned char);
 void PCM51XXStartup();
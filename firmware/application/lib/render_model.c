@@ -0,0 +1,247 @@
+/*
+ * File: render_model.c
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     The now playing presentation shared by the MID and BMBT UIs. The text
+ *     is built once per BT state change and the UIs are told to redraw
+ *     from it, one display at a time when both are fitted.
+ */
+#include "render_model.h"
+static RenderModel_t Model;
+
+/**
+ * RenderModelBuild()
+ *     Description:
+ *         Build the presentation from the BT state
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+static void RenderModelBuild()
+{
+    BT_t *bt = Model.bt;
+    char *title = Model.fields[RENDER_MODEL_FIELD_TITLE];
+    char *artist = Model.fields[RENDER_MODEL_FIELD_ARTIST];
+    char *album = Model.fields[RENDER_MODEL_FIELD_ALBUM];
+    const char *metadata[RENDER_MODEL_FIELD_COUNT] = {
+        bt->title,
+        bt->artist,
+        bt->album
+    };
+    uint8_t idx;
+    memset(Model.fields, 0, sizeof(Model.fields));
+    memset(Model.text, 0, UTILS_DISPLAY_TEXT_SIZE);
+    Model.playbackStatus = bt->playbackStatus;
+    Model.hasTitle = strlen(bt->title) > 0;
+    for (idx = 0; idx < RENDER_MODEL_FIELD_COUNT; idx++) {
+        uint8_t length = strlen(Model.text);
+        if (strlen(metadata[idx]) > 0) {
+            snprintf(
+                &Model.text[length],
+                UTILS_DISPLAY_TEXT_SIZE - length,
+                length > 0 ? " - %s" : "%s",
+                metadata[idx]
+            );
+        }
+    }
+    // Many streaming apps do not send the artist or album, so only the
+    // title gets a placeholder
+    if (Model.hasTitle == 1) {
+        UtilsStrncpy(title, bt->title, BT_METADATA_FIELD_SIZE);
+    } else if (bt->playbackStatus == BT_AVRCP_STATUS_PAUSED) {
+        UtilsStrncpy(
+            title,
+            LocaleGetText(LOCALE_STRING_NOT_PLAYING),
+            BT_METADATA_FIELD_SIZE
+        );
+    } else {
+        UtilsStrncpy(
+            title,
+            LocaleGetText(LOCALE_STRING_UNKNOWN_TITLE),
+            BT_METADATA_FIELD_SIZE
+        );
+    }
+    if (Model.hasTitle == 1 || bt->playbackStatus != BT_AVRCP_STATUS_PAUSED) {
+        UtilsStrncpy(artist, bt->artist, BT_METADATA_FIELD_SIZE);
+        UtilsStrncpy(album, bt->album, BT_METADATA_FIELD_SIZE);
+    }
+    // Close the gap left by a missing artist and drop repeated rows
+    if (strlen(artist) == 0) {
+        UtilsStrncpy(artist, album, BT_METADATA_FIELD_SIZE);
+        album[0] = '\0';
+    }
+    if (strlen(album) != 0 && strncmp(artist, album, BT_METADATA_FIELD_SIZE) == 0) {
+        album[0] = '\0';
+    }
+    if (strlen(album) == 0 && strncmp(title, artist, BT_METADATA_FIELD_SIZE) == 0) {
+        artist[0] = '\0';
+    }
+    // The displays keep whatever was in a row that is written empty
+    for (idx = 0; idx < RENDER_MODEL_FIELD_COUNT; idx++) {
+        if (strlen(Model.fields[idx]) == 0) {
+            strncpy(Model.fields[idx], " ", 2);
+        }
+    }
+}
+
+/**
+ * RenderModelNotify()
+ *     Description:
+ *         Tell the UIs to redraw. With both the MID and the BMBT fitted, the
+ *         MID redraw is held back by RENDER_MODEL_STAGGER_INT so the two
+ *         sets of writes do not hit the bus back to back.
+ *     Params:
+ *         uint8_t changes - The RENDER_MODEL_CHANGE_* to report
+ *     Returns:
+ *         void
+ */
+static void RenderModelNotify(uint8_t changes)
+{
+    RenderModelUpdate_t update;
+    update.targets = RENDER_MODEL_TARGET_ALL;
+    update.changes = changes;
+    if (ConfigGetUIMode() == CONFIG_UI_MID_BMBT) {
+        update.targets = RENDER_MODEL_TARGET_BMBT;
+        Model.pendingTargets |= RENDER_MODEL_TARGET_MID;
+        Model.pendingChanges |= changes;
+        TimerResetScheduledTask(Model.updateTaskId);
+    }
+    EventTriggerCallback(UIEvent_RenderModelUpdate, (uint8_t *) &update);
+}
+
+/**
+ * RenderModelGet()
+ *     Description:
+ *         Get the presentation to draw from
+ *     Params:
+ *         void
+ *     Returns:
+ *         RenderModel_t * - The presentation
+ */
+RenderModel_t *RenderModelGet()
+{
+    return &Model;
+}
+
+/**
+ * RenderModelInit()
+ *     Description:
+ *         Build the presentation and start following the BT state
+ *     Params:
+ *         BT_t *bt - The BT context
+ *     Returns:
+ *         void
+ */
+void RenderModelInit(BT_t *bt)
+{
+    memset(&Model, 0, sizeof(RenderModel_t));
+    Model.bt = bt;
+    RenderModelBuild();
+    EventRegisterCallback(
+        BT_EVENT_METADATA_UPDATE,
+        &RenderModelBTMetadata,
+        0
+    );
+    EventRegisterCallback(
+        BT_EVENT_PLAYBACK_STATUS_CHANGE,
+        &RenderModelBTPlaybackStatus,
+        0
+    );
+    EventRegisterCallback(
+        BT_EVENT_METADATA_CLEAR,
+        &RenderModelBTMetadataClear,
+        0
+    );
+    Model.updateTaskId = TimerRegisterScheduledTask(
+        &RenderModelTimerUpdate,
+        0,
+        RENDER_MODEL_STAGGER_INT
+    );
+}
+
+/**
+ * RenderModelRefresh()
+ *     Description:
+ *         Rebuild the presentation without telling the UIs, for changes
+ *         they redraw on their own such as the language changing
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void RenderModelRefresh()
+{
+    RenderModelBuild();
+}
+
+/**
+ * RenderModelBTMetadata()
+ *     Description:
+ *         Rebuild the presentation when the metadata changes
+ *     Params:
+ *         void *ctx - Unused
+ *         uint8_t *data - Unused
+ *     Returns:
+ *         void
+ */
+void RenderModelBTMetadata(void *ctx, uint8_t *data)
+{
+    RenderModelBuild();
+    RenderModelNotify(RENDER_MODEL_CHANGE_METADATA);
+}
+
+/**
+ * RenderModelBTMetadataClear()
+ *     Description:
+ *         Rebuild the presentation when the metadata is cleared. The UIs
+ *         redraw on their own once the device disconnects or stops, so they
+ *         are not told.
+ *     Params:
+ *         void *ctx - Unused
+ *         uint8_t *data - Unused
+ *     Returns:
+ *         void
+ */
+void RenderModelBTMetadataClear(void *ctx, uint8_t *data)
+{
+    RenderModelBuild();
+}
+
+/**
+ * RenderModelBTPlaybackStatus()
+ *     Description:
+ *         Rebuild the presentation when the playback status changes
+ *     Params:
+ *         void *ctx - Unused
+ *         uint8_t *data - Unused
+ *     Returns:
+ *         void
+ */
+void RenderModelBTPlaybackStatus(void *ctx, uint8_t *data)
+{
+    RenderModelBuild();
+    RenderModelNotify(RENDER_MODEL_CHANGE_PLAYBACK);
+}
+
+/**
+ * RenderModelTimerUpdate()
+ *     Description:
+ *         Tell the displays that were held back to redraw
+ *     Params:
+ *         void *ctx - Unused
+ *     Returns:
+ *         void
+ */
+void RenderModelTimerUpdate(void *ctx)
+{
+    RenderModelUpdate_t update;
+    if (Model.pendingTargets == 0) {
+        return;
+    }
+    update.targets = Model.pendingTargets;
+    update.changes = Model.pendingChanges;
+    Model.pendingTargets = 0;
+    Model.pendingChanges = 0;
+    EventTriggerCallback(UIEvent_RenderModelUpdate, (uint8_t *) &update);
+}
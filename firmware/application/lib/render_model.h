@@ -0,0 +1,82 @@
+/*
+ * File: render_model.h
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     The now playing presentation shared by the MID and BMBT UIs. The text
+ *     is built once per BT state change and the UIs are told to redraw
+ *     from it, one display at a time when both are fitted.
+ */
+#ifndef RENDER_MODEL_H
+#define RENDER_MODEL_H
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "../mappings.h"
+#include "bt.h"
+#include "config.h"
+#include "event.h"
+#include "locale.h"
+#include "timer.h"
+#include "utils.h"
+// The gap between the redraws of two displays
+#define RENDER_MODEL_STAGGER_INT 50
+#define RENDER_MODEL_CHANGE_METADATA 0x01
+#define RENDER_MODEL_CHANGE_PLAYBACK 0x02
+#define RENDER_MODEL_TARGET_BMBT 0x01
+#define RENDER_MODEL_TARGET_MID 0x02
+#define RENDER_MODEL_TARGET_ALL (RENDER_MODEL_TARGET_BMBT | RENDER_MODEL_TARGET_MID)
+#define RENDER_MODEL_FIELD_TITLE 0
+#define RENDER_MODEL_FIELD_ARTIST 1
+#define RENDER_MODEL_FIELD_ALBUM 2
+#define RENDER_MODEL_FIELD_COUNT 3
+
+/**
+ * RenderModelUpdate_t
+ *     Description:
+ *         Passed as the data of UIEvent_RenderModelUpdate
+ *     Fields:
+ *         targets - The RENDER_MODEL_TARGET_* displays that should redraw
+ *         changes - The RENDER_MODEL_CHANGE_* since those displays last
+ *             redrew
+ */
+typedef struct RenderModelUpdate_t {
+    uint8_t targets;
+    uint8_t changes;
+} RenderModelUpdate_t;
+
+/**
+ * RenderModel_t
+ *     Description:
+ *         The now playing presentation
+ *     Fields:
+ *         bt - The BT_t the model is built from
+ *         playbackStatus - The BT_AVRCP_STATUS_* the model was built with
+ *         hasTitle - Set if the device sent a title
+ *         fields - The title, artist and album rows with the placeholder
+ *             title filled in and repeated rows blanked, as the dashboard
+ *             shows them
+ *         text - The non-empty metadata fields on one line, for the
+ *             scrolling displays
+ *         updateTaskId - The task that redraws the deferred displays
+ *         pendingTargets - The displays waiting on the update task
+ *         pendingChanges - The changes the waiting displays have not seen
+ */
+typedef struct RenderModel_t {
+    BT_t *bt;
+    uint8_t playbackStatus;
+    uint8_t hasTitle;
+    char fields[RENDER_MODEL_FIELD_COUNT][BT_METADATA_FIELD_SIZE];
+    char text[UTILS_DISPLAY_TEXT_SIZE];
+    uint8_t updateTaskId;
+    uint8_t pendingTargets;
+    uint8_t pendingChanges;
+} RenderModel_t;
+
+RenderModel_t *RenderModelGet();
+void RenderModelInit(BT_t *);
+void RenderModelRefresh();
+void RenderModelBTMetadata(void *, uint8_t *);
+void RenderModelBTMetadataClear(void *, uint8_t *);
+void RenderModelBTPlaybackStatus(void *, uint8_t *);
+void RenderModelTimerUpdate(void *);
+#endif /* RENDER_MODEL_H */
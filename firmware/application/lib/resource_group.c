@@ -0,0 +1,144 @@
+/*
+ * File: resource_group.c
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Track the timers, event callbacks, signal subscriptions and buffer a
+ *     module owns so they can all be released together
+ */
+#include "resource_group.h"
+
+/**
+ * ResourceGroupInit()
+ *     Description:
+ *         Start an empty resource group
+ *     Params:
+ *         ResourceGroup_t *group - The group
+ *         void *buffer - The module state to clear on release, or 0
+ *         uint16_t bufferSize - The size of buffer
+ *     Returns:
+ *         void
+ */
+void ResourceGroupInit(ResourceGroup_t *group, void *buffer, uint16_t bufferSize)
+{
+    memset(group, 0, sizeof(ResourceGroup_t));
+    group->buffer = buffer;
+    group->bufferSize = bufferSize;
+}
+
+/**
+ * ResourceGroupRegisterCallback()
+ *     Description:
+ *         Register an event callback owned by the group
+ *     Params:
+ *         ResourceGroup_t *group - The group
+ *         uint8_t eventType - The event type
+ *         void *callback - Pointer to the function to call when triggered
+ *         void *context - The object to pass to the function
+ *     Returns:
+ *         void
+ */
+void ResourceGroupRegisterCallback(
+    ResourceGroup_t *group,
+    uint8_t eventType,
+    void *callback,
+    void *context
+) {
+    if (group->callbackCount == RESOURCE_GROUP_CALLBACKS_MAX) {
+        LogError("RESOURCE GROUP: Callbacks Full");
+        return;
+    }
+    uint8_t callbackId = EventRegisterCallback(eventType, callback, context);
+    if (callbackId != EVENT_CALLBACK_INVALID) {
+        group->callbacks[group->callbackCount++] = callbackId;
+    }
+}
+
+/**
+ * ResourceGroupRegisterTask()
+ *     Description:
+ *         Register a scheduled task owned by the group
+ *     Params:
+ *         ResourceGroup_t *group - The group
+ *         void *task - A pointer to the function to call
+ *         void *ctx - A pointer to the context for which to pass to the function
+ *         uint16_t interval - The number of milliseconds to elapse before calling
+ *     Returns:
+ *         uint8_t - The index of the scheduled task or TIMER_TASK_INVALID
+ */
+uint8_t ResourceGroupRegisterTask(
+    ResourceGroup_t *group,
+    void *task,
+    void *ctx,
+    uint16_t interval
+) {
+    if (group->taskCount == RESOURCE_GROUP_TASKS_MAX) {
+        LogError("RESOURCE GROUP: Tasks Full");
+        return TIMER_TASK_INVALID;
+    }
+    uint8_t taskId = TimerRegisterScheduledTask(task, ctx, interval);
+    if (taskId != TIMER_TASK_INVALID) {
+        group->tasks[group->taskCount++] = taskId;
+    }
+    return taskId;
+}
+
+/**
+ * ResourceGroupSubscribe()
+ *     Description:
+ *         Subscribe to a vehicle signal on behalf of the group
+ *     Params:
+ *         ResourceGroup_t *group - The group
+ *         uint8_t signal - The signal ID
+ *         uint8_t deadband - The minimum change between notifications
+ *         void *callback - The function to call
+ *         void *context - Passed through to the callback
+ *     Returns:
+ *         void
+ */
+void ResourceGroupSubscribe(
+    ResourceGroup_t *group,
+    uint8_t signal,
+    uint8_t deadband,
+    void *callback,
+    void *context
+) {
+    if (group->subscriptionCount == RESOURCE_GROUP_SUBSCRIPTIONS_MAX) {
+        LogError("RESOURCE GROUP: Subscriptions Full");
+        return;
+    }
+    uint8_t subscriptionId = VehicleSubscribe(signal, deadband, callback, context);
+    if (subscriptionId != VEHICLE_SUBSCRIPTION_INVALID) {
+        group->subscriptions[group->subscriptionCount++] = subscriptionId;
+    }
+}
+
+/**
+ * ResourceGroupRelease()
+ *     Description:
+ *         Free every slot the group holds and clear its buffer. The slots are
+ *         reused by the next registrations, so tearing a module down and
+ *         starting it again does not use up the queues.
+ *     Params:
+ *         ResourceGroup_t *group - The group
+ *     Returns:
+ *         void
+ */
+void ResourceGroupRelease(ResourceGroup_t *group)
+{
+    uint8_t idx;
+    for (idx = 0; idx < group->taskCount; idx++) {
+        TimerUnregisterScheduledTaskById(group->tasks[idx]);
+    }
+    for (idx = 0; idx < group->callbackCount; idx++) {
+        EventUnregisterCallbackById(group->callbacks[idx]);
+    }
+    for (idx = 0; idx < group->subscriptionCount; idx++) {
+        VehicleUnsubscribeById(group->subscriptions[idx]);
+    }
+    if (group->buffer != 0) {
+        memset(group->buffer, 0, group->bufferSize);
+    }
+    group->callbackCount = 0;
+    group->taskCount = 0;
+    group->subscriptionCount = 0;
+}
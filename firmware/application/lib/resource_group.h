@@ -0,0 +1,52 @@
+/*
+ * File: resource_group.h
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Track the timers, event callbacks, signal subscriptions and buffer a
+ *     module owns so they can all be released together
+ */
+#ifndef RESOURCE_GROUP_H
+#define RESOURCE_GROUP_H
+#include <stdint.h>
+#include <string.h>
+#include "event.h"
+#include "log.h"
+#include "timer.h"
+#include "vehicle.h"
+#define RESOURCE_GROUP_CALLBACKS_MAX 24
+#define RESOURCE_GROUP_TASKS_MAX 4
+#define RESOURCE_GROUP_SUBSCRIPTIONS_MAX 4
+
+/**
+ * ResourceGroup_t
+ *     Description:
+ *         The resources a module holds, by their index in the event queue,
+ *         the scheduled task array and the vehicle subscriptions. Releasing
+ *         the group frees each slot directly instead of searching for it.
+ *     Fields:
+ *         callbacks - The event callback indices
+ *         callbackCount - The number of event callbacks held
+ *         tasks - The scheduled task indices
+ *         taskCount - The number of scheduled tasks held
+ *         subscriptions - The vehicle subscription indices
+ *         subscriptionCount - The number of vehicle subscriptions held
+ *         *buffer - The module state to clear on release
+ *         bufferSize - The size of buffer
+ */
+typedef struct ResourceGroup_t {
+    uint8_t callbacks[RESOURCE_GROUP_CALLBACKS_MAX];
+    uint8_t callbackCount;
+    uint8_t tasks[RESOURCE_GROUP_TASKS_MAX];
+    uint8_t taskCount;
+    uint8_t subscriptions[RESOURCE_GROUP_SUBSCRIPTIONS_MAX];
+    uint8_t subscriptionCount;
+    void *buffer;
+    uint16_t bufferSize;
+} ResourceGroup_t;
+
+void ResourceGroupInit(ResourceGroup_t *, void *, uint16_t);
+void ResourceGroupRegisterCallback(ResourceGroup_t *, uint8_t, void *, void *);
+uint8_t ResourceGroupRegisterTask(ResourceGroup_t *, void *, void *, uint16_t);
+void ResourceGroupSubscribe(ResourceGroup_t *, uint8_t, uint8_t, void *, void *);
+void ResourceGroupRelease(ResourceGroup_t *);
+#endif /* RESOURCE_GROUP_H */
@@ -0,0 +1,176 @@
+/*
+ * File: sniffer.c
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Stream the IBus frames we see and send over the system UART as
+ *     compact binary records, for capture with utility/ibus_sniffer.py
+ */
+#include "sniffer.h"
+static SnifferContext_t Sniffer;
+
+/**
+ * SnifferGetFree()
+ *     Description:
+ *         Get the space left in the record ring
+ *     Params:
+ *         void
+ *     Returns:
+ *         uint16_t - The free bytes
+ */
+static uint16_t SnifferGetFree()
+{
+    return (Sniffer.tail + SNIFFER_BUFFER_SIZE - Sniffer.head - 1) % SNIFFER_BUFFER_SIZE;
+}
+
+/**
+ * SnifferPut()
+ *     Description:
+ *         Append a byte to the record ring
+ *     Params:
+ *         uint8_t byte - The byte
+ *     Returns:
+ *         void
+ */
+static void SnifferPut(uint8_t byte)
+{
+    Sniffer.buffer[Sniffer.head] = byte;
+    Sniffer.head = (Sniffer.head + 1) % SNIFFER_BUFFER_SIZE;
+}
+
+/**
+ * SnifferAddRecord()
+ *     Description:
+ *         Encode a record into the ring. The record is laid out as
+ *         A5 5A <type> <length> <timestamp, 4 bytes LE> <data> <checksum>,
+ *         where the checksum is the XOR of the type through the data.
+ *     Params:
+ *         uint8_t type - The SNIFFER_RECORD_*
+ *         const uint8_t *data - The record data
+ *         uint8_t length - The length of the data
+ *     Returns:
+ *         uint8_t - 1 if the record was queued, 0 if there was no room
+ */
+static uint8_t SnifferAddRecord(uint8_t type, const uint8_t *data, uint8_t length)
+{
+    if (SnifferGetFree() < (uint16_t) length + SNIFFER_RECORD_OVERHEAD) {
+        return 0;
+    }
+    uint32_t timestamp = TimerGetMicros();
+    uint8_t header[6] = {
+        type,
+        length,
+        timestamp & 0xFF,
+        (timestamp >> 8) & 0xFF,
+        (timestamp >> 16) & 0xFF,
+        (timestamp >> 24) & 0xFF
+    };
+    uint8_t checksum = 0;
+    uint8_t idx;
+    SnifferPut(SNIFFER_SYNC_ONE);
+    SnifferPut(SNIFFER_SYNC_TWO);
+    for (idx = 0; idx < sizeof(header); idx++) {
+        SnifferPut(header[idx]);
+        checksum ^= header[idx];
+    }
+    for (idx = 0; idx < length; idx++) {
+        SnifferPut(data[idx]);
+        checksum ^= data[idx];
+    }
+    SnifferPut(checksum);
+    return 1;
+}
+
+/**
+ * SnifferAddFrame()
+ *     Description:
+ *         Queue an IBus frame to be streamed. Frames that do not fit are
+ *         counted as dropped, and the count goes out in a DROP record ahead
+ *         of the next frame that fits so the capture shows where the gap is.
+ *     Params:
+ *         uint8_t type - The SNIFFER_RECORD_*
+ *         const uint8_t *frame - The IBus frame
+ *         uint8_t length - The length of the frame
+ *     Returns:
+ *         void
+ */
+void SnifferAddFrame(uint8_t type, const uint8_t *frame, uint8_t length)
+{
+    if (Sniffer.enabled == 0) {
+        return;
+    }
+    if (Sniffer.dropped != Sniffer.droppedSent &&
+        SnifferGetFree() >= (uint16_t) length + (SNIFFER_RECORD_OVERHEAD * 2) + 4
+    ) {
+        uint8_t count[4] = {
+            Sniffer.dropped & 0xFF,
+            (Sniffer.dropped >> 8) & 0xFF,
+            (Sniffer.dropped >> 16) & 0xFF,
+            (Sniffer.dropped >> 24) & 0xFF
+        };
+        SnifferAddRecord(SNIFFER_RECORD_DROP, count, sizeof(count));
+        Sniffer.droppedSent = Sniffer.dropped;
+    }
+    if (SnifferAddRecord(type, frame, length) == 1) {
+        Sniffer.records++;
+    } else {
+        Sniffer.dropped++;
+    }
+}
+
+/**
+ * SnifferProcess()
+ *     Description:
+ *         Send the oldest queued record. Whole records are sent so that log
+ *         text written between calls never lands inside of one.
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void SnifferProcess()
+{
+    if (Sniffer.head == Sniffer.tail) {
+        return;
+    }
+    UART_t *uart = UARTGetModuleHandler(SYSTEM_UART_MODULE);
+    if (uart == 0) {
+        return;
+    }
+    uint16_t length = Sniffer.buffer[(Sniffer.tail + 3) % SNIFFER_BUFFER_SIZE] +
+        SNIFFER_RECORD_OVERHEAD;
+    while (length > 0) {
+        uart->registers->uxtxreg = Sniffer.buffer[Sniffer.tail];
+        // Wait for the data to leave the tx buffer
+        while ((uart->registers->uxsta & (1 << 9)) != 0);
+        Sniffer.tail = (Sniffer.tail + 1) % SNIFFER_BUFFER_SIZE;
+        length--;
+    }
+}
+
+/**
+ * SnifferSetEnabled()
+ *     Description:
+ *         Start or stop streaming. Stopping sends what is still queued and
+ *         then logs the record and drop counts.
+ *     Params:
+ *         uint8_t enabled - 1 to stream, 0 to stop
+ *     Returns:
+ *         void
+ */
+void SnifferSetEnabled(uint8_t enabled)
+{
+    if (enabled == 1) {
+        memset(&Sniffer, 0, sizeof(SnifferContext_t));
+        Sniffer.enabled = 1;
+        return;
+    }
+    Sniffer.enabled = 0;
+    while (Sniffer.head != Sniffer.tail) {
+        SnifferProcess();
+    }
+    LogRaw(
+        "Sniffer: %lu records, %lu dropped\r\n",
+        Sniffer.records,
+        Sniffer.dropped
+    );
+}
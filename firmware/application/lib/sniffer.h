@@ -0,0 +1,57 @@
+/*
+ * File: sniffer.h
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Stream the IBus frames we see and send over the system UART as
+ *     compact binary records, for capture with utility/ibus_sniffer.py
+ */
+#ifndef SNIFFER_H
+#define SNIFFER_H
+#include <stdint.h>
+#include <string.h>
+#include "../mappings.h"
+#include "log.h"
+#include "timer.h"
+#include "uart.h"
+#define SNIFFER_BUFFER_SIZE 512
+#define SNIFFER_SYNC_ONE 0xA5
+#define SNIFFER_SYNC_TWO 0x5A
+// Sync (2) + Type + Length + Timestamp (4) + Checksum
+#define SNIFFER_RECORD_OVERHEAD 9
+#define SNIFFER_RECORD_RX 0x01
+#define SNIFFER_RECORD_TX 0x02
+// A frame we received that matched the one we last sent
+#define SNIFFER_RECORD_ECHO 0x03
+#define SNIFFER_RECORD_RX_BAD_CHECKSUM 0x04
+// Carries the total records dropped so far, as a 32-bit LE value
+#define SNIFFER_RECORD_DROP 0x05
+
+/**
+ * SnifferContext_t
+ *     Description:
+ *         The records waiting to go out over the system UART
+ *     Fields:
+ *         buffer - A ring of encoded records
+ *         head - The index the next byte is written to
+ *         tail - The index the next byte is sent from, always the start of
+ *             a record
+ *         enabled - Set while sniffing
+ *         records - The records queued since sniffing started
+ *         dropped - The records dropped since sniffing started, because
+ *             the UART could not keep up
+ *         droppedSent - The drop count last reported in a DROP record
+ */
+typedef struct SnifferContext_t {
+    uint8_t buffer[SNIFFER_BUFFER_SIZE];
+    uint16_t head;
+    uint16_t tail;
+    uint8_t enabled;
+    uint32_t records;
+    uint32_t dropped;
+    uint32_t droppedSent;
+} SnifferContext_t;
+
+void SnifferAddFrame(uint8_t, const uint8_t *, uint8_t);
+void SnifferProcess();
+void SnifferSetEnabled(uint8_t);
+#endif /* SNIFFER_H */
@@ -0,0 +1,411 @@
+/*
+ * File: telemetry.c
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Record vehicle signals into a ring of EEPROM pages so trips can be
+ *     exported and analysed later
+ */
+#include "telemetry.h"
+static Telemetry_t Telemetry;
+
+/**
+ * TelemetryPutVarint()
+ *     Description:
+ *         Write an unsigned LEB128 varint
+ *     Params:
+ *         uint8_t *buffer - Where to write it
+ *         uint32_t value - The value to write
+ *     Returns:
+ *         uint8_t - The number of bytes written
+ */
+static uint8_t TelemetryPutVarint(uint8_t *buffer, uint32_t value)
+{
+    uint8_t length = 0;
+    while (value >= 0x80) {
+        buffer[length++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    buffer[length++] = value;
+    return length;
+}
+
+/**
+ * TelemetryGetSlotAddress()
+ *     Description:
+ *         Get the EEPROM address of a ring slot
+ *     Params:
+ *         uint16_t slot - The ring slot
+ *     Returns:
+ *         uint32_t - The address of the first byte of the slot
+ */
+static uint32_t TelemetryGetSlotAddress(uint16_t slot)
+{
+    return TELEMETRY_EEPROM_START + ((uint32_t) slot * TELEMETRY_PAGE_SIZE);
+}
+
+/**
+ * TelemetryPageStart()
+ *     Description:
+ *         Start filling a new page at the given tick
+ *     Params:
+ *         uint32_t now - The current tick
+ *     Returns:
+ *         void
+ */
+static void TelemetryPageStart(uint32_t now)
+{
+    memset(Telemetry.page, TELEMETRY_RECORD_END, TELEMETRY_PAGE_SIZE);
+    memset(Telemetry.pageValues, 0, sizeof(Telemetry.pageValues));
+    Telemetry.page[0] = TELEMETRY_PAGE_MAGIC;
+    Telemetry.page[1] = Telemetry.sequence & 0xFF;
+    Telemetry.page[2] = Telemetry.sequence >> 8;
+    Telemetry.page[3] = Telemetry.session;
+    Telemetry.page[4] = now & 0xFF;
+    Telemetry.page[5] = (now >> 8) & 0xFF;
+    Telemetry.page[6] = (now >> 16) & 0xFF;
+    Telemetry.page[7] = (now >> 24) & 0xFF;
+    Telemetry.pageLength = TELEMETRY_PAGE_HEADER_SIZE;
+    Telemetry.lastTick = now;
+}
+
+/**
+ * TelemetryEncode()
+ *     Description:
+ *         Encode a record against the state of the current page
+ *     Params:
+ *         uint8_t *buffer - At least TELEMETRY_RECORD_MAX_SIZE bytes
+ *         uint8_t signal - The signal ID
+ *         int16_t value - The value
+ *         uint32_t now - The current tick
+ *     Returns:
+ *         uint8_t - The length of the record
+ */
+static uint8_t TelemetryEncode(
+    uint8_t *buffer,
+    uint8_t signal,
+    int16_t value,
+    uint32_t now
+) {
+    int32_t delta = (int32_t) value - Telemetry.pageValues[signal];
+    uint32_t zigzag = ((uint32_t) delta << 1) ^ (uint32_t) (delta >> 31);
+    uint8_t length = 0;
+    buffer[length++] = signal;
+    length += TelemetryPutVarint(&buffer[length], now - Telemetry.lastTick);
+    length += TelemetryPutVarint(&buffer[length], zigzag);
+    return length;
+}
+
+/**
+ * TelemetrySample()
+ *     Description:
+ *         Record a vehicle signal if we know it and it has changed since it
+ *         was last recorded
+ *     Params:
+ *         uint8_t signal - The telemetry signal ID
+ *         uint8_t vehicleSignal - The vehicle signal to read it from
+ *     Returns:
+ *         void
+ */
+static void TelemetrySample(uint8_t signal, uint8_t vehicleSignal)
+{
+    if (VehicleGetSignalStatus(vehicleSignal) != VEHICLE_SIGNAL_STATUS_VALID) {
+        return;
+    }
+    int16_t value = VehicleGetSignal(vehicleSignal);
+    if ((Telemetry.recordedMask & (1 << signal)) == 0 ||
+        Telemetry.recorded[signal] != value
+    ) {
+        TelemetryRecord(signal, value);
+    }
+}
+
+/**
+ * TelemetryInit()
+ *     Description:
+ *         Find the newest page in the ring so recording carries on after it,
+ *         then start listening for the signals we record
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+void TelemetryInit()
+{
+    uint8_t header[TELEMETRY_PAGE_HEADER_SIZE];
+    uint16_t slot;
+    uint8_t found = 0;
+    memset(&Telemetry, 0, sizeof(Telemetry_t));
+    for (slot = 0; slot < TELEMETRY_PAGE_COUNT; slot++) {
+        EEPROMReadBytes(TelemetryGetSlotAddress(slot), header, 4);
+        if (header[0] != TELEMETRY_PAGE_MAGIC) {
+            continue;
+        }
+        Telemetry.pagesUsed++;
+        uint16_t sequence = header[1] | ((uint16_t) header[2] << 8);
+        // Sequence numbers wrap, so compare them by their difference
+        if (found == 0 || (int16_t) (sequence - Telemetry.sequence) > 0) {
+            found = 1;
+            Telemetry.sequence = sequence;
+            Telemetry.session = header[3];
+            Telemetry.pageSlot = slot;
+        }
+    }
+    if (found == 1) {
+        Telemetry.sequence++;
+        Telemetry.session++;
+        Telemetry.pageSlot = (Telemetry.pageSlot + 1) % TELEMETRY_PAGE_COUNT;
+    }
+    TimerRegisterScheduledTask(
+        &TelemetryTimerSample,
+        &Telemetry,
+        TELEMETRY_TICK_MS
+    );
+    EventRegisterCallback(
+        IBUS_EVENT_IKEIgnitionStatus,
+        &TelemetryIBusIgnitionStatus,
+        &Telemetry
+    );
+    VehicleSubscribe(
+        VEHICLE_SIGNAL_GEAR_POSITION,
+        0,
+        &TelemetryVehicleGearPosition,
+        &Telemetry
+    );
+}
+
+/**
+ * TelemetryClear()
+ *     Description:
+ *         Drop all recorded pages
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+void TelemetryClear()
+{
+    uint16_t slot;
+    for (slot = 0; slot < TELEMETRY_PAGE_COUNT; slot++) {
+        if (EEPROMReadByte(TelemetryGetSlotAddress(slot)) == TELEMETRY_PAGE_MAGIC) {
+            EEPROMWriteByte(TelemetryGetSlotAddress(slot), 0x00);
+        }
+    }
+    Telemetry.pageLength = 0;
+    Telemetry.pageSlot = 0;
+    Telemetry.pagesUsed = 0;
+    Telemetry.recordedMask = 0;
+}
+
+/**
+ * TelemetryDump()
+ *     Description:
+ *         Write out every recorded page, oldest first, as hex for
+ *         telemetry_export.py to decode. The page being filled is written to
+ *         the EEPROM first so it is included.
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+void TelemetryDump()
+{
+    uint8_t page[TELEMETRY_PAGE_SIZE];
+    char line[(TELEMETRY_PAGE_SIZE * 2) + 1];
+    uint16_t idx;
+    uint8_t byte;
+    TelemetryFlush();
+    LogRaw("TLM:BEGIN,%u,%u\r\n", TELEMETRY_PAGE_SIZE, TELEMETRY_TICK_MS);
+    // The next slot to be written holds the oldest page once the ring wraps
+    for (idx = 0; idx < TELEMETRY_PAGE_COUNT; idx++) {
+        uint16_t slot = (Telemetry.pageSlot + idx) % TELEMETRY_PAGE_COUNT;
+        EEPROMReadBytes(TelemetryGetSlotAddress(slot), page, TELEMETRY_PAGE_SIZE);
+        if (page[0] != TELEMETRY_PAGE_MAGIC) {
+            continue;
+        }
+        for (byte = 0; byte < TELEMETRY_PAGE_SIZE; byte++) {
+            snprintf(&line[byte * 2], 3, "%02X", page[byte]);
+        }
+        LogRaw("TLM:%s\r\n", line);
+    }
+    LogRaw("TLM:END\r\n");
+}
+
+/**
+ * TelemetryFlush()
+ *     Description:
+ *         Write the page being filled to its ring slot in one page write and
+ *         move on to the next slot
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+void TelemetryFlush()
+{
+    if (Telemetry.pageLength <= TELEMETRY_PAGE_HEADER_SIZE) {
+        return;
+    }
+    uint32_t address = TelemetryGetSlotAddress(Telemetry.pageSlot);
+    if (EEPROMReadByte(address) != TELEMETRY_PAGE_MAGIC) {
+        Telemetry.pagesUsed++;
+    }
+    EEPROMWritePage(address, Telemetry.page, TELEMETRY_PAGE_SIZE);
+    Telemetry.pageSlot = (Telemetry.pageSlot + 1) % TELEMETRY_PAGE_COUNT;
+    Telemetry.sequence++;
+    Telemetry.pageLength = 0;
+}
+
+/**
+ * TelemetryIsEnabled()
+ *     Description:
+ *         The recorder runs if either sampling rate is set
+ *     Params:
+ *         None
+ *     Returns:
+ *         uint8_t - 1 if enabled, 0 otherwise
+ */
+uint8_t TelemetryIsEnabled()
+{
+    if (ConfigGetSetting(CONFIG_SETTING_TELEMETRY_FAST_RATE) != 0 ||
+        ConfigGetSetting(CONFIG_SETTING_TELEMETRY_SLOW_RATE) != 0
+    ) {
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * TelemetryRecord()
+ *     Description:
+ *         Append a record to the current page. When the record does not fit,
+ *         the page is written out and the record starts the next one.
+ *     Params:
+ *         uint8_t signal - The telemetry signal ID
+ *         int16_t value - The value
+ *     Returns:
+ *         void
+ */
+void TelemetryRecord(uint8_t signal, int16_t value)
+{
+    uint8_t record[TELEMETRY_RECORD_MAX_SIZE];
+    uint8_t length;
+    uint32_t now = TimerGetMillis() / TELEMETRY_TICK_MS;
+    if (signal >= TELEMETRY_SIGNAL_COUNT) {
+        return;
+    }
+    if (Telemetry.pageLength == 0) {
+        TelemetryPageStart(now);
+    }
+    length = TelemetryEncode(record, signal, value, now);
+    if (Telemetry.pageLength + length > TELEMETRY_PAGE_SIZE) {
+        TelemetryFlush();
+        TelemetryPageStart(now);
+        length = TelemetryEncode(record, signal, value, now);
+    }
+    memcpy(&Telemetry.page[Telemetry.pageLength], record, length);
+    Telemetry.pageLength += length;
+    Telemetry.pageValues[signal] = value;
+    Telemetry.lastTick = now;
+    Telemetry.recorded[signal] = value;
+    Telemetry.recordedMask |= 1 << signal;
+}
+
+/**
+ * TelemetryStatus()
+ *     Description:
+ *         Print the recorder configuration and usage
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+void TelemetryStatus()
+{
+    LogRaw(
+        "Telemetry: %s, speed / RPM every %dms, temperatures every %ds\r\n",
+        TelemetryIsEnabled() == 1 ? "ON" : "OFF",
+        ConfigGetSetting(CONFIG_SETTING_TELEMETRY_FAST_RATE) * TELEMETRY_TICK_MS,
+        ConfigGetSetting(CONFIG_SETTING_TELEMETRY_SLOW_RATE)
+    );
+    LogRaw(
+        "Pages: %u / %u, Session: %d, Next Sequence: %u\r\n",
+        Telemetry.pagesUsed,
+        TELEMETRY_PAGE_COUNT,
+        Telemetry.session,
+        Telemetry.sequence
+    );
+}
+
+/**
+ * TelemetryIBusIgnitionStatus()
+ *     Description:
+ *         Record ignition changes, and write out the page when the ignition
+ *         turns off since the power may go with it
+ *     Params:
+ *         void *ctx - The context provided at registration
+ *         uint8_t *ignitionStatus - The new ignition status
+ *     Returns:
+ *         void
+ */
+void TelemetryIBusIgnitionStatus(void *ctx, uint8_t *ignitionStatus)
+{
+    Telemetry_t *context = (Telemetry_t *) ctx;
+    if (TelemetryIsEnabled() == 0) {
+        return;
+    }
+    if ((context->recordedMask & (1 << TELEMETRY_SIGNAL_IGNITION)) == 0 ||
+        context->recorded[TELEMETRY_SIGNAL_IGNITION] != *ignitionStatus
+    ) {
+        TelemetryRecord(TELEMETRY_SIGNAL_IGNITION, *ignitionStatus);
+    }
+    if (*ignitionStatus == IBUS_IGNITION_OFF) {
+        TelemetryFlush();
+    }
+}
+
+/**
+ * TelemetryVehicleGearPosition()
+ *     Description:
+ *         Record gear changes as they happen
+ *     Params:
+ *         void *ctx - The context provided at registration
+ *         uint8_t *signal - The vehicle signal ID
+ *     Returns:
+ *         void
+ */
+void TelemetryVehicleGearPosition(void *ctx, uint8_t *signal)
+{
+    if (TelemetryIsEnabled() == 1) {
+        TelemetrySample(TELEMETRY_SIGNAL_GEAR_POSITION, *signal);
+    }
+}
+
+/**
+ * TelemetryTimerSample()
+ *     Description:
+ *         Sample speed and RPM at the fast rate and the temperatures at the
+ *         slow rate. Values that have not changed are not recorded.
+ *     Params:
+ *         void *ctx - The context provided at registration
+ *     Returns:
+ *         void
+ */
+void TelemetryTimerSample(void *ctx)
+{
+    Telemetry_t *context = (Telemetry_t *) ctx;
+    uint8_t fastRate = ConfigGetSetting(CONFIG_SETTING_TELEMETRY_FAST_RATE);
+    uint8_t slowRate = ConfigGetSetting(CONFIG_SETTING_TELEMETRY_SLOW_RATE);
+    if (fastRate != 0 && ++context->fastTicks >= fastRate) {
+        context->fastTicks = 0;
+        TelemetrySample(TELEMETRY_SIGNAL_SPEED, VEHICLE_SIGNAL_SPEED);
+        TelemetrySample(TELEMETRY_SIGNAL_RPM, VEHICLE_SIGNAL_RPM);
+    }
+    if (slowRate != 0 &&
+        ++context->slowTicks >= (uint16_t) slowRate * TELEMETRY_SLOW_RATE_TICKS
+    ) {
+        context->slowTicks = 0;
+        TelemetrySample(TELEMETRY_SIGNAL_COOLANT_TEMP, VEHICLE_SIGNAL_COOLANT_TEMP);
+        TelemetrySample(TELEMETRY_SIGNAL_AMBIENT_TEMP, VEHICLE_SIGNAL_AMBIENT_TEMP);
+        TelemetrySample(TELEMETRY_SIGNAL_OIL_TEMP, VEHICLE_SIGNAL_OIL_TEMP);
+    }
+}
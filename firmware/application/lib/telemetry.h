@@ -0,0 +1,104 @@
+/*
+ * File: telemetry.h
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Record vehicle signals into a ring of EEPROM pages so trips can be
+ *     exported and analysed later
+ */
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "config.h"
+#include "eeprom.h"
+#include "event.h"
+#include "ibus.h"
+#include "log.h"
+#include "timer.h"
+#include "vehicle.h"
+// EEPROM 0x0480 - 0x3FFF. Fits the smallest part we ship and is page aligned.
+#define TELEMETRY_EEPROM_START 0x0480
+#define TELEMETRY_EEPROM_END 0x4000
+#define TELEMETRY_PAGE_SIZE EEPROM_PAGE_SIZE
+#define TELEMETRY_PAGE_COUNT ((TELEMETRY_EEPROM_END - TELEMETRY_EEPROM_START) / TELEMETRY_PAGE_SIZE)
+/*
+ * Page layout:
+ *     0     - TELEMETRY_PAGE_MAGIC
+ *     1 - 2 - Sequence number, little endian. Increments per page written.
+ *     3     - Session, increments once per boot
+ *     4 - 7 - Time of the page in ticks since boot, little endian
+ *     8 ... - Records, padded out with TELEMETRY_RECORD_END
+ *
+ * Record layout:
+ *     Signal ID
+ *     Ticks since the previous record in the page (or the page time),
+ *         as an unsigned LEB128 varint
+ *     Change from the previous value of that signal in the page (the first
+ *         value of a signal in a page is stored against 0), zigzag encoded
+ *         as an unsigned LEB128 varint
+ *
+ * Every page decodes on its own, so losing or overwriting a page never
+ * corrupts its neighbours.
+ */
+#define TELEMETRY_PAGE_MAGIC 0xB7
+#define TELEMETRY_PAGE_HEADER_SIZE 8
+#define TELEMETRY_RECORD_END 0xFF
+// ID + 5 byte tick delta + 3 byte value delta
+#define TELEMETRY_RECORD_MAX_SIZE 9
+#define TELEMETRY_TICK_MS 100
+#define TELEMETRY_SIGNAL_SPEED 0
+#define TELEMETRY_SIGNAL_RPM 1
+#define TELEMETRY_SIGNAL_COOLANT_TEMP 2
+#define TELEMETRY_SIGNAL_AMBIENT_TEMP 3
+#define TELEMETRY_SIGNAL_OIL_TEMP 4
+#define TELEMETRY_SIGNAL_GEAR_POSITION 5
+#define TELEMETRY_SIGNAL_IGNITION 6
+#define TELEMETRY_SIGNAL_COUNT 7
+// The slow rate is set in seconds, the fast rate in ticks
+#define TELEMETRY_SLOW_RATE_TICKS (1000 / TELEMETRY_TICK_MS)
+
+/**
+ * Telemetry_t
+ *     Description:
+ *         The recorder state
+ *     Fields:
+ *         page - The page being filled
+ *         pageLength - The bytes used in page, 0 if no page has been started
+ *         pageSlot - The ring slot that page will be written to
+ *         pagesUsed - The number of slots holding a page
+ *         sequence - The sequence number of page
+ *         session - The session of this boot
+ *         lastTick - The tick of the last record in page
+ *         pageValues - The last value of each signal in page, for deltas
+ *         recorded - The last value recorded for each signal
+ *         recordedMask - Bit n is set once signal n has been recorded
+ *         fastTicks - Ticks since speed and RPM were sampled
+ *         slowTicks - Ticks since the temperatures were sampled
+ */
+typedef struct Telemetry_t {
+    uint8_t page[TELEMETRY_PAGE_SIZE];
+    uint8_t pageLength;
+    uint16_t pageSlot;
+    uint16_t pagesUsed;
+    uint16_t sequence;
+    uint8_t session;
+    uint32_t lastTick;
+    int16_t pageValues[TELEMETRY_SIGNAL_COUNT];
+    int16_t recorded[TELEMETRY_SIGNAL_COUNT];
+    uint8_t recordedMask;
+    uint16_t fastTicks;
+    uint16_t slowTicks;
+} Telemetry_t;
+
+void TelemetryInit();
+void TelemetryClear();
+void TelemetryDump();
+void TelemetryFlush();
+uint8_t TelemetryIsEnabled();
+void TelemetryRecord(uint8_t, int16_t);
+void TelemetryStatus();
+void TelemetryIBusIgnitionStatus(void *, uint8_t *);
+void TelemetryVehicleGearPosition(void *, uint8_t *);
+void TelemetryTimerSample(void *);
+#endif /* TELEMETRY_H */
@@ -0,0 +1,229 @@
+/*
+ * File: text_layout.c
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Split display text into the segments a display shows one at a time.
+ *     Chunks are worked out once when the text changes and scroll windows
+ *     follow from their index, so the scrolling timers only copy the next
+ *     one out.
+ */
+#include "text_layout.h"
+
+/**
+ * TextLayoutAdd()
+ *     Description:
+ *         Append a chunk to a layout
+ *     Params:
+ *         TextLayout_t *layout - The layout
+ *         uint8_t start - The index of the first character
+ *         uint8_t length - The number of characters
+ *     Returns:
+ *         void
+ */
+static void TextLayoutAdd(TextLayout_t *layout, uint8_t start, uint8_t length)
+{
+    if (layout->count < TEXT_LAYOUT_MAX_CHUNKS) {
+        layout->chunks[layout->count].start = start;
+        layout->chunks[layout->count].length = length;
+        layout->count++;
+    }
+}
+
+/**
+ * TextLayoutBuildChunks()
+ *     Description:
+ *         Split the text into display sized chunks, breaking at the last
+ *         space that fits so words are not cut unless they are wider than
+ *         the display
+ *     Params:
+ *         TextLayout_t *layout - The layout
+ *         const char *text - The text
+ *         uint8_t length - The length of the text
+ *     Returns:
+ *         void
+ */
+static void TextLayoutBuildChunks(TextLayout_t *layout, const char *text, uint8_t length)
+{
+    uint8_t width = layout->profile->width;
+    uint16_t pos = 0;
+    while (pos < length) {
+        uint16_t end = pos + width;
+        if (end >= length) {
+            TextLayoutAdd(layout, pos, length - pos);
+            return;
+        }
+        if (text[end] != ' ') {
+            uint16_t idx = end - 1;
+            while (idx > pos && text[idx] != ' ') {
+                idx--;
+            }
+            if (idx > pos) {
+                end = idx;
+            }
+        }
+        TextLayoutAdd(layout, pos, end - pos);
+        // The next chunk starts at the next word
+        pos = end;
+        while (pos < length && text[pos] == ' ') {
+            pos++;
+        }
+    }
+}
+
+/**
+ * TextLayoutGetScrollStart()
+ *     Description:
+ *         Get the first scroll window from the given one that is shown.
+ *         Scrolling past a window that starts with a space gives a smooth
+ *         scroll on displays that drop leading spaces.
+ *     Params:
+ *         TextLayout_t *layout - The layout
+ *         const char *text - The text the layout was prepared with
+ *         uint8_t start - The window to start looking from
+ *     Returns:
+ *         uint8_t - The start of the window
+ */
+static uint8_t TextLayoutGetScrollStart(
+    TextLayout_t *layout,
+    const char *text,
+    uint8_t start
+) {
+    if (layout->profile->leadingSpace == TEXT_LAYOUT_SPACE_SKIP) {
+        // The last window is always shown
+        while (start + 1 < layout->count && text[start] == ' ') {
+            start++;
+        }
+    }
+    return start;
+}
+
+/**
+ * TextLayoutGetSegment()
+ *     Description:
+ *         Copy a segment out ready to send to the display
+ *     Params:
+ *         TextLayout_t *layout - The layout
+ *         const char *text - The text the layout was prepared with
+ *         uint8_t segment - The segment to copy
+ *         char *output - The buffer to copy to, at least the display width
+ *             + 1 for the terminator
+ *     Returns:
+ *         uint8_t - The length of the segment, 0 if it does not exist
+ */
+uint8_t TextLayoutGetSegment(
+    TextLayout_t *layout,
+    const char *text,
+    uint8_t segment,
+    char *output
+) {
+    uint8_t start = 0;
+    uint8_t length = layout->length;
+    if (segment >= layout->count) {
+        output[0] = '\0';
+        return 0;
+    }
+    if (layout->mode == TEXT_LAYOUT_MODE_CHUNK) {
+        start = layout->chunks[segment].start;
+        length = layout->chunks[segment].length;
+    } else if (layout->count > 1) {
+        start = TextLayoutGetScrollStart(layout, text, segment);
+        length = layout->profile->width;
+    }
+    memcpy(output, &text[start], length);
+    output[length] = '\0';
+    if (layout->profile->leadingSpace == TEXT_LAYOUT_SPACE_REPLACE &&
+        output[0] == ' '
+    ) {
+        output[0] = layout->profile->spaceChar;
+    }
+    return length;
+}
+
+/**
+ * TextLayoutInit()
+ *     Description:
+ *         Set up an empty layout for a display
+ *     Params:
+ *         TextLayout_t *layout - The layout
+ *         const TextLayoutProfile_t *profile - The display
+ *     Returns:
+ *         void
+ */
+void TextLayoutInit(TextLayout_t *layout, const TextLayoutProfile_t *profile)
+{
+    layout->profile = profile;
+    layout->mode = TEXT_LAYOUT_MODE_NONE;
+    layout->count = 0;
+    layout->length = 0;
+}
+
+/**
+ * TextLayoutInvalidate()
+ *     Description:
+ *         Mark the layout for a rebuild, must be called when the text changes
+ *     Params:
+ *         TextLayout_t *layout - The layout
+ *     Returns:
+ *         void
+ */
+void TextLayoutInvalidate(TextLayout_t *layout)
+{
+    layout->mode = TEXT_LAYOUT_MODE_NONE;
+}
+
+/**
+ * TextLayoutNextSegment()
+ *     Description:
+ *         Get the segment shown after the given one
+ *     Params:
+ *         TextLayout_t *layout - The layout
+ *         const char *text - The text the layout was prepared with
+ *         uint8_t segment - The segment shown last
+ *     Returns:
+ *         uint8_t - The next segment, the segment count after the last one
+ */
+uint8_t TextLayoutNextSegment(TextLayout_t *layout, const char *text, uint8_t segment)
+{
+    if (layout->mode == TEXT_LAYOUT_MODE_SCROLL && segment < layout->count) {
+        segment = TextLayoutGetScrollStart(layout, text, segment);
+        if (segment + 1 < layout->count) {
+            return TextLayoutGetScrollStart(layout, text, segment + 1);
+        }
+    }
+    return segment + 1;
+}
+
+/**
+ * TextLayoutPrepare()
+ *     Description:
+ *         Build the segments of the text if the text or the mode changed.
+ *         Text that fits the display is a single segment.
+ *     Params:
+ *         TextLayout_t *layout - The layout
+ *         const char *text - The text
+ *         uint8_t mode - The TEXT_LAYOUT_MODE_* to show the text in
+ *     Returns:
+ *         uint8_t - The number of segments
+ */
+uint8_t TextLayoutPrepare(TextLayout_t *layout, const char *text, uint8_t mode)
+{
+    if (layout->mode == mode) {
+        return layout->count;
+    }
+    uint8_t length = strlen(text);
+    layout->mode = mode;
+    layout->count = 0;
+    layout->length = length;
+    if (length <= layout->profile->width) {
+        if (mode == TEXT_LAYOUT_MODE_CHUNK) {
+            TextLayoutAdd(layout, 0, length);
+        } else {
+            layout->count = 1;
+        }
+    } else if (mode == TEXT_LAYOUT_MODE_CHUNK) {
+        TextLayoutBuildChunks(layout, text, length);
+    } else {
+        layout->count = length - layout->profile->width + 1;
+    }
+    return layout->count;
+}
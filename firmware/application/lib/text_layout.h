@@ -0,0 +1,83 @@
+/*
+ * File: text_layout.h
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Split display text into the segments a display shows one at a time.
+ *     Chunks are worked out once when the text changes and scroll windows
+ *     follow from their index, so the scrolling timers only copy the next
+ *     one out.
+ */
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+#include <stdint.h>
+#include <string.h>
+#include "utils.h"
+#define TEXT_LAYOUT_MODE_SCROLL 0
+#define TEXT_LAYOUT_MODE_CHUNK 1
+// The layout has to be rebuilt before it is used
+#define TEXT_LAYOUT_MODE_NONE 0xFF
+// What to do with a segment that starts with a space, which most displays
+// drop
+#define TEXT_LAYOUT_SPACE_KEEP 0
+#define TEXT_LAYOUT_SPACE_SKIP 1
+#define TEXT_LAYOUT_SPACE_REPLACE 2
+// The narrowest display a layout is used for, the BMBT title
+#define TEXT_LAYOUT_MIN_WIDTH 9
+// Breaking at words can make a chunk short, but any two chunks in a row cover
+// more than the display width
+#define TEXT_LAYOUT_MAX_CHUNKS (((UTILS_DISPLAY_TEXT_SIZE / (TEXT_LAYOUT_MIN_WIDTH + 1)) + 1) * 2)
+
+/**
+ * TextLayoutProfile_t
+ *     Description:
+ *         What a display can show
+ *     Fields:
+ *         width - The characters shown at a time
+ *         leadingSpace - The TEXT_LAYOUT_SPACE_* handling of a leading space
+ *         spaceChar - The character a leading space is replaced with
+ */
+typedef struct TextLayoutProfile_t {
+    uint8_t width;
+    uint8_t leadingSpace;
+    char spaceChar;
+} TextLayoutProfile_t;
+
+/**
+ * TextLayoutSegment_t
+ *     Description:
+ *         A chunk of the text shown at once
+ *     Fields:
+ *         start - The index of the first character
+ *         length - The number of characters
+ */
+typedef struct TextLayoutSegment_t {
+    uint8_t start;
+    uint8_t length;
+} TextLayoutSegment_t;
+
+/**
+ * TextLayout_t
+ *     Description:
+ *         The segments of a text for a display
+ *     Fields:
+ *         profile - The display the layout is for
+ *         mode - The TEXT_LAYOUT_MODE_* the segments were built with
+ *         count - The number of segments. In scroll mode segment n is the
+ *             window starting at character n.
+ *         length - The length of the text
+ *         chunks - The chunks in the order they are shown, in chunk mode
+ */
+typedef struct TextLayout_t {
+    const TextLayoutProfile_t *profile;
+    uint8_t mode;
+    uint8_t count;
+    uint8_t length;
+    TextLayoutSegment_t chunks[TEXT_LAYOUT_MAX_CHUNKS];
+} TextLayout_t;
+
+uint8_t TextLayoutGetSegment(TextLayout_t *, const char *, uint8_t, char *);
+void TextLayoutInit(TextLayout_t *, const TextLayoutProfile_t *);
+void TextLayoutInvalidate(TextLayout_t *);
+uint8_t TextLayoutNextSegment(TextLayout_t *, const char *, uint8_t);
+uint8_t TextLayoutPrepare(TextLayout_t *, const char *, uint8_t);
+#endif /* TEXT_LAYOUT_H */
@@ -51,6 +51,89 @@ void TimerDelayMicroseconds(uint16_t delay)
     T2CONbits.TON = 0;
 }
 
+/**
+ * TimerCycleCounterStart()
+ *     Description:
+ *         Start Timer4/5 as a free running 32-bit counter clocked from the
+ *         instruction clock, so that code paths can be measured in
+ *         instruction cycles. Overflows after ~268 seconds.
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+void TimerCycleCounterStart()
+{
+    T4CON = 0;
+    T5CON = 0;
+    TMR5 = 0;
+    TMR4 = 0;
+    PR5 = 0xFFFF;
+    PR4 = 0xFFFF;
+    T4CON = TIMER_ON | TIMER_SOURCE_INTERNAL | GATED_TIME_DISABLED | TIMER_32BIT_MODE | TIMER_PRESCALER;
+}
+
+/**
+ * TimerCycleCounterGet()
+ *     Description:
+ *         Return the instruction cycles counted since TimerCycleCounterStart().
+ *         Reading TMR4 latches the upper word into TMR5HLD.
+ *     Params:
+ *         None
+ *     Returns:
+ *         uint32_t - The instruction cycle count
+ */
+uint32_t TimerCycleCounterGet()
+{
+    uint16_t low = TMR4;
+    return ((uint32_t) TMR5HLD << 16) | low;
+}
+
+/**
+ * TimerCycleCounterStop()
+ *     Description:
+ *         Stop the instruction cycle counter
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+void TimerCycleCounterStop()
+{
+    T4CON = 0;
+}
+
+/**
+ * TimerGetMicros()
+ *     Description:
+ *         Return the number of elapsed microseconds since boot, built from
+ *         the millisecond count and the Timer1 count within it. Wraps after
+ *         ~71 minutes.
+ *     Params:
+ *         None
+ *     Returns:
+ *         uint32_t - The microseconds since boot
+ */
+uint32_t TimerGetMicros()
+{
+    uint32_t millis;
+    uint16_t ticks;
+    uint8_t rolledOver;
+    // Read again if the millisecond rolled over between the two reads
+    do {
+        millis = TimerCurrentMillis;
+        ticks = TMR1;
+        rolledOver = IFS0bits.T1IF;
+    } while (millis != TimerCurrentMillis);
+    // Timer1 wrapped but its interrupt has not counted the millisecond yet,
+    // e.g. we were called with it masked, so count it here rather than
+    // stepping back in time
+    if (rolledOver == 1 && ticks < PR1_SETTING / 2) {
+        millis++;
+    }
+    return (millis * 1000) + (ticks / TIMER_TICKS_PER_MICROSECOND);
+}
+
 /**
  * TimerGetMillis()
  *     Description:
@@ -90,27 +173,38 @@ void TimerProcessScheduledTasks()
  * TimerRegisterScheduledTask()
  *     Description:
  *         Register a function to be called at a given interval with the given
- *         context
+ *         context. Slots freed by unregistering are reused before the tasks
+ *         array grows.
  *     Params:
  *         void *task - A pointer to the function to call
  *         void *ctx - A pointer to the context for which to pass to the function
  *         uint16_t interval - The number of milliseconds to elapse before calling
  *     Returns:
- *         uint8_t - The index of the scheduled task in the tasks array
+ *         uint8_t - The index of the scheduled task in the tasks array or
+ *             TIMER_TASK_INVALID if the array is full
  */
 uint8_t TimerRegisterScheduledTask(void *task, void *ctx, uint16_t interval)
 {
-    if (TimerRegisteredTasksCount == TIMER_TASKS_MAX) {
+    uint8_t idx;
+    for (idx = 0; idx < TimerRegisteredTasksCount; idx++) {
+        if (TimerRegisteredTasks[idx].task == 0) {
+            break;
+        }
+    }
+    if (idx == TIMER_TASKS_MAX) {
         LogError("FAILED TO REGISTER TIMER -- Allocations Full");
-        return 0;
+        return TIMER_TASK_INVALID;
+    }
+    volatile TimerScheduledTask_t *t = &TimerRegisteredTasks[idx];
+    t->context = ctx;
+    t->ticks = 0;
+    t->interval = interval;
+    // The interrupt only counts ticks for slots with a task, so set it last
+    t->task = task;
+    if (idx == TimerRegisteredTasksCount) {
+        TimerRegisteredTasksCount++;
     }
-    TimerScheduledTask_t scheduledTask;
-    scheduledTask.task = task;
-    scheduledTask.context = ctx;
-    scheduledTask.ticks = 0;
-    scheduledTask.interval = interval;
-    TimerRegisteredTasks[TimerRegisteredTasksCount++] = scheduledTask;
-    return TimerRegisteredTasksCount - 1;
+    return idx;
 }
 
 /**
@@ -128,7 +222,7 @@ uint8_t TimerUnregisterScheduledTask(void *task)
     for (idx = 0; idx < TimerRegisteredTasksCount; idx++) {
         volatile TimerScheduledTask_t *t = &TimerRegisteredTasks[idx];
         if (t->task == task) {
-            memset((void *)t, 0, sizeof(TimerScheduledTask_t));
+            TimerUnregisterScheduledTaskById(idx);
             return 0;
         }
     }
@@ -146,7 +240,12 @@ uint8_t TimerUnregisterScheduledTask(void *task)
  */
 void TimerUnregisterScheduledTaskById(uint8_t taskId)
 {
+    if (taskId >= TimerRegisteredTasksCount) {
+        return;
+    }
     volatile TimerScheduledTask_t *t = &TimerRegisteredTasks[taskId];
+    // Clear the task first so the interrupt stops counting the slot
+    t->task = 0;
     memset((void *)t, 0, sizeof(TimerScheduledTask_t));
 }
 
@@ -161,6 +260,9 @@ void TimerUnregisterScheduledTaskById(uint8_t taskId)
  */
 void TimerResetScheduledTask(uint8_t taskId)
 {
+    if (taskId >= TIMER_TASKS_MAX) {
+        return;
+    }
     volatile TimerScheduledTask_t *t = &TimerRegisteredTasks[taskId];
     if (t->task != 0) {
         t->ticks = 0;
@@ -180,6 +282,9 @@ void TimerResetScheduledTask(uint8_t taskId)
  */
 void TimerSetTaskInterval(uint8_t taskId, uint16_t interval)
 {
+    if (taskId >= TIMER_TASKS_MAX) {
+        return;
+    }
     volatile TimerScheduledTask_t *t = &TimerRegisteredTasks[taskId];
     if (t->task != 0) {
         t->interval = interval;
@@ -197,6 +302,9 @@ void TimerSetTaskInterval(uint8_t taskId, uint16_t interval)
  */
 void TimerTriggerScheduledTask(uint8_t taskId)
 {
+    if (taskId >= TIMER_TASKS_MAX) {
+        return;
+    }
     volatile TimerScheduledTask_t *t = &TimerRegisteredTasks[taskId];
     if (t->task != 0) {
         // Prevent it from executing immediately
@@ -18,9 +18,11 @@
 #define TIMER_INTERRUPT_PRIORITY 0x0002
 #define CLOCK_DIVIDER TIMER_PRESCALER
 #define PR1_SETTING (SYS_CLOCK / 1000 / 1)
+#define TIMER_TICKS_PER_MICROSECOND (SYS_CLOCK / 1000000)
 #define TIMER_TASKS_MAX 32
 #define TIMER_INDEX 0
 #define TIMER_TASK_DISABLED 0
+#define TIMER_TASK_INVALID 0xFF
 #include <stdint.h>
 #include <string.h>
 #include <xc.h>
@@ -44,7 +46,11 @@ typedef struct TimerScheduledTask_t {
 } TimerScheduledTask_t;
 
 void TimerInit();
+void TimerCycleCounterStart();
+uint32_t TimerCycleCounterGet();
+void TimerCycleCounterStop();
 void TimerDelayMicroseconds(uint16_t);
+uint32_t TimerGetMicros();
 uint32_t TimerGetMillis();
 void TimerProcessScheduledTasks();
 uint8_t TimerRegisterScheduledTask(void *, void *, uint16_t);
@@ -0,0 +1,265 @@
+/*
+ * File: trace.c
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Record latency trace points into a RAM ring buffer. Each input from
+ *     the IBus or the BT module starts a trace with its own ID, and the
+ *     events, BT commands and IBus frames it causes are recorded against
+ *     that ID so the path from input to output can be followed.
+ */
+#include "trace.h"
+static TraceContext_t Trace;
+
+/**
+ * TraceWrite()
+ *     Description:
+ *         Write a point into the ring, over the oldest point if it is full
+ *     Params:
+ *         TraceRecord_t *record - The point
+ *     Returns:
+ *         void
+ */
+static void TraceWrite(TraceRecord_t *record)
+{
+    Trace.records[Trace.head] = *record;
+    Trace.head = (Trace.head + 1) % TRACE_BUFFER_SIZE;
+    if (Trace.count < TRACE_BUFFER_SIZE) {
+        Trace.count++;
+    }
+}
+
+static const char *TracePointNames[] = {
+    "IBus RX",
+    "BT RX",
+    "Event",
+    "BT TX",
+    "IBus Queue",
+    "IBus TX"
+};
+
+/**
+ * TraceBegin()
+ *     Description:
+ *         Start a new trace for an input. Points recorded until TraceEnd()
+ *         belong to it. Most bus traffic produces no output, so the points
+ *         are held back and only written once the trace sends something.
+ *     Params:
+ *         uint8_t point - TRACE_POINT_IBUS_RX or TRACE_POINT_BT_RX
+ *         uint8_t arg - The IBus command or BT event
+ *     Returns:
+ *         void
+ */
+void TraceBegin(uint8_t point, uint8_t arg)
+{
+    if (Trace.enabled == 0) {
+        return;
+    }
+    Trace.nextId++;
+    if (Trace.nextId == TRACE_ID_NONE) {
+        Trace.nextId++;
+    }
+    Trace.activeId = Trace.nextId;
+    Trace.pendingCount = 0;
+    Trace.committed = 0;
+    TracePoint(point, arg);
+}
+
+/**
+ * TraceClear()
+ *     Description:
+ *         Drop every recorded point
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void TraceClear()
+{
+    Trace.head = 0;
+    Trace.count = 0;
+    Trace.activeId = TRACE_ID_NONE;
+}
+
+/**
+ * TraceDump()
+ *     Description:
+ *         Log the recorded points in the Chrome trace event format, so the
+ *         output can be loaded into chrome://tracing or Perfetto. Each trace
+ *         is an async slice from its input to its last output, with the
+ *         points in between as steps.
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void TraceDump()
+{
+    uint8_t start = (Trace.head + TRACE_BUFFER_SIZE - Trace.count) % TRACE_BUFFER_SIZE;
+    uint8_t i;
+    uint8_t j;
+    uint8_t first = 1;
+    LogRaw("{\"traceEvents\":[\r\n");
+    for (i = 0; i < Trace.count; i++) {
+        TraceRecord_t *record = &Trace.records[(start + i) % TRACE_BUFFER_SIZE];
+        TraceRecord_t *origin = record;
+        uint8_t isFirst = 1;
+        uint8_t isLast = 1;
+        for (j = 0; j < Trace.count; j++) {
+            TraceRecord_t *other = &Trace.records[(start + j) % TRACE_BUFFER_SIZE];
+            if (other->id == record->id) {
+                if (j < i) {
+                    if (isFirst == 1) {
+                        origin = other;
+                    }
+                    isFirst = 0;
+                } else if (j > i) {
+                    isLast = 0;
+                }
+            }
+        }
+        const char *name = TracePointNames[origin->point];
+        if (isFirst == 1) {
+            LogRaw(
+                "%s{\"name\":\"%s\",\"cat\":\"latency\",\"ph\":\"b\",\"id\":%u,"
+                "\"ts\":%lu,\"pid\":1,\"tid\":1,\"args\":{\"arg\":\"%02X\"}}\r\n",
+                first == 1 ? "" : ",",
+                name,
+                record->id,
+                (unsigned long) record->timestamp,
+                record->arg
+            );
+            first = 0;
+        } else {
+            LogRaw(
+                ",{\"name\":\"%s\",\"cat\":\"latency\",\"ph\":\"n\",\"id\":%u,"
+                "\"ts\":%lu,\"pid\":1,\"tid\":1,\"args\":{\"arg\":\"%02X\"}}\r\n",
+                TracePointNames[record->point],
+                record->id,
+                (unsigned long) record->timestamp,
+                record->arg
+            );
+        }
+        if (isLast == 1) {
+            LogRaw(
+                ",{\"name\":\"%s\",\"cat\":\"latency\",\"ph\":\"e\",\"id\":%u,"
+                "\"ts\":%lu,\"pid\":1,\"tid\":1,\"args\":{\"last\":\"%s\"}}\r\n",
+                name,
+                record->id,
+                (unsigned long) record->timestamp,
+                TracePointNames[record->point]
+            );
+        }
+    }
+    LogRaw("]}\r\n");
+}
+
+/**
+ * TraceEnd()
+ *     Description:
+ *         Stop following the current trace, dropping its points if it sent
+ *         nothing. Frames it queued on the IBus keep its ID until they are
+ *         transmitted.
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void TraceEnd()
+{
+    Trace.activeId = TRACE_ID_NONE;
+    Trace.pendingCount = 0;
+}
+
+/**
+ * TraceGetId()
+ *     Description:
+ *         Get the trace being followed, for outputs that leave later
+ *     Params:
+ *         void
+ *     Returns:
+ *         uint16_t - The trace ID or TRACE_ID_NONE
+ */
+uint16_t TraceGetId()
+{
+    return Trace.activeId;
+}
+
+/**
+ * TracePoint()
+ *     Description:
+ *         Record a point against the trace being followed, if any. BT
+ *         commands and queued IBus frames are outputs and commit the trace.
+ *     Params:
+ *         uint8_t point - The TRACE_POINT_*
+ *         uint8_t arg - The event type, BT opcode or IBus command
+ *     Returns:
+ *         void
+ */
+void TracePoint(uint8_t point, uint8_t arg)
+{
+    uint8_t idx;
+    if (Trace.activeId == TRACE_ID_NONE) {
+        return;
+    }
+    if (Trace.committed == 0 &&
+        point != TRACE_POINT_BT_TX &&
+        point != TRACE_POINT_IBUS_QUEUE
+    ) {
+        if (Trace.pendingCount < TRACE_PENDING_SIZE) {
+            TraceRecord_t *record = &Trace.pending[Trace.pendingCount++];
+            record->timestamp = TimerGetMicros();
+            record->id = Trace.activeId;
+            record->point = point;
+            record->arg = arg;
+        }
+        return;
+    }
+    if (Trace.committed == 0) {
+        // The first output, keep what led up to it
+        for (idx = 0; idx < Trace.pendingCount; idx++) {
+            TraceWrite(&Trace.pending[idx]);
+        }
+        Trace.pendingCount = 0;
+        Trace.committed = 1;
+    }
+    TracePointId(Trace.activeId, point, arg);
+}
+
+/**
+ * TracePointId()
+ *     Description:
+ *         Record a point against the given trace
+ *     Params:
+ *         uint16_t id - The trace ID, TRACE_ID_NONE records nothing
+ *         uint8_t point - The TRACE_POINT_*
+ *         uint8_t arg - The event type, BT opcode or IBus command
+ *     Returns:
+ *         void
+ */
+void TracePointId(uint16_t id, uint8_t point, uint8_t arg)
+{
+    if (Trace.enabled == 0 || id == TRACE_ID_NONE) {
+        return;
+    }
+    TraceRecord_t record;
+    record.timestamp = TimerGetMicros();
+    record.id = id;
+    record.point = point;
+    record.arg = arg;
+    TraceWrite(&record);
+}
+
+/**
+ * TraceSetEnabled()
+ *     Description:
+ *         Start or stop recording
+ *     Params:
+ *         uint8_t enabled - 1 to record, 0 to stop
+ *     Returns:
+ *         void
+ */
+void TraceSetEnabled(uint8_t enabled)
+{
+    Trace.enabled = enabled;
+    Trace.activeId = TRACE_ID_NONE;
+}
@@ -0,0 +1,80 @@
+/*
+ * File: trace.h
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Record latency trace points into a RAM ring buffer. Each input from
+ *     the IBus or the BT module starts a trace with its own ID, and the
+ *     events, BT commands and IBus frames it causes are recorded against
+ *     that ID so the path from input to output can be followed.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+#include <stdint.h>
+#include <string.h>
+#include "log.h"
+#include "timer.h"
+#define TRACE_BUFFER_SIZE 128
+// Points held for an input until we know it produced an output
+#define TRACE_PENDING_SIZE 8
+#define TRACE_ID_NONE 0
+#define TRACE_POINT_IBUS_RX 0
+#define TRACE_POINT_BT_RX 1
+#define TRACE_POINT_EVENT 2
+#define TRACE_POINT_BT_TX 3
+#define TRACE_POINT_IBUS_QUEUE 4
+#define TRACE_POINT_IBUS_TX 5
+
+/**
+ * TraceRecord_t
+ *     Description:
+ *         A single trace point
+ *     Fields:
+ *         timestamp - Microseconds since boot
+ *         id - The trace the point belongs to
+ *         point - The TRACE_POINT_*
+ *         arg - The IBus command, event type or BT opcode of the point
+ */
+typedef struct TraceRecord_t {
+    uint32_t timestamp;
+    uint16_t id;
+    uint8_t point;
+    uint8_t arg;
+} TraceRecord_t;
+
+/**
+ * TraceContext_t
+ *     Description:
+ *         The trace buffer and the trace being followed
+ *     Fields:
+ *         records - The ring of trace points, the oldest is overwritten
+ *         head - The index the next point is written to
+ *         count - The number of points held
+ *         pending - The points of the active trace, until it has an output
+ *         pendingCount - The number of pending points
+ *         committed - Set once the active trace has had an output, so its
+ *             points go straight to records
+ *         enabled - Set while tracing
+ *         activeId - The trace being followed or TRACE_ID_NONE
+ *         nextId - The ID to give the next trace
+ */
+typedef struct TraceContext_t {
+    TraceRecord_t records[TRACE_BUFFER_SIZE];
+    uint8_t head;
+    uint8_t count;
+    TraceRecord_t pending[TRACE_PENDING_SIZE];
+    uint8_t pendingCount;
+    uint8_t committed;
+    uint8_t enabled;
+    uint16_t activeId;
+    uint16_t nextId;
+} TraceContext_t;
+
+void TraceBegin(uint8_t, uint8_t);
+void TraceClear();
+void TraceDump();
+void TraceEnd();
+uint16_t TraceGetId();
+void TracePoint(uint8_t, uint8_t);
+void TracePointId(uint16_t, uint8_t, uint8_t);
+void TraceSetEnabled(uint8_t);
+#endif /* TRACE_H */
@@ -20,7 +20,9 @@ static const char UTILS_CHARS_LATIN[] =
     "SsTtTtTtUuUuUuUu" /* 0160-016F */
     "UuUuWwYyYZzZzZzF"; /* 0170-017F */
 
+#ifndef BOARD_VERSION_FIXED
 static int8_t BOARD_VERSION = -1;
+#endif
 
 /**
  * UtilsConvertCmToIn()
@@ -57,6 +59,7 @@ UtilsAbstractDisplayValue_t UtilsDisplayValueInit(char *text, uint8_t status)
     return value;
 }
 
+#ifndef BOARD_VERSION_FIXED
 /**
  * UtilsGetBoardVersion()
  *     Description:
@@ -77,6 +80,7 @@ uint8_t UtilsGetBoardVersion()
     }
     return BOARD_VERSION;
 }
+#endif
 
 /**
  * UtilsGetMinByte()
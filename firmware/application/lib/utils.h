@@ -187,7 +187,11 @@ typedef struct UtilsAbstractDisplayValue_t {
 } UtilsAbstractDisplayValue_t;
 uint8_t UtilsConvertCmToIn(uint8_t);
 UtilsAbstractDisplayValue_t UtilsDisplayValueInit(char *, uint8_t);
+#ifdef BOARD_VERSION_FIXED
+#define UtilsGetBoardVersion() (BOARD_VERSION_FIXED)
+#else
 uint8_t UtilsGetBoardVersion();
+#endif
 uint8_t UtilsGetMinByte(uint8_t *, uint8_t);
 uint8_t UtilsGetUnicodeByteLength(uint8_t);
 void UtilsNormalizeText(char *, const char *, uint16_t);
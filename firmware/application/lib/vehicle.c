@@ -0,0 +1,217 @@
+/*
+ * File: vehicle.c
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Keep the last known state of the vehicle signals we decode from the
+ *     I/K-Bus and notify subscribers only when a change is relevant to them
+ */
+#include "vehicle.h"
+static VehicleSignal_t VehicleSignals[VEHICLE_SIGNAL_COUNT];
+static VehicleSubscription_t VehicleSubscriptions[VEHICLE_SUBSCRIPTIONS_MAX];
+
+// Indexed by signal ID. The oil temperature is derived from a sensor voltage
+// that wanders by a degree between LCM replies, so it needs a wider step.
+static const uint8_t VehicleSignalHysteresis[VEHICLE_SIGNAL_COUNT] = {
+    0, // VEHICLE_SIGNAL_GEAR_POSITION
+    1, // VEHICLE_SIGNAL_COOLANT_TEMP
+    1, // VEHICLE_SIGNAL_AMBIENT_TEMP
+    2, // VEHICLE_SIGNAL_OIL_TEMP
+    0, // VEHICLE_SIGNAL_SPEED
+    0  // VEHICLE_SIGNAL_RPM
+};
+
+/**
+ * VehicleInit()
+ *     Description:
+ *         Reset all signals to unknown and drop all subscriptions
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+void VehicleInit()
+{
+    uint8_t idx;
+    memset(VehicleSubscriptions, 0, sizeof(VehicleSubscriptions));
+    for (idx = 0; idx < VEHICLE_SIGNAL_COUNT; idx++) {
+        VehicleSignals[idx].value = 0;
+        VehicleSignals[idx].hysteresis = VehicleSignalHysteresis[idx];
+        VehicleSignals[idx].status = VEHICLE_SIGNAL_STATUS_UNKNOWN;
+        VehicleSignals[idx].updated = 0;
+    }
+}
+
+/**
+ * VehicleGetSignal()
+ *     Description:
+ *         Get the last accepted value of a signal. Unknown signals read as 0.
+ *     Params:
+ *         uint8_t signal - The signal ID
+ *     Returns:
+ *         int16_t - The value
+ */
+int16_t VehicleGetSignal(uint8_t signal)
+{
+    if (signal >= VEHICLE_SIGNAL_COUNT) {
+        return 0;
+    }
+    return VehicleSignals[signal].value;
+}
+
+/**
+ * VehicleGetSignalUpdated()
+ *     Description:
+ *         Get the time the signal last changed value
+ *     Params:
+ *         uint8_t signal - The signal ID
+ *     Returns:
+ *         uint32_t - The time in milliseconds, or 0 if never seen
+ */
+uint32_t VehicleGetSignalUpdated(uint8_t signal)
+{
+    if (signal >= VEHICLE_SIGNAL_COUNT) {
+        return 0;
+    }
+    return VehicleSignals[signal].updated;
+}
+
+/**
+ * VehicleGetSignalStatus()
+ *     Description:
+ *         Check if we have received a reading for the signal yet
+ *     Params:
+ *         uint8_t signal - The signal ID
+ *     Returns:
+ *         uint8_t - VEHICLE_SIGNAL_STATUS_UNKNOWN or VEHICLE_SIGNAL_STATUS_VALID
+ */
+uint8_t VehicleGetSignalStatus(uint8_t signal)
+{
+    if (signal >= VEHICLE_SIGNAL_COUNT) {
+        return VEHICLE_SIGNAL_STATUS_UNKNOWN;
+    }
+    return VehicleSignals[signal].status;
+}
+
+/**
+ * VehicleSetSignal()
+ *     Description:
+ *         Store a new reading for the given signal. Readings within the
+ *         hysteresis of the stored value are dropped. When the value changes,
+ *         every subscriber whose deadband has been crossed since it was last
+ *         notified is called with the signal ID.
+ *     Params:
+ *         uint8_t signal - The signal ID
+ *         int16_t value - The reading
+ *     Returns:
+ *         uint8_t - 1 if the stored value changed, 0 otherwise
+ */
+uint8_t VehicleSetSignal(uint8_t signal, int16_t value)
+{
+    if (signal >= VEHICLE_SIGNAL_COUNT) {
+        return 0;
+    }
+    VehicleSignal_t *state = &VehicleSignals[signal];
+    if (state->status == VEHICLE_SIGNAL_STATUS_VALID) {
+        int16_t delta = abs(value - state->value);
+        if (delta == 0 || delta < state->hysteresis) {
+            return 0;
+        }
+    }
+    state->value = value;
+    state->status = VEHICLE_SIGNAL_STATUS_VALID;
+    state->updated = TimerGetMillis();
+    uint8_t idx;
+    for (idx = 0; idx < VEHICLE_SUBSCRIPTIONS_MAX; idx++) {
+        VehicleSubscription_t *sub = &VehicleSubscriptions[idx];
+        if (sub->callback == 0 || sub->signal != signal) {
+            continue;
+        }
+        if (sub->status == VEHICLE_SIGNAL_STATUS_VALID &&
+            abs(value - sub->notified) < sub->deadband
+        ) {
+            continue;
+        }
+        sub->notified = value;
+        sub->status = VEHICLE_SIGNAL_STATUS_VALID;
+        sub->callback(sub->context, &signal);
+    }
+    return 1;
+}
+
+/**
+ * VehicleSubscribe()
+ *     Description:
+ *         Subscribe to changes of a signal. If the signal is already known,
+ *         the subscriber will be notified on the next change that crosses
+ *         its deadband, measured from the current value.
+ *     Params:
+ *         uint8_t signal - The signal ID
+ *         uint8_t deadband - The minimum change between notifications
+ *         void *callback - The function to call, see VehicleSubscription_t
+ *         void *context - Passed through to the callback
+ *     Returns:
+ *         uint8_t - The index of the subscription or
+ *             VEHICLE_SUBSCRIPTION_INVALID if all subscription slots are taken
+ */
+uint8_t VehicleSubscribe(
+    uint8_t signal,
+    uint8_t deadband,
+    void *callback,
+    void *context
+) {
+    uint8_t idx;
+    for (idx = 0; idx < VEHICLE_SUBSCRIPTIONS_MAX; idx++) {
+        VehicleSubscription_t *sub = &VehicleSubscriptions[idx];
+        if (sub->callback == 0) {
+            sub->signal = signal;
+            sub->deadband = deadband;
+            sub->notified = VehicleGetSignal(signal);
+            sub->status = VehicleGetSignalStatus(signal);
+            sub->context = context;
+            sub->callback = callback;
+            return idx;
+        }
+    }
+    LogError("FAILED TO SUBSCRIBE TO SIGNAL %d -- Allocations Full", signal);
+    return VEHICLE_SUBSCRIPTION_INVALID;
+}
+
+/**
+ * VehicleUnsubscribe()
+ *     Description:
+ *         Remove a subscription and free its slot
+ *     Params:
+ *         uint8_t signal - The signal ID
+ *         void *callback - The function given to VehicleSubscribe()
+ *     Returns:
+ *         uint8_t - 0 on success, 1 if there was no such subscription
+ */
+uint8_t VehicleUnsubscribe(uint8_t signal, void *callback)
+{
+    uint8_t idx;
+    for (idx = 0; idx < VEHICLE_SUBSCRIPTIONS_MAX; idx++) {
+        VehicleSubscription_t *sub = &VehicleSubscriptions[idx];
+        if (sub->signal == signal && sub->callback == callback) {
+            VehicleUnsubscribeById(idx);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * VehicleUnsubscribeById()
+ *     Description:
+ *         Remove a subscription using the index VehicleSubscribe() returned
+ *     Params:
+ *         uint8_t subscriptionId - The index of the subscription
+ *     Returns:
+ *         void
+ */
+void VehicleUnsubscribeById(uint8_t subscriptionId)
+{
+    if (subscriptionId >= VEHICLE_SUBSCRIPTIONS_MAX) {
+        return;
+    }
+    memset(&VehicleSubscriptions[subscriptionId], 0, sizeof(VehicleSubscription_t));
+}
@@ -0,0 +1,78 @@
+/*
+ * File: vehicle.h
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     Keep the last known state of the vehicle signals we decode from the
+ *     I/K-Bus and notify subscribers only when a change is relevant to them
+ */
+#ifndef VEHICLE_H
+#define VEHICLE_H
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "log.h"
+#include "timer.h"
+#define VEHICLE_SIGNAL_GEAR_POSITION 0
+#define VEHICLE_SIGNAL_COOLANT_TEMP 1
+#define VEHICLE_SIGNAL_AMBIENT_TEMP 2
+#define VEHICLE_SIGNAL_OIL_TEMP 3
+#define VEHICLE_SIGNAL_SPEED 4
+#define VEHICLE_SIGNAL_RPM 5
+#define VEHICLE_SIGNAL_COUNT 6
+#define VEHICLE_SIGNAL_STATUS_UNKNOWN 0
+#define VEHICLE_SIGNAL_STATUS_VALID 1
+#define VEHICLE_SUBSCRIPTIONS_MAX 8
+#define VEHICLE_SUBSCRIPTION_INVALID 0xFF
+
+/**
+ * VehicleSignal_t
+ *     Description:
+ *         The stored state of a single signal
+ *     Fields:
+ *         value - The last accepted value
+ *         hysteresis - The smallest change from the stored value that is
+ *             accepted. Readings closer than this to the stored value are
+ *             treated as noise. 0 and 1 accept every change.
+ *         status - VEHICLE_SIGNAL_STATUS_UNKNOWN until the first reading
+ *         updated - The time (in milliseconds) the value last changed
+ */
+typedef struct VehicleSignal_t {
+    int16_t value;
+    uint8_t hysteresis;
+    uint8_t status;
+    uint32_t updated;
+} VehicleSignal_t;
+
+/**
+ * VehicleSubscription_t
+ *     Description:
+ *         A subscriber to a single signal
+ *     Fields:
+ *         signal - The signal to watch
+ *         deadband - How far the value has to move from the last value this
+ *             subscriber was given before it is notified again. 0 and 1
+ *             notify on every change.
+ *         notified - The last value handed to the subscriber
+ *         status - VEHICLE_SIGNAL_STATUS_VALID once notified has been set
+ *         *context - Passed through to the callback
+ *         (*callback)(void *, uint8_t *) - Called with the context and a
+ *             pointer to the signal ID, like an event callback
+ */
+typedef struct VehicleSubscription_t {
+    uint8_t signal;
+    uint8_t deadband;
+    int16_t notified;
+    uint8_t status;
+    void *context;
+    void (*callback)(void *, uint8_t *);
+} VehicleSubscription_t;
+
+void VehicleInit();
+int16_t VehicleGetSignal(uint8_t);
+uint32_t VehicleGetSignalUpdated(uint8_t);
+uint8_t VehicleGetSignalStatus(uint8_t);
+uint8_t VehicleSetSignal(uint8_t, int16_t);
+uint8_t VehicleSubscribe(uint8_t, uint8_t, void *, void *);
+uint8_t VehicleUnsubscribe(uint8_t, void *);
+void VehicleUnsubscribeById(uint8_t);
+#endif /* VEHICLE_H */
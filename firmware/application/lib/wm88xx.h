@@ -9,7 +9,6 @@
 #include "log.h"
 
 #define WM88XX_I2C_ADDR 0x3A
-#define WM88XX_POLL_INT 5000
 #define WM88XX_REGISTER_PLL_K_3 3
 #define WM88XX_REGISTER_PLL_K_2 4
 #define WM88XX_REGISTER_PLL_K_1 5
@@ -17,12 +16,19 @@
 #define WM88XX_REGISTER_PLLMODE 7
 #define WM88XX_REGISTER_PLLCLK 8
 #define WM88XX_REGISTER_SPDMODE 9
+#define WM88XX_REGISTER_INTSTAT 11
+#define WM88XX_REGISTER_SPDSTAT 12
 #define WM88XX_REGISTER_TXSRC 21
 #define WM88XX_REGISTER_AIFTX 27
 #define WM88XX_REGISTER_AIFRX 28
 #define WM88XX_REGISTER_SPDRX1 29
 #define WM88XX_REGISTER_PWR 30
-
+// SPDSTAT bit 6 is set while the S/PDIF receiver is not locked
+#define WM88XX_SPDSTAT_UNLOCK 0x40
+// PWR bit 1 powers down the S/PDIF receiver, all blocks are on at 0
+#define WM88XX_PWR_ON 0x00
+#define WM88XX_PWR_SPDIFRX_PD 0x02
 
 void WM88XXInit();
-void WM88XXPollTimer(void *);
+int8_t WM88XXConfigure();
+int8_t WM88XXRestartReceiver();
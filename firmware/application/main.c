@@ -11,16 +11,22 @@
 #include "handler.h"
 #include "mappings.h"
 #include "upgrade.h"
+#include "lib/bench.h"
 #include "lib/bt.h"
+#include "lib/codec.h"
 #include "lib/config.h"
+#include "lib/diagnostics.h"
 #include "lib/eeprom.h"
 #include "lib/log.h"
 #include "lib/i2c.h"
 #include "lib/ibus.h"
 #include "lib/pcm51xx.h"
+#include "lib/sniffer.h"
+#include "lib/telemetry.h"
 #include "lib/timer.h"
 #include "lib/uart.h"
 #include "lib/utils.h"
+#include "lib/vehicle.h"
 #include "lib/wm88xx.h"
 #include "ui/cli.h"
 
@@ -114,17 +120,29 @@ int main(void)
     // this level to maintain a global scope
     UARTAddModuleHandler(&systemUart);
     LogMessage("", "**** BlueBus ****");
+#ifdef BOARD_VERSION_FIXED
+    // The EEPROM address width and the BT module differ between the board
+    // revisions, so an image built for the other one must not go further.
+    // The bootloader still accepts a new image at power on.
+    if (BOARD_VERSION_STATUS != BOARD_VERSION_FIXED) {
+        LogError("Firmware is built for a different board revision");
+        while (1);
+    }
+#endif
 
     // Initialize low level modules
     EEPROMInit();
     TimerInit();
     I2CInit();
+    VehicleInit();
 
     struct BT_t bt = BTInit();
     UARTAddModuleHandler(&bt.uart);
 
     struct IBus_t ibus = IBusInit();
     UARTAddModuleHandler(&ibus.uart);
+    TelemetryInit();
+    DiagnosticsInit(&ibus);
 
     // WM8804 and PCM5122 must be initialized after the I2C Bus
     if (boardVersion == BOARD_VERSION_ONE) {
@@ -148,15 +166,25 @@ int main(void)
     UpgradeProcess(&bt, &ibus);
     // Run the PCM51XX Start-up process
     PCM51XXStartup();
+    // Supervise the codecs now that they are configured
+    CodecInit(boardVersion == BOARD_VERSION_ONE);
     // Reset the Boot flag in the EEPROM to indicate a valid boot
     ConfigSetBootloaderMode(0x00);
 
+#ifdef BENCH_STANDALONE
+    // Simulator builds run the benchmarks once and halt the debugger
+    BenchRun(&bt, &ibus, 0);
+    __builtin_software_breakpoint();
+    while (1);
+#endif
+
     // Process events
     while (1) {
         BTProcess(&bt);
         IBusProcess(&ibus);
         TimerProcessScheduledTasks();
         CLIProcess();
+        SnifferProcess();
     }
 
     return 0;
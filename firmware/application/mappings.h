@@ -46,6 +46,9 @@
 
 #define BOARD_VERSION_ONE 0
 #define BOARD_VERSION_TWO 1
+// Builds for a single board revision define BOARD_VERSION_FIXED as one of
+// the above so the revision checks fold away at compile time. Without it,
+// the revision is read from the board at run time.
 
 #define BOARD_VERSION_MODE TRISGbits.TRISG8
 #define BOARD_VERSION_STATUS PORTGbits.RG8
@@ -111,6 +114,9 @@
 // UI Events
 #define UIEvent_InitiateConnection 96
 #define UIEvent_CloseConnection 97
+#define UIEvent_InputGesture 98
+#define UIEvent_RenderModelUpdate 99
+#define UIEvent_DisplayClaim 100
 
 #define FIRMWARE_VERSION_MAJOR 1
 #define FIRMWARE_VERSION_MINOR 3
@@ -6,6 +6,58 @@
  */
 #include "bmbt.h"
 static BMBTContext_t Context;
+static ResourceGroup_t Resources;
+
+static const TextLayoutProfile_t BMBTDisplayProfile = {
+    BMBT_MAIN_AREA_LEN,
+    TEXT_LAYOUT_SPACE_KEEP,
+    ' '
+};
+
+static const InputBinding_t BMBTInputBindings[] = {
+    {
+        INPUT_SOURCE_BMBT,
+        IBUS_DEVICE_BMBT_Button_PlayPause,
+        INPUT_GESTURE_PRESS,
+        &BMBTInputPlayPause
+    },
+    {
+        INPUT_SOURCE_BMBT,
+        IBUS_DEVICE_BMBT_Button_Num1,
+        INPUT_GESTURE_PRESS,
+        &BMBTInputPlayPause
+    },
+    {
+        INPUT_SOURCE_BMBT,
+        IBUS_DEVICE_BMBT_Button_Knob,
+        INPUT_GESTURE_PRESS,
+        &BMBTInputKnob
+    },
+    {
+        INPUT_SOURCE_BMBT,
+        IBUS_DEVICE_BMBT_Button_Display,
+        INPUT_GESTURE_PRESS,
+        &BMBTInputDisplay
+    },
+    {
+        INPUT_SOURCE_BMBT,
+        IBUS_DEVICE_BMBT_Button_Mode,
+        INPUT_GESTURE_PRESS,
+        &BMBTInputMode
+    },
+    {
+        INPUT_SOURCE_BMBT,
+        IBUS_DEVICE_BMBT_Button_TEL_Press,
+        INPUT_GESTURE_HOLD,
+        &BMBTInputTELHold
+    },
+    {
+        INPUT_SOURCE_BMBT,
+        IBUS_DEVICE_BMBT_Button_TEL_Press,
+        INPUT_GESTURE_RELEASE,
+        &BMBTInputTELRelease
+    }
+};
 
 static const uint8_t menuSettings[] = {
     BMBT_MENU_IDX_SETTINGS_ABOUT,
@@ -61,6 +113,7 @@ static const char *navZoomScaleMetric[IBUS_SES_ZOOM_LEVELS] = {
 
 void BMBTInit(BT_t *bt, IBus_t *ibus)
 {
+    ResourceGroupInit(&Resources, &Context, sizeof(BMBTContext_t));
     Context.bt = bt;
     Context.ibus = ibus;
     Context.menu = BMBT_MENU_NONE;
@@ -76,115 +129,165 @@ void BMBTInit(BT_t *bt, IBus_t *ibus)
         LocaleGetText(LOCALE_STRING_BLUETOOTH),
         BMBT_DISPLAY_OFF
     );
+    TextLayoutInit(&Context.mainLayout, &BMBTDisplayProfile);
     Context.navZoom = -1;
     Context.navZoomTime = 0;
+    MenuDeviceListInit(
+        &Context.deviceList,
+        bt,
+        BMBT_DEVICE_LIST_PAGE_SIZE,
+        BMBT_DEVICE_NAME_LEN
+    );
 
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         BT_EVENT_DEVICE_CONNECTED,
         &BMBTBTDeviceConnected,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         BT_EVENT_DEVICE_LINK_DISCONNECTED,
         &BMBTBTDeviceDisconnected,
         &Context
     );
-    EventRegisterCallback(
-        BT_EVENT_METADATA_UPDATE,
-        &BMBTBTMetadata,
-        &Context
-    );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         BT_EVENT_BOOT,
         &BMBTBTReady,
         &Context
     );
-    EventRegisterCallback(
-        BT_EVENT_PLAYBACK_STATUS_CHANGE,
-        &BMBTBTPlaybackStatus,
+    ResourceGroupRegisterCallback(
+        &Resources,
+        UIEvent_RenderModelUpdate,
+        &BMBTRenderModelUpdate,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_BMBTButton,
         &BMBTIBusBMBTButtonPress,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
+        UIEvent_InputGesture,
+        &BMBTInputGesture,
+        &Context
+    );
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_CDStatusRequest,
         &BMBTIBusCDChangerStatus,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_GTChangeUIRequest,
         &BMBTIBusGTChangeUIRequest,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_GT_MENU_BUFFER_UPDATE,
         &BMBTIBusGTMenuBufferUpdate,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_GTMenuSelect,
         &BMBTIBusMenuSelect,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_SCREEN_BUFFER_FLUSH,
         &BMBTIBusScreenBufferFlush,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_SENSOR_VALUE_UPDATE,
         &BMBTIBusSensorValueUpdate,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_RADDisplayMenu,
         &BMBTRADDisplayMenu,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupSubscribe(
+        &Resources,
+        VEHICLE_SIGNAL_COOLANT_TEMP,
+        BMBT_TEMP_DEADBAND,
+        &BMBTVehicleTemperatureUpdate,
+        &Context
+    );
+    ResourceGroupSubscribe(
+        &Resources,
+        VEHICLE_SIGNAL_AMBIENT_TEMP,
+        BMBT_TEMP_DEADBAND,
+        &BMBTVehicleTemperatureUpdate,
+        &Context
+    );
+    ResourceGroupSubscribe(
+        &Resources,
+        VEHICLE_SIGNAL_OIL_TEMP,
+        BMBT_TEMP_DEADBAND,
+        &BMBTVehicleTemperatureUpdate,
+        &Context
+    );
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_RAD_WRITE_DISPLAY,
         &BMBTRADUpdateMainArea,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_ScreenModeSet,
         &BMBTGTScreenModeSet,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_ScreenModeUpdate,
         &BMBTRADScreenModeRequest,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_TV_STATUS,
         &BMBTTVStatusUpdate,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_IKE_VEHICLE_CONFIG,
         &BMBTIBusVehicleConfig,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_IKESpeedRPMUpdate,
         &BMBTIKESpeedRPMUpdate,
         &Context
     );
-    Context.headerWriteTaskId = TimerRegisterScheduledTask(
+    Context.headerWriteTaskId = ResourceGroupRegisterTask(
+        &Resources,
         &BMBTTimerHeaderWrite,
         &Context,
         BMBT_HEADER_TIMER_WRITE_INT
     );
-    Context.menuWriteTaskId = TimerRegisterScheduledTask(
+    Context.menuWriteTaskId = ResourceGroupRegisterTask(
+        &Resources,
         &BMBTTimerMenuWrite,
         &Context,
         BMBT_MENU_TIMER_WRITE_INT
     );
-    Context.displayUpdateTaskId = TimerRegisterScheduledTask(
+    Context.displayUpdateTaskId = ResourceGroupRegisterTask(
+        &Resources,
         &BMBTTimerScrollDisplay,
         &Context,
         BMBT_SCROLL_TEXT_TIMER
@@ -194,7 +297,8 @@ void BMBTInit(BT_t *bt, IBus_t *ibus)
 /**
  * BMBTDestroy()
  *     Description:
- *         Unregister all event handlers, scheduled tasks and clear the context
+ *         Release the event handlers, scheduled tasks and signal
+ *         subscriptions the UI registered, and clear the context
  *     Params:
  *         void
  *     Returns:
@@ -202,82 +306,7 @@ void BMBTInit(BT_t *bt, IBus_t *ibus)
  */
 void BMBTDestroy()
 {
-    EventUnregisterCallback(
-        BT_EVENT_DEVICE_CONNECTED,
-        &BMBTBTDeviceConnected
-    );
-    EventUnregisterCallback(
-        BT_EVENT_DEVICE_LINK_DISCONNECTED,
-        &BMBTBTDeviceDisconnected
-    );
-    EventUnregisterCallback(
-        BT_EVENT_METADATA_UPDATE,
-        &BMBTBTMetadata
-    );
-    EventUnregisterCallback(
-        BT_EVENT_BOOT,
-        &BMBTBTReady
-    );
-    EventUnregisterCallback(
-        BT_EVENT_PLAYBACK_STATUS_CHANGE,
-        &BMBTBTPlaybackStatus
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_BMBTButton,
-        &BMBTIBusBMBTButtonPress
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_CDStatusRequest,
-        &BMBTIBusCDChangerStatus
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_SCREEN_BUFFER_FLUSH,
-        &BMBTIBusScreenBufferFlush
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_SENSOR_VALUE_UPDATE,
-        &BMBTIBusSensorValueUpdate
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_GTChangeUIRequest,
-        &BMBTIBusGTChangeUIRequest
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_GT_MENU_BUFFER_UPDATE,
-        &BMBTIBusGTMenuBufferUpdate
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_GTMenuSelect,
-        &BMBTIBusMenuSelect
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_RADDisplayMenu,
-        &BMBTRADDisplayMenu
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_RAD_WRITE_DISPLAY,
-        &BMBTRADUpdateMainArea
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_ScreenModeSet,
-        &BMBTGTScreenModeSet
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_ScreenModeUpdate,
-        &BMBTRADScreenModeRequest
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_TV_STATUS,
-        &BMBTTVStatusUpdate
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_IKE_VEHICLE_CONFIG,
-        &BMBTIBusVehicleConfig
-    );
-    TimerUnregisterScheduledTask(&BMBTTimerHeaderWrite);
-    TimerUnregisterScheduledTask(&BMBTTimerMenuWrite);
-    TimerUnregisterScheduledTask(&BMBTTimerScrollDisplay);
-    memset(&Context, 0, sizeof(BMBTContext_t));
+    ResourceGroupRelease(&Resources);
 }
 
 /**
@@ -354,6 +383,7 @@ static void BMBTSetMainDisplayText(
     context->mainDisplay.text[UTILS_DISPLAY_TEXT_SIZE - 1] = '\0';
     context->mainDisplay.length = strlen(context->mainDisplay.text);
     context->mainDisplay.index = 0;
+    TextLayoutInvalidate(&context->mainLayout);
     if (autoUpdate == 1) {
         TimerTriggerScheduledTask(context->displayUpdateTaskId);
     }
@@ -599,9 +629,9 @@ static void BMBTMenuDashboardUpdateOBCValues(BMBTContext_t *context)
         tempUnit = 'F';
     }
 
-    int ambtemp = context->ibus->ambientTemperature;
-    int oiltemp = context->ibus->oilTemperature;
-    int cooltemp = context->ibus->coolantTemperature;
+    int ambtemp = VehicleGetSignal(VEHICLE_SIGNAL_AMBIENT_TEMP);
+    int oiltemp = VehicleGetSignal(VEHICLE_SIGNAL_OIL_TEMP);
+    int cooltemp = VehicleGetSignal(VEHICLE_SIGNAL_COOLANT_TEMP);
 
     if (tempUnit == 'F') {
         ambtemp = (ambtemp * 1.8 + 32 + 0.5);
@@ -637,36 +667,12 @@ static void BMBTMenuDashboardUpdateOBCValues(BMBTContext_t *context)
     }
 }
 
-static void BMBTMenuDashboardUpdate(BMBTContext_t *context, char *f1, char *f2, char *f3)
-{
-    if (strlen(f1) == 0) {
-        strncpy(f1, " ", 2);
-    }
-
-    // Prevent duplication of fields
-    if (strlen(f2) == 0 && strlen(f3) == 0) {
-        strncpy(f2, " ", 2);
-        strncpy(f3, " ", 2);
-    } else if (strlen(f2) == 0 && strlen(f3) != 0) {
-        char *tmp = f2;
-        f2 = f3;
-        f3 = tmp;
-        strncpy(f3, " ", 2);
-        if (strncmp(f1, f2, BT_METADATA_FIELD_SIZE) == 0) {
-            strncpy(f2, " ", 2);
-        }
-    } else if (strlen(f3) == 0) {
-        strncpy(f3, " ", 2);
-        if (strncmp(f1, f2, BT_METADATA_FIELD_SIZE) == 0) {
-            strncpy(f2, " ", 2);
-        }
-    } else if (strlen(f2) != 0 && strncmp(f2, f3, BT_METADATA_FIELD_SIZE) == 0) {
-        strncpy(f3, " ", 2);
-        if (strncmp(f1, f2, BT_METADATA_FIELD_SIZE) == 0) {
-            strncpy(f2, " ", 2);
-        }
-    }
-
+static void BMBTMenuDashboardUpdate(
+    BMBTContext_t *context,
+    char *f1,
+    char *f2,
+    char *f3
+) {
     if (context->ibus->gtVersion == IBUS_GT_MKIV_STATIC) {
         IBusCommandGTWriteIndexStatic(context->ibus, 0x41, f1);
         IBusCommandGTWriteIndexStatic(context->ibus, 0x42, f2);
@@ -695,37 +701,13 @@ static void BMBTMenuDashboardUpdate(BMBTContext_t *context, char *f1, char *f2,
 
 static void BMBTMenuDashboard(BMBTContext_t *context)
 {
-    char title[BT_METADATA_FIELD_SIZE] = {0};
-    char artist[BT_METADATA_FIELD_SIZE] = {0};
-    char album[BT_METADATA_FIELD_SIZE] = {0};
-    UtilsStrncpy(title, context->bt->title, BT_METADATA_FIELD_SIZE);
-    uint8_t metadataKnown = 1;
-    if (context->bt->playbackStatus == BT_AVRCP_STATUS_PAUSED) {
-        if (strlen(title) == 0) {
-            UtilsStrncpy(
-                title,
-                LocaleGetText(LOCALE_STRING_NOT_PLAYING),
-                BT_METADATA_FIELD_SIZE
-            );
-            metadataKnown = 0;
-        }
-    } else {
-        // Set "Unknown" text for title and artist when missing but ignore
-        // missing album or artist information as many streaming apps do not provide it
-        if (strlen(title) == 0) {
-            UtilsStrncpy(
-                title,
-                LocaleGetText(LOCALE_STRING_UNKNOWN_TITLE),
-                BT_METADATA_FIELD_SIZE
-            );
-        }
-    }
-    // Only copy the data if we need it
-    if (metadataKnown == 1) {
-        UtilsStrncpy(artist, context->bt->artist, BT_METADATA_FIELD_SIZE);
-        UtilsStrncpy(album, context->bt->album, BT_METADATA_FIELD_SIZE);
-    }
-    BMBTMenuDashboardUpdate(context, title, artist, album);
+    RenderModel_t *model = RenderModelGet();
+    BMBTMenuDashboardUpdate(
+        context,
+        model->fields[RENDER_MODEL_FIELD_TITLE],
+        model->fields[RENDER_MODEL_FIELD_ARTIST],
+        model->fields[RENDER_MODEL_FIELD_ALBUM]
+    );
     context->menu = BMBT_MENU_DASHBOARD;
 }
 
@@ -733,52 +715,47 @@ static void BMBTMenuDeviceSelection(BMBTContext_t *context)
 {
     BMBTGTWriteTitleIndex(context, LocaleGetText(LOCALE_STRING_DEVICES));
     uint8_t idx;
-    uint8_t screenIdx = 2;
+    uint8_t screenIdx = BMBT_MENU_IDX_FIRST_DEVICE;
     if (context->bt->discoverable == BT_STATE_ON) {
         BMBTGTWriteIndex(context, BMBT_MENU_IDX_PAIRING_MODE, LocaleGetText(LOCALE_STRING_PAIRING_ON), 0);
     } else {
         BMBTGTWriteIndex(context, BMBT_MENU_IDX_PAIRING_MODE, LocaleGetText(LOCALE_STRING_PAIRING_OFF), 0);
     }
-    BTPairedDevice_t *dev = 0;
-    uint8_t devicesCount = 0;
-    for (idx = 0; idx < context->bt->pairedDevicesCount; idx++) {
-        dev = &context->bt->pairedDevices[idx];
-        if (dev != 0) {
-            devicesCount++;
-        }
-    }
-    if (devicesCount == 0) {
+    MenuDeviceListContext_t *deviceList = &context->deviceList;
+    uint8_t pageCount = MenuDeviceListGetPageCount(deviceList);
+    if (MenuDeviceListGetCount(deviceList) == 0) {
         BMBTGTWriteIndex(context, BMBT_MENU_IDX_CLEAR_PAIRING, LocaleGetText(LOCALE_STRING_CLEAR_PAIRINGS), 5);
     } else {
         BMBTGTWriteIndex(context, BMBT_MENU_IDX_CLEAR_PAIRING, LocaleGetText(LOCALE_STRING_CLEAR_PAIRINGS), 0);
     }
-    for (idx = 0; idx < context->bt->pairedDevicesCount; idx++) {
-        dev = &context->bt->pairedDevices[idx];
-        if (dev != 0) {
-            if (devicesCount > 0) {
-                devicesCount--;
-            }
-            char deviceName[23] = {0};
-            strncpy(deviceName, dev->deviceName, 11);
-            deviceName[22] = '\0';
-            // Add a space and asterisks to the end of the device name
-            // if it's the currently selected device
-            if (memcmp(dev->macId, context->bt->activeDevice.macId, BT_LEN_MAC_ID) == 0) {
-                uint8_t startIdx = strlen(deviceName);
-                if (startIdx > 20) {
-                    startIdx = 20;
-                }
-                deviceName[startIdx++] = 0x20;
-                deviceName[startIdx++] = 0x2A;
-            }
-            if (devicesCount == 0) {
-                uint8_t feedCount = 6 - screenIdx;
-                BMBTGTWriteIndex(context, screenIdx, deviceName, feedCount);
-            } else {
-                BMBTGTWriteIndex(context, screenIdx, deviceName, 0);
+    // Only the devices on the current page are written out
+    for (idx = 0; idx < BMBT_DEVICE_LIST_PAGE_SIZE; idx++) {
+        char deviceName[BMBT_MENU_STRING_MAX_SIZE];
+        if (MenuDeviceListGetRow(deviceList, idx, deviceName, sizeof(deviceName)) == MENU_DEVICE_LIST_DEVICE_NONE) {
+            break;
+        }
+        uint8_t feedCount = 0;
+        if (MenuDeviceListGetDevice(deviceList, idx + 1) == MENU_DEVICE_LIST_DEVICE_NONE) {
+            // Clear the rows below the last device, and the page row if the
+            // list fits on one page
+            feedCount = BMBT_MENU_IDX_DEVICE_PAGE - 1 - screenIdx;
+            if (pageCount == 1) {
+                feedCount++;
             }
-            screenIdx++;
         }
+        BMBTGTWriteIndex(context, screenIdx, deviceName, feedCount);
+        screenIdx++;
+    }
+    if (pageCount > 1) {
+        char pageText[BMBT_MENU_STRING_MAX_SIZE];
+        snprintf(
+            pageText,
+            BMBT_MENU_STRING_MAX_SIZE,
+            "%d/%d >>",
+            deviceList->page + 1,
+            pageCount
+        );
+        BMBTGTWriteIndex(context, BMBT_MENU_IDX_DEVICE_PAGE, pageText, 0);
     }
     BMBTGTWriteIndex(context, BMBT_MENU_IDX_BACK, LocaleGetText(LOCALE_STRING_BACK), 0);
     BMBTGTBufferFlush(context);
@@ -842,413 +819,204 @@ static void BMBTMenuSettingsAbout(BMBTContext_t *context)
     context->menu = BMBT_MENU_SETTINGS_ABOUT;
 }
 
-static void BMBTMenuSettingsAudio(BMBTContext_t *context)
+static void BMBTSettingsFormatDACGain(BMBTContext_t *context, uint8_t value, char *text)
 {
-    BMBTGTWriteTitleIndex(context, LocaleGetText(LOCALE_STRING_SETTINGS_AUDIO));
-    if (ConfigGetSetting(CONFIG_SETTING_AUTOPLAY) == CONFIG_SETTING_OFF) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_AUDIO_AUTOPLAY,
-            LocaleGetText(LOCALE_STRING_AUTOPLAY_OFF),
-            0
-        );
-    } else {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_AUDIO_AUTOPLAY,
-            LocaleGetText(LOCALE_STRING_AUTOPLAY_ON),
-            0
-        );
-    }
-    uint8_t currentVolume = ConfigGetSetting(CONFIG_SETTING_DAC_AUDIO_VOL);
-    char volText[BMBT_MENU_STRING_MAX_SIZE] = {0};
-    if (currentVolume > 0x30) {
-        uint8_t gain = (currentVolume - 0x30) / 2;
-        snprintf(volText, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_VOLUME_NEG_DB), gain);
-    } else if (currentVolume == 0) {
-        snprintf(volText, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_VOLUME_24_DB));
-    } else if (currentVolume == 0x30) {
-        snprintf(volText, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_VOLUME_0_DB));
-    } else {
-        uint8_t gain = (0x30 - currentVolume) / 2;
-        snprintf(volText, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_VOLUME_POS_DB), gain);
-    }
-    BMBTGTWriteIndex(
-        context,
-        BMBT_MENU_IDX_SETTINGS_AUDIO_DAC_GAIN,
-        volText,
-        0
-    );
-    uint8_t dspInput = ConfigGetSetting(CONFIG_SETTING_DSP_INPUT_SRC);
-    if (dspInput == CONFIG_SETTING_DSP_INPUT_SPDIF) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_AUDIO_DSP_INPUT,
-            LocaleGetText(LOCALE_STRING_DSP_DIGITAL),
-            0
-        );
-    } else if (dspInput == CONFIG_SETTING_DSP_INPUT_ANALOG) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_AUDIO_DSP_INPUT,
-            LocaleGetText(LOCALE_STRING_DSP_ANALOG),
-            0
-        );
-    } else {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_AUDIO_DSP_INPUT,
-            LocaleGetText(LOCALE_STRING_DSP_DEFAULT),
-            0
-        );
-    }
-    if (ConfigGetSetting(CONFIG_SETTING_MANAGE_VOLUME) == CONFIG_SETTING_ON) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_AUDIO_MANAGE_VOL,
-            LocaleGetText(LOCALE_STRING_MANAGE_VOL_ON),
-            0
-        );
-    } else {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_AUDIO_MANAGE_VOL,
-            LocaleGetText(LOCALE_STRING_MANAGE_VOL_OFF),
-            0
-        );
-    }
-    if (ConfigGetSetting(CONFIG_SETTING_VOLUME_LOWER_ON_REV) == CONFIG_SETTING_ON) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_AUDIO_REV_VOL,
-            LocaleGetText(LOCALE_STRING_REV_VOL_LOW_ON),
-            2
-        );
+    if (value > 0x30) {
+        uint8_t gain = (value - 0x30) / 2;
+        snprintf(text, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_VOLUME_NEG_DB), gain);
+    } else if (value == 0) {
+        snprintf(text, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_VOLUME_24_DB));
+    } else if (value == 0x30) {
+        snprintf(text, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_VOLUME_0_DB));
     } else {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_AUDIO_REV_VOL,
-            LocaleGetText(LOCALE_STRING_REV_VOL_LOW_OFF),
-            2
-        );
+        uint8_t gain = (0x30 - value) / 2;
+        snprintf(text, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_VOLUME_POS_DB), gain);
     }
-    BMBTGTWriteIndex(context, BMBT_MENU_IDX_BACK, LocaleGetText(LOCALE_STRING_BACK), 0);
-    BMBTGTBufferFlush(context);
-    context->menu = BMBT_MENU_SETTINGS_AUDIO;
 }
 
-static void BMBTMenuSettingsComfort(BMBTContext_t *context)
+static uint8_t BMBTSettingsNextDACGain(BMBTContext_t *context, uint8_t value)
 {
-    BMBTGTWriteTitleIndex(context, LocaleGetText(LOCALE_STRING_SETTINGS_COMFORT));
-    uint8_t comfortLock = ConfigGetComfortLock();
-    if (comfortLock == CONFIG_SETTING_COMFORT_LOCK_10KM) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_COMFORT_LOCK,
-            LocaleGetText(LOCALE_STRING_LOCK_10KMH),
-            0
-        );
-    } else if (comfortLock == CONFIG_SETTING_COMFORT_LOCK_20KM) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_COMFORT_LOCK,
-            LocaleGetText(LOCALE_STRING_LOCK_20KMH),
-            0
-        );
-    } else {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_COMFORT_LOCK,
-            LocaleGetText(LOCALE_STRING_LOCK_OFF),
-            0
-        );
+    value = value + 2;
+    if (value > 96) {
+        value = 0;
     }
-    uint8_t comfortUnlock = ConfigGetComfortUnlock();
-    if (comfortUnlock == CONFIG_SETTING_COMFORT_UNLOCK_POS_1) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_COMFORT_UNLOCK,
-            LocaleGetText(LOCALE_STRING_UNLOCK_POS_1),
-            0
-        );
-    } else if (comfortUnlock == CONFIG_SETTING_COMFORT_UNLOCK_POS_0) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_COMFORT_UNLOCK,
-            LocaleGetText(LOCALE_STRING_UNLOCK_POS_0),
-            0
-        );
-    } else {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_COMFORT_UNLOCK,
-            LocaleGetText(LOCALE_STRING_UNLOCK_OFF),
-            0
-        );
+    return value;
+}
+
+static void BMBTSettingsApplyDACGain(BMBTContext_t *context, uint8_t value)
+{
+    PCM51XXSetVolume(value);
+}
+
+static void BMBTSettingsApplyDSPInput(BMBTContext_t *context, uint8_t value)
+{
+    if (value == CONFIG_SETTING_DSP_INPUT_SPDIF) {
+        IBusCommandDSPSetMode(context->ibus, IBUS_DSP_CONFIG_SET_INPUT_SPDIF);
+    } else if (value == CONFIG_SETTING_DSP_INPUT_ANALOG) {
+        IBusCommandDSPSetMode(context->ibus, IBUS_DSP_CONFIG_SET_INPUT_RADIO);
     }
-    uint8_t blinkCount = ConfigGetSetting(CONFIG_SETTING_COMFORT_BLINKERS);
-    if (blinkCount == 0) {
-        blinkCount = 1;
+}
+
+static void BMBTSettingsApplyParkingLamps(BMBTContext_t *context, uint8_t value)
+{
+    // Request cluster indicators so we can trigger the new light setting
+    // when the response (0x5B) is received
+    IBusCommandLMGetClusterIndicators(context->ibus);
+}
+
+static void BMBTSettingsFormatAutoZoom(BMBTContext_t *context, uint8_t value, char *text)
+{
+    if (value >= IBUS_SES_ZOOM_LEVELS) {
+        value = CONFIG_SETTING_OFF;
     }
-    char blinkerText[BMBT_MENU_STRING_MAX_SIZE] = {0};
-    snprintf(blinkerText, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_BLINKERS), blinkCount);
-    BMBTGTWriteIndex(
-        context,
-        BMBT_MENU_IDX_SETTINGS_COMFORT_BLINKERS,
-        blinkerText,
-        0
-    );
-    if (ConfigGetSetting(CONFIG_SETTING_COMFORT_PARKING_LAMPS) == CONFIG_SETTING_ON) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_COMFORT_PARKING_LAMPS,
-            LocaleGetText(LOCALE_STRING_PARK_LAMPS_ON),
-            0
+    if (value == CONFIG_SETTING_OFF) {
+        snprintf(text, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_AUTOZOOM), "Off");
+    } else if (ConfigGetDistUnit() == 0) {
+        snprintf(
+            text,
+            BMBT_MENU_STRING_MAX_SIZE,
+            LocaleGetText(LOCALE_STRING_AUTOZOOM),
+            navZoomScaleMetric[value]
         );
     } else {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_COMFORT_PARKING_LAMPS,
-            LocaleGetText(LOCALE_STRING_PARK_LAMPS_OFF),
-            0
-        );
-    }
-    uint8_t autozoom = ConfigGetSetting(CONFIG_SETTING_COMFORT_AUTOZOOM);
-    if (autozoom >= IBUS_SES_ZOOM_LEVELS) {
-        autozoom = CONFIG_SETTING_OFF;
-    }
-    char autoZoomText[BMBT_MENU_STRING_MAX_SIZE] = {0};
-    if (autozoom == CONFIG_SETTING_OFF) {
         snprintf(
-            autoZoomText,
+            text,
             BMBT_MENU_STRING_MAX_SIZE,
             LocaleGetText(LOCALE_STRING_AUTOZOOM),
-            "Off"
+            navZoomScaleImperial[value]
         );
-    } else {
-        if (ConfigGetDistUnit() == 0) {
-            snprintf(
-                autoZoomText,
-                BMBT_MENU_STRING_MAX_SIZE,
-                LocaleGetText(LOCALE_STRING_AUTOZOOM),
-                navZoomScaleMetric[autozoom]
-            );
-        } else {
-            snprintf(
-                autoZoomText,
-                BMBT_MENU_STRING_MAX_SIZE,
-                LocaleGetText(LOCALE_STRING_AUTOZOOM),
-                navZoomScaleImperial[autozoom]
-            );
-        }
     }
-    BMBTGTWriteIndex(context, BMBT_MENU_IDX_SETTINGS_COMFORT_AUTOZOOM, autoZoomText, 1);
-    BMBTGTWriteIndex(context, BMBT_MENU_IDX_BACK, LocaleGetText(LOCALE_STRING_BACK), 0);
-    BMBTGTBufferFlush(context);
-    context->menu = BMBT_MENU_SETTINGS_COMFORT;
 }
 
-static void BMBTMenuSettingsCalling(BMBTContext_t *context)
+static void BMBTSettingsApplyHFP(BMBTContext_t *context, uint8_t value)
 {
-    BMBTGTWriteTitleIndex(context, LocaleGetText(LOCALE_STRING_SETTINGS_CALLING));
-    if (ConfigGetSetting(CONFIG_SETTING_HFP) == CONFIG_SETTING_OFF) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_CALLING_HFP,
-            LocaleGetText(LOCALE_STRING_HANDSFREE_OFF),
-            0
-        );
-    } else {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_CALLING_HFP,
-            LocaleGetText(LOCALE_STRING_HANDSFREE_ON),
-            0
-        );
-    }
-    uint8_t micGain = ConfigGetSetting(CONFIG_SETTING_MIC_GAIN);
-    char micGainText[BMBT_MENU_STRING_MAX_SIZE] = {0};
-    if (context->bt->type == BT_BTM_TYPE_BC127) {
-        if (micGain > 21) {
-            micGain = 0;
+    if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
+        if (value == CONFIG_SETTING_ON) {
+            BC127CommandProfileOpen(context->bt, "HFP");
+        } else {
+            BC127CommandClose(context->bt, context->bt->activeDevice.hfpId);
         }
-        snprintf(
-            micGainText,
-            BMBT_MENU_STRING_MAX_SIZE,
-            LocaleGetText(LOCALE_STRING_MIC_GAIN),
-            (int8_t) BTBC127MicGainTable[micGain]
-        );
+    } else if (value == CONFIG_SETTING_OFF) {
+        BM83CommandDisconnect(context->bt, BM83_CMD_DISCONNECT_PARAM_HF);
     } else {
-        if (micGain > 0x0F) {
-            micGain = 0;
+        BTPairedDevice_t *device = 0;
+        uint8_t i = 0;
+        for (i = 0; i < BT_MAC_ID_LEN; i++) {
+            BTPairedDevice_t *tmpDev = &context->bt->pairedDevices[i];
+            if (memcmp(context->bt->activeDevice.macId, tmpDev->macId, BT_MAC_ID_LEN) == 0) {
+                device = tmpDev;
+            }
         }
-        snprintf(
-            micGainText,
-            BMBT_MENU_STRING_MAX_SIZE,
-            LocaleGetText(LOCALE_STRING_MIC_GAIN),
-            (int8_t) BTBM83MicGainTable[micGain]
-        );
-    }
-    BMBTGTWriteIndex(
-        context,
-        BMBT_MENU_IDX_SETTINGS_CALLING_MIC_GAIN,
-        micGainText,
-        0
-    );
-    uint8_t volOffsetSkip = 0;
-    if (context->bt->type == BT_BTM_TYPE_BC127) {
-        volOffsetSkip = 4;
-    }
-    int8_t volumeOffset = ConfigGetSetting(CONFIG_SETTING_TEL_VOL);
-    char volOffsetText[BMBT_MENU_STRING_MAX_SIZE] = {0};
-    snprintf(
-        volOffsetText,
-        BMBT_MENU_STRING_MAX_SIZE,
-        LocaleGetText(LOCALE_STRING_VOL_OFFSET),
-        volumeOffset
-    );
-    BMBTGTWriteIndex(
-        context,
-        BMBT_MENU_IDX_SETTINGS_CALLING_VOL_OFFSET,
-        volOffsetText,
-        volOffsetSkip
-    );
-    // Hide TCU Mode option on HW Version 1. It is not necessary there.
-    if (context->bt->type != BT_BTM_TYPE_BC127) {
-        uint8_t telMode = ConfigGetSetting(CONFIG_SETTING_TEL_MODE);
-        if (telMode == CONFIG_SETTING_TEL_MODE_TCU) {
-            BMBTGTWriteIndex(
-                context,
-                BMBT_MENU_IDX_SETTINGS_CALLING_MODE,
-                LocaleGetText(LOCALE_STRING_MODE_TCU),
-                3
-            );
-        } else if (telMode == CONFIG_SETTING_TEL_MODE_NO_MUTE) {
-            BMBTGTWriteIndex(
-                context,
-                BMBT_MENU_IDX_SETTINGS_CALLING_MODE,
-                LocaleGetText(LOCALE_STRING_MODE_NO_MUTE),
-                3
-            );
-        } else {
-            BMBTGTWriteIndex(
-                context,
-                BMBT_MENU_IDX_SETTINGS_CALLING_MODE,
-                LocaleGetText(LOCALE_STRING_MODE_DEFAULT),
-                3
+        if (device != 0) {
+            BM83CommandConnect(
+                context->bt,
+                device,
+                BM83_DATA_LINK_BACK_PROFILES_HF
             );
         }
     }
-    BMBTGTWriteIndex(context, BMBT_MENU_IDX_BACK, LocaleGetText(LOCALE_STRING_BACK), 0);
-    BMBTGTBufferFlush(context);
-    context->menu = BMBT_MENU_SETTINGS_CALLING;
 }
 
-static void BMBTMenuSettingsUI(BMBTContext_t *context)
+static uint8_t BMBTSettingsMicGainMax(BMBTContext_t *context)
 {
-    BMBTGTWriteTitleIndex(context, LocaleGetText(LOCALE_STRING_SETTINGS_UI));
-    if (ConfigGetSetting(CONFIG_SETTING_BMBT_DEFAULT_MENU) == CONFIG_SETTING_OFF) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_UI_DEFAULT_MENU,
-            LocaleGetText(LOCALE_STRING_MENU_MAIN),
-            0
-        );
-    } else {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_UI_DEFAULT_MENU,
-            LocaleGetText(LOCALE_STRING_MENU_DASHBOARD),
-            0
-        );
+    if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
+        return 21;
     }
-    uint8_t metadataMode = ConfigGetSetting(CONFIG_SETTING_METADATA_MODE);
-    if (metadataMode == BMBT_METADATA_MODE_PARTY) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_UI_METADATA_MODE,
-            LocaleGetText(LOCALE_STRING_METADATA_PARTY),
-            0
-        );
-    } else if (metadataMode == BMBT_METADATA_MODE_CHUNK) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_UI_METADATA_MODE,
-            LocaleGetText(LOCALE_STRING_METADATA_CHUNK),
-            0
-        );
-    } else {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_UI_METADATA_MODE,
-            LocaleGetText(LOCALE_STRING_METADATA_OFF),
-            0
-        );
+    return 0x0F;
+}
+
+static uint8_t BMBTSettingsNextMicGain(BMBTContext_t *context, uint8_t value)
+{
+    value = value + 1;
+    if (value > BMBTSettingsMicGainMax(context)) {
+        value = 0;
     }
-    uint8_t tempMode = ConfigGetTempDisplay();
-    if (tempMode == CONFIG_SETTING_OFF) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_UI_TEMPS,
-            LocaleGetText(LOCALE_STRING_TEMPS_OFF),
-            0
-        );
-    } else if (tempMode == CONFIG_SETTING_TEMP_COOLANT) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_UI_TEMPS,
-            LocaleGetText(LOCALE_STRING_TEMPS_COOLANT),
-            0
-        );
-    } else if (tempMode == CONFIG_SETTING_TEMP_AMBIENT) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_UI_TEMPS,
-            LocaleGetText(LOCALE_STRING_TEMPS_AMBIENT),
-            0
-        );
-    } else if (tempMode == CONFIG_SETTING_TEMP_OIL) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_UI_TEMPS,
-            LocaleGetText(LOCALE_STRING_TEMPS_OIL),
-            0
-        );
+    return value;
+}
+
+static void BMBTSettingsFormatMicGain(BMBTContext_t *context, uint8_t value, char *text)
+{
+    if (value > BMBTSettingsMicGainMax(context)) {
+        value = 0;
     }
-    uint8_t dashboardOBC = ConfigGetSetting(CONFIG_SETTING_BMBT_DASHBOARD_OBC);
-    if (dashboardOBC == CONFIG_SETTING_ON) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_IU_DASH_OBC,
-            LocaleGetText(LOCALE_STRING_DASH_OBC_ON),
-            0
-        );
-    } else if (dashboardOBC == CONFIG_SETTING_OFF) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_IU_DASH_OBC,
-            LocaleGetText(LOCALE_STRING_DASH_OBC_OFF),
-            0
-        );
+    int8_t gain = BTBM83MicGainTable[value];
+    if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
+        gain = BTBC127MicGainTable[value];
     }
-    if (ConfigGetSetting(CONFIG_SETTING_MONITOR_OFF) == CONFIG_SETTING_ON) {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_UI_MONITOR_OFF,
-            LocaleGetText(LOCALE_STRING_BMBT_OFF_ON),
-            0
+    snprintf(text, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_MIC_GAIN), gain);
+}
+
+static void BMBTSettingsApplyMicGain(BMBTContext_t *context, uint8_t value)
+{
+    if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
+        BC127CommandSetMicGain(
+            context->bt,
+            value,
+            ConfigGetSetting(CONFIG_SETTING_MIC_BIAS),
+            ConfigGetSetting(CONFIG_SETTING_MIC_PREAMP)
         );
+    } else if (value == 0x00) {
+        // Reset the gain
+        uint8_t start = 0x0F;
+        while (start > 0) {
+            BM83CommandMicGainDown(context->bt);
+            start--;
+        }
     } else {
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_UI_MONITOR_OFF,
-            LocaleGetText(LOCALE_STRING_BMBT_OFF_OFF),
-            0
-        );
+        BM83CommandMicGainUp(context->bt);
+    }
+}
+
+static void BMBTSettingsApplyMetadataMode(BMBTContext_t *context, uint8_t value)
+{
+    RenderModel_t *model = RenderModelGet();
+    if (value != BMBT_METADATA_MODE_OFF &&
+        model->hasTitle == 1 &&
+        model->playbackStatus == BT_AVRCP_STATUS_PLAYING
+    ) {
+        BMBTSetMainDisplayText(context, model->text, 0, 0);
+    } else if (value == BMBT_METADATA_MODE_OFF) {
+        BMBTGTBufferFlush(context);
+        BMBTGTWriteTitle(context, LocaleGetText(LOCALE_STRING_BLUETOOTH));
+    }
+}
+
+static uint8_t BMBTSettingsNextTemps(BMBTContext_t *context, uint8_t value)
+{
+    if (value == CONFIG_SETTING_OFF) {
+        return CONFIG_SETTING_TEMP_COOLANT;
+    } else if (value == CONFIG_SETTING_TEMP_COOLANT) {
+        return CONFIG_SETTING_TEMP_AMBIENT;
+    } else if (
+        value == CONFIG_SETTING_TEMP_AMBIENT &&
+        context->ibus->vehicleType != IBUS_VEHICLE_TYPE_E46 &&
+        context->ibus->vehicleType != IBUS_VEHICLE_TYPE_E8X
+    ) {
+        return CONFIG_SETTING_TEMP_OIL;
     }
-    uint8_t selectedLanguage = ConfigGetSetting(CONFIG_SETTING_LANGUAGE);
+    return CONFIG_SETTING_OFF;
+}
+
+static void BMBTSettingsApplyTemps(BMBTContext_t *context, uint8_t value)
+{
+    uint8_t valueType = IBUS_SENSOR_VALUE_COOLANT_TEMP;
+    if (value == CONFIG_SETTING_OFF) {
+        // Clear the header area
+        IBusCommandGTWriteZone(context->ibus, BMBT_HEADER_TEMPS, "      ");
+        IBusCommandGTUpdate(context->ibus, IBUS_CMD_GT_WRITE_ZONE);
+        return;
+    } else if (value == CONFIG_SETTING_TEMP_AMBIENT) {
+        valueType = IBUS_SENSOR_VALUE_AMBIENT_TEMP;
+    } else if (value == CONFIG_SETTING_TEMP_OIL) {
+        valueType = IBUS_SENSOR_VALUE_OIL_TEMP;
+    }
+    BMBTIBusSensorValueUpdate((void *)context, &valueType);
+}
+
+static void BMBTSettingsFormatLanguage(BMBTContext_t *context, uint8_t value, char *text)
+{
     char localeName[5] = {0};
-    switch (selectedLanguage) {
+    switch (value) {
         case CONFIG_SETTING_LANGUAGE_DUTCH:
             strncpy(localeName, "NL", 2);
             break;
@@ -1281,477 +1049,511 @@ static void BMBTMenuSettingsUI(BMBTContext_t *context)
             strncpy(localeName, "Auto", 4);
             break;
     }
-    char langStr[BMBT_MENU_STRING_MAX_SIZE] = {0};
-    snprintf(
-        langStr,
-        BMBT_MENU_STRING_MAX_SIZE,
-        LocaleGetText(LOCALE_STRING_LANG),
-        localeName
-    );
-    BMBTGTWriteIndex(
-        context,
-        BMBT_MENU_IDX_SETTINGS_UI_LANGUAGE,
-        langStr,
-        1
-    );
-    BMBTGTWriteIndex(context, BMBT_MENU_IDX_BACK, LocaleGetText(LOCALE_STRING_BACK), 0);
-    BMBTGTBufferFlush(context);
-    context->menu = BMBT_MENU_SETTINGS_UI;
+    snprintf(text, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_LANG), localeName);
 }
 
-static void BMBTSettingsUpdateAbout(BMBTContext_t *context, uint8_t selectedIdx)
+static void BMBTSettingsApplyLanguage(BMBTContext_t *context, uint8_t value)
 {
-    if (selectedIdx == BMBT_MENU_IDX_BACK) {
-        BMBTMenuSettings(context);
-    }
+    // Pick up the placeholder title in the new language
+    RenderModelRefresh();
+    BMBTTriggerWriteHeader(context);
 }
 
-static void BMBTSettingsUpdateAudio(BMBTContext_t *context, uint8_t selectedIdx)
+static const BMBTSettingValue_t settingsAutoplayValues[] = {
+    {CONFIG_SETTING_OFF, LOCALE_STRING_AUTOPLAY_OFF},
+    {CONFIG_SETTING_ON, LOCALE_STRING_AUTOPLAY_ON}
+};
+
+static const BMBTSettingValue_t settingsDSPInputValues[] = {
+    {CONFIG_SETTING_OFF, LOCALE_STRING_DSP_DEFAULT},
+    {CONFIG_SETTING_DSP_INPUT_SPDIF, LOCALE_STRING_DSP_DIGITAL},
+    {CONFIG_SETTING_DSP_INPUT_ANALOG, LOCALE_STRING_DSP_ANALOG}
+};
+
+static const BMBTSettingValue_t settingsManageVolValues[] = {
+    {CONFIG_SETTING_OFF, LOCALE_STRING_MANAGE_VOL_OFF},
+    {CONFIG_SETTING_ON, LOCALE_STRING_MANAGE_VOL_ON}
+};
+
+static const BMBTSettingValue_t settingsRevVolValues[] = {
+    {CONFIG_SETTING_OFF, LOCALE_STRING_REV_VOL_LOW_OFF},
+    {CONFIG_SETTING_ON, LOCALE_STRING_REV_VOL_LOW_ON}
+};
+
+static const BMBTSettingValue_t settingsLockValues[] = {
+    {CONFIG_SETTING_OFF, LOCALE_STRING_LOCK_OFF},
+    {CONFIG_SETTING_COMFORT_LOCK_10KM, LOCALE_STRING_LOCK_10KMH},
+    {CONFIG_SETTING_COMFORT_LOCK_20KM, LOCALE_STRING_LOCK_20KMH}
+};
+
+static const BMBTSettingValue_t settingsUnlockValues[] = {
+    {CONFIG_SETTING_OFF, LOCALE_STRING_UNLOCK_OFF},
+    {CONFIG_SETTING_COMFORT_UNLOCK_POS_1, LOCALE_STRING_UNLOCK_POS_1},
+    {CONFIG_SETTING_COMFORT_UNLOCK_POS_0, LOCALE_STRING_UNLOCK_POS_0}
+};
+
+static const BMBTSettingValue_t settingsParkingLampsValues[] = {
+    {CONFIG_SETTING_OFF, LOCALE_STRING_PARK_LAMPS_OFF},
+    {CONFIG_SETTING_ON, LOCALE_STRING_PARK_LAMPS_ON}
+};
+
+static const BMBTSettingValue_t settingsHFPValues[] = {
+    {CONFIG_SETTING_OFF, LOCALE_STRING_HANDSFREE_OFF},
+    {CONFIG_SETTING_ON, LOCALE_STRING_HANDSFREE_ON}
+};
+
+static const BMBTSettingValue_t settingsTelModeValues[] = {
+    {CONFIG_SETTING_TEL_MODE_DEFAULT, LOCALE_STRING_MODE_DEFAULT},
+    {CONFIG_SETTING_TEL_MODE_TCU, LOCALE_STRING_MODE_TCU},
+    {CONFIG_SETTING_TEL_MODE_NO_MUTE, LOCALE_STRING_MODE_NO_MUTE}
+};
+
+static const BMBTSettingValue_t settingsDefaultMenuValues[] = {
+    {CONFIG_SETTING_OFF, LOCALE_STRING_MENU_MAIN},
+    {CONFIG_SETTING_ON, LOCALE_STRING_MENU_DASHBOARD}
+};
+
+static const BMBTSettingValue_t settingsMetadataModeValues[] = {
+    {BMBT_METADATA_MODE_OFF, LOCALE_STRING_METADATA_OFF},
+    {BMBT_METADATA_MODE_PARTY, LOCALE_STRING_METADATA_PARTY},
+    {BMBT_METADATA_MODE_CHUNK, LOCALE_STRING_METADATA_CHUNK}
+};
+
+static const BMBTSettingValue_t settingsTempsValues[] = {
+    {CONFIG_SETTING_OFF, LOCALE_STRING_TEMPS_OFF},
+    {CONFIG_SETTING_TEMP_COOLANT, LOCALE_STRING_TEMPS_COOLANT},
+    {CONFIG_SETTING_TEMP_AMBIENT, LOCALE_STRING_TEMPS_AMBIENT},
+    {CONFIG_SETTING_TEMP_OIL, LOCALE_STRING_TEMPS_OIL}
+};
+
+static const BMBTSettingValue_t settingsDashOBCValues[] = {
+    {CONFIG_SETTING_OFF, LOCALE_STRING_DASH_OBC_OFF},
+    {CONFIG_SETTING_ON, LOCALE_STRING_DASH_OBC_ON}
+};
+
+static const BMBTSettingValue_t settingsMonitorOffValues[] = {
+    {CONFIG_SETTING_OFF, LOCALE_STRING_BMBT_OFF_OFF},
+    {CONFIG_SETTING_ON, LOCALE_STRING_BMBT_OFF_ON}
+};
+
+// The order the language setting cycles through
+static const BMBTSettingValue_t settingsLanguageValues[] = {
+    {CONFIG_SETTING_LANGUAGE_AUTO, 0},
+    {CONFIG_SETTING_LANGUAGE_ENGLISH, 0},
+    {CONFIG_SETTING_LANGUAGE_ESTONIAN, 0},
+    {CONFIG_SETTING_LANGUAGE_GERMAN, 0},
+    {CONFIG_SETTING_LANGUAGE_ITALIAN, 0},
+    {CONFIG_SETTING_LANGUAGE_RUSSIAN, 0},
+    {CONFIG_SETTING_LANGUAGE_SPANISH, 0},
+    {CONFIG_SETTING_LANGUAGE_POLISH, 0},
+    {CONFIG_SETTING_LANGUAGE_FRENCH, 0},
+    {CONFIG_SETTING_LANGUAGE_DUTCH, 0}
+};
+
+#define BMBT_SETTING_VALUES(list) .values = list, .valuesCount = sizeof(list) / sizeof(BMBTSettingValue_t)
+
+/* Rows are listed in BMBT_MENU_IDX_SETTINGS_* order */
+static const BMBTSettingItem_t settingsAudioItems[] = {
+    {
+        .setting = CONFIG_SETTING_AUTOPLAY,
+        BMBT_SETTING_VALUES(settingsAutoplayValues)
+    },
+    {
+        .setting = CONFIG_SETTING_DAC_AUDIO_VOL,
+        .next = &BMBTSettingsNextDACGain,
+        .format = &BMBTSettingsFormatDACGain,
+        .apply = &BMBTSettingsApplyDACGain
+    },
+    {
+        .setting = CONFIG_SETTING_DSP_INPUT_SRC,
+        BMBT_SETTING_VALUES(settingsDSPInputValues),
+        .apply = &BMBTSettingsApplyDSPInput
+    },
+    {
+        .setting = CONFIG_SETTING_MANAGE_VOLUME,
+        BMBT_SETTING_VALUES(settingsManageVolValues)
+    },
+    {
+        .setting = CONFIG_SETTING_VOLUME_LOWER_ON_REV,
+        BMBT_SETTING_VALUES(settingsRevVolValues)
+    }
+};
+
+static const BMBTSettingItem_t settingsComfortItems[] = {
+    {
+        BMBT_SETTING_VALUES(settingsLockValues),
+        .get = &ConfigGetComfortLock,
+        .set = &ConfigSetComfortLock
+    },
+    {
+        BMBT_SETTING_VALUES(settingsUnlockValues),
+        .get = &ConfigGetComfortUnlock,
+        .set = &ConfigSetComfortUnlock
+    },
+    {
+        .setting = CONFIG_SETTING_COMFORT_BLINKERS,
+        .min = 1,
+        .max = 8,
+        .label = LOCALE_STRING_BLINKERS
+    },
+    {
+        .setting = CONFIG_SETTING_COMFORT_PARKING_LAMPS,
+        BMBT_SETTING_VALUES(settingsParkingLampsValues),
+        .apply = &BMBTSettingsApplyParkingLamps
+    },
+    {
+        .setting = CONFIG_SETTING_COMFORT_AUTOZOOM,
+        .min = CONFIG_SETTING_OFF,
+        .max = IBUS_SES_ZOOM_LEVELS - 1,
+        .format = &BMBTSettingsFormatAutoZoom
+    }
+};
+
+static const BMBTSettingItem_t settingsCallingItems[] = {
+    {
+        .setting = CONFIG_SETTING_HFP,
+        BMBT_SETTING_VALUES(settingsHFPValues),
+        .apply = &BMBTSettingsApplyHFP
+    },
+    {
+        .setting = CONFIG_SETTING_MIC_GAIN,
+        .next = &BMBTSettingsNextMicGain,
+        .format = &BMBTSettingsFormatMicGain,
+        .apply = &BMBTSettingsApplyMicGain
+    },
+    {
+        .setting = CONFIG_SETTING_TEL_VOL,
+        .min = 0,
+        .max = CONFIG_SETTING_TEL_VOL_OFFSET_MAX,
+        .label = LOCALE_STRING_VOL_OFFSET
+    },
+    {
+        // Not necessary on HW Version 1
+        .setting = CONFIG_SETTING_TEL_MODE,
+        .flags = BMBT_SETTING_FLAG_BM83_ONLY,
+        BMBT_SETTING_VALUES(settingsTelModeValues)
+    }
+};
+
+static const BMBTSettingItem_t settingsUIItems[] = {
+    {
+        .setting = CONFIG_SETTING_BMBT_DEFAULT_MENU,
+        BMBT_SETTING_VALUES(settingsDefaultMenuValues)
+    },
+    {
+        .setting = CONFIG_SETTING_METADATA_MODE,
+        BMBT_SETTING_VALUES(settingsMetadataModeValues),
+        .apply = &BMBTSettingsApplyMetadataMode
+    },
+    {
+        BMBT_SETTING_VALUES(settingsTempsValues),
+        .get = &ConfigGetTempDisplay,
+        .set = &ConfigSetTempDisplay,
+        .next = &BMBTSettingsNextTemps,
+        .apply = &BMBTSettingsApplyTemps
+    },
+    {
+        .setting = CONFIG_SETTING_BMBT_DASHBOARD_OBC,
+        BMBT_SETTING_VALUES(settingsDashOBCValues)
+    },
+    {
+        .setting = CONFIG_SETTING_MONITOR_OFF,
+        BMBT_SETTING_VALUES(settingsMonitorOffValues)
+    },
+    {
+        // Every row has to be redrawn in the new language
+        .setting = CONFIG_SETTING_LANGUAGE,
+        .flags = BMBT_SETTING_FLAG_REDRAW,
+        BMBT_SETTING_VALUES(settingsLanguageValues),
+        .format = &BMBTSettingsFormatLanguage,
+        .apply = &BMBTSettingsApplyLanguage
+    }
+};
+
+/* Indexed by menu ID, starting at BMBT_MENU_SETTINGS_AUDIO */
+static const BMBTSettingsMenu_t settingsMenus[] = {
+    {
+        LOCALE_STRING_SETTINGS_AUDIO,
+        settingsAudioItems,
+        sizeof(settingsAudioItems) / sizeof(BMBTSettingItem_t)
+    },
+    {
+        LOCALE_STRING_SETTINGS_COMFORT,
+        settingsComfortItems,
+        sizeof(settingsComfortItems) / sizeof(BMBTSettingItem_t)
+    },
+    {
+        LOCALE_STRING_SETTINGS_CALLING,
+        settingsCallingItems,
+        sizeof(settingsCallingItems) / sizeof(BMBTSettingItem_t)
+    },
+    {
+        LOCALE_STRING_SETTINGS_UI,
+        settingsUIItems,
+        sizeof(settingsUIItems) / sizeof(BMBTSettingItem_t)
+    }
+};
+
+/**
+ * BMBTSettingsGetMenu()
+ *     Description:
+ *         Get the table entry for the given settings menu
+ *     Params:
+ *         uint8_t menu - The menu ID
+ *     Returns:
+ *         const BMBTSettingsMenu_t * - The menu, or 0 if it is not table driven
+ */
+static const BMBTSettingsMenu_t *BMBTSettingsGetMenu(uint8_t menu)
 {
-    if (selectedIdx == BMBT_MENU_IDX_SETTINGS_AUDIO_DAC_GAIN) {
-        uint8_t currentVolume = ConfigGetSetting(CONFIG_SETTING_DAC_AUDIO_VOL);
-        currentVolume = currentVolume + 2;
-        if (currentVolume > 96) {
-            currentVolume = 0;
-        }
-        ConfigSetSetting(CONFIG_SETTING_DAC_AUDIO_VOL, currentVolume);
-        char volText[BMBT_MENU_STRING_MAX_SIZE] = {0};
-        if (currentVolume > 0x30) {
-            uint8_t gain = (currentVolume - 0x30) / 2;
-            snprintf(volText, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_VOLUME_NEG_DB), gain);
-        } else if (currentVolume == 0) {
-            snprintf(volText, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_VOLUME_24_DB));
-        } else if (currentVolume == 0x30) {
-            snprintf(volText, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_VOLUME_0_DB));
-        } else {
-            uint8_t gain = (0x30 - currentVolume) / 2;
-            snprintf(volText, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_VOLUME_POS_DB), gain);
-        }
-        BMBTGTWriteIndex(context, selectedIdx, volText, 0);
-        PCM51XXSetVolume(currentVolume);
-    } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_AUDIO_DSP_INPUT) {
-        uint8_t dspInput = ConfigGetSetting(CONFIG_SETTING_DSP_INPUT_SRC);
-        if (dspInput == CONFIG_SETTING_OFF) {
-            ConfigSetSetting(CONFIG_SETTING_DSP_INPUT_SRC, CONFIG_SETTING_DSP_INPUT_SPDIF);
-            IBusCommandDSPSetMode(context->ibus, IBUS_DSP_CONFIG_SET_INPUT_SPDIF);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_DSP_DIGITAL), 0);
-        } else if (dspInput == CONFIG_SETTING_DSP_INPUT_SPDIF) {
-            ConfigSetSetting(CONFIG_SETTING_DSP_INPUT_SRC, CONFIG_SETTING_DSP_INPUT_ANALOG);
-            IBusCommandDSPSetMode(context->ibus, IBUS_DSP_CONFIG_SET_INPUT_RADIO);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_DSP_ANALOG), 0);
-        } else {
-            ConfigSetSetting(CONFIG_SETTING_DSP_INPUT_SRC, CONFIG_SETTING_OFF);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_DSP_DEFAULT), 0);
-        }
-    } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_AUDIO_AUTOPLAY) {
-        if (ConfigGetSetting(CONFIG_SETTING_AUTOPLAY) == CONFIG_SETTING_OFF) {
-            ConfigSetSetting(CONFIG_SETTING_AUTOPLAY, CONFIG_SETTING_ON);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_AUTOPLAY_ON), 0);
-        } else {
-            ConfigSetSetting(CONFIG_SETTING_AUTOPLAY, CONFIG_SETTING_OFF);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_AUTOPLAY_OFF), 0);
-        }
-    } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_AUDIO_MANAGE_VOL) {
-        if (ConfigGetSetting(CONFIG_SETTING_MANAGE_VOLUME) == CONFIG_SETTING_OFF) {
-            ConfigSetSetting(CONFIG_SETTING_MANAGE_VOLUME, CONFIG_SETTING_ON);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_MANAGE_VOL_ON), 0);
-        } else {
-            ConfigSetSetting(CONFIG_SETTING_MANAGE_VOLUME, CONFIG_SETTING_OFF);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_MANAGE_VOL_OFF), 0);
-        }
-    } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_AUDIO_REV_VOL) {
-        if (ConfigGetSetting(CONFIG_SETTING_VOLUME_LOWER_ON_REV) == CONFIG_SETTING_OFF) {
-            ConfigSetSetting(CONFIG_SETTING_VOLUME_LOWER_ON_REV, CONFIG_SETTING_ON);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_REV_VOL_LOW_ON), 0);
-        } else {
-            ConfigSetSetting(CONFIG_SETTING_VOLUME_LOWER_ON_REV, CONFIG_SETTING_OFF);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_REV_VOL_LOW_OFF), 0);
-        }
-    } else if (selectedIdx == BMBT_MENU_IDX_BACK) {
-        BMBTMenuSettings(context);
+    if (menu < BMBT_MENU_SETTINGS_AUDIO || menu > BMBT_MENU_SETTINGS_UI) {
+        return 0;
     }
-    if (selectedIdx != BMBT_MENU_IDX_BACK) {
-        BMBTGTBufferFlush(context);
+    return &settingsMenus[menu - BMBT_MENU_SETTINGS_AUDIO];
+}
+
+static uint8_t BMBTSettingsIsVisible(
+    BMBTContext_t *context,
+    const BMBTSettingItem_t *item
+) {
+    if ((item->flags & BMBT_SETTING_FLAG_BM83_ONLY) != 0 &&
+        BTGetType(context->bt) == BT_BTM_TYPE_BC127
+    ) {
+        return 0;
     }
+    return 1;
 }
 
-static void BMBTSettingsUpdateComfort(BMBTContext_t *context, uint8_t selectedIdx)
+static uint8_t BMBTSettingsGetValue(const BMBTSettingItem_t *item)
 {
-    if (selectedIdx == BMBT_MENU_IDX_SETTINGS_COMFORT_BLINKERS) {
-        uint8_t value = ConfigGetSetting(CONFIG_SETTING_COMFORT_BLINKERS);
-        if (value == 0) {
-            value = 1;
-        } else if (value == 8) {
-            value = 0;
-        }
-        value = value + 1;
-        ConfigSetSetting(CONFIG_SETTING_COMFORT_BLINKERS, value);
-        char blinkerText[BMBT_MENU_STRING_MAX_SIZE] = {0};
-        snprintf(blinkerText, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_BLINKERS), value);
-        BMBTGTWriteIndex(context, selectedIdx, blinkerText, 0);
-    } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_COMFORT_PARKING_LAMPS) {
-        uint8_t value = ConfigGetSetting(CONFIG_SETTING_COMFORT_PARKING_LAMPS);
-        if (value == CONFIG_SETTING_OFF) {
-            value = CONFIG_SETTING_ON;
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_PARK_LAMPS_ON), 0);
-        } else {
-            value = CONFIG_SETTING_OFF;
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_PARK_LAMPS_OFF), 0);
-        }
-        // Request cluster indicators so we can trigger the new light setting
-        // when the response (0x5B) is received
-        IBusCommandLMGetClusterIndicators(context->ibus);
-        ConfigSetSetting(CONFIG_SETTING_COMFORT_PARKING_LAMPS, value);
-    } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_COMFORT_LOCK) {
-        uint8_t comfortLock = ConfigGetComfortLock();
-        if (comfortLock == CONFIG_SETTING_OFF ||
-            comfortLock > CONFIG_SETTING_COMFORT_LOCK_20KM
-        ) {
-            ConfigSetComfortLock(CONFIG_SETTING_COMFORT_LOCK_10KM);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_LOCK_10KMH), 0);
-        } else if (comfortLock == CONFIG_SETTING_COMFORT_LOCK_10KM) {
-            ConfigSetComfortLock(CONFIG_SETTING_COMFORT_LOCK_20KM);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_LOCK_20KMH), 0);
-        } else {
-            ConfigSetComfortLock(CONFIG_SETTING_OFF);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_LOCK_OFF), 0);
-        }
-    } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_COMFORT_UNLOCK) {
-        uint8_t comfortUnlock = ConfigGetComfortUnlock();
-        if (comfortUnlock == CONFIG_SETTING_OFF ||
-            comfortUnlock > CONFIG_SETTING_COMFORT_UNLOCK_POS_0
-        ) {
-            ConfigSetComfortUnlock(CONFIG_SETTING_COMFORT_UNLOCK_POS_1);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_UNLOCK_POS_1), 0);
-        } else if (comfortUnlock == CONFIG_SETTING_COMFORT_UNLOCK_POS_1) {
-            ConfigSetComfortUnlock(CONFIG_SETTING_COMFORT_UNLOCK_POS_0);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_UNLOCK_POS_0), 0);
-        } else {
-            ConfigSetComfortUnlock(CONFIG_SETTING_OFF);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_UNLOCK_OFF), 0);
-        }
-    } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_COMFORT_AUTOZOOM) {
-        uint8_t autozoom = ConfigGetSetting(CONFIG_SETTING_COMFORT_AUTOZOOM);
-        autozoom++;
-        if (autozoom >= IBUS_SES_ZOOM_LEVELS) {
-            autozoom = CONFIG_SETTING_OFF;
-        }
-        ConfigSetSetting(CONFIG_SETTING_COMFORT_AUTOZOOM, autozoom);
-        char autoZoomText[BMBT_MENU_STRING_MAX_SIZE] = {0};
-        if (autozoom == CONFIG_SETTING_OFF) {
-            snprintf(
-                autoZoomText,
-                BMBT_MENU_STRING_MAX_SIZE,
-                LocaleGetText(LOCALE_STRING_AUTOZOOM),
-                "Off"
-            );
-        } else {
-            if (ConfigGetDistUnit() == 0) {
-                snprintf(
-                    autoZoomText,
-                    BMBT_MENU_STRING_MAX_SIZE,
-                    LocaleGetText(LOCALE_STRING_AUTOZOOM),
-                    navZoomScaleMetric[autozoom]
-                );
-            } else {
-                snprintf(
-                    autoZoomText,
-                    BMBT_MENU_STRING_MAX_SIZE,
-                    LocaleGetText(LOCALE_STRING_AUTOZOOM),
-                    navZoomScaleImperial[autozoom]
-                );
+    if (item->get != 0) {
+        return item->get();
+    }
+    return ConfigGetSetting(item->setting);
+}
+
+/**
+ * BMBTSettingsGetNextValue()
+ *     Description:
+ *         Get the value that follows the current one. Value lists advance to
+ *         the next entry and ranges step by one, both wrapping around. A
+ *         stored value that is not in the list or range resets to the first.
+ *     Params:
+ *         BMBTContext_t *context - The context
+ *         const BMBTSettingItem_t *item - The setting
+ *         uint8_t value - The current value
+ *     Returns:
+ *         uint8_t - The next value
+ */
+static uint8_t BMBTSettingsGetNextValue(
+    BMBTContext_t *context,
+    const BMBTSettingItem_t *item,
+    uint8_t value
+) {
+    if (item->next != 0) {
+        return item->next(context, value);
+    }
+    if (item->values != 0) {
+        uint8_t idx;
+        for (idx = 0; idx < item->valuesCount; idx++) {
+            if (item->values[idx].value == value) {
+                return item->values[(idx + 1) % item->valuesCount].value;
             }
         }
-        BMBTGTWriteIndex(context, selectedIdx, autoZoomText, 0);
-    } else if (selectedIdx == BMBT_MENU_IDX_BACK) {
-        BMBTMenuSettings(context);
+        return item->values[0].value;
     }
-    if (selectedIdx != BMBT_MENU_IDX_BACK) {
-        BMBTGTBufferFlush(context);
+    if (value < item->min || value > item->max) {
+        value = item->min;
+    }
+    if (value == item->max) {
+        return item->min;
     }
+    return value + 1;
 }
 
-static void BMBTSettingsUpdateCalling(BMBTContext_t *context, uint8_t selectedIdx)
-{
-    if (selectedIdx == BMBT_MENU_IDX_SETTINGS_CALLING_HFP) {
-        uint8_t value = ConfigGetSetting(CONFIG_SETTING_HFP);
-        if (context->bt->type == BT_BTM_TYPE_BC127) {
-            if (value == 0x00) {
-                ConfigSetSetting(CONFIG_SETTING_HFP, CONFIG_SETTING_ON);
-                BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_HANDSFREE_ON), 0);
-                BC127CommandProfileOpen(context->bt, "HFP");
-            } else {
-                ConfigSetSetting(CONFIG_SETTING_HFP, CONFIG_SETTING_OFF);
-                BC127CommandClose(context->bt, context->bt->activeDevice.hfpId);
-                BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_HANDSFREE_OFF), 0);
-            }
-        } else {
-            if (value == 0x01) {
-                BM83CommandDisconnect(context->bt, BM83_CMD_DISCONNECT_PARAM_HF);
-                ConfigSetSetting(CONFIG_SETTING_HFP, 0x00);
-                BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_HANDSFREE_OFF), 0);
-            } else {
-                BTPairedDevice_t *device = 0;
-                uint8_t i = 0;
-                for (i = 0; i < BT_MAC_ID_LEN; i++) {
-                    BTPairedDevice_t *tmpDev = &context->bt->pairedDevices[i];
-                    if (memcmp(context->bt->activeDevice.macId, tmpDev->macId, BT_MAC_ID_LEN) == 0) {
-                        device = tmpDev;
-                    }
-                }
-                if (device != 0) {
-                    BM83CommandConnect(
-                        context->bt,
-                        device,
-                        BM83_DATA_LINK_BACK_PROFILES_HF
-                    );
-                }
-                ConfigSetSetting(CONFIG_SETTING_HFP, 0x01);
-                BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_HANDSFREE_ON), 0);
+/**
+ * BMBTSettingsFormat()
+ *     Description:
+ *         Write the row text for the given setting value
+ *     Params:
+ *         BMBTContext_t *context - The context
+ *         const BMBTSettingItem_t *item - The setting
+ *         uint8_t value - The value to show
+ *         char *text - The buffer to write to, BMBT_MENU_STRING_MAX_SIZE long
+ *     Returns:
+ *         void
+ */
+static void BMBTSettingsFormat(
+    BMBTContext_t *context,
+    const BMBTSettingItem_t *item,
+    uint8_t value,
+    char *text
+) {
+    if (item->format != 0) {
+        item->format(context, value, text);
+    } else if (item->values != 0) {
+        uint16_t label = item->values[0].label;
+        uint8_t idx;
+        for (idx = 0; idx < item->valuesCount; idx++) {
+            if (item->values[idx].value == value) {
+                label = item->values[idx].label;
+                break;
             }
         }
-    } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_CALLING_MIC_GAIN) {
-        uint8_t micGain = ConfigGetSetting(CONFIG_SETTING_MIC_GAIN);
-        micGain = micGain + 1;
-        char micGainText[BMBT_MENU_STRING_MAX_SIZE] = {0};
-        if (context->bt->type == BT_BTM_TYPE_BC127) {
-            if (micGain > 21) {
-                micGain = 0;
-            }
+        strncpy(text, LocaleGetText(label), BMBT_MENU_STRING_MAX_SIZE - 1);
+    } else {
+        if (value < item->min || value > item->max) {
+            value = item->min;
+        }
+        snprintf(text, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(item->label), value);
+    }
+}
 
-            uint8_t micBias = ConfigGetSetting(CONFIG_SETTING_MIC_BIAS);
-            uint8_t micPreamp = ConfigGetSetting(CONFIG_SETTING_MIC_PREAMP);
-            BC127CommandSetMicGain(
-                context->bt,
-                micGain,
-                micBias,
-                micPreamp
-            );
-            snprintf(micGainText, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_MIC_GAIN), (int8_t) BTBC127MicGainTable[micGain]);
-        } else {
-            if (micGain > 0x0F) {
-                micGain = 0;
-            }
-            if (micGain == 0x00) {
-                // Reset the gain
-                uint8_t start = 0x0F;
-                while (start > 0) {
-                    BM83CommandMicGainDown(context->bt);
-                    start--;
-                }
-            } else {
-                BM83CommandMicGainUp(context->bt);
-            }
-            snprintf(micGainText, BMBT_MENU_STRING_MAX_SIZE, LocaleGetText(LOCALE_STRING_MIC_GAIN), (int8_t) BTBM83MicGainTable[micGain]);
+/**
+ * BMBTMenuSettingsRender()
+ *     Description:
+ *         Draw a table driven settings menu. The last visible row clears the
+ *         rows between it and the back button.
+ *     Params:
+ *         BMBTContext_t *context - The context
+ *         uint8_t menu - The menu ID
+ *     Returns:
+ *         void
+ */
+static void BMBTMenuSettingsRender(BMBTContext_t *context, uint8_t menu)
+{
+    const BMBTSettingsMenu_t *settings = BMBTSettingsGetMenu(menu);
+    if (settings == 0) {
+        return;
+    }
+    BMBTGTWriteTitleIndex(context, LocaleGetText(settings->title));
+    uint8_t lastIdx = 0;
+    uint8_t idx;
+    for (idx = 0; idx < settings->itemsCount; idx++) {
+        if (BMBTSettingsIsVisible(context, &settings->items[idx]) == 1) {
+            lastIdx = idx;
         }
-        ConfigSetSetting(CONFIG_SETTING_MIC_GAIN, micGain);
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_CALLING_MIC_GAIN,
-            micGainText,
-            0
-        );
-    } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_CALLING_VOL_OFFSET) {
-        int8_t volumeOffset = ConfigGetSetting(CONFIG_SETTING_TEL_VOL);
-        volumeOffset = volumeOffset + 1;
-        char volOffsetText[BMBT_MENU_STRING_MAX_SIZE] = {0};
-        if (volumeOffset > CONFIG_SETTING_TEL_VOL_OFFSET_MAX) {
-            volumeOffset = 0;
+    }
+    for (idx = 0; idx <= lastIdx; idx++) {
+        const BMBTSettingItem_t *item = &settings->items[idx];
+        if (BMBTSettingsIsVisible(context, item) == 0) {
+            continue;
         }
-        ConfigSetSetting(CONFIG_SETTING_TEL_VOL, volumeOffset);
-        snprintf(
-            volOffsetText,
-            BMBT_MENU_STRING_MAX_SIZE,
-            LocaleGetText(LOCALE_STRING_VOL_OFFSET),
-            volumeOffset
-        );
-        BMBTGTWriteIndex(
-            context,
-            BMBT_MENU_IDX_SETTINGS_CALLING_VOL_OFFSET,
-            volOffsetText,
-            0
-        );
-    } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_CALLING_MODE) {
-        uint8_t telMode = ConfigGetSetting(CONFIG_SETTING_TEL_MODE);
-        if (telMode == CONFIG_SETTING_TEL_MODE_DEFAULT) {
-            ConfigSetSetting(CONFIG_SETTING_TEL_MODE, CONFIG_SETTING_TEL_MODE_TCU);
-            BMBTGTWriteIndex(
-                context,
-                BMBT_MENU_IDX_SETTINGS_CALLING_MODE,
-                LocaleGetText(LOCALE_STRING_MODE_TCU),
-                0
-            );
-        } else if (telMode == CONFIG_SETTING_TEL_MODE_TCU) {
-            ConfigSetSetting(CONFIG_SETTING_TEL_MODE, CONFIG_SETTING_TEL_MODE_NO_MUTE);
-            BMBTGTWriteIndex(
-                context,
-                BMBT_MENU_IDX_SETTINGS_CALLING_MODE,
-                LocaleGetText(LOCALE_STRING_MODE_NO_MUTE),
-                0
-            );
-        } else {
-            ConfigSetSetting(CONFIG_SETTING_TEL_MODE, CONFIG_SETTING_TEL_MODE_DEFAULT);
-            BMBTGTWriteIndex(
-                context,
-                BMBT_MENU_IDX_SETTINGS_CALLING_MODE,
-                LocaleGetText(LOCALE_STRING_MODE_DEFAULT),
-                0
-            );
+        uint8_t clearIdxs = 0;
+        if (idx == lastIdx) {
+            clearIdxs = BMBT_MENU_IDX_BACK - 1 - lastIdx;
         }
-    } else if (selectedIdx == BMBT_MENU_IDX_BACK) {
+        char text[BMBT_MENU_STRING_MAX_SIZE] = {0};
+        BMBTSettingsFormat(context, item, BMBTSettingsGetValue(item), text);
+        BMBTGTWriteIndex(context, idx, text, clearIdxs);
+    }
+    BMBTGTWriteIndex(context, BMBT_MENU_IDX_BACK, LocaleGetText(LOCALE_STRING_BACK), 0);
+    BMBTGTBufferFlush(context);
+    context->menu = menu;
+}
+
+static void BMBTSettingsUpdateAbout(BMBTContext_t *context, uint8_t selectedIdx)
+{
+    if (selectedIdx == BMBT_MENU_IDX_BACK) {
         BMBTMenuSettings(context);
     }
-    if (selectedIdx != BMBT_MENU_IDX_BACK) {
-        BMBTGTBufferFlush(context);
-    }
 }
 
-static void BMBTSettingsUpdateUI(BMBTContext_t *context, uint8_t selectedIdx)
+/**
+ * BMBTSettingsUpdate()
+ *     Description:
+ *         Advance the selected setting of a table driven settings menu to its
+ *         next value, store it, apply it and redraw only the affected row
+ *     Params:
+ *         BMBTContext_t *context - The context
+ *         uint8_t selectedIdx - The selected row
+ *     Returns:
+ *         void
+ */
+static void BMBTSettingsUpdate(BMBTContext_t *context, uint8_t selectedIdx)
 {
-    if (selectedIdx == BMBT_MENU_IDX_SETTINGS_UI_METADATA_MODE) {
-        uint8_t value = ConfigGetSetting(CONFIG_SETTING_METADATA_MODE);
-        if (value == 0x00) {
-            value = BMBT_METADATA_MODE_PARTY;
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_METADATA_PARTY), 0);
-        } else if (value == 0x01) {
-            value = BMBT_METADATA_MODE_CHUNK;
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_METADATA_CHUNK), 0);
-        } else {
-            value = BMBT_METADATA_MODE_OFF;
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_METADATA_OFF), 0);
-        }
-        ConfigSetSetting(CONFIG_SETTING_METADATA_MODE, value);
-        if (value != BMBT_METADATA_MODE_OFF &&
-            strlen(context->bt->title) > 0 &&
-            context->bt->playbackStatus == BT_AVRCP_STATUS_PLAYING
-        ) {
-            char text[UTILS_DISPLAY_TEXT_SIZE] = {0};
-            snprintf(
-                text,
-                UTILS_DISPLAY_TEXT_SIZE,
-                "%s - %s - %s",
-                context->bt->title,
-                context->bt->artist,
-                context->bt->album
-            );
-            BMBTSetMainDisplayText(context, text, 0, 0);
-        } else if (value == BMBT_METADATA_MODE_OFF) {
-            BMBTGTBufferFlush(context);
-            BMBTGTWriteTitle(context, LocaleGetText(LOCALE_STRING_BLUETOOTH));
-        }
-    } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_UI_DEFAULT_MENU) {
-        if (ConfigGetSetting(CONFIG_SETTING_BMBT_DEFAULT_MENU) == 0x00) {
-            ConfigSetSetting(CONFIG_SETTING_BMBT_DEFAULT_MENU, 0x01);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_MENU_DASHBOARD), 0);
-        } else {
-            ConfigSetSetting(CONFIG_SETTING_BMBT_DEFAULT_MENU, 0x00);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_MENU_MAIN), 0);
-        }
-    } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_UI_TEMPS) {
-        uint8_t tempMode = ConfigGetTempDisplay();
-        if (tempMode == CONFIG_SETTING_OFF) {
-            ConfigSetTempDisplay(CONFIG_SETTING_TEMP_COOLANT);
-            uint8_t valueType = IBUS_SENSOR_VALUE_COOLANT_TEMP;
-            BMBTIBusSensorValueUpdate((void *)context, &valueType);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_TEMPS_COOLANT), 0);
-        } else if (tempMode == CONFIG_SETTING_TEMP_COOLANT) {
-            ConfigSetTempDisplay(CONFIG_SETTING_TEMP_AMBIENT);
-            uint8_t valueType = IBUS_SENSOR_VALUE_AMBIENT_TEMP;
-            BMBTIBusSensorValueUpdate((void *)context, &valueType);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_TEMPS_AMBIENT), 0);
-        } else if (
-            tempMode == CONFIG_SETTING_TEMP_AMBIENT &&
-            context->ibus->vehicleType != IBUS_VEHICLE_TYPE_E46 &&
-            context->ibus->vehicleType != IBUS_VEHICLE_TYPE_E8X
-        ) {
-            ConfigSetTempDisplay(CONFIG_SETTING_TEMP_OIL);
-            uint8_t valueType = IBUS_SENSOR_VALUE_OIL_TEMP;
-            BMBTIBusSensorValueUpdate((void *)context, &valueType);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_TEMPS_OIL), 0);
-        } else {
-            // Clear the header area
-            IBusCommandGTWriteZone(context->ibus, BMBT_HEADER_TEMPS, "      ");
-            IBusCommandGTUpdate(context->ibus, IBUS_CMD_GT_WRITE_ZONE);
-            ConfigSetTempDisplay(CONFIG_SETTING_OFF);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_TEMPS_OFF), 0);
-        }
-    } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_IU_DASH_OBC) {
-        if (ConfigGetSetting(CONFIG_SETTING_BMBT_DASHBOARD_OBC) == CONFIG_SETTING_ON) {
-            BMBTGTWriteIndex(
-                context,
-                BMBT_MENU_IDX_SETTINGS_IU_DASH_OBC,
-                LocaleGetText(LOCALE_STRING_DASH_OBC_OFF),
-                0
-            );
-            ConfigSetSetting(
-                CONFIG_SETTING_BMBT_DASHBOARD_OBC,
-                CONFIG_SETTING_OFF
-            );
-        } else {
-            BMBTGTWriteIndex(
-                context,
-                BMBT_MENU_IDX_SETTINGS_IU_DASH_OBC,
-                LocaleGetText(LOCALE_STRING_DASH_OBC_ON),
-                0
-            );
-            ConfigSetSetting(
-                CONFIG_SETTING_BMBT_DASHBOARD_OBC,
-                CONFIG_SETTING_ON
-            );
-        }
-    } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_UI_MONITOR_OFF) {
-        if (ConfigGetSetting(CONFIG_SETTING_MONITOR_OFF) == CONFIG_SETTING_ON) {
-            BMBTGTWriteIndex(
-                context,
-                BMBT_MENU_IDX_SETTINGS_UI_MONITOR_OFF,
-                LocaleGetText(LOCALE_STRING_BMBT_OFF_OFF),
-                0
-            );
-            ConfigSetSetting(CONFIG_SETTING_MONITOR_OFF, CONFIG_SETTING_OFF);
-        } else {
-            BMBTGTWriteIndex(
-                context,
-                BMBT_MENU_IDX_SETTINGS_UI_MONITOR_OFF,
-                LocaleGetText(LOCALE_STRING_BMBT_OFF_ON),
-                0
-            );
-            ConfigSetSetting(CONFIG_SETTING_MONITOR_OFF, CONFIG_SETTING_ON);
-        }
-    } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_UI_LANGUAGE) {
-        uint8_t selectedLanguage = ConfigGetSetting(CONFIG_SETTING_LANGUAGE);
-        if (selectedLanguage == CONFIG_SETTING_LANGUAGE_AUTO) {
-            selectedLanguage = CONFIG_SETTING_LANGUAGE_ENGLISH;
-        } else if (selectedLanguage == CONFIG_SETTING_LANGUAGE_ENGLISH) {
-            selectedLanguage = CONFIG_SETTING_LANGUAGE_ESTONIAN;
-        } else if (selectedLanguage == CONFIG_SETTING_LANGUAGE_ESTONIAN) {
-            selectedLanguage = CONFIG_SETTING_LANGUAGE_GERMAN;
-        } else if (selectedLanguage == CONFIG_SETTING_LANGUAGE_GERMAN) {
-            selectedLanguage = CONFIG_SETTING_LANGUAGE_ITALIAN;
-        } else if (selectedLanguage == CONFIG_SETTING_LANGUAGE_ITALIAN) {
-            selectedLanguage = CONFIG_SETTING_LANGUAGE_RUSSIAN;
-        } else if (selectedLanguage == CONFIG_SETTING_LANGUAGE_RUSSIAN) {
-            selectedLanguage = CONFIG_SETTING_LANGUAGE_SPANISH;
-        } else if (selectedLanguage == CONFIG_SETTING_LANGUAGE_SPANISH) {
-            selectedLanguage = CONFIG_SETTING_LANGUAGE_POLISH;
-        } else if (selectedLanguage == CONFIG_SETTING_LANGUAGE_POLISH) {
-            selectedLanguage = CONFIG_SETTING_LANGUAGE_FRENCH;
-        } else if (selectedLanguage == CONFIG_SETTING_LANGUAGE_FRENCH) {
-            selectedLanguage = CONFIG_SETTING_LANGUAGE_DUTCH;
-        } else if (selectedLanguage == CONFIG_SETTING_LANGUAGE_DUTCH) {
-            selectedLanguage = CONFIG_SETTING_LANGUAGE_AUTO;
-        } else {
-            selectedLanguage = CONFIG_SETTING_LANGUAGE_ENGLISH;
-        }
-        ConfigSetSetting(CONFIG_SETTING_LANGUAGE, selectedLanguage);
-        // Change the UI Language
-        BMBTMenuSettingsUI(context);
-        BMBTTriggerWriteHeader(context);
-    } else if (selectedIdx == BMBT_MENU_IDX_BACK) {
+    if (selectedIdx == BMBT_MENU_IDX_BACK) {
         BMBTMenuSettings(context);
+        return;
     }
-    if (selectedIdx != BMBT_MENU_IDX_BACK) {
-        BMBTGTBufferFlush(context);
+    const BMBTSettingsMenu_t *settings = BMBTSettingsGetMenu(context->menu);
+    if (settings == 0 || selectedIdx >= settings->itemsCount) {
+        return;
+    }
+    const BMBTSettingItem_t *item = &settings->items[selectedIdx];
+    if (BMBTSettingsIsVisible(context, item) == 0) {
+        return;
+    }
+    uint8_t value = BMBTSettingsGetNextValue(
+        context,
+        item,
+        BMBTSettingsGetValue(item)
+    );
+    if (item->set != 0) {
+        item->set(value);
+    } else {
+        ConfigSetSetting(item->setting, value);
+    }
+    if ((item->flags & BMBT_SETTING_FLAG_REDRAW) != 0) {
+        BMBTMenuSettingsRender(context, context->menu);
+    } else {
+        char text[BMBT_MENU_STRING_MAX_SIZE] = {0};
+        BMBTSettingsFormat(context, item, value, text);
+        BMBTGTWriteIndex(context, selectedIdx, text, 0);
+    }
+    if (item->apply != 0) {
+        item->apply(context, value);
+    }
+    BMBTGTBufferFlush(context);
+}
+
+/**
+ * BMBTShowMetadata()
+ *     Description:
+ *         Redraw the scrolling text and the dashboard from the render model
+ *     Params:
+ *         BMBTContext_t *context - The BMBT context
+ *     Returns:
+ *         void
+ */
+static void BMBTShowMetadata(BMBTContext_t *context)
+{
+    if (context->status.playerMode != BMBT_MODE_ACTIVE ||
+        context->status.displayMode != BMBT_DISPLAY_ON
+    ) {
+        return;
+    }
+    if (ConfigGetSetting(CONFIG_SETTING_METADATA_MODE) != CONFIG_SETTING_OFF) {
+        BMBTSetMainDisplayText(context, RenderModelGet()->text, 0, 1);
+    }
+    if (context->menu == BMBT_MENU_DASHBOARD ||
+        context->menu == BMBT_MENU_DASHBOARD_FRESH
+    ) {
+        BMBTMenuDashboard(context);
+    }
+}
+
+/**
+ * BMBTShowPlaybackStatus()
+ *     Description:
+ *         Redraw the playback status from the render model
+ *     Params:
+ *         BMBTContext_t *context - The BMBT context
+ *     Returns:
+ *         void
+ */
+static void BMBTShowPlaybackStatus(BMBTContext_t *context)
+{
+    if (context->status.displayMode != BMBT_DISPLAY_ON) {
+        return;
+    }
+    if (RenderModelGet()->playbackStatus == BT_AVRCP_STATUS_PAUSED) {
+        BMBTSetMainDisplayText(context, LocaleGetText(LOCALE_STRING_BLUETOOTH), 0, 1);
+        IBusCommandGTWriteZone(context->ibus, BMBT_HEADER_PB_STAT, "||");
+    } else {
+        BMBTMainAreaRefresh(context);
+        IBusCommandGTWriteZone(context->ibus, BMBT_HEADER_PB_STAT, "> ");
     }
+    IBusCommandGTUpdate(context->ibus, IBUS_CMD_GT_WRITE_ZONE);
 }
 
 /**
@@ -1806,158 +1608,207 @@ void BMBTBTDeviceDisconnected(void *ctx, uint8_t *data)
 }
 
 /**
- * BMBTBTMetadata()
+ * BMBTBTReady()
  *     Description:
- *         Handle metadata updates from the BT module
+ *         Handle the BT module rebooting gracefully
  *     Params:
  *         void *context - A void pointer to the BMBTContext_t struct
  *         uint8_t *tmp - The data from the event
  *     Returns:
  *         void
  */
-void BMBTBTMetadata(void *ctx, uint8_t *data)
+void BMBTBTReady(void *ctx, uint8_t *tmp)
+{
+    BMBTContext_t *context = (BMBTContext_t *) ctx;
+    BMBTHeaderWriteDeviceName(context, LocaleGetText(LOCALE_STRING_NO_DEVICE));
+    if (context->status.displayMode == BMBT_DISPLAY_ON) {
+        IBusCommandGTUpdate(context->ibus, IBUS_CMD_GT_WRITE_ZONE);
+    }
+}
+
+/**
+ * BMBTIBusBMBTButtonPress()
+ *     Description:
+ *         Handle the BoardMonitor soft buttons that do not carry a hold /
+ *         release state. Every other button arrives as a gesture.
+ *     Params:
+ *         void *context - A void pointer to the BMBTContext_t struct
+ *         uint8_t *pkt - A pointer to the data packet
+ *     Returns:
+ *         void
+ */
+void BMBTIBusBMBTButtonPress(void *ctx, uint8_t *pkt)
 {
     BMBTContext_t *context = (BMBTContext_t *) ctx;
+    // Handle the SEL and Info buttons gracefully
     if (context->status.playerMode == BMBT_MODE_ACTIVE &&
-        context->status.displayMode == BMBT_DISPLAY_ON
+        pkt[IBUS_PKT_CMD] == IBUS_CMD_BMBT_BUTTON0 &&
+        pkt[IBUS_PKT_LEN] == 0x05
     ) {
-        if (ConfigGetSetting(CONFIG_SETTING_METADATA_MODE) != CONFIG_SETTING_OFF) {
-            char text[UTILS_DISPLAY_TEXT_SIZE] = {0};
-            snprintf(
-                text,
-                UTILS_DISPLAY_TEXT_SIZE,
-                "%s - %s - %s",
-                context->bt->title,
-                context->bt->artist,
-                context->bt->album
-            );
-            BMBTSetMainDisplayText(context, text, 0, 1);
-        }
-        if (context->menu == BMBT_MENU_DASHBOARD ||
-            context->menu == BMBT_MENU_DASHBOARD_FRESH
-        ) {
-            BMBTMenuDashboard(context);
+        if (pkt[IBUS_PKT_DB2] == IBUS_DEVICE_BMBT_Button_Info) {
+            context->status.displayMode = BMBT_DISPLAY_INFO;
+        } else if (pkt[IBUS_PKT_DB2] == IBUS_DEVICE_BMBT_Button_SEL) {
+            context->status.displayMode = BMBT_DISPLAY_TONE_SEL;
         }
     }
 }
 
 /**
- * BMBTBTPlaybackStatus()
+ * BMBTInputGesture()
  *     Description:
- *         Handle the BT Module playback state changes
+ *         Run the BoardMonitor action bound to a button gesture
  *     Params:
- *         void *context - A void pointer to the BMBTContext_t struct
- *         uint8_t *tmp - The data from the event
+ *         void *ctx - A void pointer to the BMBTContext_t struct
+ *         uint8_t *data - The InputGesture_t
+ *     Returns:
+ *         void
+ */
+void BMBTInputGesture(void *ctx, uint8_t *data)
+{
+    InputDispatch(
+        BMBTInputBindings,
+        sizeof(BMBTInputBindings) / sizeof(InputBinding_t),
+        ctx,
+        (InputGesture_t *) data
+    );
+}
+
+/**
+ * BMBTInputDisplay()
+ *     Description:
+ *         Toggle our display when the display button is pressed
+ *     Params:
+ *         void *ctx - A void pointer to the BMBTContext_t struct
+ *         InputGesture_t *gesture - The gesture
  *     Returns:
  *         void
  */
-void BMBTBTPlaybackStatus(void *ctx, uint8_t *tmp)
+void BMBTInputDisplay(void *ctx, InputGesture_t *gesture)
 {
     BMBTContext_t *context = (BMBTContext_t *) ctx;
-    if (context->status.displayMode == BMBT_DISPLAY_ON) {
-        if (context->bt->playbackStatus == BT_AVRCP_STATUS_PAUSED) {
-            BMBTSetMainDisplayText(context, LocaleGetText(LOCALE_STRING_BLUETOOTH), 0, 1);
-            IBusCommandGTWriteZone(context->ibus, BMBT_HEADER_PB_STAT, "||");
-        } else {
-            BMBTMainAreaRefresh(context);
-            IBusCommandGTWriteZone(context->ibus, BMBT_HEADER_PB_STAT, "> ");
+    if (context->status.playerMode != BMBT_MODE_ACTIVE) {
+        return;
+    }
+    if (context->status.displayMode == BMBT_DISPLAY_OFF) {
+        context->status.displayMode = BMBT_DISPLAY_ON;
+        if (context->menu != BMBT_MENU_DASHBOARD_FRESH) {
+            context->menu = BMBT_MENU_NONE;
         }
-        IBusCommandGTUpdate(context->ibus, IBUS_CMD_GT_WRITE_ZONE);
+        if (context->ibus->moduleStatus.NAV == 1) {
+            IBusCommandRADDisableMenu(context->ibus);
+        }
+    } else {
+        context->status.displayMode = BMBT_DISPLAY_OFF;
     }
 }
 
 /**
- * BMBTBTReady()
+ * BMBTInputKnob()
  *     Description:
- *         Handle the BT module rebooting gracefully
+ *         Leave the static dashboard for the main menu when the knob is
+ *         pressed
  *     Params:
- *         void *context - A void pointer to the BMBTContext_t struct
- *         uint8_t *tmp - The data from the event
+ *         void *ctx - A void pointer to the BMBTContext_t struct
+ *         InputGesture_t *gesture - The gesture
  *     Returns:
  *         void
  */
-void BMBTBTReady(void *ctx, uint8_t *tmp)
+void BMBTInputKnob(void *ctx, InputGesture_t *gesture)
 {
     BMBTContext_t *context = (BMBTContext_t *) ctx;
-    BMBTHeaderWriteDeviceName(context, LocaleGetText(LOCALE_STRING_NO_DEVICE));
-    if (context->status.displayMode == BMBT_DISPLAY_ON) {
-        IBusCommandGTUpdate(context->ibus, IBUS_CMD_GT_WRITE_ZONE);
+    if (context->status.playerMode == BMBT_MODE_ACTIVE &&
+        context->status.displayMode == BMBT_DISPLAY_ON &&
+        context->menu == BMBT_MENU_DASHBOARD &&
+        context->ibus->gtVersion == IBUS_GT_MKIV_STATIC
+    ) {
+        BMBTMenuMain(context);
     }
 }
 
 /**
- * BMBTIBusBMBTButtonPress()
+ * BMBTInputMode()
  *     Description:
- *         Handle button presses on the BoardMonitor
+ *         The radio takes over the screen when the mode button is pressed
  *     Params:
- *         void *context - A void pointer to the BMBTContext_t struct
- *         uint8_t *pkt - A pointer to the data packet
+ *         void *ctx - A void pointer to the BMBTContext_t struct
+ *         InputGesture_t *gesture - The gesture
  *     Returns:
  *         void
  */
-void BMBTIBusBMBTButtonPress(void *ctx, uint8_t *pkt)
+void BMBTInputMode(void *ctx, InputGesture_t *gesture)
 {
     BMBTContext_t *context = (BMBTContext_t *) ctx;
     if (context->status.playerMode == BMBT_MODE_ACTIVE) {
-        if (pkt[IBUS_PKT_DB1] == IBUS_DEVICE_BMBT_Button_PlayPause ||
-            pkt[IBUS_PKT_DB1] == IBUS_DEVICE_BMBT_Button_Num1
-        ) {
-            if (context->bt->playbackStatus == BT_AVRCP_STATUS_PLAYING) {
-                BTCommandPause(context->bt);
-            } else {
-                BTCommandPlay(context->bt);
-            }
-        }
-        if (pkt[IBUS_PKT_DB1] == IBUS_DEVICE_BMBT_Button_Knob) {
-            if (context->status.displayMode == BMBT_DISPLAY_ON &&
-                context->menu == BMBT_MENU_DASHBOARD &&
-                context->ibus->gtVersion == IBUS_GT_MKIV_STATIC
-            ) {
-                BMBTMenuMain(context);
-            }
-        }
-        if (pkt[IBUS_PKT_DB1] == IBUS_DEVICE_BMBT_Button_Display) {
-            if (context->status.playerMode == BMBT_MODE_ACTIVE) {
-                if (context->status.displayMode == BMBT_DISPLAY_OFF) {
-                    context->status.displayMode = BMBT_DISPLAY_ON;
-                    if (context->menu != BMBT_MENU_DASHBOARD_FRESH) {
-                        context->menu = BMBT_MENU_NONE;
-                    }
-                    if (context->ibus->moduleStatus.NAV == 1) {
-                        IBusCommandRADDisableMenu(context->ibus);
-                    }
-                } else {
-                    context->status.displayMode = BMBT_DISPLAY_OFF;
-                }
-            }
-        }
-        if (pkt[IBUS_PKT_DB1] == IBUS_DEVICE_BMBT_Button_Mode) {
-            context->status.playerMode = BMBT_MODE_INACTIVE;
-        }
-        // Handle the SEL and Info buttons gracefully
-        if (pkt[3] == IBUS_CMD_BMBT_BUTTON0 && pkt[1] == 0x05) {
-            if (pkt[5] == IBUS_DEVICE_BMBT_Button_Info) {
-                context->status.displayMode = BMBT_DISPLAY_INFO;
-            } else if (pkt[5] == IBUS_DEVICE_BMBT_Button_SEL) {
-                context->status.displayMode = BMBT_DISPLAY_TONE_SEL;
-            }
-        }
+        context->status.playerMode = BMBT_MODE_INACTIVE;
     }
-    // Handle calls at any time
-    if (ConfigGetSetting(CONFIG_SETTING_HFP) == CONFIG_SETTING_ON) {
-        if (pkt[IBUS_PKT_DB1] == IBUS_DEVICE_BMBT_Button_TEL_Release) {
-            if (context->bt->callStatus == BT_CALL_ACTIVE) {
-                BTCommandCallEnd(context->bt);
-            } else if (context->bt->callStatus == BT_CALL_INCOMING) {
-                BTCommandCallAccept(context->bt);
-            } else if (context->bt->callStatus == BT_CALL_OUTGOING) {
-                BTCommandCallEnd(context->bt);
-            }
-        } else if (context->bt->callStatus == BT_CALL_INACTIVE &&
-                   pkt[IBUS_PKT_DB1] == IBUS_DEVICE_BMBT_Button_TEL_Hold
-        ) {
-            BTCommandToggleVoiceRecognition(context->bt);
-        }
+}
+
+/**
+ * BMBTInputPlayPause()
+ *     Description:
+ *         Toggle playback when play / pause or preset 1 is pressed
+ *     Params:
+ *         void *ctx - A void pointer to the BMBTContext_t struct
+ *         InputGesture_t *gesture - The gesture
+ *     Returns:
+ *         void
+ */
+void BMBTInputPlayPause(void *ctx, InputGesture_t *gesture)
+{
+    BMBTContext_t *context = (BMBTContext_t *) ctx;
+    if (context->status.playerMode != BMBT_MODE_ACTIVE) {
+        return;
+    }
+    if (context->bt->playbackStatus == BT_AVRCP_STATUS_PLAYING) {
+        BTCommandPause(context->bt);
+    } else {
+        BTCommandPlay(context->bt);
+    }
+}
+
+/**
+ * BMBTInputTELHold()
+ *     Description:
+ *         Toggle voice recognition when the telephone button is held
+ *         outside of a call
+ *     Params:
+ *         void *ctx - A void pointer to the BMBTContext_t struct
+ *         InputGesture_t *gesture - The gesture
+ *     Returns:
+ *         void
+ */
+void BMBTInputTELHold(void *ctx, InputGesture_t *gesture)
+{
+    BMBTContext_t *context = (BMBTContext_t *) ctx;
+    if (ConfigGetSetting(CONFIG_SETTING_HFP) == CONFIG_SETTING_ON &&
+        context->bt->callStatus == BT_CALL_INACTIVE
+    ) {
+        BTCommandToggleVoiceRecognition(context->bt);
+    }
+}
+
+/**
+ * BMBTInputTELRelease()
+ *     Description:
+ *         Answer or end a call when the telephone button is released
+ *     Params:
+ *         void *ctx - A void pointer to the BMBTContext_t struct
+ *         InputGesture_t *gesture - The gesture
+ *     Returns:
+ *         void
+ */
+void BMBTInputTELRelease(void *ctx, InputGesture_t *gesture)
+{
+    BMBTContext_t *context = (BMBTContext_t *) ctx;
+    if (ConfigGetSetting(CONFIG_SETTING_HFP) != CONFIG_SETTING_ON) {
+        return;
+    }
+    if (context->bt->callStatus == BT_CALL_ACTIVE ||
+        context->bt->callStatus == BT_CALL_OUTGOING
+    ) {
+        BTCommandCallEnd(context->bt);
+    } else if (context->bt->callStatus == BT_CALL_INCOMING) {
+        BTCommandCallAccept(context->bt);
     }
 }
 
@@ -2149,6 +2000,7 @@ void BMBTIBusMenuSelect(void *ctx, uint8_t *pkt)
             if (selectedIdx == BMBT_MENU_IDX_DASHBOARD) {
                 BMBTMenuDashboard(context);
             } else if (selectedIdx == BMBT_MENU_IDX_DEVICE_SELECTION) {
+                MenuDeviceListSetPage(&context->deviceList, 0);
                 BMBTMenuDeviceSelection(context);
             } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS) {
                 BMBTMenuSettings(context);
@@ -2172,7 +2024,7 @@ void BMBTIBusMenuSelect(void *ctx, uint8_t *pkt)
                 BMBTGTBufferFlush(context);
                 BTCommandSetDiscoverable(context->bt, state);
             } else if (selectedIdx == BMBT_MENU_IDX_CLEAR_PAIRING) {
-                if (context->bt->type == BT_BTM_TYPE_BC127) {
+                if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
                     BC127CommandUnpair(context->bt);
                 } else {
                     BM83CommandRestore(context->bt);
@@ -2185,26 +2037,18 @@ void BMBTIBusMenuSelect(void *ctx, uint8_t *pkt)
             } else if (selectedIdx == BMBT_MENU_IDX_BACK) {
                 // Back Button
                 BMBTMenuMain(context);
-            } else {
-                uint8_t selectedDeviceId = selectedIdx - BMBT_MENU_IDX_FIRST_DEVICE;
-                uint8_t deviceId = 0;
-                uint8_t devicesPos = 0;
-                uint8_t idx;
-                BTPairedDevice_t *dev = 0;
-
-                for (idx = 0; idx < context->bt->pairedDevicesCount; idx++) {
-                    dev = &context->bt->pairedDevices[idx];
-                    if (dev != 0) {
-                        if ( devicesPos == selectedDeviceId ) {
-                            deviceId = idx;
-                            break;
-                        }
-                        devicesPos++;
-                    }
-                }
-
-                if ((dev != 0) &&
-                    (memcmp(dev->macId, context->bt->activeDevice.macId, BT_LEN_MAC_ID) != 0 )
+            } else if (selectedIdx == BMBT_MENU_IDX_DEVICE_PAGE &&
+                       MenuDeviceListGetPageCount(&context->deviceList) > 1
+            ) {
+                MenuDeviceListNextPage(&context->deviceList);
+                BMBTMenuDeviceSelection(context);
+            } else if (selectedIdx >= BMBT_MENU_IDX_FIRST_DEVICE) {
+                uint8_t deviceId = MenuDeviceListGetDevice(
+                    &context->deviceList,
+                    selectedIdx - BMBT_MENU_IDX_FIRST_DEVICE
+                );
+                if (deviceId != MENU_DEVICE_LIST_DEVICE_NONE &&
+                    MenuDeviceListIsActive(&context->deviceList, deviceId) == 0
                 ) {
                     // Trigger device selection event
                     EventTriggerCallback(
@@ -2217,26 +2061,20 @@ void BMBTIBusMenuSelect(void *ctx, uint8_t *pkt)
             if (selectedIdx == BMBT_MENU_IDX_SETTINGS_ABOUT) {
                 BMBTMenuSettingsAbout(context);
             } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_AUDIO) {
-                BMBTMenuSettingsAudio(context);
+                BMBTMenuSettingsRender(context, BMBT_MENU_SETTINGS_AUDIO);
             } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_COMFORT) {
-                BMBTMenuSettingsComfort(context);
+                BMBTMenuSettingsRender(context, BMBT_MENU_SETTINGS_COMFORT);
             } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_CALLING) {
-                BMBTMenuSettingsCalling(context);
+                BMBTMenuSettingsRender(context, BMBT_MENU_SETTINGS_CALLING);
             } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_UI) {
-                BMBTMenuSettingsUI(context);
+                BMBTMenuSettingsRender(context, BMBT_MENU_SETTINGS_UI);
             } else if (selectedIdx == BMBT_MENU_IDX_BACK) {
                 BMBTMenuMain(context);
             }
         } else if (context->menu == BMBT_MENU_SETTINGS_ABOUT) {
             BMBTSettingsUpdateAbout(context, selectedIdx);
-        } else if (context->menu == BMBT_MENU_SETTINGS_AUDIO) {
-            BMBTSettingsUpdateAudio(context, selectedIdx);
-        } else if (context->menu == BMBT_MENU_SETTINGS_COMFORT) {
-            BMBTSettingsUpdateComfort(context, selectedIdx);
-        } else if (context->menu == BMBT_MENU_SETTINGS_CALLING) {
-            BMBTSettingsUpdateCalling(context, selectedIdx);
-        } else if (context->menu == BMBT_MENU_SETTINGS_UI) {
-            BMBTSettingsUpdateUI(context, selectedIdx);
+        } else if (BMBTSettingsGetMenu(context->menu) != 0) {
+            BMBTSettingsUpdate(context, selectedIdx);
         }
     }
 }
@@ -2289,10 +2127,8 @@ void BMBTIBusSensorValueUpdate(void *ctx, uint8_t *type)
     char temperature[8] = {0};
     char config = ConfigGetTempDisplay();
 
-    // We may need to add additional `updateType` values in the future
     if (config == CONFIG_SETTING_OFF ||
-        context->status.displayMode != BMBT_DISPLAY_ON ||
-        updateType == IBUS_SENSOR_VALUE_GEAR_POS
+        context->status.displayMode != BMBT_DISPLAY_ON
     ) {
         return;
     }
@@ -2321,7 +2157,7 @@ void BMBTIBusSensorValueUpdate(void *ctx, uint8_t *type)
             (updateType == IBUS_SENSOR_VALUE_COOLANT_TEMP ||
             updateType == IBUS_SENSOR_VALUE_TEMP_UNIT)
         ) {
-            temp = context->ibus->coolantTemperature;
+            temp = VehicleGetSignal(VEHICLE_SIGNAL_COOLANT_TEMP);
             if (temp != 0) {
                 redraw = 1;
             }
@@ -2330,13 +2166,13 @@ void BMBTIBusSensorValueUpdate(void *ctx, uint8_t *type)
             updateType == IBUS_SENSOR_VALUE_AMBIENT_TEMP_CALCULATED ||
             updateType == IBUS_SENSOR_VALUE_TEMP_UNIT)
         ) {
-            temp = context->ibus->ambientTemperature;
+            temp = VehicleGetSignal(VEHICLE_SIGNAL_AMBIENT_TEMP);
             redraw = 1;
         } else if (config == CONFIG_SETTING_TEMP_OIL &&
             (updateType == IBUS_SENSOR_VALUE_OIL_TEMP ||
             updateType == IBUS_SENSOR_VALUE_TEMP_UNIT)
         ) {
-            temp = context->ibus->oilTemperature;
+            temp = VehicleGetSignal(VEHICLE_SIGNAL_OIL_TEMP);
             if (temp != 0) {
                 redraw = 1;
             }
@@ -2625,6 +2461,53 @@ void BMBTIBusVehicleConfig(void *ctx, uint8_t *pkt)
     }
 }
 
+/**
+ * BMBTVehicleTemperatureUpdate()
+ *     Description:
+ *         Redraw the temperature header when a temperature has moved by at
+ *         least BMBT_TEMP_DEADBAND since we last drew it
+ *     Params:
+ *         void *ctx - A void pointer to the BMBTContext_t struct
+ *         uint8_t *signal - The vehicle signal ID
+ *     Returns:
+ *         void
+ */
+void BMBTVehicleTemperatureUpdate(void *ctx, uint8_t *signal)
+{
+    uint8_t valueType = IBUS_SENSOR_VALUE_COOLANT_TEMP;
+    if (*signal == VEHICLE_SIGNAL_AMBIENT_TEMP) {
+        valueType = IBUS_SENSOR_VALUE_AMBIENT_TEMP;
+    } else if (*signal == VEHICLE_SIGNAL_OIL_TEMP) {
+        valueType = IBUS_SENSOR_VALUE_OIL_TEMP;
+    }
+    BMBTIBusSensorValueUpdate(ctx, &valueType);
+}
+
+/**
+ * BMBTRenderModelUpdate()
+ *     Description:
+ *         Redraw from the render model when it changes
+ *     Params:
+ *         void *ctx - A void pointer to the BMBTContext_t struct
+ *         uint8_t *data - The RenderModelUpdate_t
+ *     Returns:
+ *         void
+ */
+void BMBTRenderModelUpdate(void *ctx, uint8_t *data)
+{
+    BMBTContext_t *context = (BMBTContext_t *) ctx;
+    RenderModelUpdate_t *update = (RenderModelUpdate_t *) data;
+    if ((update->targets & RENDER_MODEL_TARGET_BMBT) == 0) {
+        return;
+    }
+    if ((update->changes & RENDER_MODEL_CHANGE_METADATA) != 0) {
+        BMBTShowMetadata(context);
+    }
+    if ((update->changes & RENDER_MODEL_CHANGE_PLAYBACK) != 0) {
+        BMBTShowPlaybackStatus(context);
+    }
+}
+
 /**
  * BMBTTimerHeaderWrite()
  *     Description:
@@ -2658,7 +2541,8 @@ void BMBTTimerHeaderWrite(void *ctx)
  * BMBTTimerMenuWrite()
  *     Description:
  *         Write out the menu after a given timeout so the radio does not
- *         fight us when re-writing the menu to the screen
+ *         fight us when re-writing the menu to the screen. When there is
+ *         nothing to write, prefetch the device list names.
  *     Params:
  *         void *ctx - The context
  *     Returns:
@@ -2691,16 +2575,10 @@ void BMBTTimerMenuWrite(void *ctx)
                         BMBTMenuSettingsAbout(context);
                         break;
                     case BMBT_MENU_SETTINGS_AUDIO:
-                        BMBTMenuSettingsAudio(context);
-                        break;
                     case BMBT_MENU_SETTINGS_COMFORT:
-                        BMBTMenuSettingsComfort(context);
-                        break;
                     case BMBT_MENU_SETTINGS_CALLING:
-                        BMBTMenuSettingsCalling(context);
-                        break;
                     case BMBT_MENU_SETTINGS_UI:
-                        BMBTMenuSettingsUI(context);
+                        BMBTMenuSettingsRender(context, context->menu);
                         break;
                     case BMBT_MENU_NONE:
                         if (ConfigGetSetting(CONFIG_SETTING_BMBT_DEFAULT_MENU) == 0x01) {
@@ -2715,6 +2593,15 @@ void BMBTTimerMenuWrite(void *ctx)
             } else {
                 context->timerMenuIntervals++;
             }
+        } else if (context->menu == BMBT_MENU_MAIN ||
+                   context->menu == BMBT_MENU_DEVICE_SELECTION
+        ) {
+            // Get the device names ready while the bus is quiet, so opening
+            // or paging the device list only copies strings
+            uint32_t idleTime = TimerGetMillis() - context->ibus->rxLastStamp;
+            if (idleTime >= BMBT_DEVICE_LIST_PREFETCH_IDLE) {
+                MenuDeviceListPrefetch(&context->deviceList);
+            }
         }
     }
 }
@@ -2739,38 +2626,47 @@ void BMBTTimerScrollDisplay(void *ctx)
         if (context->mainDisplay.timeout > 0) {
             context->mainDisplay.timeout--;
         } else {
-            if (context->mainDisplay.length > BMBT_MAIN_AREA_LEN) {
+            uint8_t layoutMode = TEXT_LAYOUT_MODE_SCROLL;
+            if (ConfigGetSetting(CONFIG_SETTING_METADATA_MODE) ==
+                BMBT_METADATA_MODE_CHUNK
+            ) {
+                layoutMode = TEXT_LAYOUT_MODE_CHUNK;
+            }
+            uint8_t segments = TextLayoutPrepare(
+                &context->mainLayout,
+                context->mainDisplay.text,
+                layoutMode
+            );
+            if (segments > 1) {
                 char text[BMBT_DISPLAY_TEXT_LEN + 1] = {0};
-                uint8_t textLength = BMBT_DISPLAY_TEXT_LEN;
-                uint8_t idxEnd = context->mainDisplay.index + textLength;
-                // Prevent strncpy() from going out of bounds
-                if (idxEnd >= context->mainDisplay.length) {
-                    textLength = context->mainDisplay.length - context->mainDisplay.index;
-                    idxEnd = context->mainDisplay.index + textLength;
+                if (context->mainDisplay.index >= segments) {
+                    context->mainDisplay.index = 0;
                 }
-                UtilsStrncpy(
-                    text,
-                    &context->mainDisplay.text[context->mainDisplay.index],
-                    textLength + 1
+                TextLayoutGetSegment(
+                    &context->mainLayout,
+                    context->mainDisplay.text,
+                    context->mainDisplay.index,
+                    text
+                );
+                uint8_t next = TextLayoutNextSegment(
+                    &context->mainLayout,
+                    context->mainDisplay.text,
+                    context->mainDisplay.index
                 );
                 BMBTGTWriteTitle(context, text);
                 // Pause at the beginning of the text
                 if (context->mainDisplay.index == 0) {
                     context->mainDisplay.timeout = 5;
                 }
-                if (idxEnd >= context->mainDisplay.length) {
+                if (next >= segments) {
                     // Pause at the end of the text
                     context->mainDisplay.timeout = 2;
                     context->mainDisplay.index = 0;
                 } else {
-                    if (ConfigGetSetting(CONFIG_SETTING_METADATA_MODE) ==
-                        BMBT_METADATA_MODE_CHUNK
-                    ) {
+                    if (layoutMode == TEXT_LAYOUT_MODE_CHUNK) {
                         context->mainDisplay.timeout = 2;
-                        context->mainDisplay.index += BMBT_MAIN_AREA_LEN;
-                    } else {
-                        context->mainDisplay.index++;
                     }
+                    context->mainDisplay.index = next;
                 }
             } else {
                 if (context->mainDisplay.index == 0) {
@@ -14,11 +14,16 @@
 #include "../lib/event.h"
 #include "../lib/i2c.h"
 #include "../lib/ibus.h"
+#include "../lib/input.h"
 #include "../lib/locale.h"
 #include "../lib/pcm51xx.h"
+#include "../lib/render_model.h"
+#include "../lib/resource_group.h"
+#include "../lib/text_layout.h"
 #include "../lib/timer.h"
 #include "../lib/utils.h"
 #include "../lib/wm88xx.h"
+#include "menu/menu_device_list.h"
 #define BMBT_DISPLAY_OFF 0x00
 #define BMBT_DISPLAY_TONE_SEL 0x01
 #define BMBT_DISPLAY_INFO 0x02
@@ -84,6 +89,12 @@
 #define BMBT_MENU_IDX_PAIRING_MODE 0
 #define BMBT_MENU_IDX_CLEAR_PAIRING 1
 #define BMBT_MENU_IDX_FIRST_DEVICE 2
+// Shown instead of a device when the pairings do not fit on one page
+#define BMBT_MENU_IDX_DEVICE_PAGE 6
+#define BMBT_DEVICE_LIST_PAGE_SIZE 4
+#define BMBT_DEVICE_NAME_LEN 11
+// Only prefetch device names once the bus has been quiet this long
+#define BMBT_DEVICE_LIST_PREFETCH_IDLE 20
 #define BMBT_MENU_WRITE_DELAY 300
 #define BMBT_MENU_TIMER_WRITE_INT 100
 #define BMBT_MENU_TIMER_WRITE_TIMEOUT 500
@@ -100,9 +111,16 @@
 #define BMBT_NAV_BOOT 0x10
 #define BMBT_NAV_STATE_BOOT 0x00
 #define BMBT_NAV_STATE_ON 0x01
+#define BMBT_SETTING_FLAG_NONE 0x00
+// Not supported by the BC127, so the row is left blank
+#define BMBT_SETTING_FLAG_BM83_ONLY 0x01
+// The new value changes other rows, so the whole menu is redrawn
+#define BMBT_SETTING_FLAG_REDRAW 0x02
 #define BMBT_SCROLL_TEXT_SIZE 255
 #define BMBT_SCROLL_TEXT_SPEED 750
 #define BMBT_SCROLL_TEXT_TIMER 500
+// Degrees a temperature has to move before the header is redrawn
+#define BMBT_TEMP_DEADBAND 1
 #define BMBT_TV_STATUS_OFF 0
 #define BMBT_TV_STATUS_ON 1
 
@@ -131,17 +149,63 @@ typedef struct BMBTContext_t {
     uint8_t menuWriteTaskId;
     uint8_t dspMode;
     UtilsAbstractDisplayValue_t mainDisplay;
+    TextLayout_t mainLayout;
     uint8_t navZoom: 4;
     uint32_t navZoomTime;
-
+    MenuDeviceListContext_t deviceList;
 } BMBTContext_t;
 
+/**
+ * BMBTSettingValue_t
+ *     Description:
+ *         A value that a setting can take and the locale string shown for it
+ */
+typedef struct BMBTSettingValue_t {
+    uint8_t value;
+    uint16_t label;
+} BMBTSettingValue_t;
+
+/**
+ * BMBTSettingItem_t
+ *     Description:
+ *         Describes a single settings menu row. A row either cycles through
+ *         the given values or steps from min to max, wrapping around. The
+ *         stored value is read and written through get / set, falling back to
+ *         ConfigGetSetting() / ConfigSetSetting() with the setting key. The
+ *         optional callbacks cover rows that need more than that: next picks
+ *         the value that follows, format writes the row text and apply
+ *         pushes the new value to the hardware.
+ */
+typedef struct BMBTSettingItem_t {
+    uint8_t setting;
+    uint8_t flags;
+    uint8_t min;
+    uint8_t max;
+    uint16_t label;
+    const BMBTSettingValue_t *values;
+    uint8_t valuesCount;
+    uint8_t (*get)();
+    void (*set)(uint8_t);
+    uint8_t (*next)(BMBTContext_t *, uint8_t);
+    void (*format)(BMBTContext_t *, uint8_t, char *);
+    void (*apply)(BMBTContext_t *, uint8_t);
+} BMBTSettingItem_t;
+
+/**
+ * BMBTSettingsMenu_t
+ *     Description:
+ *         A settings menu: its title and its rows, in row index order
+ */
+typedef struct BMBTSettingsMenu_t {
+    uint16_t title;
+    const BMBTSettingItem_t *items;
+    uint8_t itemsCount;
+} BMBTSettingsMenu_t;
+
 void BMBTInit(BT_t *, IBus_t *);
 void BMBTDestroy();
 void BMBTBTDeviceConnected(void *, uint8_t *);
 void BMBTBTDeviceDisconnected(void *, uint8_t *);
-void BMBTBTMetadata(void *, uint8_t *);
-void BMBTBTPlaybackStatus(void *, uint8_t *);
 void BMBTBTReady(void *, uint8_t *);
 void BMBTIBusBMBTButtonPress(void *, uint8_t *);
 void BMBTIBusCDChangerStatus(void *, uint8_t *);
@@ -157,6 +221,15 @@ void BMBTRADScreenModeRequest(void *, uint8_t *);
 void BMBTGTScreenModeSet(void *, uint8_t *);
 void BMBTTVStatusUpdate(void *, uint8_t *);
 void BMBTIBusVehicleConfig(void *, uint8_t *);
+void BMBTInputGesture(void *, uint8_t *);
+void BMBTInputDisplay(void *, InputGesture_t *);
+void BMBTInputKnob(void *, InputGesture_t *);
+void BMBTInputMode(void *, InputGesture_t *);
+void BMBTInputPlayPause(void *, InputGesture_t *);
+void BMBTInputTELHold(void *, InputGesture_t *);
+void BMBTInputTELRelease(void *, InputGesture_t *);
+void BMBTVehicleTemperatureUpdate(void *, uint8_t *);
+void BMBTRenderModelUpdate(void *, uint8_t *);
 void BMBTTimerHeaderWrite(void *);
 void BMBTTimerMenuWrite(void *);
 void BMBTTimerScrollDisplay(void *);
@@ -6,13 +6,44 @@
  */
 #include "cd53.h"
 static CD53Context_t Context;
+static ResourceGroup_t Resources;
+
+// The display drops a leading space, 0x9D gives a true blank instead
+static const TextLayoutProfile_t CD53DisplayProfile = {
+    CD53_DISPLAY_TEXT_LEN,
+    TEXT_LAYOUT_SPACE_REPLACE,
+    IBUS_RAD_SPACE_CHAR_ALT
+};
+
+static const InputBinding_t CD53InputBindings[] = {
+    {
+        INPUT_SOURCE_BMBT,
+        IBUS_DEVICE_BMBT_Button_PlayPause,
+        INPUT_GESTURE_PRESS,
+        &CD53InputPlayPause
+    },
+    {
+        INPUT_SOURCE_MFL,
+        IBUS_MFL_BTN_NEXT,
+        INPUT_GESTURE_RELEASE,
+        &CD53InputNextPrev
+    },
+    {
+        INPUT_SOURCE_MFL,
+        IBUS_MFL_BTN_PREV,
+        INPUT_GESTURE_RELEASE,
+        &CD53InputNextPrev
+    }
+};
 
 void CD53Init(BT_t *bt, IBus_t *ibus)
 {
+    ResourceGroupInit(&Resources, &Context, sizeof(CD53Context_t));
     Context.bt = bt;
     Context.ibus = ibus;
     Context.mode = CD53_MODE_OFF;
     Context.mainDisplay = UtilsDisplayValueInit("Bluetooth", CD53_DISPLAY_STATUS_OFF);
+    TextLayoutInit(&Context.mainLayout, &CD53DisplayProfile);
     Context.tempDisplay = UtilsDisplayValueInit("", CD53_DISPLAY_STATUS_OFF);
     Context.btDeviceIndex = CD53_PAIRING_DEVICE_NONE;
     Context.displayMetadata = CD53_DISPLAY_METADATA_ON;
@@ -22,67 +53,80 @@ void CD53Init(BT_t *bt, IBus_t *ibus)
     Context.radioType = ConfigGetUIMode();
     Context.mediaChangeState = CD53_MEDIA_STATE_OK;
     Context.menuContext = MenuSingleLineInit(ibus, bt, &CD53DisplayUpdateText, &Context);
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         BT_EVENT_CALLER_ID_UPDATE,
         &CD53BTCallerID,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         BT_EVENT_CALL_STATUS_UPDATE,
         &CD53BTCallStatus,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         BT_EVENT_BOOT,
         &CD53BTDeviceReady,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         BT_EVENT_DEVICE_LINK_DISCONNECTED,
         &CD53BTDeviceDisconnected,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         BT_EVENT_METADATA_UPDATE,
         &CD53BTMetadata,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         BT_EVENT_PLAYBACK_STATUS_CHANGE,
         &CD53BTPlaybackStatus,
         &Context
     );
-    EventRegisterCallback(
-        IBUS_EVENT_BMBTButton,
-        &CD53IBusBMBTButtonPress,
-        &Context
-    );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_CDStatusRequest,
         &CD53IBusCDChangerStatus,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_IKEIgnitionStatus,
         &CD53IBusIgnitionStatus,
         &Context
     );
-    EventRegisterCallback(
-        IBUS_EVENT_MFLButton,
-        &CD53IBusMFLButton,
+    ResourceGroupRegisterCallback(
+        &Resources,
+        UIEvent_InputGesture,
+        &CD53InputGesture,
+        &Context
+    );
+    ResourceGroupRegisterCallback(
+        &Resources,
+        UIEvent_DisplayClaim,
+        &CD53DisplayClaim,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_RAD_WRITE_DISPLAY,
         &CD53IBusRADWriteDisplay,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_ScreenModeSet,
         &CD53GTScreenModeSet,
         &Context
     );
-    Context.displayUpdateTaskId = TimerRegisterScheduledTask(
+    Context.displayUpdateTaskId = ResourceGroupRegisterTask(
+        &Resources,
         &CD53TimerDisplay,
         &Context,
         CD53_DISPLAY_TIMER_INT
@@ -92,7 +136,8 @@ void CD53Init(BT_t *bt, IBus_t *ibus)
 /**
  * CD53Destroy()
  *     Description:
- *         Unregister all event handlers, scheduled tasks and clear the context
+ *         Release the event handlers, scheduled tasks and signal
+ *         subscriptions the UI registered, and clear the context
  *     Params:
  *         void
  *     Returns:
@@ -100,56 +145,7 @@ void CD53Init(BT_t *bt, IBus_t *ibus)
  */
 void CD53Destroy()
 {
-    EventUnregisterCallback(
-        BT_EVENT_BOOT,
-        &CD53BTDeviceReady
-    );
-    EventUnregisterCallback(
-        BT_EVENT_CALLER_ID_UPDATE,
-        &CD53BTCallerID
-    );
-    EventUnregisterCallback(
-        BT_EVENT_CALL_STATUS_UPDATE,
-        &CD53BTCallStatus
-    );
-    EventUnregisterCallback(
-        BT_EVENT_DEVICE_LINK_DISCONNECTED,
-        &CD53BTDeviceDisconnected
-    );
-    EventUnregisterCallback(
-        BT_EVENT_METADATA_UPDATE,
-        &CD53BTMetadata
-    );
-    EventUnregisterCallback(
-        BT_EVENT_PLAYBACK_STATUS_CHANGE,
-        &CD53BTPlaybackStatus
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_BMBTButton,
-        &CD53IBusBMBTButtonPress
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_CDStatusRequest,
-        &CD53IBusCDChangerStatus
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_IKEIgnitionStatus,
-        &CD53IBusIgnitionStatus
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_MFLButton,
-        &CD53IBusMFLButton
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_RAD_WRITE_DISPLAY,
-        &CD53IBusRADWriteDisplay
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_ScreenModeSet,
-        &CD53GTScreenModeSet
-    );
-    TimerUnregisterScheduledTask(&CD53TimerDisplay);
-    memset(&Context, 0, sizeof(CD53Context_t));
+    ResourceGroupRelease(&Resources);
 }
 
 static void CD53SetMainDisplayText(
@@ -160,6 +156,7 @@ static void CD53SetMainDisplayText(
     UtilsStrncpy(context->mainDisplay.text, str, UTILS_DISPLAY_TEXT_SIZE);
     context->mainDisplay.length = strlen(context->mainDisplay.text);
     context->mainDisplay.index = 0;
+    TextLayoutInvalidate(&context->mainLayout);
     TimerTriggerScheduledTask(context->displayUpdateTaskId);
     context->mainDisplay.timeout = timeout;
 }
@@ -407,11 +404,14 @@ void CD53BTCallerID(void *ctx, unsigned char *tmp)
     if (context->mode != CD53_MODE_CALL) {
         context->mode = CD53_MODE_CALL;
         context->mainDisplay.timeout = 0;
+        // The text is written straight away, so let it skip the queue
+        IBusSetTXPriority(context->ibus, IBUS_TX_PRIORITY_HIGH);
         CD53SetMainDisplayText(
             context,
             context->bt->callerId,
             3000 / CD53_DISPLAY_SCROLL_SPEED
         );
+        IBusSetTXPriority(context->ibus, IBUS_TX_PRIORITY_NORMAL);
     }
 }
 
@@ -445,6 +445,7 @@ void CD53BTDeviceReady(void *ctx, unsigned char *tmp)
     CD53Context_t *context = (CD53Context_t *) ctx;
     // The BT Device Reset -- Clear the Display
     context->mainDisplay = UtilsDisplayValueInit("", CD53_DISPLAY_STATUS_OFF);
+    TextLayoutInvalidate(&context->mainLayout);
     // If we're in Bluetooth mode, display our banner
     if (context->ibus->cdChangerFunction == IBUS_CDC_FUNC_PLAYING) {
         CD53SetMainDisplayText(context, "Bluetooth", 0);
@@ -521,27 +522,20 @@ void CD53BTPlaybackStatus(void *ctx, unsigned char *status)
 }
 
 /**
- * CD53IBusBMBTButtonPress()
+ * CD53DisplayClaim()
  *     Description:
- *         Handle button presses on the BoardMonitor when installed with
- *         a monochrome navigation unit
+ *         Put our text back up once the radio has stopped writing the display
  *     Params:
- *         void *context - A void pointer to the CD53Context_t struct
- *         unsigned char *pkt - A pointer to the data packet
+ *         void *ctx - A void pointer to the CD53Context_t struct
+ *         uint8_t *data - The DISPLAY_ARBITER_* that can be redrawn
  *     Returns:
  *         void
  */
-void CD53IBusBMBTButtonPress(void *ctx, unsigned char *pkt)
+void CD53DisplayClaim(void *ctx, uint8_t *data)
 {
     CD53Context_t *context = (CD53Context_t *) ctx;
-    if (context->mode != CD53_MODE_OFF) {
-        if (pkt[IBUS_PKT_DB1] == IBUS_DEVICE_BMBT_Button_PlayPause) {
-            if (context->bt->playbackStatus == BT_AVRCP_STATUS_PLAYING) {
-                BTCommandPause(context->bt);
-            } else {
-                BTCommandPlay(context->bt);
-            }
-        }
+    if (data[0] == DISPLAY_ARBITER_CD53 && context->mode != CD53_MODE_OFF) {
+        CD53RedisplayText(context);
     }
 }
 
@@ -566,6 +560,72 @@ void CD53GTScreenModeSet(void *ctx, uint8_t *pkt)
     }
 }
 
+/**
+ * CD53InputGesture()
+ *     Description:
+ *         Run the CD53 action bound to a button gesture
+ *     Params:
+ *         void *ctx - A void pointer to the CD53Context_t struct
+ *         unsigned char *data - The InputGesture_t
+ *     Returns:
+ *         void
+ */
+void CD53InputGesture(void *ctx, unsigned char *data)
+{
+    InputDispatch(
+        CD53InputBindings,
+        sizeof(CD53InputBindings) / sizeof(InputBinding_t),
+        ctx,
+        (InputGesture_t *) data
+    );
+}
+
+/**
+ * CD53InputNextPrev()
+ *     Description:
+ *         Change the track, device or setting when the MFL next / previous
+ *         buttons are released while the wheel is in telephone mode
+ *     Params:
+ *         void *ctx - A void pointer to the CD53Context_t struct
+ *         InputGesture_t *gesture - The gesture
+ *     Returns:
+ *         void
+ */
+void CD53InputNextPrev(void *ctx, InputGesture_t *gesture)
+{
+    CD53Context_t *context = (CD53Context_t *) ctx;
+    if (gesture->target == IBUS_DEVICE_TEL) {
+        unsigned char direction = 0x00;
+        if (gesture->button == IBUS_MFL_BTN_PREV) {
+            direction = 0x01;
+        }
+        CD53HandleUIButtonsNextPrev(context, direction);
+    }
+}
+
+/**
+ * CD53InputPlayPause()
+ *     Description:
+ *         Toggle playback from the BoardMonitor when installed with a
+ *         monochrome navigation unit
+ *     Params:
+ *         void *ctx - A void pointer to the CD53Context_t struct
+ *         InputGesture_t *gesture - The gesture
+ *     Returns:
+ *         void
+ */
+void CD53InputPlayPause(void *ctx, InputGesture_t *gesture)
+{
+    CD53Context_t *context = (CD53Context_t *) ctx;
+    if (context->mode != CD53_MODE_OFF) {
+        if (context->bt->playbackStatus == BT_AVRCP_STATUS_PLAYING) {
+            BTCommandPause(context->bt);
+        } else {
+            BTCommandPlay(context->bt);
+        }
+    }
+}
+
 void CD53IBusCDChangerStatus(void *ctx, unsigned char *pkt)
 {
     CD53Context_t *context = (CD53Context_t *) ctx;
@@ -627,28 +687,6 @@ void CD53IBusIgnitionStatus(void *ctx, unsigned char *pkt)
     }
 }
 
-void CD53IBusMFLButton(void *ctx, unsigned char *pkt)
-{
-    CD53Context_t *context = (CD53Context_t *) ctx;
-    if (pkt[IBUS_PKT_DST] == IBUS_DEVICE_TEL) {
-        // 0x00 = R/T Mode RAD
-        if (pkt[IBUS_PKT_DB1] == 0x00 &&
-            context->displayMetadata == CD53_DISPLAY_METADATA_ON
-        ) {
-            // Do not do this as it will stick the radio in TEL mode
-            //CD53RedisplayText(context);
-        } else if (pkt[IBUS_PKT_DB1] == IBUS_MFL_BTN_EVENT_NEXT_REL ||
-                   pkt[IBUS_PKT_DB1] == IBUS_MFL_BTN_EVENT_PREV_REL
-        ) {
-            unsigned char direction = 0x00;
-            if (pkt[IBUS_PKT_DB1] == IBUS_MFL_BTN_EVENT_PREV_REL) {
-                direction = 0x01;
-            }
-            CD53HandleUIButtonsNextPrev(context, direction);
-        }
-    }
-}
-
 void CD53IBusRADWriteDisplay(void *ctx, unsigned char *pkt)
 {
     CD53Context_t *context = (CD53Context_t *) ctx;
@@ -656,9 +694,10 @@ void CD53IBusRADWriteDisplay(void *ctx, unsigned char *pkt)
         context->radioType = CONFIG_UI_MIR;
     }
     // Ensure that the display mode is 0xC4 so we know we did not write this
-    // to the display
+    // to the display. The text is put back once the radio goes quiet, so
+    // we do not trade redraws with it.
     if (context->mode != CD53_MODE_OFF && pkt[IBUS_PKT_DB1] == 0xC4) {
-        CD53RedisplayText(context);
+        DisplayArbiterRadioWrite(DISPLAY_ARBITER_CD53);
     }
 }
 
@@ -697,38 +736,52 @@ void CD53TimerDisplay(void *ctx)
         if (context->mainDisplay.length <= CD53_DISPLAY_TEXT_LEN) {
             context->mainDisplay.index = 0;
         }
-    } else {
-        // Display the main text if there isn't a timeout set
+    } else if (context->mode == CD53_MODE_CALL ||
+               DisplayArbiterHasRadio(DISPLAY_ARBITER_CD53) == 0
+    ) {
+        // Display the main text if there isn't a timeout set. The text is
+        // held back while the radio writes the display and put back up once
+        // it hands the display back, except for the caller ID, which can't
+        // wait out a back off.
         if (context->mainDisplay.timeout > 0) {
             context->mainDisplay.timeout--;
         } else if (context->mainDisplay.timeout == 0 ||
                    context->mainDisplay.timeout == CD53_TIMEOUT_SCROLL_STOP_NEXT_ITR
         ) {
-            if (context->mainDisplay.length > CD53_DISPLAY_TEXT_LEN) {
+            uint8_t metaMode = ConfigGetSetting(CONFIG_SETTING_METADATA_MODE);
+            uint8_t layoutMode = TEXT_LAYOUT_MODE_SCROLL;
+            // Only metadata is shown a chunk at a time
+            if (context->mode == CD53_MODE_ACTIVE &&
+                metaMode == MENU_SINGLELINE_SETTING_METADATA_MODE_CHUNK
+            ) {
+                layoutMode = TEXT_LAYOUT_MODE_CHUNK;
+            }
+            uint8_t segments = TextLayoutPrepare(
+                &context->mainLayout,
+                context->mainDisplay.text,
+                layoutMode
+            );
+            if (segments > 1) {
                 char text[CD53_DISPLAY_TEXT_LEN + 1] = {0};
-                uint8_t textLength = CD53_DISPLAY_TEXT_LEN;
-                uint8_t idxEnd = context->mainDisplay.index + textLength;
-                // Prevent strncpy() from going out of bounds
-                if (idxEnd >= context->mainDisplay.length) {
-                    textLength = context->mainDisplay.length - context->mainDisplay.index;
-                    idxEnd = context->mainDisplay.index + textLength;
+                if (context->mainDisplay.index >= segments) {
+                    context->mainDisplay.index = 0;
                 }
-                UtilsStrncpy(
-                    text,
-                    &context->mainDisplay.text[context->mainDisplay.index],
-                    textLength + 1
+                TextLayoutGetSegment(
+                    &context->mainLayout,
+                    context->mainDisplay.text,
+                    context->mainDisplay.index,
+                    text
+                );
+                uint8_t next = TextLayoutNextSegment(
+                    &context->mainLayout,
+                    context->mainDisplay.text,
+                    context->mainDisplay.index
                 );
-                // If we start with a space, it will be ignored by the display
-                // Instead, use 0x9D which results in a true blank being displayed
-                if (text[0] == 0x20) {
-                    text[0] = IBUS_RAD_SPACE_CHAR_ALT;
-                }
                 if (context->radioType == CONFIG_UI_CD53) {
                     IBusCommandTELIKEDisplayWrite(context->ibus, text);
                 } else if (context->radioType == CONFIG_UI_MIR) {
                     IBusCommandGTWriteBusinessNavTitle(context->ibus, text);
                 }
-                uint8_t metaMode = ConfigGetSetting(CONFIG_SETTING_METADATA_MODE);
                 // Pause at the beginning of the text
                 if (context->mainDisplay.index == 0) {
                     if (metaMode == MENU_SINGLELINE_SETTING_METADATA_MODE_STATIC ||
@@ -739,7 +792,7 @@ void CD53TimerDisplay(void *ctx)
                         context->mainDisplay.timeout = 5;
                     }
                 }
-                if (idxEnd >= context->mainDisplay.length) {
+                if (next >= segments) {
                     // Pause at the end of the text or on the next iteration
                     // if we have Party Single Scroll mode enabled
                     context->mainDisplay.index = 0;
@@ -752,15 +805,15 @@ void CD53TimerDisplay(void *ctx)
                     if (context->mode == CD53_MODE_ACTIVE) {
                         if (metaMode == MENU_SINGLELINE_SETTING_METADATA_MODE_CHUNK) {
                             context->mainDisplay.timeout = 2;
-                            context->mainDisplay.index += CD53_DISPLAY_TEXT_LEN;
+                            context->mainDisplay.index = next;
                         } else if (metaMode == MENU_SINGLELINE_SETTING_METADATA_MODE_PARTY ||
                             metaMode == MENU_SINGLELINE_SETTING_METADATA_MODE_PARTY_SINGLE
                         ) {
-                            context->mainDisplay.index++;
+                            context->mainDisplay.index = next;
                         }
                     } else {
                         // Use Party Scroll for all modes except metadata
-                        context->mainDisplay.index++;
+                        context->mainDisplay.index = next;
                     }
                 }
             } else {
@@ -9,9 +9,13 @@
 #include <stdio.h>
 #include "../lib/bt/bt_bc127.h"
 #include "../lib/bt.h"
+#include "../lib/display_arbiter.h"
 #include "../lib/log.h"
 #include "../lib/event.h"
 #include "../lib/ibus.h"
+#include "../lib/input.h"
+#include "../lib/resource_group.h"
+#include "../lib/text_layout.h"
 #include "../lib/timer.h"
 #include "../lib/utils.h"
 #include "menu/menu_singleline.h"
@@ -51,6 +55,7 @@
  *      the display update task immediately.
  *  btDeviceIndex: The selected Bluetooth device -- Used to change selected devices
  *  mainDisplay: The main text that should be displayed
+ *  mainLayout: The segments of the main text
  *  tempDisplay: The value to temporarily display on the screen. The max text
  *      length is 11 characters.
  */
@@ -69,6 +74,7 @@ typedef struct CD53Context_t {
     uint8_t mediaChangeState;
     uint32_t lastTelephoneButtonPress;
     UtilsAbstractDisplayValue_t mainDisplay;
+    TextLayout_t mainLayout;
     UtilsAbstractDisplayValue_t tempDisplay;
     MenuSingleLineContext_t menuContext;
 } CD53Context_t;
@@ -81,10 +87,12 @@ void CD53BTDeviceDisconnected(void *, uint8_t *);
 void CD53BTDeviceReady(void *, uint8_t *);
 void CD53BTMetadata(CD53Context_t *, uint8_t *);
 void CD53BTPlaybackStatus(void *, uint8_t *);
-void CD53IBusBMBTButtonPress(void *, uint8_t *);
+void CD53DisplayClaim(void *, uint8_t *);
 void CD53IBusCDChangerStatus(void *, uint8_t *);
 void CD53IBusIgnitionStatus(void *, unsigned char *);
-void CD53IBusMFLButton(void *, uint8_t *);
+void CD53InputGesture(void *, unsigned char *);
+void CD53InputNextPrev(void *, InputGesture_t *);
+void CD53InputPlayPause(void *, InputGesture_t *);
 void CD53IBusRADWriteDisplay(void *, uint8_t *);
 void CD53GTScreenModeSet(void *, uint8_t *);
 void CD53TimerDisplay(void *);
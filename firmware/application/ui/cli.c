@@ -39,6 +39,25 @@ void CLIInit(UART_t *uart, BT_t *bt, IBus_t *ibus)
     );
 }
 
+/**
+ * CLICommandBTBC127CVCPreset()
+ *     Description:
+ *         Parse a CVC preset name
+ *     Params:
+ *         char *name - The preset name, A or B
+ *     Returns:
+ *         uint8_t - The preset, or BT_CVC_PRESET_NONE if the name is unknown
+ */
+static uint8_t CLICommandBTBC127CVCPreset(char *name)
+{
+    if (UtilsStricmp(name, "A") == 0) {
+        return 0;
+    } else if (UtilsStricmp(name, "B") == 0) {
+        return 1;
+    }
+    return BT_CVC_PRESET_NONE;
+}
+
 /**
  * CLICommandBTBC127()
  *     Description:
@@ -67,6 +86,73 @@ void CLICommandBTBC127(char **msgBuf, uint8_t *cmdSuccess, uint8_t delimCount)
             } else if (UtilsStricmp(msgBuf[2], "OFF") == 0) {
                 BC127SendCommand(cli.bt, "SET HFP_CONFIG=OFF ON ON OFF ON OFF");
                 BC127CommandWrite(cli.bt);
+            } else if (UtilsStricmp(msgBuf[2], "AB") == 0) {
+                // Flip between the presets, starting with A
+                uint8_t preset = 0;
+                if (cli.bt->cvc.preset == 0) {
+                    preset = 1;
+                }
+                if (BC127CVCPresetLoad(cli.bt, preset) == 1) {
+                    LogRaw("CVC: Preset %c\r\n", 'A' + preset);
+                } else {
+                    LogRaw("CVC: Preset %c is not stored\r\n", 'A' + preset);
+                }
+            } else if (UtilsStricmp(msgBuf[2], "BULK") == 0) {
+                if (delimCount != 3 + (BT_CVC_BAND_COUNT * BT_CVC_PARAM_COUNT)) {
+                    LogRaw(
+                        "CVC: Expected %d parameters\r\n",
+                        BT_CVC_BAND_COUNT * BT_CVC_PARAM_COUNT
+                    );
+                    *cmdSuccess = 0;
+                } else {
+                    uint16_t params[BT_CVC_PARAM_COUNT];
+                    uint8_t band;
+                    uint8_t idx;
+                    uint8_t sent = 0;
+                    for (band = 0; band < BT_CVC_BAND_COUNT; band++) {
+                        for (idx = 0; idx < BT_CVC_PARAM_COUNT; idx++) {
+                            params[idx] = (uint16_t) strtol(
+                                msgBuf[3 + (band * BT_CVC_PARAM_COUNT) + idx],
+                                0,
+                                16
+                            );
+                        }
+                        sent += BC127CommandCVCWrite(cli.bt, band, params);
+                    }
+                    cli.bt->cvc.preset = BT_CVC_PRESET_NONE;
+                    LogRaw("CVC: Sent %d parameters\r\n", sent);
+                }
+            } else if (UtilsStricmp(msgBuf[2], "GET") == 0) {
+                uint8_t band;
+                uint8_t idx;
+                for (band = 0; band < BT_CVC_BAND_COUNT; band++) {
+                    LogRaw("CVC: %s", band == BT_CVC_BAND_WB ? "WB" : "NB");
+                    if ((cli.bt->cvc.validMask & (1 << band)) == 0) {
+                        LogRaw(" Unknown\r\n");
+                        continue;
+                    }
+                    for (idx = 0; idx < BT_CVC_PARAM_COUNT; idx++) {
+                        LogRaw(" %04X", cli.bt->cvc.params[band][idx]);
+                    }
+                    LogRaw("\r\n");
+                }
+                if (cli.bt->cvc.preset == BT_CVC_PRESET_NONE) {
+                    LogRaw("CVC: Preset None\r\n");
+                } else {
+                    LogRaw("CVC: Preset %c\r\n", 'A' + cli.bt->cvc.preset);
+                }
+            } else if (UtilsStricmp(msgBuf[2], "LOAD") == 0 && delimCount == 4) {
+                uint8_t preset = CLICommandBTBC127CVCPreset(msgBuf[3]);
+                if (BC127CVCPresetLoad(cli.bt, preset) == 0) {
+                    LogRaw("CVC: Preset %s is not stored\r\n", msgBuf[3]);
+                    *cmdSuccess = 0;
+                }
+            } else if (UtilsStricmp(msgBuf[2], "SAVE") == 0 && delimCount == 4) {
+                uint8_t preset = CLICommandBTBC127CVCPreset(msgBuf[3]);
+                if (BC127CVCPresetSave(cli.bt, preset) == 0) {
+                    LogRaw("CVC: Nothing to save, send the parameters first\r\n");
+                    *cmdSuccess = 0;
+                }
             } else {
                 *cmdSuccess = 0;
             }
@@ -419,14 +505,28 @@ void CLIProcess()
             // functions
             char tmpMsg[messageLength];
             strcpy(tmpMsg, msg);
-            char *msgBuf[delimCount];
+            uint8_t msgBufSize = delimCount;
+            if (msgBufSize < CLI_MSG_MIN_FIELDS) {
+                msgBufSize = CLI_MSG_MIN_FIELDS;
+            }
+            char *msgBuf[msgBufSize];
             char *p = strtok(tmpMsg, " ");
             i = 0;
             while (p != 0x00) {
                 msgBuf[i++] = p;
                 p = strtok(0x00, " ");
             }
-            if (UtilsStricmp(msgBuf[0], "BOOTLOADER") == 0) {
+            // Point missing parameters at an empty string
+            while (i < msgBufSize) {
+                msgBuf[i++] = "";
+            }
+            if (UtilsStricmp(msgBuf[0], "BENCH") == 0) {
+                if (delimCount == 2) {
+                    BenchRun(cli.bt, cli.ibus, msgBuf[1]);
+                } else {
+                    BenchRun(cli.bt, cli.ibus, 0);
+                }
+            } else if (UtilsStricmp(msgBuf[0], "BOOTLOADER") == 0) {
                 LogRaw("Rebooting into bootloader\r\n");
                 uint32_t now = TimerGetMillis();
                 // Wait 15ms before going into the bootloader
@@ -437,7 +537,7 @@ void CLIProcess()
             } else if (UtilsStricmp(msgBuf[0], "BT") == 0) {
                 if (UtilsStricmp(msgBuf[1], "AT") == 0) {
                     if (delimCount == 3) {
-                        if (cli.bt->type == BT_BTM_TYPE_BC127) {
+                        if (BTGetType(cli.bt) == BT_BTM_TYPE_BC127) {
                             BC127CommandAT(cli.bt, msgBuf[2]);
                         } else {
                             BM83CommandVendorATCommand(cli.bt, msgBuf[2]);
@@ -457,7 +557,7 @@ void CLIProcess()
                     BTCommandDial(cli.bt, cli.bt->dialBuffer, 0);
                 } else if (UtilsStricmp(msgBuf[1], "REDIAL_PHONE") == 0) {
                     BTCommandRedial(cli.bt);
-                } else if (cli.bt->type == BT_BTM_TYPE_BC127) {
+                } else if (BTGetType(cli.bt) == BT_BTM_TYPE_BC127) {
                     CLICommandBTBC127(msgBuf, &cmdSuccess, delimCount);
                 } else {
                     CLICommandBTBM83(msgBuf, &cmdSuccess, delimCount);
@@ -474,10 +574,19 @@ void CLIProcess()
                         cmdSuccess = 0;
                     }
                 } else if (UtilsStricmp(msgBuf[1], "IBUS") == 0) {
-                    IBusCommandDIAGetIdentity(cli.ibus, IBUS_DEVICE_GT);
-                    IBusCommandDIAGetIdentity(cli.ibus, IBUS_DEVICE_RAD);
+                    IBusPrintTXStatus(cli.ibus);
+                    DiagnosticsRequestLive(IBUS_DEVICE_GT, DIAGNOSTICS_JOB_IDENTITY);
+                    DiagnosticsRequestLive(IBUS_DEVICE_RAD, DIAGNOSTICS_JOB_IDENTITY);
                 } else if (UtilsStricmp(msgBuf[1], "LCM") == 0) {
-                    IBusCommandDIAGetIdentity(cli.ibus, IBUS_DEVICE_LCM);
+                    DiagnosticsRequestLive(IBUS_DEVICE_LCM, DIAGNOSTICS_JOB_IDENTITY);
+                } else if (UtilsStricmp(msgBuf[1], "AUDIO") == 0) {
+                    AudioProfilePrint();
+                } else if (UtilsStricmp(msgBuf[1], "CODEC") == 0) {
+                    CodecPrintStatus();
+                } else if (UtilsStricmp(msgBuf[1], "DIA") == 0) {
+                    DiagnosticsCachePrint();
+                } else if (UtilsStricmp(msgBuf[1], "DISPLAY") == 0) {
+                    DisplayArbiterPrint();
                 } else if (UtilsStricmp(msgBuf[1], "ERR") == 0) {
                     // Errors
                     LogRaw("Trap Counts: \r\n");
@@ -512,6 +621,8 @@ void CLIProcess()
                     status = I2CRead(0x4C, 0x76, &buffer);
                     LogRaw("PCM5122: PWRSTAT %02X (0x76) [%d]\r\n", buffer, status);
                     LogRaw("PCM5122: Volume configured to %02X\r\n", ConfigGetSetting(CONFIG_SETTING_DAC_AUDIO_VOL));
+                } else if (UtilsStricmp(msgBuf[1], "I2C") == 0) {
+                    I2CPrintStatus();
                 } else if (UtilsStricmp(msgBuf[1], "I2S") == 0) {
                     int8_t status;
                     uint8_t buffer;
@@ -569,7 +680,10 @@ void CLIProcess()
                     cmdSuccess = 0;
                 }
             } else if (UtilsStricmp(msgBuf[0], "SEND") == 0) {
-                if (UtilsStricmp(msgBuf[1], "IBUS") == 0) {
+                if (UtilsStricmp(msgBuf[1], "IBUS") == 0 &&
+                    delimCount > 6 &&
+                    delimCount - 6 <= IBUS_MAX_MSG_LENGTH - 4
+                ) {
                     uint8_t idx = 2;
                     uint8_t message[delimCount - 4];
                     uint8_t src = 0x00;
@@ -591,6 +705,8 @@ void CLIProcess()
                     if (size > 0) {
                         IBusSendCommand(cli.ibus, src, dst, message, size);
                     }
+                } else {
+                    cmdSuccess = 0;
                 }
             } else if (UtilsStricmp(msgBuf[0], "SET") == 0) {
                 if (UtilsStricmp(msgBuf[1], "BYTE") == 0 && delimCount == 4) {
@@ -636,6 +752,31 @@ void CLIProcess()
                             cmdSuccess = 0;
                         }
                     }
+                } else if (UtilsStricmp(msgBuf[1], "AUDIO") == 0 && delimCount >= 4) {
+                    uint8_t profile = AudioProfileFind(msgBuf[3]);
+                    if (profile == AUDIO_PROFILE_NONE) {
+                        LogRaw("Audio Profile '%s' not found\r\n", msgBuf[3]);
+                        cmdSuccess = 0;
+                    } else if (UtilsStricmp(msgBuf[2], "LOAD") == 0) {
+                        cmdSuccess = AudioProfileApply(
+                            cli.bt,
+                            cli.ibus,
+                            profile,
+                            HandlerGetTelStatus()
+                        );
+                    } else if (UtilsStricmp(msgBuf[2], "SAVE") == 0 && delimCount == 5) {
+                        cmdSuccess = AudioProfileSave(profile, msgBuf[4]);
+                    } else if (UtilsStricmp(msgBuf[2], "DELETE") == 0) {
+                        cmdSuccess = AudioProfileDelete(profile);
+                    } else {
+                        cmdSuccess = 0;
+                    }
+                } else if (UtilsStricmp(msgBuf[1], "DIA") == 0) {
+                    if (UtilsStricmp(msgBuf[2], "CLEAR") == 0) {
+                        DiagnosticsCacheClear();
+                    } else {
+                        cmdSuccess = 0;
+                    }
                 } else if (UtilsStricmp(msgBuf[1], "DAC") == 0) {
                     if (UtilsStricmp(msgBuf[2], "GAIN") == 0) {
                         uint8_t currentVolume = UtilsStrToHex(msgBuf[3]);
@@ -782,7 +923,7 @@ void CLIProcess()
                 }
             } else if (UtilsStricmp(msgBuf[0], "RESTORE") == 0) {
                 uint8_t micGain = 0x00;
-                if (cli.bt->type == BT_BTM_TYPE_BC127) {
+                if (BTGetType(cli.bt) == BT_BTM_TYPE_BC127) {
                     BC127CommandUnpair(cli.bt);
                     BC127CommandSetAudio(cli.bt, 0, 1);
                     BC127CommandSetAudioAnalog(cli.bt, 1, 15, 1, "OFF");
@@ -834,6 +975,52 @@ void CLIProcess()
                 ConfigSetSetting(CONFIG_SETTING_HFP, CONFIG_SETTING_ON);
                 ConfigSetSetting(CONFIG_SETTING_MIC_BIAS, CONFIG_SETTING_ON);
                 ConfigSetSetting(CONFIG_SETTING_MIC_GAIN, micGain);
+            } else if (UtilsStricmp(msgBuf[0], "TELEMETRY") == 0) {
+                if (delimCount == 1) {
+                    TelemetryStatus();
+                } else if (UtilsStricmp(msgBuf[1], "DUMP") == 0) {
+                    TelemetryDump();
+                } else if (UtilsStricmp(msgBuf[1], "CLEAR") == 0) {
+                    TelemetryClear();
+                } else if (UtilsStricmp(msgBuf[1], "RATE") == 0 && delimCount == 4) {
+                    long fastRate = strtol(msgBuf[2], 0, 10) / TELEMETRY_TICK_MS;
+                    long slowRate = strtol(msgBuf[3], 0, 10);
+                    if (fastRate < 0 || slowRate < 0) {
+                        fastRate = 0;
+                        slowRate = 0;
+                    }
+                    if (fastRate > 0xFF) {
+                        fastRate = 0xFF;
+                    }
+                    if (slowRate > 0xFF) {
+                        slowRate = 0xFF;
+                    }
+                    ConfigSetSetting(CONFIG_SETTING_TELEMETRY_FAST_RATE, fastRate);
+                    ConfigSetSetting(CONFIG_SETTING_TELEMETRY_SLOW_RATE, slowRate);
+                    TelemetryStatus();
+                } else {
+                    cmdSuccess = 0;
+                }
+            } else if (UtilsStricmp(msgBuf[0], "SNIFFER") == 0 && delimCount == 2) {
+                if (UtilsStricmp(msgBuf[1], "ON") == 0) {
+                    SnifferSetEnabled(1);
+                } else if (UtilsStricmp(msgBuf[1], "OFF") == 0) {
+                    SnifferSetEnabled(0);
+                } else {
+                    cmdSuccess = 0;
+                }
+            } else if (UtilsStricmp(msgBuf[0], "TRACE") == 0 && delimCount == 2) {
+                if (UtilsStricmp(msgBuf[1], "START") == 0) {
+                    TraceSetEnabled(1);
+                } else if (UtilsStricmp(msgBuf[1], "STOP") == 0) {
+                    TraceSetEnabled(0);
+                } else if (UtilsStricmp(msgBuf[1], "CLEAR") == 0) {
+                    TraceClear();
+                } else if (UtilsStricmp(msgBuf[1], "DUMP") == 0) {
+                    TraceDump();
+                } else {
+                    cmdSuccess = 0;
+                }
             } else if (UtilsStricmp(msgBuf[0], "TEST") == 0) {
                 int8_t status = 0x00;
                 uint8_t buffer = 0x00;
@@ -853,10 +1040,15 @@ void CLIProcess()
                 LogRaw("Hardware Revision: %d\r\n", BOARD_VERSION_STATUS + 1);
             } else if (UtilsStricmp(msgBuf[0], "HELP") == 0 || UtilsStricmp(msgBuf[0], "?") == 0) {
                 LogRaw("Available Commands:\r\n");
+                LogRaw("    BENCH [name] - Run the performance benchmarks, or only the named one\r\n");
                 LogRaw("    BOOTLOADER - Reboot into the bootloader immediately\r\n");
-                if (cli.bt->type == BT_BTM_TYPE_BC127) {
+                if (BTGetType(cli.bt) == BT_BTM_TYPE_BC127) {
                     LogRaw("    BT CONFIG - Get the BC127 Configuration\r\n");
                     LogRaw("    BT CVC ON/OFF - Enable or Disable Clear Voice Capture\r\n");
+                    LogRaw("    BT CVC BULK <NB x14> <WB x14> - Write the CVC parameters, only sending changes\r\n");
+                    LogRaw("    BT CVC GET - Get the CVC parameters and the active preset\r\n");
+                    LogRaw("    BT CVC SAVE/LOAD A/B - Store or apply a CVC preset\r\n");
+                    LogRaw("    BT CVC AB - Switch between CVC presets A and B\r\n");
                     LogRaw("    BT HFP ON/OFF - Enable or Disable HFP. Get the HFP Status without a param.\r\n");
                     LogRaw("    BT MGAIN x - Set the Mic gain to x where x is octal C0-D6\r\n");
                     LogRaw("    BT MPREAMP ON/OFF - Enable the microphone pre-amp so non-OE microphones work well\r\n");
@@ -878,16 +1070,24 @@ void CLIProcess()
                 LogRaw("    BT AT command> - Send raw AT command\r\n");
                 LogRaw("    BT DIAL <number> <name> - Dial a number and display name\r\n");
                 LogRaw("    BT REDIAL - Dial last number\r\n");
+                LogRaw("    GET AUDIO - List the stored audio profiles\r\n");
+                LogRaw("    GET CODEC - Get the codec supervisor state and fault counters\r\n");
                 LogRaw("    GET DAC - Get info from the PCM5122 DAC\r\n");
+                LogRaw("    GET DIA - Show the cached diagnostic replies\r\n");
+                LogRaw("    GET DISPLAY - Get the radio display write and redraw counters\r\n");
                 LogRaw("    GET ERR - Get the Error counter\r\n");
                 LogRaw("    GET IBUS - Get debug info from the IBus\r\n");
                 LogRaw("    GET UI - Get the current UI Mode\r\n");
+                LogRaw("    GET I2C - Get the I2C error and bus recovery counters\r\n");
                 LogRaw("    GET I2S - Read the WM8804 INT/SPD Status registers\r\n");
                 LogRaw("    GET VIN - Read the stored vehicle VIN\r\n");
                 LogRaw("    REBOOT - Reboot the device\r\n");
+                LogRaw("    SET AUDIO SAVE n name - Store the DAC, microphone and DSP settings as profile n (1-4)\r\n");
+                LogRaw("    SET AUDIO LOAD/DELETE n|name - Apply or remove an audio profile\r\n");
                 LogRaw("    SET COMFORT BLINKERS x - Set the comfort blinkers between 1 and 8\r\n");
                 LogRaw("    SET COMFORT LOCK x - Lock the car at the given KM/h. 10, 20 or OFF\r\n");
                 LogRaw("    SET COMFORT UNLOCK x - Unlock the car at the given ignition position. POS0, POS1 or OFF\r\n");
+                LogRaw("    SET DIA CLEAR - Drop the cached diagnostic replies\r\n");
                 LogRaw("    SET DAC GAIN xx - Set the PCM5122 gain from 0x00 - 0xCF (higher is lower)\r\n");
                 LogRaw("    SET DSP INPUT ANALOG/DIGITAL/DEFAULT - Set the CD Changer DSP input\r\n");
                 LogRaw("    SET IGN ON/OFF/ALWAYSON - Send the ignition status message or configure the BlueBus to assume the ignition is always on\r\n");
@@ -902,6 +1102,16 @@ void CLIProcess()
                 LogRaw("        x = 4. BMBT / MID\r\n");
                 LogRaw("        x = 5. Business Navigation (MIR)\r\n");
                 LogRaw("    RESTORE - Fully Reset the BlueBus and BC127 to factory defaults\r\n");
+                LogRaw("    SNIFFER ON - Stream IBus frames as binary records for ibus_sniffer.py\r\n");
+                LogRaw("    SNIFFER OFF - Stop streaming and print the record and drop counts\r\n");
+                LogRaw("    TELEMETRY - Get the telemetry recorder status\r\n");
+                LogRaw("    TELEMETRY DUMP - Print the recorded pages for telemetry_export.py\r\n");
+                LogRaw("    TELEMETRY CLEAR - Drop all recorded pages\r\n");
+                LogRaw("    TELEMETRY RATE x y - Sample speed / RPM every x ms and temperatures every y seconds. 0 disables.\r\n");
+                LogRaw("    TRACE START - Record the latency from bus input to bus and BT output\r\n");
+                LogRaw("    TRACE STOP - Stop recording latency traces\r\n");
+                LogRaw("    TRACE CLEAR - Drop all recorded traces\r\n");
+                LogRaw("    TRACE DUMP - Print the recorded traces as Chrome trace JSON\r\n");
                 LogRaw("    VERSION - Get the BlueBus Hardware/Software Versions\r\n");
             } else {
                 cmdSuccess = 0;
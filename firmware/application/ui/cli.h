@@ -10,15 +10,24 @@
 #include <string.h>
 #include <stdio.h>
 #include "../mappings.h"
+#include "../handler.h"
 #include "../lib/bt/bt_bc127.h"
 #include "../lib/bt/bt_bm83.h"
+#include "../lib/audio_profile.h"
+#include "../lib/bench.h"
 #include "../lib/bt.h"
 #include "../lib/char_queue.h"
+#include "../lib/codec.h"
 #include "../lib/config.h"
+#include "../lib/diagnostics.h"
+#include "../lib/display_arbiter.h"
 #include "../lib/i2c.h"
 #include "../lib/ibus.h"
 #include "../lib/pcm51xx.h"
+#include "../lib/sniffer.h"
+#include "../lib/telemetry.h"
 #include "../lib/timer.h"
+#include "../lib/trace.h"
 #include "../lib/uart.h"
 
 // Banner timeout is in seconds
@@ -26,6 +35,8 @@
 #define CLI_MSG_END_CHAR 0x0D
 #define CLI_MSG_DELIMETER 0x20
 #define CLI_MSG_DELETE_CHAR 0x7F
+// Commands index up to this many fields without checking the field count
+#define CLI_MSG_MIN_FIELDS 8
 /**
  * CLI_t
  *     Description:
@@ -0,0 +1,301 @@
+/*
+ * File: menu_device_list.c
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     A paged view over the paired devices list, shared by the UIs. Only the
+ *     visible page is rendered and device names are normalized once and
+ *     cached until the pairing list changes.
+ */
+#include "menu_device_list.h"
+
+/**
+ * MenuDeviceListCheckRevision()
+ *     Description:
+ *         Drop the name cache if the pairing list changed since it was built
+ *     Params:
+ *         MenuDeviceListContext_t *context - The list
+ *     Returns:
+ *         void
+ */
+static void MenuDeviceListCheckRevision(MenuDeviceListContext_t *context)
+{
+    if (context->revision != context->bt->pairedDevicesRevision) {
+        context->revision = context->bt->pairedDevicesRevision;
+        context->cachedMask = 0;
+        if (context->page >= MenuDeviceListGetPageCount(context)) {
+            context->page = 0;
+        }
+    }
+}
+
+/**
+ * MenuDeviceListInit()
+ *     Description:
+ *         Set up a device list view
+ *     Params:
+ *         MenuDeviceListContext_t *context - The list
+ *         BT_t *bt - The BT_t to read the pairings from
+ *         uint8_t pageSize - The number of devices shown at a time
+ *         uint8_t nameLength - The characters of a name that fit on a row
+ *     Returns:
+ *         void
+ */
+void MenuDeviceListInit(
+    MenuDeviceListContext_t *context,
+    BT_t *bt,
+    uint8_t pageSize,
+    uint8_t nameLength
+) {
+    memset(context, 0, sizeof(MenuDeviceListContext_t));
+    context->bt = bt;
+    context->pageSize = pageSize;
+    if (nameLength > MENU_DEVICE_LIST_NAME_SIZE - 1) {
+        nameLength = MENU_DEVICE_LIST_NAME_SIZE - 1;
+    }
+    context->nameLength = nameLength;
+    context->revision = bt->pairedDevicesRevision;
+}
+
+/**
+ * MenuDeviceListGetCount()
+ *     Description:
+ *         Get the number of devices in the list
+ *     Params:
+ *         MenuDeviceListContext_t *context - The list
+ *     Returns:
+ *         uint8_t - The device count
+ */
+uint8_t MenuDeviceListGetCount(MenuDeviceListContext_t *context)
+{
+    uint8_t count = context->bt->pairedDevicesCount;
+    if (count > BT_MAX_DEVICE_PAIRED) {
+        count = BT_MAX_DEVICE_PAIRED;
+    }
+    return count;
+}
+
+/**
+ * MenuDeviceListGetDevice()
+ *     Description:
+ *         Get the pairing index of the device shown on a row of the current
+ *         page
+ *     Params:
+ *         MenuDeviceListContext_t *context - The list
+ *         uint8_t row - The row on the page
+ *     Returns:
+ *         uint8_t - The index into pairedDevices or
+ *             MENU_DEVICE_LIST_DEVICE_NONE if the row is empty
+ */
+uint8_t MenuDeviceListGetDevice(MenuDeviceListContext_t *context, uint8_t row)
+{
+    MenuDeviceListCheckRevision(context);
+    if (row >= context->pageSize) {
+        return MENU_DEVICE_LIST_DEVICE_NONE;
+    }
+    uint8_t deviceIdx = (context->page * context->pageSize) + row;
+    if (deviceIdx >= MenuDeviceListGetCount(context)) {
+        return MENU_DEVICE_LIST_DEVICE_NONE;
+    }
+    return deviceIdx;
+}
+
+/**
+ * MenuDeviceListGetName()
+ *     Description:
+ *         Get the normalized name of a device, normalizing it on first use
+ *     Params:
+ *         MenuDeviceListContext_t *context - The list
+ *         uint8_t deviceIdx - The index into pairedDevices
+ *     Returns:
+ *         const char * - The cached name, cut to the row length
+ */
+const char *MenuDeviceListGetName(MenuDeviceListContext_t *context, uint8_t deviceIdx)
+{
+    MenuDeviceListCheckRevision(context);
+    if (deviceIdx >= BT_MAX_DEVICE_PAIRED) {
+        return "";
+    }
+    char *name = context->names[deviceIdx];
+    if ((context->cachedMask & (1 << deviceIdx)) == 0) {
+        char normalized[BT_DEVICE_NAME_LEN + 1];
+        memset(normalized, 0, sizeof(normalized));
+        UtilsNormalizeText(
+            normalized,
+            context->bt->pairedDevices[deviceIdx].deviceName,
+            sizeof(normalized)
+        );
+        UtilsStrncpy(name, normalized, context->nameLength + 1);
+        context->cachedMask |= 1 << deviceIdx;
+    }
+    return name;
+}
+
+/**
+ * MenuDeviceListGetPageCount()
+ *     Description:
+ *         Get the number of pages it takes to show every device
+ *     Params:
+ *         MenuDeviceListContext_t *context - The list
+ *     Returns:
+ *         uint8_t - The page count, at least 1
+ */
+uint8_t MenuDeviceListGetPageCount(MenuDeviceListContext_t *context)
+{
+    uint8_t count = MenuDeviceListGetCount(context);
+    if (count == 0 || context->pageSize == 0) {
+        return 1;
+    }
+    return (count + context->pageSize - 1) / context->pageSize;
+}
+
+/**
+ * MenuDeviceListGetRow()
+ *     Description:
+ *         Build the text for a row of the current page. The connected device
+ *         gets MENU_DEVICE_LIST_ACTIVE_SUFFIX, cutting its name short if the
+ *         row would not fit otherwise.
+ *     Params:
+ *         MenuDeviceListContext_t *context - The list
+ *         uint8_t row - The row on the page
+ *         char *text - The buffer to write the row to
+ *         uint8_t size - The size of text
+ *     Returns:
+ *         uint8_t - The index into pairedDevices or
+ *             MENU_DEVICE_LIST_DEVICE_NONE if the row is empty
+ */
+uint8_t MenuDeviceListGetRow(
+    MenuDeviceListContext_t *context,
+    uint8_t row,
+    char *text,
+    uint8_t size
+) {
+    uint8_t deviceIdx = MenuDeviceListGetDevice(context, row);
+    memset(text, 0, size);
+    if (deviceIdx == MENU_DEVICE_LIST_DEVICE_NONE) {
+        return deviceIdx;
+    }
+    UtilsStrncpy(text, MenuDeviceListGetName(context, deviceIdx), size);
+    if (MenuDeviceListIsActive(context, deviceIdx) == 1) {
+        uint8_t suffixLength = sizeof(MENU_DEVICE_LIST_ACTIVE_SUFFIX) - 1;
+        uint8_t length = strlen(text);
+        if (size <= suffixLength) {
+            return deviceIdx;
+        }
+        if (length > size - 1 - suffixLength) {
+            length = size - 1 - suffixLength;
+        }
+        memcpy(&text[length], MENU_DEVICE_LIST_ACTIVE_SUFFIX, suffixLength + 1);
+    }
+    return deviceIdx;
+}
+
+/**
+ * MenuDeviceListIsActive()
+ *     Description:
+ *         Check if a device is the one we are connected to
+ *     Params:
+ *         MenuDeviceListContext_t *context - The list
+ *         uint8_t deviceIdx - The index into pairedDevices
+ *     Returns:
+ *         uint8_t - 1 if it is connected, 0 otherwise
+ */
+uint8_t MenuDeviceListIsActive(MenuDeviceListContext_t *context, uint8_t deviceIdx)
+{
+    if (deviceIdx >= MenuDeviceListGetCount(context)) {
+        return 0;
+    }
+    if (memcmp(
+        context->bt->pairedDevices[deviceIdx].macId,
+        context->bt->activeDevice.macId,
+        BT_LEN_MAC_ID
+    ) == 0) {
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * MenuDeviceListNextPage()
+ *     Description:
+ *         Move to the next page, wrapping around to the first
+ *     Params:
+ *         MenuDeviceListContext_t *context - The list
+ *     Returns:
+ *         void
+ */
+void MenuDeviceListNextPage(MenuDeviceListContext_t *context)
+{
+    MenuDeviceListCheckRevision(context);
+    context->page++;
+    if (context->page >= MenuDeviceListGetPageCount(context)) {
+        context->page = 0;
+    }
+}
+
+/**
+ * MenuDeviceListPrefetch()
+ *     Description:
+ *         Normalize one name from the current or the following page that is
+ *         not cached yet, so the next render only copies strings. Meant to
+ *         be called while the bus is idle.
+ *     Params:
+ *         MenuDeviceListContext_t *context - The list
+ *     Returns:
+ *         uint8_t - 1 if a name was cached, 0 if there was nothing to do
+ */
+uint8_t MenuDeviceListPrefetch(MenuDeviceListContext_t *context)
+{
+    MenuDeviceListCheckRevision(context);
+    uint8_t count = MenuDeviceListGetCount(context);
+    uint8_t start = context->page * context->pageSize;
+    uint8_t offset;
+    if (count == 0) {
+        return 0;
+    }
+    for (offset = 0; offset < context->pageSize * 2; offset++) {
+        uint8_t deviceIdx = (start + offset) % count;
+        if ((context->cachedMask & (1 << deviceIdx)) == 0) {
+            MenuDeviceListGetName(context, deviceIdx);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * MenuDeviceListPreviousPage()
+ *     Description:
+ *         Move to the previous page, wrapping around to the last
+ *     Params:
+ *         MenuDeviceListContext_t *context - The list
+ *     Returns:
+ *         void
+ */
+void MenuDeviceListPreviousPage(MenuDeviceListContext_t *context)
+{
+    MenuDeviceListCheckRevision(context);
+    if (context->page == 0) {
+        context->page = MenuDeviceListGetPageCount(context) - 1;
+    } else {
+        context->page--;
+    }
+}
+
+/**
+ * MenuDeviceListSetPage()
+ *     Description:
+ *         Jump to a page
+ *     Params:
+ *         MenuDeviceListContext_t *context - The list
+ *         uint8_t page - The page, out of range pages show the first page
+ *     Returns:
+ *         void
+ */
+void MenuDeviceListSetPage(MenuDeviceListContext_t *context, uint8_t page)
+{
+    MenuDeviceListCheckRevision(context);
+    if (page >= MenuDeviceListGetPageCount(context)) {
+        page = 0;
+    }
+    context->page = page;
+}
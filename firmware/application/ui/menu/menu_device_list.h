@@ -0,0 +1,55 @@
+/*
+ * File: menu_device_list.h
+ * Author: Ted Salmon <tass2001@gmail.com>
+ * Description:
+ *     A paged view over the paired devices list, shared by the UIs. Only the
+ *     visible page is rendered and device names are normalized once and
+ *     cached until the pairing list changes.
+ */
+#ifndef MENU_DEVICE_LIST_H
+#define MENU_DEVICE_LIST_H
+#include <stdint.h>
+#include <string.h>
+#include "../../lib/bt.h"
+#include "../../lib/utils.h"
+// 23 characters is the widest row we draw (BMBT), + 1 for the terminator
+#define MENU_DEVICE_LIST_NAME_SIZE 24
+#define MENU_DEVICE_LIST_DEVICE_NONE 0xFF
+// The suffix for the connected device
+#define MENU_DEVICE_LIST_ACTIVE_SUFFIX " *"
+
+/**
+ * MenuDeviceListContext_t
+ *     Description:
+ *         The state of a device list view
+ *     Fields:
+ *         bt - The BT_t to read the pairings from
+ *         pageSize - The number of devices shown at a time
+ *         nameLength - The characters of a name that fit on a row
+ *         page - The page being shown
+ *         revision - The BT_t pairing revision the cache was built from
+ *         cachedMask - Bit n is set once the name of device n is cached
+ *         names - The cached, normalized device names
+ */
+typedef struct MenuDeviceListContext_t {
+    BT_t *bt;
+    uint8_t pageSize;
+    uint8_t nameLength;
+    uint8_t page;
+    uint8_t revision;
+    uint8_t cachedMask;
+    char names[BT_MAX_DEVICE_PAIRED][MENU_DEVICE_LIST_NAME_SIZE];
+} MenuDeviceListContext_t;
+
+void MenuDeviceListInit(MenuDeviceListContext_t *, BT_t *, uint8_t, uint8_t);
+uint8_t MenuDeviceListGetCount(MenuDeviceListContext_t *);
+uint8_t MenuDeviceListGetDevice(MenuDeviceListContext_t *, uint8_t);
+const char *MenuDeviceListGetName(MenuDeviceListContext_t *, uint8_t);
+uint8_t MenuDeviceListGetPageCount(MenuDeviceListContext_t *);
+uint8_t MenuDeviceListGetRow(MenuDeviceListContext_t *, uint8_t, char *, uint8_t);
+uint8_t MenuDeviceListIsActive(MenuDeviceListContext_t *, uint8_t);
+void MenuDeviceListNextPage(MenuDeviceListContext_t *);
+uint8_t MenuDeviceListPrefetch(MenuDeviceListContext_t *);
+void MenuDeviceListPreviousPage(MenuDeviceListContext_t *);
+void MenuDeviceListSetPage(MenuDeviceListContext_t *, uint8_t);
+#endif /* MENU_DEVICE_LIST_H */
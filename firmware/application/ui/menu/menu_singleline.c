@@ -169,7 +169,7 @@ void MenuSingleLineSettingsEditSave(MenuSingleLineContext_t *context)
         // Save Setting
         if (context->settingIdx == MENU_SINGLELINE_SETTING_IDX_PAIRINGS) {
             if (context->settingValue == CONFIG_SETTING_ON) {
-                if (context->bt->type == BT_BTM_TYPE_BC127) {
+                if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
                     BC127CommandUnpair(context->bt);
                 } else {
                     BM83CommandRestore(context->bt);
@@ -195,7 +195,7 @@ void MenuSingleLineSettingsEditSave(MenuSingleLineContext_t *context)
         } else if (context->settingIdx == MENU_SINGLELINE_SETTING_IDX_TEL_MIC_GAIN) {
             MenuSingleLineSetTempDisplayText(context, "Saved", 1);
             uint8_t micGain = ConfigGetSetting(CONFIG_SETTING_MIC_GAIN);
-            if (context->bt->type == BT_BTM_TYPE_BC127) {
+            if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
                 uint8_t micBias = ConfigGetSetting(CONFIG_SETTING_MIC_BIAS);
                 uint8_t micPreamp = ConfigGetSetting(CONFIG_SETTING_MIC_PREAMP);
                 BC127CommandSetMicGain(
@@ -226,13 +226,13 @@ void MenuSingleLineSettingsEditSave(MenuSingleLineContext_t *context)
                 context->bt->activeDevice.deviceId != 0
             ) {
                 if (context->settingValue == 0x00) {
-                    if (context->bt->type == BT_BTM_TYPE_BC127) {
+                    if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
                         BC127CommandClose(context->bt, context->bt->activeDevice.hfpId);
                     } else {
                         BM83CommandDisconnect(context->bt, BM83_CMD_DISCONNECT_PARAM_HF);
                     }
                 } else {
-                    if (context->bt->type == BT_BTM_TYPE_BC127) {
+                    if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
                         BC127CommandProfileOpen(context->bt, "HFP");
                     } else {
                         BTPairedDevice_t *device = 0;
@@ -286,7 +286,7 @@ void MenuSingleLineSettingsScroll(MenuSingleLineContext_t *context, uint8_t dire
         }
         // Hide TCU Mode option on HW Version 1. It is not necessary there.
         if (nextOption == MENU_SINGLELINE_SETTING_IDX_TEL_TCU_MODE &&
-            context->bt->type == BT_BTM_TYPE_BC127
+            BTGetType(context->bt) == BT_BTM_TYPE_BC127
         ) {
             if (direction == 0x00) {
                 nextOption++;
@@ -372,7 +372,7 @@ void MenuSingleLineSettingsNextSetting(MenuSingleLineContext_t *context, uint8_t
         uint8_t micGain = ConfigGetSetting(CONFIG_SETTING_MIC_GAIN);
         context->settingValue = micGain;
         char micGainText[17] = {0};
-        if (context->bt->type == BT_BTM_TYPE_BC127) {
+        if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
             if (micGain > 21) {
                 micGain = 0;
             }
@@ -539,7 +539,7 @@ void MenuSingleLineSettingsNextValue(MenuSingleLineContext_t *context, uint8_t d
             context->settingValue++;
         }
         char micGainText[6] = {0};
-        if (context->bt->type == BT_BTM_TYPE_BC127) {
+        if (BTGetType(context->bt) == BT_BTM_TYPE_BC127) {
             if (context->settingValue > 21) {
                 context->settingValue = 0;
             }
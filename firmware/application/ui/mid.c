@@ -6,65 +6,90 @@
  */
 #include "mid.h"
 static MIDContext_t Context;
+static ResourceGroup_t Resources;
+
+// The MID drops a leading space, so scrolling steps over them
+static const TextLayoutProfile_t MIDDisplayProfile = {
+    IBus_MID_MAX_CHARS,
+    TEXT_LAYOUT_SPACE_SKIP,
+    ' '
+};
 
 void MIDInit(BT_t *bt, IBus_t *ibus)
 {
+    ResourceGroupInit(&Resources, &Context, sizeof(MIDContext_t));
     Context.bt = bt;
     Context.ibus = ibus;
-    Context.btDeviceIndex = 0;
     Context.mode = MID_MODE_OFF;
     Context.displayUpdate = MID_DISPLAY_NONE;
     Context.mainDisplay = UtilsDisplayValueInit("", MID_DISPLAY_STATUS_OFF);
+    TextLayoutInit(&Context.mainLayout, &MIDDisplayProfile);
     Context.tempDisplay = UtilsDisplayValueInit("", MID_DISPLAY_STATUS_OFF);
     Context.modeChangeStatus = MID_MODE_CHANGE_OFF;
     Context.menuContext = MenuSingleLineInit(ibus, bt, &MIDDisplayUpdateText, &Context);
+    MenuDeviceListInit(
+        &Context.deviceList,
+        bt,
+        MID_DEVICE_LIST_PAGE_SIZE,
+        MID_DEVICE_NAME_LEN
+    );
     strncpy(Context.mainText, "Bluetooth", 10);
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         BT_EVENT_DEVICE_LINK_DISCONNECTED,
         &MIDBTDeviceDisconnected,
         &Context
     );
-    EventRegisterCallback(
-        BT_EVENT_METADATA_UPDATE,
-        &MIDBTMetadataUpdate,
-        &Context
-    );
-    EventRegisterCallback(
-        BT_EVENT_PLAYBACK_STATUS_CHANGE,
-        &MIDBTPlaybackStatus,
-        &Context
-    );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_CDStatusRequest,
         &MIDIBusCDChangerStatus,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_IKEIgnitionStatus,
         &MIDIBusIgnitionStatus,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_MIDButtonPress,
         &MIDIBusMIDButtonPress,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_RADMIDDisplayText,
         &MIDIIBusRADMIDDisplayUpdate,
         &Context
     );
-    EventRegisterCallback(
+    ResourceGroupRegisterCallback(
+        &Resources,
         IBUS_EVENT_MIDModeChange,
         &MIDIBusMIDModeChange,
         &Context
     );
-    TimerRegisterScheduledTask(
+    ResourceGroupRegisterCallback(
+        &Resources,
+        UIEvent_RenderModelUpdate,
+        &MIDRenderModelUpdate,
+        &Context
+    );
+    ResourceGroupRegisterCallback(
+        &Resources,
+        UIEvent_DisplayClaim,
+        &MIDDisplayClaim,
+        &Context
+    );
+    ResourceGroupRegisterTask(
+        &Resources,
         &MIDTimerMenuWrite,
         &Context,
         MID_TIMER_MENU_WRITE_INT
     );
-    Context.displayUpdateTaskId = TimerRegisterScheduledTask(
+    Context.displayUpdateTaskId = ResourceGroupRegisterTask(
+        &Resources,
         &MIDTimerDisplay,
         &Context,
         MID_TIMER_DISPLAY_INT
@@ -74,7 +99,8 @@ void MIDInit(BT_t *bt, IBus_t *ibus)
 /**
  * MIDDestroy()
  *     Description:
- *         Unregister all event handlers, scheduled tasks and clear the context
+ *         Release the event handlers, scheduled tasks and signal
+ *         subscriptions the UI registered, and clear the context
  *     Params:
  *         void
  *     Returns:
@@ -82,41 +108,7 @@ void MIDInit(BT_t *bt, IBus_t *ibus)
  */
 void MIDDestroy()
 {
-    EventUnregisterCallback(
-        BT_EVENT_DEVICE_LINK_DISCONNECTED,
-        &MIDBTDeviceDisconnected
-    );
-    EventUnregisterCallback(
-        BT_EVENT_METADATA_UPDATE,
-        &MIDBTMetadataUpdate
-    );
-    EventUnregisterCallback(
-        BT_EVENT_PLAYBACK_STATUS_CHANGE,
-        &MIDBTPlaybackStatus
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_CDStatusRequest,
-        &MIDIBusCDChangerStatus
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_IKEIgnitionStatus,
-        &MIDIBusIgnitionStatus
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_MIDButtonPress,
-        &MIDIBusMIDButtonPress
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_RADMIDDisplayText,
-        &MIDIIBusRADMIDDisplayUpdate
-    );
-    EventUnregisterCallback(
-        IBUS_EVENT_MIDModeChange,
-        &MIDIBusMIDModeChange
-    );
-    TimerUnregisterScheduledTask(&MIDTimerMenuWrite);
-    TimerUnregisterScheduledTask(&MIDTimerDisplay);
-    memset(&Context, 0, sizeof(MIDContext_t));
+    ResourceGroupRelease(&Resources);
 }
 
 static void MIDSetMainDisplayText(
@@ -136,6 +128,7 @@ static void MIDSetMainDisplayText(
     UtilsStrncpy(context->mainDisplay.text, text, UTILS_DISPLAY_TEXT_SIZE);
     context->mainDisplay.length = strlen(context->mainDisplay.text);
     context->mainDisplay.index = 0;
+    TextLayoutInvalidate(&context->mainLayout);
     TimerTriggerScheduledTask(context->displayUpdateTaskId);
     context->mainDisplay.timeout = timeout;
 }
@@ -163,40 +156,65 @@ static void MIDSetTempDisplayText(
     TimerTriggerScheduledTask(context->displayUpdateTaskId);
 }
 
+/**
+ * MIDShowMetadata()
+ *     Description:
+ *         Scroll the now playing text from the render model
+ *     Params:
+ *         MIDContext_t *context - The MID context
+ *     Returns:
+ *         void
+ */
+static void MIDShowMetadata(MIDContext_t *context)
+{
+    RenderModel_t *model = RenderModelGet();
+    if (context->mode != MID_MODE_ACTIVE ||
+        model->hasTitle == 0 ||
+        ConfigGetSetting(CONFIG_SETTING_METADATA_MODE) == MID_SETTING_METADATA_MODE_OFF
+    ) {
+        return;
+    }
+    MIDSetMainDisplayText(context, model->text, 3000 / MID_DISPLAY_SCROLL_SPEED);
+}
+
+/**
+ * MIDShowPlaybackStatus()
+ *     Description:
+ *         Show the playback status from the render model
+ *     Params:
+ *         MIDContext_t *context - The MID context
+ *     Returns:
+ *         void
+ */
+static void MIDShowPlaybackStatus(MIDContext_t *context)
+{
+    if (context->mode != MID_MODE_ACTIVE) {
+        return;
+    }
+    if (RenderModelGet()->playbackStatus == BT_AVRCP_STATUS_PLAYING) {
+        IBusCommandMIDMenuWriteSingle(context->ibus, 0, " >");
+        BTCommandGetMetadata(context->bt);
+    } else {
+        if (ConfigGetSetting(CONFIG_SETTING_METADATA_MODE) != MID_SETTING_METADATA_MODE_OFF) {
+            MIDSetMainDisplayText(context, "Paused", 0);
+        }
+        IBusCommandMIDMenuWriteSingle(context->ibus, 0, "|| ");
+    }
+}
+
 // Menu Creation
 static void MIDShowNextDevice(MIDContext_t *context, uint8_t direction)
 {
-    if (context->bt->pairedDevicesCount == 0) {
+    if (MenuDeviceListGetCount(&context->deviceList) == 0) {
         MIDSetMainDisplayText(context, "No Devices Available", 0);
     } else {
         if (direction == MID_BUTTON_NEXT_VAL) {
-            if (context->btDeviceIndex < context->bt->pairedDevicesCount - 1) {
-                context->btDeviceIndex++;
-            } else {
-                context->btDeviceIndex = 0;
-            }
-        } else {
-            if (context->btDeviceIndex == 0) {
-                context->btDeviceIndex = context->bt->pairedDevicesCount - 1;
-            } else {
-                context->btDeviceIndex--;
-            }
-        }
-        BTPairedDevice_t *dev = &context->bt->pairedDevices[context->btDeviceIndex];
-        char text[16];
-        strncpy(text, dev->deviceName, 15);
-        text[15] = '\0';
-        // Add a space and asterisks to the end of the device name
-        // if it's the currently selected device
-        if (memcmp(dev->macId, context->bt->activeDevice.macId, BT_LEN_MAC_ID) == 0) {
-            uint8_t startIdx = strlen(text);
-            if (startIdx > 13) {
-                startIdx = 13;
-            }
-            text[startIdx++] = 0x20;
-            text[startIdx++] = 0x2A;
-            text[startIdx++] = 0;
+            MenuDeviceListNextPage(&context->deviceList);
+        } else if (direction == MID_BUTTON_PREV_VAL) {
+            MenuDeviceListPreviousPage(&context->deviceList);
         }
+        char text[MID_DEVICE_NAME_LEN + 1];
+        MenuDeviceListGetRow(&context->deviceList, 0, text, sizeof(text));
         MIDSetMainDisplayText(context, text, 0);
     }
 }
@@ -206,7 +224,7 @@ static void MIDMenuDevices(MIDContext_t *context)
 {
     context->mode = MID_MODE_DEVICES;
     strncpy(context->mainText, "Devices", 8);
-    context->btDeviceIndex = MID_PAIRING_DEVICE_NONE;
+    MenuDeviceListSetPage(&context->deviceList, 0);
     MIDShowNextDevice(context, 0);
     IBusCommandMIDMenuWriteSingle(context->ibus, MID_BUTTON_BACK, "Back");
     IBusCommandMIDMenuWriteSingle(context->ibus, MID_BUTTON_EDIT_SAVE, " Con");
@@ -221,7 +239,7 @@ static void MIDMenuMain(MIDContext_t *context)
     context->mode = MID_MODE_ACTIVE;
     strncpy(context->mainText, "Bluetooth", 10);
     MIDSetMainDisplayText(context, "", 0);
-    MIDBTMetadataUpdate((void *) context, 0x00);
+    MIDShowMetadata(context);
     // This sucks
     unsigned char mainMenuText[] = {
         0x06,
@@ -256,6 +274,28 @@ static void MIDMenuSettings(MIDContext_t *context)
     IBusCommandMIDMenuWriteSingle(context->ibus, MID_BUTTON_DEVICES_L, "   ");
 }
 
+/**
+ * MIDDisplayClaim()
+ *     Description:
+ *         Put our title back up once the radio has stopped writing the MID
+ *     Params:
+ *         void *ctx - A void pointer to the MIDContext_t struct
+ *         uint8_t *data - The DISPLAY_ARBITER_* that can be redrawn
+ *     Returns:
+ *         void
+ */
+void MIDDisplayClaim(void *ctx, uint8_t *data)
+{
+    MIDContext_t *context = (MIDContext_t *) ctx;
+    if (data[0] == DISPLAY_ARBITER_MID &&
+        (context->mode == MID_MODE_ACTIVE ||
+         context->mode == MID_MODE_DISPLAY_OFF) &&
+        context->modeChangeStatus == MID_MODE_CHANGE_OFF
+    ) {
+        IBusCommandMIDDisplayRADTitleText(context->ibus, "Bluetooth");
+    }
+}
+
 /**
  * MIDDisplayUpdateText()
  *     Description:
@@ -287,65 +327,6 @@ void MIDBTDeviceDisconnected(void *ctx, unsigned char *tmp)
 }
 
 
-void MIDBTMetadataUpdate(void *ctx, unsigned char *tmp)
-{
-    MIDContext_t *context = (MIDContext_t *) ctx;
-    if (context->mode != MID_MODE_ACTIVE ||
-        strlen(context->bt->title) == 0 ||
-        ConfigGetSetting(CONFIG_SETTING_METADATA_MODE) == MID_SETTING_METADATA_MODE_OFF
-    ) {
-        return;
-    }
-    char text[UTILS_DISPLAY_TEXT_SIZE] = {0};
-    if (strlen(context->bt->artist) > 0 && strlen(context->bt->album) > 0) {
-        snprintf(
-            text,
-            UTILS_DISPLAY_TEXT_SIZE,
-            "%s - %s on %s",
-            context->bt->title,
-            context->bt->artist,
-            context->bt->album
-        );
-    } else if (strlen(context->bt->artist) > 0) {
-        snprintf(
-            text,
-            UTILS_DISPLAY_TEXT_SIZE,
-            "%s - %s",
-            context->bt->title,
-            context->bt->artist
-        );
-    } else if (strlen(context->bt->album) > 0) {
-        snprintf(
-            text,
-            UTILS_DISPLAY_TEXT_SIZE ,
-            "%s on %s",
-            context->bt->title,
-            context->bt->album
-        );
-    } else {
-        snprintf(text, UTILS_DISPLAY_TEXT_SIZE, "%s", context->bt->title);
-    }
-    MIDSetMainDisplayText(context, text, 3000 / MID_DISPLAY_SCROLL_SPEED);
-    TimerTriggerScheduledTask(context->displayUpdateTaskId);
-}
-
-void MIDBTPlaybackStatus(void *ctx, unsigned char *tmp)
-{
-    MIDContext_t *context = (MIDContext_t *) ctx;
-    if (context->mode != MID_MODE_ACTIVE) {
-        return;
-    }
-    if (context->bt->playbackStatus == BT_AVRCP_STATUS_PLAYING) {
-        IBusCommandMIDMenuWriteSingle(context->ibus, 0, " >");
-        BTCommandGetMetadata(context->bt);
-    } else {
-        if (ConfigGetSetting(CONFIG_SETTING_METADATA_MODE) != MID_SETTING_METADATA_MODE_OFF) {
-            MIDSetMainDisplayText(context, "Paused", 0);
-        }
-        IBusCommandMIDMenuWriteSingle(context->ibus, 0, "|| ");
-    }
-}
-
 void MIDIBusCDChangerStatus(void *ctx, unsigned char *pkt)
 {
     MIDContext_t *context = (MIDContext_t *) ctx;
@@ -473,18 +454,16 @@ void MIDIBusMIDButtonPress(void *ctx, unsigned char *pkt)
         if (btnPressed == MID_BUTTON_BACK) {
             context->mode = MID_MODE_ACTIVE_NEW;
         } else if (btnPressed == MID_BUTTON_EDIT_SAVE) {
-            if (context->bt->pairedDevicesCount > 0) {
-                // Connect to device
-                BTPairedDevice_t *dev = &context->bt->pairedDevices[context->btDeviceIndex];
-                if (memcmp(dev->macId, context->bt->activeDevice.macId, BT_LEN_MAC_ID) != 0 &&
-                    dev != 0
-                ) {
-                    // Trigger device selection event
-                    EventTriggerCallback(
-                        UIEvent_InitiateConnection,
-                        (uint8_t *)&context->btDeviceIndex
-                    );
-                }
+            uint8_t deviceId = MenuDeviceListGetDevice(&context->deviceList, 0);
+            // Connect to device
+            if (deviceId != MENU_DEVICE_LIST_DEVICE_NONE &&
+                MenuDeviceListIsActive(&context->deviceList, deviceId) == 0
+            ) {
+                // Trigger device selection event
+                EventTriggerCallback(
+                    UIEvent_InitiateConnection,
+                    (uint8_t *)&deviceId
+                );
             }
         } else if (btnPressed == MID_BUTTON_PREV_VAL ||
                    btnPressed == MID_BUTTON_NEXT_VAL
@@ -523,7 +502,8 @@ void MIDIBusMIDButtonPress(void *ctx, unsigned char *pkt)
 /**
  * MIDIIBusRADMIDDisplayUpdate()
  *     Description:
- *         Handle the RAD writing to the MID.
+ *         Handle the RAD writing to the MID. The title is put back
+ *         once the radio goes quiet, so we do not trade redraws with it.
  *     Params:
  *         void *context - A void pointer to the MIDContext_t struct
  *         unsigned char *pkt - The IBus packet
@@ -539,7 +519,7 @@ void MIDIIBusRADMIDDisplayUpdate(void *ctx, unsigned char *pkt)
              context->mode == MID_MODE_DISPLAY_OFF) &&
             context->modeChangeStatus == MID_MODE_CHANGE_OFF
         ) {
-            IBusCommandMIDDisplayRADTitleText(context->ibus, "Bluetooth");
+            DisplayArbiterRadioWrite(DISPLAY_ARBITER_MID);
         }
     }
 }
@@ -595,6 +575,33 @@ void MIDIBusMIDModeChange(void *ctx, unsigned char *pkt)
     }
 }
 
+/**
+ * MIDRenderModelUpdate()
+ *     Description:
+ *         Redraw from the render model when it changes
+ *     Params:
+ *         void *ctx - A void pointer to the MIDContext_t struct
+ *         uint8_t *data - The RenderModelUpdate_t
+ *     Returns:
+ *         void
+ */
+void MIDRenderModelUpdate(void *ctx, uint8_t *data)
+{
+    MIDContext_t *context = (MIDContext_t *) ctx;
+    RenderModelUpdate_t *update = (RenderModelUpdate_t *) data;
+    if ((update->targets & RENDER_MODEL_TARGET_MID) == 0) {
+        return;
+    }
+    // A deferred redraw can carry both, the playback status goes last so
+    // that "Paused" is not scrolled away by the metadata
+    if ((update->changes & RENDER_MODEL_CHANGE_METADATA) != 0) {
+        MIDShowMetadata(context);
+    }
+    if ((update->changes & RENDER_MODEL_CHANGE_PLAYBACK) != 0) {
+        MIDShowPlaybackStatus(context);
+    }
+}
+
 void MIDTimerMenuWrite(void *ctx)
 {
     MIDContext_t *context = (MIDContext_t *) ctx;
@@ -608,6 +615,12 @@ void MIDTimerMenuWrite(void *ctx)
         case MID_MODE_DEVICES_NEW:
             MIDMenuDevices(context);
             break;
+        case MID_MODE_DEVICES:
+            // Get the neighbouring device names ready while the bus is quiet
+            if (TimerGetMillis() - context->ibus->rxLastStamp >= MID_DEVICE_LIST_PREFETCH_IDLE) {
+                MenuDeviceListPrefetch(&context->deviceList);
+            }
+            break;
     }
 }
 
@@ -639,50 +652,54 @@ void MIDTimerDisplay(void *ctx)
         if (context->mainDisplay.length <= IBus_MID_MAX_CHARS) {
             context->mainDisplay.index = 0;
         }
-    } else {
-        // Display the main text if there isn't a timeout set
+    } else if (DisplayArbiterHasRadio(DISPLAY_ARBITER_MID) == 0) {
+        // Display the main text if there isn't a timeout set. The text is
+        // held back while the radio writes the display and put back up once
+        // it hands the display back.
         if (context->mainDisplay.timeout > 0) {
             context->mainDisplay.timeout--;
         } else {
-            if (context->mainDisplay.length > IBus_MID_MAX_CHARS) {
+            uint8_t layoutMode = TEXT_LAYOUT_MODE_SCROLL;
+            if (ConfigGetSetting(CONFIG_SETTING_METADATA_MODE) ==
+                MID_SETTING_METADATA_MODE_CHUNK
+            ) {
+                layoutMode = TEXT_LAYOUT_MODE_CHUNK;
+            }
+            uint8_t segments = TextLayoutPrepare(
+                &context->mainLayout,
+                context->mainDisplay.text,
+                layoutMode
+            );
+            if (segments > 1) {
                 char text[IBus_MID_MAX_CHARS + 1] = {0};
-                uint8_t textLength = IBus_MID_MAX_CHARS;
-                // If we start with a space, it will be ignored by the display
-                // Skipping the space allows us to have "smooth" scrolling
-                if (context->mainDisplay.text[context->mainDisplay.index] == 0x20 &&
-                    context->mainDisplay.index < context->mainDisplay.length
-                ) {
-                    context->mainDisplay.index++;
-                }
-                uint8_t idxEnd = context->mainDisplay.index + textLength;
-                // Prevent strncpy() from going out of bounds
-                if (idxEnd >= context->mainDisplay.length) {
-                    textLength = context->mainDisplay.length - context->mainDisplay.index;
-                    idxEnd = context->mainDisplay.index + textLength;
+                if (context->mainDisplay.index >= segments) {
+                    context->mainDisplay.index = 0;
                 }
-                UtilsStrncpy(
-                    text,
-                    &context->mainDisplay.text[context->mainDisplay.index],
-                    textLength + 1
+                TextLayoutGetSegment(
+                    &context->mainLayout,
+                    context->mainDisplay.text,
+                    context->mainDisplay.index,
+                    text
+                );
+                uint8_t next = TextLayoutNextSegment(
+                    &context->mainLayout,
+                    context->mainDisplay.text,
+                    context->mainDisplay.index
                 );
                 IBusCommandMIDDisplayText(context->ibus, text);
                 // Pause at the beginning of the text
                 if (context->mainDisplay.index == 0) {
                     context->mainDisplay.timeout = 5;
                 }
-                if (idxEnd >= context->mainDisplay.length) {
+                if (next >= segments) {
                     // Pause at the end of the text
                     context->mainDisplay.timeout = 2;
                     context->mainDisplay.index = 0;
                 } else {
-                    if (ConfigGetSetting(CONFIG_SETTING_METADATA_MODE) ==
-                        MID_SETTING_METADATA_MODE_CHUNK
-                    ) {
+                    if (layoutMode == TEXT_LAYOUT_MODE_CHUNK) {
                         context->mainDisplay.timeout = 2;
-                        context->mainDisplay.index += IBus_MID_MAX_CHARS;
-                    } else {
-                        context->mainDisplay.index++;
                     }
+                    context->mainDisplay.index = next;
                 }
             } else {
                 if (context->mainDisplay.index == 0) {
@@ -9,11 +9,16 @@
 #include "../lib/bt/bt_bc127.h"
 #include "../lib/bt.h"
 #include "../lib/config.h"
+#include "../lib/display_arbiter.h"
 #include "../lib/event.h"
 #include "../lib/ibus.h"
 #include "../lib/log.h"
+#include "../lib/render_model.h"
+#include "../lib/resource_group.h"
+#include "../lib/text_layout.h"
 #include "../lib/timer.h"
 #include "../lib/utils.h"
+#include "menu/menu_device_list.h"
 #include "menu/menu_singleline.h"
 
 #define MID_BUTTON_PLAYBACK 0x40
@@ -60,7 +65,10 @@
 #define MID_MODE_CHANGE_PRESS 1
 #define MID_MODE_CHANGE_RELEASE 2
 
-#define MID_PAIRING_DEVICE_NONE -1
+// The MID shows one device at a time
+#define MID_DEVICE_LIST_PAGE_SIZE 1
+#define MID_DEVICE_NAME_LEN 15
+#define MID_DEVICE_LIST_PREFETCH_IDLE 20
 
 #define MID_SETTING_IDX_METADATA_MODE 0
 #define MID_SETTING_IDX_AUTOPLAY 1
@@ -90,32 +98,35 @@
  *  IBus_t *ibus: A pointer to the IBus struct
  *  mode: Track the state of the radio to see what we should display to the user.
  *  screenUpdated: The screen has been updated by the radio
+ *  deviceList: The paired devices view, one device per page
+ *  mainLayout: The segments of the main text
  */
 typedef struct MIDContext_t {
     IBus_t *ibus;
     BT_t *bt;
-    int8_t btDeviceIndex;
     uint8_t mode;
     uint8_t displayUpdate;
     uint8_t modeChangeStatus;
     char mainText[16];
     MenuSingleLineContext_t menuContext;
     UtilsAbstractDisplayValue_t mainDisplay;
+    TextLayout_t mainLayout;
     UtilsAbstractDisplayValue_t tempDisplay;
     uint8_t displayUpdateTaskId;
+    MenuDeviceListContext_t deviceList;
 } MIDContext_t;
 void MIDInit(BT_t *, IBus_t *);
 void MIDDestroy();
+void MIDDisplayClaim(void *, uint8_t *);
 void MIDDisplayUpdateText(void *, char *, int8_t, uint8_t);
 void MIDBTDeviceDisconnected(void *, uint8_t *);
-void MIDBTMetadataUpdate(void *, uint8_t *);
-void MIDBTPlaybackStatus(void *, uint8_t *);
 void MIDIBusCDChangerStatus(void *, uint8_t *);
 void MIDIBusIgnitionStatus(void *, uint8_t *);
 void MIDIBusMIDButtonPress(void *, uint8_t *);
 void MIDIIBusRADMIDDisplayUpdate(void *, uint8_t *);
 void MIDIIBusRADMIDMenuUpdate(void *, uint8_t *);
 void MIDIBusMIDModeChange(void *, uint8_t *);
+void MIDRenderModelUpdate(void *, uint8_t *);
 void MIDTimerMenuWrite(void *);
 void MIDTimerDisplay(void *);
 #endif /* MID_H */
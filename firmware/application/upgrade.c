@@ -6,10 +6,163 @@
  */
 #include "upgrade.h"
 
+// Initial settings burn
+static void UpgradeMigrateProvision(uint8_t *config, BT_t *bt)
+{
+    // Reset the UI, the VIN and all settings
+    memset(
+        &config[CONFIG_SETTING_START_ADDRESS],
+        0x00,
+        0x50 - CONFIG_SETTING_START_ADDRESS + 1
+    );
+    // -10dB Gain for the DAC
+    config[CONFIG_SETTING_DAC_AUDIO_VOL] = 0x44;
+    PCM51XXSetVolume(0x44);
+    config[CONFIG_SETTING_HFP] = CONFIG_SETTING_ON;
+    config[CONFIG_SETTING_MIC_BIAS] = CONFIG_SETTING_ON;
+    // Set the Mic Gain to -17.5dB by default
+    config[CONFIG_SETTING_MIC_GAIN] = 0x03;
+    LogRaw("Device Provisioned\r\n");
+}
+
+// Changes in version 1.1.1
+static void UpgradeMigrate_1_1_1(uint8_t *config, BT_t *bt)
+{
+    // Set the Mic Gain to -23dB by default
+    config[CONFIG_SETTING_MIC_GAIN] = 0x01;
+}
+
+// Changes in version 1.1.8
+static void UpgradeMigrate_1_1_8(uint8_t *config, BT_t *bt)
+{
+    // -10dB Gain for the DAC in Telephone Mode
+    config[CONFIG_SETTING_DAC_TEL_TCU_MODE_VOL] = 0x44;
+}
+
+// Changes in version 1.1.9
+static void UpgradeMigrate_1_1_9(uint8_t *config, BT_t *bt)
+{
+    // Max out the A2DP and HFP volumes by default
+    BC127CommandSetBtVolConfig(bt, 15, 100, 10, 1);
+    // Set a starting value for the telephony volume value
+    config[CONFIG_SETTING_TEL_VOL] = 0x00;
+}
+
+// Changes in version 1.1.10
+static void UpgradeMigrate_1_1_10(uint8_t *config, BT_t *bt)
+{
+    // Migrate settings to new addresses by shifting every value up by one
+    memmove(&config[0x1D], &config[0x1C], 4);
+    // Set new `0x1C` to OFF
+    config[CONFIG_SETTING_IGN_ALWAYS_ON] = CONFIG_SETTING_OFF;
+}
+
+// Changes in version 1.1.15
+static void UpgradeMigrate_1_1_15(uint8_t *config, BT_t *bt)
+{
+    // Enable cVc by default AGAIN to fix the units where
+    // "restore" wiped out cVc
+    BC127SendCommand(bt, "SET HFP_CONFIG=ON ON ON ON ON OFF");
+}
+
+// Changes in version 1.1.17
+static void UpgradeMigrate_1_1_17(uint8_t *config, BT_t *bt)
+{
+    // Set new `0x21` to English language by default
+    config[CONFIG_SETTING_LANGUAGE] = CONFIG_SETTING_LANGUAGE_ENGLISH;
+    // The BC127 failure counters live outside of the image
+    ConfigSetBC127BootFailures(0);
+    config[CONFIG_SETTING_AUTO_POWEROFF] = CONFIG_SETTING_ON;
+    config[CONFIG_SETTING_IGN_ALWAYS_ON] = config[0x1C];
+    // Reset to logging to all off
+    config[CONFIG_SETTING_LOG] = 0x01;
+}
+
+// Changes in version 1.1.18
+static void UpgradeMigrate_1_1_18(uint8_t *config, BT_t *bt)
+{
+    config[CONFIG_SETTING_MANAGE_VOLUME] = CONFIG_SETTING_ON;
+    config[CONFIG_SETTING_VOLUME_LOWER_ON_REV] = CONFIG_SETTING_ON;
+    BC127CommandSetCOD(bt, 300420);
+}
+
+// Changes in version 1.2.0
+static void UpgradeMigrate_1_2_0(uint8_t *config, BT_t *bt)
+{
+    if (BTGetType(bt) == BT_BTM_TYPE_BM83) {
+        config[CONFIG_SETTING_MIC_GAIN] = 0x09;
+    }
+}
+
+// Changes in version 1.2.1
+static void UpgradeMigrate_1_2_1(uint8_t *config, BT_t *bt)
+{
+    if (BTGetType(bt) == BT_BTM_TYPE_BM83) {
+        config[CONFIG_SETTING_MIC_GAIN] = 0x00;
+        config[CONFIG_SETTING_LAST_CONNECTED_DEVICE] = 0x00;
+    }
+}
+
+// Changes in version 1.3.2
+static void UpgradeMigrate_1_3_2(uint8_t *config, BT_t *bt)
+{
+    config[CONFIG_SETTING_LAST_CONNECTED_DEVICE_MAC] = 0x00;
+}
+
+// Changes in version 1.4.0
+static void UpgradeMigrate_1_4_0(uint8_t *config, BT_t *bt)
+{
+    config[CONFIG_SETTING_COMFORT_AUTOZOOM] = CONFIG_SETTING_OFF;
+    config[CONFIG_SETTING_COMFORT_PDC] = CONFIG_SETTING_OFF;
+}
+
+// Oldest first, each runs when the stored version is older than its own
+static const UpgradeMigration_t UpgradeMigrations[] = {
+    {0, 0, 1, &UpgradeMigrateProvision},
+    {1, 1, 1, &UpgradeMigrate_1_1_1},
+    {1, 1, 8, &UpgradeMigrate_1_1_8},
+    {1, 1, 9, &UpgradeMigrate_1_1_9},
+    {1, 1, 10, &UpgradeMigrate_1_1_10},
+    {1, 1, 15, &UpgradeMigrate_1_1_15},
+    {1, 1, 17, &UpgradeMigrate_1_1_17},
+    {1, 1, 18, &UpgradeMigrate_1_1_18},
+    {1, 2, 0, &UpgradeMigrate_1_2_0},
+    {1, 2, 1, &UpgradeMigrate_1_2_1},
+    {1, 3, 2, &UpgradeMigrate_1_3_2},
+    {1, 4, 0, &UpgradeMigrate_1_4_0}
+};
+
+/**
+ * UpgradeCommit()
+ *     Description:
+ *         Write the migrated image back a page at a time. The first page
+ *         holds the firmware version, so it is written last and the version
+ *         only moves forward once every setting has been stored.
+ *     Params:
+ *         uint8_t *config - The image, indexed by EEPROM address
+ *     Returns:
+ *         void
+ */
+static void UpgradeCommit(uint8_t *config)
+{
+    ConfigSetBytes(
+        EEPROM_PAGE_SIZE,
+        &config[EEPROM_PAGE_SIZE],
+        UPGRADE_IMAGE_END - EEPROM_PAGE_SIZE
+    );
+    ConfigSetBytes(
+        UPGRADE_IMAGE_START,
+        &config[UPGRADE_IMAGE_START],
+        EEPROM_PAGE_SIZE - UPGRADE_IMAGE_START
+    );
+}
+
 /**
  * UpgradeProcess()
  *     Description:
- *         Run through the applicable upgrades
+ *         Run the migrations newer than the stored firmware version against
+ *         a copy of the config in RAM, then store the result and the new
+ *         version in one batch of page writes
  *     Params:
  *         BT_t *bt - The bt object
  *         IBus_t *ibus - The ibus object
@@ -27,118 +180,45 @@ uint8_t UpgradeProcess(BT_t *bt, IBus_t *ibus)
     ) {
         return 0;
     }
-    // Initial settings burn
-    if (UpgradeVersionCompare(curMajor, curMinor, curPatch, 0, 0, 1) == 1) {
-        // Reset the UI
-        ConfigSetUIMode(0x00);
-        ConfigSetNavType(0x00);
-        // Reset the VIN
-        unsigned char vin[] = {0x00, 0x00, 0x00, 0x00, 0x00};
-        ConfigSetVehicleIdentity(vin);
-        // Reset all settings
-        uint8_t idx = CONFIG_SETTING_START_ADDRESS;
-        while (idx <= 0x50) {
-            ConfigSetSetting(idx, 0x00);
-            idx++;
-        }
-        // Settings
-        // -10dB Gain for the DAC
-        ConfigSetSetting(CONFIG_SETTING_DAC_AUDIO_VOL, 0x44);
-        PCM51XXSetVolume(0x44);
-        ConfigSetSetting(CONFIG_SETTING_HFP, CONFIG_SETTING_ON);
-        ConfigSetSetting(CONFIG_SETTING_MIC_BIAS, CONFIG_SETTING_ON);
-        // Set the Mic Gain to -17.5dB by default
-        ConfigSetSetting(CONFIG_SETTING_MIC_GAIN, 0x03);
-        LogRaw("Device Provisioned\r\n");
-    }
-    // Changes in version 1.1.1
-    if (UpgradeVersionCompare(curMajor, curMinor, curPatch, 1, 1, 1) == 1) {
-        // Set the Mic Gain to -23dB by default
-        ConfigSetSetting(CONFIG_SETTING_MIC_GAIN, 0x01);
-        LogRaw("Ran Upgrade 1.1.1\r\n");
-    }
-    // Changes in version 1.1.8
-    if (UpgradeVersionCompare(curMajor, curMinor, curPatch, 1, 1, 8) == 1) {
-        // -10dB Gain for the DAC in Telephone Mode
-        ConfigSetSetting(CONFIG_SETTING_DAC_TEL_TCU_MODE_VOL, 0x44);
-        LogRaw("Ran Upgrade 1.1.8\r\n");
-    }
-    // Changes in version 1.1.9
-    if (UpgradeVersionCompare(curMajor, curMinor, curPatch, 1, 1, 9) == 1) {
-        // Max out the A2DP and HFP volumes by default
-        BC127CommandSetBtVolConfig(bt, 15, 100, 10, 1);
-        // Set a starting value for the telephony volume value
-        ConfigSetSetting(CONFIG_SETTING_TEL_VOL, 0x00);
-        LogRaw("Ran Upgrade 1.1.9\r\n");
-    }
-    // Changes in version 1.1.10
-    if (UpgradeVersionCompare(curMajor, curMinor, curPatch, 1, 1, 10) == 1) {
-        // Migrate settings to new addresses by shifting every value up by one
-        unsigned char startAddress = 0x20;
-        while (startAddress > 0x1C) {
-            ConfigSetSetting(startAddress, ConfigGetSetting(startAddress - 1));
-            startAddress--;
-        }
-        // Set new `0x1C` to OFF
-        ConfigSetSetting(CONFIG_SETTING_IGN_ALWAYS_ON, CONFIG_SETTING_OFF);
-        LogRaw("Ran Upgrade 1.1.10\r\n");
-    }
-    // Changes in version 1.1.15
-    if (UpgradeVersionCompare(curMajor, curMinor, curPatch, 1, 1, 15) == 1) {
-        // Enable cVc by default AGAIN to fix the units where
-        // "restore" wiped out cVc
-        BC127SendCommand(bt, "SET HFP_CONFIG=ON ON ON ON ON OFF");
-    }
-    // Changes in version 1.1.17
-    if (UpgradeVersionCompare(curMajor, curMinor, curPatch, 1, 1, 17) == 1) {
-        // Set new `0x21` to English language by default
-        ConfigSetSetting(CONFIG_SETTING_LANGUAGE, CONFIG_SETTING_LANGUAGE_ENGLISH);
-        // Set BC127 failure counters
-        ConfigSetBC127BootFailures(0);
-        ConfigSetSetting(CONFIG_SETTING_AUTO_POWEROFF, CONFIG_SETTING_ON);
-        ConfigSetSetting(CONFIG_SETTING_IGN_ALWAYS_ON, ConfigGetSetting(0x1C));
-        // Reset to logging to all off
-        ConfigSetSetting(CONFIG_SETTING_LOG, 0x01);
-        LogRaw("Ran Upgrade 1.1.17\r\n");
-    }
-    // Changes in version 1.1.18
-    if (UpgradeVersionCompare(curMajor, curMinor, curPatch, 1, 1, 18) == 1) {
-        ConfigSetSetting(CONFIG_SETTING_MANAGE_VOLUME, CONFIG_SETTING_ON);
-        ConfigSetSetting(CONFIG_SETTING_VOLUME_LOWER_ON_REV, CONFIG_SETTING_ON);
-        BC127CommandSetCOD(bt, 300420);
-        LogRaw("Ran Upgrade 1.1.18\r\n");
-    }
-    // Changes in version 1.2.0
-    if (UpgradeVersionCompare(curMajor, curMinor, curPatch, 1, 2, 0) == 1) {
-        if (bt->type == BT_BTM_TYPE_BM83) {
-            ConfigSetSetting(CONFIG_SETTING_MIC_GAIN, 0x09);
+    uint8_t config[UPGRADE_IMAGE_END] = {0};
+    uint8_t idx;
+    EEPROMReadBytes(
+        UPGRADE_IMAGE_START,
+        &config[UPGRADE_IMAGE_START],
+        UPGRADE_IMAGE_END - UPGRADE_IMAGE_START
+    );
+    // Unwritten settings read as 0x00, the same as ConfigGetSetting(). The
+    // bootloader only writes the build date over 0xFF, so the bytes before
+    // the settings are left as they are.
+    for (idx = CONFIG_SETTING_START_ADDRESS; idx < UPGRADE_IMAGE_END; idx++) {
+        if (config[idx] == 0xFF) {
+            config[idx] = 0x00;
         }
-        LogRaw("Ran Upgrade 1.2.0\r\n");
     }
-    // Changes in version 1.2.1
-    if (UpgradeVersionCompare(curMajor, curMinor, curPatch, 1, 2, 1) == 1) {
-        if (bt->type == BT_BTM_TYPE_BM83) {
-            ConfigSetSetting(CONFIG_SETTING_MIC_GAIN, 0x00);
-            ConfigSetSetting(CONFIG_SETTING_LAST_CONNECTED_DEVICE, 0x00);
+    for (idx = 0; idx < sizeof(UpgradeMigrations) / sizeof(UpgradeMigration_t); idx++) {
+        const UpgradeMigration_t *migration = &UpgradeMigrations[idx];
+        if (UpgradeVersionCompare(
+                curMajor,
+                curMinor,
+                curPatch,
+                migration->major,
+                migration->minor,
+                migration->patch
+            ) == 1
+        ) {
+            migration->migrate(config, bt);
+            LogRaw(
+                "Ran Upgrade %d.%d.%d\r\n",
+                migration->major,
+                migration->minor,
+                migration->patch
+            );
         }
-        LogRaw("Ran Upgrade 1.2.1\r\n");
-    }
-    // Changes in version 1.3.2
-    if (UpgradeVersionCompare(curMajor, curMinor, curPatch, 1, 3, 2) == 1) {
-        ConfigSetSetting(CONFIG_SETTING_LAST_CONNECTED_DEVICE_MAC,0x00);
-        LogRaw("Ran Upgrade 1.3.2\r\n");
     }
-    // Changes in version 1.4.0
-    if (UpgradeVersionCompare(curMajor, curMinor, curPatch, 1, 4, 0) == 1) {
-        ConfigSetSetting(CONFIG_SETTING_COMFORT_AUTOZOOM, CONFIG_SETTING_OFF);
-        ConfigSetSetting(CONFIG_SETTING_COMFORT_PDC, CONFIG_SETTING_OFF);
-        LogRaw("Ran Upgrade 1.4.0\r\n");
-    }
-    ConfigSetFirmwareVersion(
-        FIRMWARE_VERSION_MAJOR,
-        FIRMWARE_VERSION_MINOR,
-        FIRMWARE_VERSION_PATCH
-    );
+    config[CONFIG_FIRMWARE_VERSION_MAJOR_ADDRESS] = FIRMWARE_VERSION_MAJOR;
+    config[CONFIG_FIRMWARE_VERSION_MINOR_ADDRESS] = FIRMWARE_VERSION_MINOR;
+    config[CONFIG_FIRMWARE_VERSION_PATCH_ADDRESS] = FIRMWARE_VERSION_PATCH;
+    UpgradeCommit(config);
     return 1;
 }
 
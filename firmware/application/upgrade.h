@@ -8,12 +8,40 @@
 #define UPGRADE_H
 #include "lib/bt/bt_bc127.h"
 #include "lib/config.h"
+#include "lib/eeprom.h"
 #include "lib/ibus.h"
 #include "lib/log.h"
 #include "lib/pcm51xx.h"
 #define UPGRADE_MINOR_IS_NEWER 0
 #define UPGRADE_MINOR_IS_SAME 1
 #define UPGRADE_MINOR_IS_OLDER 2
+// The migrations work on a copy of the EEPROM from the firmware version up
+// to the end of the settings, indexed by EEPROM address. Only the settings
+// are migrated, the build date, bootloader mode and trap counters in between
+// are written back exactly as they were read.
+#define UPGRADE_IMAGE_START CONFIG_FIRMWARE_VERSION_MAJOR_ADDRESS
+#define UPGRADE_IMAGE_END CONFIG_SETTING_CACHE_SIZE
+
+/**
+ * UpgradeMigration_t
+ *     Description:
+ *         The settings changes that came with a firmware version. Settings
+ *         from the second EEPROM page up may only be set to constants or to
+ *         values from the first page, so a migration cut short between the
+ *         two page writes gives the same result when it is run again.
+ *     Fields:
+ *         major - The major version
+ *         minor - The minor version
+ *         patch - The patch version
+ *         migrate - Apply the changes to the config image
+ */
+typedef struct UpgradeMigration_t {
+    uint8_t major;
+    uint8_t minor;
+    uint8_t patch;
+    void (*migrate)(uint8_t *, BT_t *);
+} UpgradeMigration_t;
+
 uint8_t UpgradeProcess(BT_t *, IBus_t *);
 uint8_t UpgradeVersionCompare(
     unsigned char,
@@ -322,7 +322,12 @@ ProtocolPacket_t ProtocolProcessPacket(UART_t *uart)
     packet.status = PROTOCOL_PACKET_STATUS_INCOMPLETE;
     uint16_t queueSize = CharQueueGetSize(&uart->rxQueue);
     if (queueSize >= PROTOCOL_PACKET_MIN_SIZE) {
-        if (queueSize >= CharQueueGetOffset(&uart->rxQueue, 1)) {
+        uint8_t packetLength = CharQueueGetOffset(&uart->rxQueue, 1);
+        if (packetLength < PROTOCOL_PACKET_MIN_SIZE) {
+            // The length can never be smaller than the control bytes plus
+            // one byte of data, so the stream is not aligned with a packet
+            packet.status = PROTOCOL_PACKET_STATUS_BAD;
+        } else if (queueSize >= packetLength) {
             packet.command = CharQueueNext(&uart->rxQueue);
             packet.dataSize = CharQueueNext(&uart->rxQueue) - PROTOCOL_CONTROL_PACKET_SIZE;
             uint8_t i;
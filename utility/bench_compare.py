@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""
+BlueBus benchmark comparison tool
+
+Collects the output of the firmware "BENCH" CLI command, either live from the
+BlueBus over its USB serial port or from a captured log, and compares the
+cycles/op (or ns/op for older captures) against a stored baseline. Exits
+non-zero when any benchmark regressed past the allowed threshold so it can
+gate a release build.
+
+Usage:
+    ./bench_compare.py --port /dev/ttyUSB0                  # run and compare
+    ./bench_compare.py --log session.log                    # compare a capture
+    ./bench_compare.py --port /dev/ttyUSB0 --update         # store a baseline
+    ./bench_compare.py --log session.log --json             # results as JSON
+"""
+import argparse
+import json
+import os
+import sys
+from time import time
+
+BASELINE_FILE = os.path.join(
+    os.path.dirname(os.path.abspath(__file__)),
+    'bench_baseline.json'
+)
+BAUDRATE = 115200
+PREFIX = 'BENCH:'
+# Percentage a benchmark may slow down before it counts as a regression
+DEFAULT_THRESHOLD = 10.0
+TIMEOUT = 30
+
+
+def parse_lines(lines):
+    """Pull the last complete BENCH:BEGIN ... BENCH:END block out of the lines"""
+    run = None
+    complete = None
+    for line in lines:
+        idx = line.find(PREFIX)
+        if idx == -1:
+            continue
+        fields = line[idx + len(PREFIX):].strip().split(',')
+        if fields[0] == 'BEGIN':
+            run = {
+                'bt_type': int(fields[1]) if len(fields) > 1 else None,
+                'log_mask': fields[2] if len(fields) > 2 else None,
+                'results': {},
+            }
+        elif fields[0] == 'END':
+            if run is not None:
+                complete = run
+            run = None
+        elif run is not None and len(fields) in (4, 5):
+            result = {
+                'ops': int(fields[1]),
+                'elapsed_ms': int(fields[2]),
+                'ns_per_op': int(fields[3]),
+            }
+            if len(fields) == 5:
+                result['cycles_per_op'] = int(fields[4])
+            run['results'][fields[0]] = result
+    return complete
+
+
+def read_serial(port, bench_filter):
+    from serial import Serial
+    lines = []
+    with Serial(port, BAUDRATE, timeout=1) as serial_port:
+        serial_port.reset_input_buffer()
+        command = 'BENCH %s\r' % bench_filter if bench_filter else 'BENCH\r'
+        serial_port.write(command.encode('ascii'))
+        start = time()
+        while time() - start < TIMEOUT:
+            line = serial_port.readline().decode('ascii', errors='replace')
+            if not line:
+                continue
+            lines.append(line)
+            if (PREFIX + 'END') in line:
+                break
+    return lines
+
+
+def compare(run, baseline, threshold):
+    """
+    Compare on instruction cycles when both sides have them, since they are
+    exact, and fall back to the millisecond derived ns/op otherwise
+    """
+    report = []
+    for name, result in sorted(run['results'].items()):
+        base = baseline.get('results', {}).get(name)
+        metric = 'ns_per_op'
+        if 'cycles_per_op' in result and (base is None or 'cycles_per_op' in base):
+            metric = 'cycles_per_op'
+        entry = {'name': name, 'metric': metric, 'value': result[metric]}
+        if base is None:
+            entry['status'] = 'new'
+        else:
+            limit = baseline.get('thresholds', {}).get(name, threshold)
+            delta = 0.0
+            if base[metric] > 0:
+                delta = 100.0 * (result[metric] - base[metric]) / base[metric]
+            entry['baseline'] = base[metric]
+            entry['delta_pct'] = round(delta, 2)
+            entry['threshold_pct'] = limit
+            entry['status'] = 'regressed' if delta > limit else 'ok'
+        report.append(entry)
+    return report
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare BlueBus benchmark results to a baseline')
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('--port', help='Serial port of the BlueBus')
+    source.add_argument('--log', help='A captured log containing BENCH output')
+    parser.add_argument('--filter', help='Only run the named benchmark')
+    parser.add_argument('--baseline', default=BASELINE_FILE)
+    parser.add_argument('--threshold', type=float, default=DEFAULT_THRESHOLD)
+    parser.add_argument('--update', action='store_true', help='Store the results as the new baseline')
+    parser.add_argument('--json', action='store_true')
+    args = parser.parse_args()
+
+    if args.port:
+        lines = read_serial(args.port, args.filter)
+    else:
+        with open(args.log, 'r', errors='replace') as log:
+            lines = log.readlines()
+    run = parse_lines(lines)
+    if run is None:
+        sys.stderr.write('No complete BENCH run found\n')
+        return 2
+
+    if args.update:
+        baseline = {}
+        if os.path.exists(args.baseline):
+            with open(args.baseline, 'r') as handle:
+                baseline = json.load(handle)
+        baseline.setdefault('results', {}).update(run['results'])
+        baseline['bt_type'] = run['bt_type']
+        baseline['log_mask'] = run['log_mask']
+        with open(args.baseline, 'w') as handle:
+            json.dump(baseline, handle, indent=2, sort_keys=True)
+            handle.write('\n')
+        print('Baseline written to %s' % args.baseline)
+        return 0
+
+    if not os.path.exists(args.baseline):
+        sys.stderr.write('No baseline at %s -- run with --update first\n' % args.baseline)
+        return 2
+    with open(args.baseline, 'r') as handle:
+        baseline = json.load(handle)
+    if baseline.get('log_mask') != run['log_mask']:
+        sys.stderr.write(
+            'Warning: log mask %s differs from the baseline (%s), results may not be comparable\n' %
+            (run['log_mask'], baseline.get('log_mask'))
+        )
+    report = compare(run, baseline, args.threshold)
+    if args.json:
+        json.dump(report, sys.stdout, indent=2)
+        sys.stdout.write('\n')
+    else:
+        for entry in report:
+            unit = 'cyc/op' if entry['metric'] == 'cycles_per_op' else 'ns/op'
+            if entry['status'] == 'new':
+                print('%-28s %10d %-6s  (no baseline)' % (entry['name'], entry['value'], unit))
+            else:
+                print('%-28s %10d %-6s  baseline %10d  %+7.2f%%  %s' % (
+                    entry['name'],
+                    entry['value'],
+                    unit,
+                    entry['baseline'],
+                    entry['delta_pct'],
+                    entry['status'].upper()
+                ))
+    return 1 if any(entry['status'] == 'regressed' for entry in report) else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
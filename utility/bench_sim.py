@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""
+BlueBus simulator benchmark runner
+
+Runs the firmware benchmarks under the Microchip simulator (MDB / sim30) in
+batch mode so hot paths are measured in PIC24 instruction cycles without any
+hardware attached. The results are compared against a simulator baseline in
+the same way bench_compare.py does for on-device runs.
+
+The application image must be built with BENCH_STANDALONE defined (add it to
+the xc16-gcc preprocessor macros of the application configuration). That
+build runs every benchmark once after boot, then hits a software breakpoint,
+which is the signal for MDB to stop.
+
+Usage:
+    ./bench_sim.py --elf dist/application/production/application.production.elf
+    ./bench_sim.py --elf app.elf --update          # store a simulator baseline
+    ./bench_sim.py --elf app.elf --mdb /opt/microchip/mplabx/v6.20/mplab_platform/bin/mdb.sh
+"""
+import argparse
+import glob
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+from bench_compare import compare, parse_lines
+
+DEVICE = 'PIC24FJ1024GA606'
+BASELINE_FILE = os.path.join(
+    os.path.dirname(os.path.abspath(__file__)),
+    'bench_baseline_sim.json'
+)
+# SYSTEM_UART_MODULE in mappings.h
+SYSTEM_UART = 3
+# Simulated milliseconds are far slower than real ones
+DEFAULT_TIMEOUT = 600
+MDB_SEARCH_PATHS = (
+    '/opt/microchip/mplabx/*/mplab_platform/bin/mdb.sh',
+    '/Applications/microchip/mplabx/*/mplab_platform/bin/mdb.sh',
+    'C:\\Program Files\\Microchip\\MPLABX\\*\\mplab_platform\\bin\\mdb.bat',
+)
+# The simulator has nothing attached to the bus or BT UART, so the parser
+# benchmarks run against empty lines, like a quiet car
+MDB_SCRIPT = """device {device}
+hwtool SIM
+set uart{uart}io.uartioenabled true
+set uart{uart}io.output file
+set uart{uart}io.outputfile {output}
+program "{elf}"
+run
+wait {wait}
+quit
+"""
+
+
+def find_mdb(explicit):
+    if explicit:
+        return explicit
+    for name in ('mdb.sh', 'mdb'):
+        path = shutil.which(name)
+        if path:
+            return path
+    for pattern in MDB_SEARCH_PATHS:
+        matches = sorted(glob.glob(pattern))
+        if matches:
+            return matches[-1]
+    return None
+
+
+def run_simulator(mdb, elf, uart, timeout):
+    workdir = tempfile.mkdtemp(prefix='bluebus_bench_')
+    output = os.path.join(workdir, 'uart.txt')
+    script = os.path.join(workdir, 'bench.mdb')
+    with open(script, 'w') as handle:
+        handle.write(MDB_SCRIPT.format(
+            device=DEVICE,
+            uart=uart,
+            output=output.replace('\\', '/'),
+            elf=os.path.abspath(elf).replace('\\', '/'),
+            wait=timeout * 1000
+        ))
+    subprocess.run([mdb, script], check=True, timeout=timeout + 60)
+    if not os.path.exists(output):
+        return []
+    with open(output, 'r', errors='replace') as handle:
+        return handle.readlines()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Run the BlueBus benchmarks under the MPLAB simulator')
+    parser.add_argument('--elf', required=True, help='Application image built with BENCH_STANDALONE')
+    parser.add_argument('--mdb', help='Path to mdb.sh / mdb.bat')
+    parser.add_argument('--uart', type=int, default=SYSTEM_UART)
+    parser.add_argument('--timeout', type=int, default=DEFAULT_TIMEOUT, help='Seconds to wait for the run')
+    parser.add_argument('--baseline', default=BASELINE_FILE)
+    parser.add_argument('--threshold', type=float, default=1.0, help='Simulator runs are deterministic')
+    parser.add_argument('--update', action='store_true')
+    parser.add_argument('--json', action='store_true')
+    args = parser.parse_args()
+
+    mdb = find_mdb(args.mdb)
+    if mdb is None:
+        sys.stderr.write('Unable to find MDB, pass --mdb\n')
+        return 2
+    run = parse_lines(run_simulator(mdb, args.elf, args.uart, args.timeout))
+    if run is None:
+        sys.stderr.write('The simulator did not produce a complete BENCH run\n')
+        return 2
+    missing = [name for name, result in run['results'].items() if 'cycles_per_op' not in result]
+    if missing:
+        sys.stderr.write('Image does not report cycles for: %s\n' % ', '.join(missing))
+        return 2
+
+    if args.update:
+        with open(args.baseline, 'w') as handle:
+            json.dump({'results': run['results']}, handle, indent=2, sort_keys=True)
+            handle.write('\n')
+        print('Baseline written to %s' % args.baseline)
+        return 0
+
+    baseline = {}
+    if os.path.exists(args.baseline):
+        with open(args.baseline, 'r') as handle:
+            baseline = json.load(handle)
+    report = compare(run, baseline, args.threshold)
+    if args.json:
+        json.dump(report, sys.stdout, indent=2)
+        sys.stdout.write('\n')
+    else:
+        for entry in report:
+            line = '%-28s %10d cyc/op' % (entry['name'], entry['value'])
+            if entry['status'] != 'new':
+                line += '  baseline %10d  %+7.2f%%  %s' % (
+                    entry['baseline'],
+                    entry['delta_pct'],
+                    entry['status'].upper()
+                )
+            print(line)
+    return 1 if any(entry['status'] == 'regressed' for entry in report) else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""
+BlueBus cVc tuning tool
+
+Headless companion to gui_cvc_tool.py for tuning the BC127 cVc parameters in
+the car. A parameter set is uploaded with a single "BT CVC BULK" command. The
+firmware only forwards the parameters that changed to the BC127, and this tool
+skips the upload entirely when the device already holds the set.
+
+Parameter files are JSON with 14 16-bit words per band, as hex strings or
+integers, see BC127CommandCVCParams() for their meaning:
+    {"nb": ["2280", "0000", ...], "wb": ["2284", "0000", ...]}
+
+Usage:
+    ./console_cvc_tool.py --port /dev/ttyUSB0 get
+    ./console_cvc_tool.py --port /dev/ttyUSB0 push quiet.json --save A
+    ./console_cvc_tool.py --port /dev/ttyUSB0 load B
+    ./console_cvc_tool.py --port /dev/ttyUSB0 ab
+"""
+import argparse
+import json
+import sys
+from time import time
+
+BAUDRATE = 115200
+TIMEOUT = 5
+PARAM_COUNT = 14
+BANDS = ('nb', 'wb')
+PREFIX = 'CVC: '
+
+
+class Device:
+
+    def __init__(self, port):
+        from serial import Serial
+        self.serial_port = Serial(port, BAUDRATE, timeout=0.25)
+        self.serial_port.reset_input_buffer()
+
+    def command(self, command):
+        """Send a CLI command and collect the CVC lines it prints"""
+        self.serial_port.reset_input_buffer()
+        self.serial_port.write(command.encode('ascii') + b'\r')
+        lines = []
+        start = time()
+        while time() - start < TIMEOUT:
+            line = self.serial_port.readline().decode('ascii', errors='replace')
+            idx = line.find(PREFIX)
+            if idx != -1:
+                lines.append(line[idx + len(PREFIX):].strip())
+            elif 'Command not found' in line:
+                raise RuntimeError('%s: %s' % (command, ' '.join(lines) or 'failed'))
+            elif line.startswith('OK'):
+                return lines
+        raise RuntimeError('%s: timed out waiting for a reply' % command)
+
+    def get(self):
+        """Read the parameters and preset the device holds"""
+        state = {'preset': None}
+        for line in self.command('BT CVC GET'):
+            fields = line.split()
+            if fields[0].lower() in BANDS:
+                if fields[1] == 'Unknown':
+                    state[fields[0].lower()] = None
+                else:
+                    state[fields[0].lower()] = [int(value, 16) for value in fields[1:]]
+            elif fields[0] == 'Preset' and fields[1] != 'None':
+                state['preset'] = fields[1]
+        return state
+
+
+def load_params(path):
+    with open(path, 'r') as params_file:
+        data = json.load(params_file)
+    params = {}
+    for band in BANDS:
+        values = data.get(band)
+        if values is None or len(values) != PARAM_COUNT:
+            raise ValueError('%s: "%s" needs %d parameters' % (path, band, PARAM_COUNT))
+        params[band] = [int(value, 16) if isinstance(value, str) else int(value) for value in values]
+        if any(value < 0 or value > 0xFFFF for value in params[band]):
+            raise ValueError('%s: "%s" parameters must fit in 16 bits' % (path, band))
+    return params
+
+
+def print_state(state):
+    for band in BANDS:
+        values = state.get(band)
+        if values is None:
+            print('%s: unknown' % band.upper())
+        else:
+            print('%s: %s' % (band.upper(), ' '.join('%04X' % value for value in values)))
+    print('Preset: %s' % (state['preset'] or 'none'))
+
+
+def print_diff(state, params):
+    changed = 0
+    for band in BANDS:
+        current = state.get(band)
+        for idx, value in enumerate(params[band]):
+            if current is None or current[idx] != value:
+                old = '----' if current is None else '%04X' % current[idx]
+                print('%s[%2d]: %s -> %04X' % (band.upper(), idx, old, value))
+                changed += 1
+    return changed
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Tune the BlueBus cVc parameters')
+    parser.add_argument('--port', required=True, help='Serial port of the BlueBus')
+    actions = parser.add_subparsers(dest='action', required=True)
+    actions.add_parser('get', help='Show the parameters the device holds')
+    push = actions.add_parser('push', help='Upload a parameter file')
+    push.add_argument('file', help='JSON parameter file')
+    push.add_argument('--save', choices=('A', 'B'), help='Store the upload as a preset')
+    load = actions.add_parser('load', help='Apply a stored preset')
+    load.add_argument('preset', choices=('A', 'B'))
+    save = actions.add_parser('save', help='Store the current parameters as a preset')
+    save.add_argument('preset', choices=('A', 'B'))
+    actions.add_parser('ab', help='Switch between presets A and B')
+    args = parser.parse_args()
+
+    try:
+        device = Device(args.port)
+        if args.action == 'push':
+            params = load_params(args.file)
+            changed = print_diff(device.get(), params)
+            if changed == 0:
+                print('Device is up to date')
+            else:
+                values = ' '.join(
+                    '%04X' % value for band in BANDS for value in params[band]
+                )
+                print(' '.join(device.command('BT CVC BULK %s' % values)))
+            if args.save:
+                device.command('BT CVC SAVE %s' % args.save)
+                print('Saved as preset %s' % args.save)
+        elif args.action == 'load':
+            device.command('BT CVC LOAD %s' % args.preset)
+            print_state(device.get())
+        elif args.action == 'save':
+            device.command('BT CVC SAVE %s' % args.preset)
+            print('Saved as preset %s' % args.preset)
+        elif args.action == 'ab':
+            print(' '.join(device.command('BT CVC AB')))
+        else:
+            print_state(device.get())
+    except (RuntimeError, ValueError) as error:
+        sys.stderr.write('%s\n' % error)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,465 @@
+#!/usr/bin/env python3
+"""
+BlueBus IBus bus simulator
+
+Deterministic discrete-event model of a 9600 baud 8E1 IBus segment with
+virtual RAD, GT, IKE, MFL, BMBT, LCM and DSP nodes and a BlueBus node that
+follows the firmware transmit discipline (16 frame FIFO, IBUS_TX_BUFFER_WAIT
+between frames, TH3122 STATUS sensing and IBUS_TX_TIMEOUT_WAIT give-up).
+
+The timing constants and device addresses are read from
+firmware/application/lib/ibus.h so the model tracks the firmware.
+
+Usage:
+    ./ibus_simulator.py                       # run every scenario
+    ./ibus_simulator.py -s mfl_next -d 60     # one scenario for 60 seconds
+    ./ibus_simulator.py --json                # machine-readable results
+"""
+import argparse
+import heapq
+import json
+import os
+import random
+import re
+import sys
+
+IBUS_HEADER = os.path.join(
+    os.path.dirname(os.path.abspath(__file__)),
+    '..', 'firmware', 'application', 'lib', 'ibus.h'
+)
+
+BAUDRATE = 9600
+# Start + 8 data + even parity + stop
+BITS_PER_BYTE = 11
+BIT_TIME_US = 1000000 / BAUDRATE
+BYTE_TIME_US = int(round(BITS_PER_BYTE * BIT_TIME_US))
+# The TH3122 holds STATUS high while the bus is active and until it has
+# seen roughly one idle character time after the last stop bit
+TH3122_IDLE_US = BYTE_TIME_US
+# Two transmitters that both saw STATUS low within a single bit time will
+# start driving the bus together and corrupt each other's frames
+COLLISION_WINDOW_US = int(round(BIT_TIME_US))
+# OEM modules retry a corrupted frame after a randomized backoff
+OEM_BACKOFF_US = (2000, 12000)
+OEM_MAX_RETRIES = 8
+# Time for the firmware to act on a received frame (parse + handler)
+FIRMWARE_REACTION_US = 1500
+
+
+def load_firmware_constants(path):
+    """Parse the #define values we care about out of ibus.h"""
+    defines = {}
+    pattern = re.compile(r'^#define\s+(IBUS_\w+)\s+(0x[0-9A-Fa-f]+|\d+)\b')
+    try:
+        with open(path, 'r', encoding='utf-8', errors='replace') as header:
+            for line in header:
+                match = pattern.match(line)
+                if match:
+                    defines[match.group(1)] = int(match.group(2), 0)
+    except OSError:
+        pass
+    fallback = {
+        'IBUS_TX_BUFFER_SIZE': 16,
+        'IBUS_TX_BUFFER_WAIT': 7,
+        'IBUS_TX_TIMEOUT_WAIT': 250,
+        'IBUS_RX_BUFFER_TIMEOUT': 70,
+        'IBUS_MAX_MSG_LENGTH': 47,
+        'IBUS_DEVICE_CDC': 0x18,
+        'IBUS_DEVICE_GT': 0x3B,
+        'IBUS_DEVICE_MFL': 0x50,
+        'IBUS_DEVICE_RAD': 0x68,
+        'IBUS_DEVICE_DSP': 0x6A,
+        'IBUS_DEVICE_IKE': 0x80,
+        'IBUS_DEVICE_GLO': 0xBF,
+        'IBUS_DEVICE_TEL': 0xC8,
+        'IBUS_DEVICE_LCM': 0xD0,
+        'IBUS_DEVICE_BMBT': 0xF0,
+    }
+    for key, value in fallback.items():
+        defines.setdefault(key, value)
+    return defines
+
+
+FW = load_firmware_constants(IBUS_HEADER)
+DEV_BLUEBUS = FW['IBUS_DEVICE_CDC']
+DEV_GT = FW['IBUS_DEVICE_GT']
+DEV_MFL = FW['IBUS_DEVICE_MFL']
+DEV_RAD = FW['IBUS_DEVICE_RAD']
+DEV_DSP = FW['IBUS_DEVICE_DSP']
+DEV_IKE = FW['IBUS_DEVICE_IKE']
+DEV_GLO = FW['IBUS_DEVICE_GLO']
+DEV_TEL = FW['IBUS_DEVICE_TEL']
+DEV_LCM = FW['IBUS_DEVICE_LCM']
+DEV_BMBT = FW['IBUS_DEVICE_BMBT']
+DEVICE_NAMES = {
+    DEV_BLUEBUS: 'BlueBus',
+    DEV_GT: 'GT',
+    DEV_MFL: 'MFL',
+    DEV_RAD: 'RAD',
+    DEV_DSP: 'DSP',
+    DEV_IKE: 'IKE',
+    DEV_LCM: 'LCM',
+    DEV_BMBT: 'BMBT',
+}
+
+
+def build_frame(src, dst, data):
+    """Build an IBus frame the same way IBusSendCommand() does"""
+    frame = [src, len(data) + 2, dst] + list(data)
+    crc = 0
+    for byte in frame:
+        crc ^= byte
+    frame.append(crc)
+    return bytes(frame)
+
+
+def percentile(values, pct):
+    if not values:
+        return 0
+    ordered = sorted(values)
+    idx = min(len(ordered) - 1, int(round((pct / 100.0) * (len(ordered) - 1))))
+    return ordered[idx]
+
+
+class Bus(object):
+    """The shared wire and the TH3122 STATUS signal every node senses"""
+
+    def __init__(self, sim):
+        self.sim = sim
+        self.busy_until = 0
+        self.idle_from = 0
+        self.active = []
+        self.busy_us = 0
+        self.frames = 0
+        self.corrupt_frames = 0
+        self.collisions = 0
+        self.nodes = []
+
+    def status(self, now):
+        """
+        Mirror of IBUS_UART_STATUS -- 1 while the bus is not free. A frame
+        that started less than a bit time ago has not been sensed yet.
+        """
+        for tx in self.active:
+            if now - tx['start'] >= COLLISION_WINDOW_US:
+                return 1
+        return 1 if now < self.idle_from else 0
+
+    def transmit(self, node, frame, now):
+        duration = len(frame) * BYTE_TIME_US
+        tx = {'node': node, 'frame': frame, 'start': now, 'collided': False}
+        if self.active:
+            self.collisions += 1
+            tx['collided'] = True
+            for other in self.active:
+                other['collided'] = True
+        self.active.append(tx)
+        end = now + duration
+        if end > self.busy_until:
+            self.busy_us += end - max(now, self.busy_until)
+            self.busy_until = end
+        self.sim.schedule(end, self.complete, tx)
+
+    def complete(self, now, tx):
+        self.active.remove(tx)
+        self.idle_from = max(self.idle_from, now + TH3122_IDLE_US)
+        tx['node'].on_tx_complete(now, tx['frame'], not tx['collided'])
+        if tx['collided']:
+            self.corrupt_frames += 1
+            return
+        self.frames += 1
+        for node in self.nodes:
+            node.on_frame(now, tx['frame'])
+
+
+class Node(object):
+    """An OEM module: sends when STATUS is low, retries after collisions"""
+
+    def __init__(self, sim, address):
+        self.sim = sim
+        self.address = address
+        self.queue = []
+        self.retries = 0
+        self.pending = False
+        self.tx_frames = 0
+        self.tx_dropped = 0
+
+    @property
+    def name(self):
+        return DEVICE_NAMES.get(self.address, '%02X' % self.address)
+
+    def send(self, dst, data):
+        self.queue.append(build_frame(self.address, dst, data))
+        if not self.pending:
+            self.pending = True
+            self.sim.schedule(self.sim.now, self.try_transmit)
+
+    def try_transmit(self, now, _arg=None):
+        if not self.queue:
+            self.pending = False
+            return
+        if self.sim.bus.status(now):
+            wake = max(self.sim.bus.busy_until + TH3122_IDLE_US, self.sim.bus.idle_from)
+            self.sim.schedule(wake, self.try_transmit)
+            return
+        self.sim.bus.transmit(self, self.queue[0], now)
+
+    def on_tx_complete(self, now, frame, ok):
+        if ok:
+            self.queue.pop(0)
+            self.tx_frames += 1
+            self.retries = 0
+            delay = 0
+        else:
+            self.retries += 1
+            if self.retries > OEM_MAX_RETRIES:
+                self.queue.pop(0)
+                self.tx_dropped += 1
+                self.retries = 0
+            delay = self.sim.rng.randint(*OEM_BACKOFF_US)
+        if self.queue:
+            self.sim.schedule(now + delay, self.try_transmit)
+        else:
+            self.pending = False
+
+    def on_frame(self, now, frame):
+        pass
+
+    def every(self, start_us, period_us, func, jitter_us=0):
+        def tick(now, _arg=None):
+            func(now)
+            jitter = self.sim.rng.randint(0, jitter_us) if jitter_us else 0
+            self.sim.schedule(now + period_us + jitter, tick)
+        self.sim.schedule(start_us, tick)
+
+
+class BlueBusNode(Node):
+    """
+    The BlueBus transmit path as implemented by IBusProcess(): a ring of
+    IBUS_TX_BUFFER_SIZE frames, IBUS_TX_BUFFER_WAIT ms between frames and a
+    give-up after IBUS_TX_TIMEOUT_WAIT ms of STATUS being high. The TH3122
+    does not arbitrate, so collided frames are lost, exactly like on the car.
+    """
+
+    def __init__(self, sim, title_targets):
+        super(BlueBusNode, self).__init__(sim, DEV_BLUEBUS)
+        self.tx_last = -FW['IBUS_TX_BUFFER_WAIT'] * 1000
+        self.tx_begin = None
+        self.title_targets = title_targets
+        self.tx_overflows = 0
+        self.tx_timeouts = 0
+        self.tx_collided = 0
+        # Button frame timestamp awaiting its first display frame
+        self.pending_latency = []
+        self.latencies = []
+
+    def send(self, dst, data):
+        if len(self.queue) >= FW['IBUS_TX_BUFFER_SIZE']:
+            self.tx_overflows += 1
+            return
+        super(BlueBusNode, self).send(dst, data)
+
+    def try_transmit(self, now, _arg=None):
+        if not self.queue:
+            self.pending = False
+            self.tx_begin = None
+            return
+        if self.tx_begin is None:
+            self.tx_begin = now
+        wait_until = self.tx_last + FW['IBUS_TX_BUFFER_WAIT'] * 1000
+        if now < wait_until:
+            self.sim.schedule(wait_until, self.try_transmit)
+            return
+        if self.sim.bus.status(now):
+            if now - self.tx_begin > FW['IBUS_TX_TIMEOUT_WAIT'] * 1000:
+                # The firmware leaves the frame queued and returns to RX
+                self.tx_timeouts += 1
+                self.tx_begin = None
+            # IBusProcess() polls STATUS once per main loop iteration
+            self.sim.schedule(now + 100, self.try_transmit)
+            return
+        self.sim.bus.transmit(self, self.queue[0], now)
+
+    def on_tx_complete(self, now, frame, ok):
+        # Frames are removed from the ring once written to the UART, whether
+        # or not they survived on the wire
+        self.queue.pop(0)
+        self.tx_last = now
+        self.tx_begin = None
+        if ok:
+            self.tx_frames += 1
+            if self.pending_latency and frame[2] in self.title_targets:
+                self.latencies.append(now - self.pending_latency.pop(0))
+        else:
+            self.tx_collided += 1
+        if self.queue:
+            self.sim.schedule(now, self.try_transmit)
+        else:
+            self.pending = False
+
+    def on_frame(self, now, frame):
+        src, dst, cmd = frame[0], frame[2], frame[3]
+        is_mfl_next = src == DEV_MFL and cmd == 0x3B and frame[4] == 0x01
+        is_bmbt_next = src == DEV_BMBT and cmd == 0x48 and frame[4] == 0x00
+        if is_mfl_next or is_bmbt_next:
+            self.pending_latency.append(now)
+            self.sim.schedule(now + FIRMWARE_REACTION_US, self.on_track_change)
+        elif src == DEV_RAD and dst == DEV_BLUEBUS and cmd == 0x38:
+            # CDC status request -> CDC status response
+            self.sim.schedule(
+                now + FIRMWARE_REACTION_US,
+                lambda t, _a=None: self.send(DEV_RAD, [0x39, 0x00, 0x09, 0x00, 0x3F, 0x00, 0x01, 0x01])
+            )
+        elif src == DEV_RAD and dst == DEV_BLUEBUS and cmd == 0x01:
+            self.sim.schedule(
+                now + FIRMWARE_REACTION_US,
+                lambda t, _a=None: self.send(DEV_GLO, [0x02, 0x00])
+            )
+
+    def on_track_change(self, now, _arg=None):
+        # Metadata arrives shortly after the AVRCP skip: title to each
+        # display, then the GT index fields
+        title = [ord(c) for c in 'Artist - Title']
+        for target in self.title_targets:
+            if target == DEV_GT:
+                self.send(DEV_GT, [0x23, 0x62, 0x10] + title)
+                for field in range(0x41, 0x44):
+                    self.send(DEV_GT, [0x21, 0x60, 0x00, field] + title[:14])
+            else:
+                self.send(target, [0x23, 0x42, 0x32] + title[:11])
+
+
+class Simulator(object):
+
+    def __init__(self, seed):
+        self.now = 0
+        self.events = []
+        self.seq = 0
+        self.rng = random.Random(seed)
+        self.bus = Bus(self)
+
+    def schedule(self, when, func, arg=None):
+        self.seq += 1
+        heapq.heappush(self.events, (int(when), self.seq, func, arg))
+
+    def run(self, duration_us):
+        while self.events:
+            when, _seq, func, arg = heapq.heappop(self.events)
+            if when > duration_us:
+                break
+            self.now = when
+            func(when, arg)
+        self.now = duration_us
+
+
+def build_scenario(name, sim):
+    """Wire the virtual modules for a named scenario"""
+    bus = sim.bus
+    has_gt = name in ('bmbt_browse', 'heavy')
+    targets = [DEV_GT] if has_gt else [DEV_IKE]
+    bluebus = BlueBusNode(sim, targets)
+    ike = Node(sim, DEV_IKE)
+    lcm = Node(sim, DEV_LCM)
+    rad = Node(sim, DEV_RAD)
+    mfl = Node(sim, DEV_MFL)
+    nodes = [bluebus, ike, lcm, rad, mfl]
+    # Periodic broadcasts present in every car
+    ike.every(50000, 2000000, lambda t: ike.send(DEV_GLO, [0x18, 0x20, 0x1E]), 20000)
+    ike.every(120000, 10000000, lambda t: ike.send(DEV_GLO, [0x19, 0x0E, 0x50, 0x00]), 20000)
+    lcm.every(300000, 3000000, lambda t: lcm.send(DEV_GLO, [0x5B, 0x00, 0x00, 0x00, 0x00]), 50000)
+    rad.every(10000, 20000000, lambda t: rad.send(DEV_BLUEBUS, [0x01]), 0)
+    rad.every(15000, 5000000, lambda t: rad.send(DEV_BLUEBUS, [0x38, 0x00, 0x00]), 10000)
+    if name in ('mfl_next', 'heavy'):
+        def mfl_next(t):
+            mfl.send(DEV_RAD, [0x3B, 0x01])
+            sim.schedule(t + 150000, lambda t2, _a=None: mfl.send(DEV_RAD, [0x3B, 0x21]))
+        mfl.every(1000000, 1500000, mfl_next, 200000)
+    if has_gt:
+        gt = Node(sim, DEV_GT)
+        bmbt = Node(sim, DEV_BMBT)
+        dsp = Node(sim, DEV_DSP)
+        nodes += [gt, bmbt, dsp]
+        gt.every(200000, 1000000, lambda t: gt.send(DEV_RAD, [0x45, 0x00]), 30000)
+        dsp.every(400000, 4000000, lambda t: dsp.send(DEV_RAD, [0x36, 0x30]), 40000)
+        # Radio repaints the GT header as the user interacts with it
+        rad.every(600000, 800000, lambda t: rad.send(DEV_GT, [0x23, 0x62, 0x30] + [0x20] * 11), 100000)
+
+        def bmbt_next(t):
+            bmbt.send(DEV_RAD, [0x48, 0x00])
+            sim.schedule(t + 120000, lambda t2, _a=None: bmbt.send(DEV_RAD, [0x48, 0x80]))
+        bmbt.every(700000, 2300000, bmbt_next, 300000)
+        if name == 'heavy':
+            # Knob spinning produces a frame per detent
+            bmbt.every(900000, 60000, lambda t: bmbt.send(DEV_GT, [0x49, 0x01]), 10000)
+            ike.every(500000, 200000, lambda t: ike.send(DEV_GLO, [0x18, 0x40, 0x2A]), 10000)
+    bus.nodes = nodes
+    return bluebus, nodes
+
+
+SCENARIOS = ('idle', 'mfl_next', 'bmbt_browse', 'heavy')
+
+
+def run_scenario(name, duration_s, seed):
+    sim = Simulator(seed)
+    bluebus, nodes = build_scenario(name, sim)
+    sim.run(duration_s * 1000000)
+    bus = sim.bus
+    return {
+        'scenario': name,
+        'duration_s': duration_s,
+        'seed': seed,
+        'bus_utilization_pct': round(100.0 * bus.busy_us / (duration_s * 1000000), 2),
+        'frames_ok': bus.frames,
+        'frames_corrupt': bus.corrupt_frames,
+        'collisions': bus.collisions,
+        'bluebus_tx_frames': bluebus.tx_frames,
+        'bluebus_tx_collided': bluebus.tx_collided,
+        'bluebus_tx_timeouts': bluebus.tx_timeouts,
+        'bluebus_tx_overflows': bluebus.tx_overflows,
+        'oem_tx_dropped': sum(n.tx_dropped for n in nodes if n is not bluebus),
+        'latency_samples': len(bluebus.latencies),
+        'latency_ms_avg': round(
+            sum(bluebus.latencies) / len(bluebus.latencies) / 1000.0, 2
+        ) if bluebus.latencies else 0,
+        'latency_ms_p95': round(percentile(bluebus.latencies, 95) / 1000.0, 2),
+        'latency_ms_max': round(max(bluebus.latencies) / 1000.0, 2) if bluebus.latencies else 0,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description='BlueBus IBus bus simulator')
+    parser.add_argument('-s', '--scenario', choices=SCENARIOS, action='append')
+    parser.add_argument('-d', '--duration', type=int, default=120, help='Seconds of bus time')
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--json', action='store_true', help='Emit JSON results')
+    args = parser.parse_args()
+    results = [
+        run_scenario(name, args.duration, args.seed)
+        for name in (args.scenario or SCENARIOS)
+    ]
+    if args.json:
+        json.dump(results, sys.stdout, indent=2)
+        sys.stdout.write('\n')
+        return
+    for result in results:
+        print('Scenario: %s (%ds, seed %d)' % (result['scenario'], result['duration_s'], result['seed']))
+        print('  Bus utilization:      %6.2f%%' % result['bus_utilization_pct'])
+        print('  Frames ok / corrupt:  %d / %d' % (result['frames_ok'], result['frames_corrupt']))
+        print('  Collisions:           %d' % result['collisions'])
+        print('  BlueBus TX frames:    %d (collided %d, timeouts %d, overflows %d)' % (
+            result['bluebus_tx_frames'],
+            result['bluebus_tx_collided'],
+            result['bluebus_tx_timeouts'],
+            result['bluebus_tx_overflows']
+        ))
+        print('  OEM frames dropped:   %d' % result['oem_tx_dropped'])
+        print('  Button -> display:    avg %.2f ms, p95 %.2f ms, max %.2f ms (n=%d)' % (
+            result['latency_ms_avg'],
+            result['latency_ms_p95'],
+            result['latency_ms_max'],
+            result['latency_samples']
+        ))
+
+
+if __name__ == '__main__':
+    main()
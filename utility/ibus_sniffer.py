@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+"""
+BlueBus IBus sniffer capture
+
+Turns on the "SNIFFER ON" CLI mode, which streams every IBus frame the BlueBus
+receives or sends as a binary record, and writes the frames to a pcap file
+for Wireshark. Captures can also be taken with any terminal program that
+saves raw bytes and converted afterwards with --input.
+
+Each record is laid out as A5 5A <type> <length> <timestamp> <data> <checksum>
+with a 32-bit little endian timestamp in microseconds and an XOR checksum over
+the type through the data, see firmware/application/lib/sniffer.h. Log text
+the firmware prints between records is skipped over.
+
+The pcap uses the USER0 link type. Each packet starts with the record type
+(1 = RX, 2 = TX, 3 = echo of our TX, 4 = RX with a bad checksum) followed by
+the IBus frame.
+
+Usage:
+    ./ibus_sniffer.py --port /dev/ttyUSB0 --output ibus.pcap
+    ./ibus_sniffer.py --input capture.bin --output ibus.pcap
+"""
+import argparse
+import struct
+import sys
+
+BAUDRATE = 115200
+SYNC = b'\xA5\x5A'
+RECORD_OVERHEAD = 9
+RECORD_RX = 0x01
+RECORD_TX = 0x02
+RECORD_ECHO = 0x03
+RECORD_RX_BAD_CHECKSUM = 0x04
+RECORD_DROP = 0x05
+RECORD_TYPES = (RECORD_RX, RECORD_TX, RECORD_ECHO, RECORD_RX_BAD_CHECKSUM, RECORD_DROP)
+TIMESTAMP_WRAP = 1 << 32
+PCAP_LINKTYPE_USER0 = 147
+PCAP_SNAPLEN = 65535
+
+
+def read_serial(port):
+    from serial import Serial
+    data = bytearray()
+    with Serial(port, BAUDRATE, timeout=1) as serial_port:
+        serial_port.reset_input_buffer()
+        serial_port.write(b'SNIFFER ON\r')
+        sys.stderr.write('Capturing, press Ctrl-C to stop\n')
+        try:
+            while True:
+                data += serial_port.read(serial_port.in_waiting or 1)
+        except KeyboardInterrupt:
+            pass
+        serial_port.write(b'SNIFFER OFF\r')
+        summary = serial_port.read_until(b'dropped\r\n')
+        data += summary
+    return bytes(data)
+
+
+def parse_records(data):
+    """Yield (type, timestamp, payload) for each valid record in the stream"""
+    offset = 0
+    skipped = 0
+    while True:
+        start = data.find(SYNC, offset)
+        if start < 0 or start + RECORD_OVERHEAD > len(data):
+            break
+        record_type = data[start + 2]
+        length = data[start + 3]
+        end = start + RECORD_OVERHEAD + length
+        if record_type not in RECORD_TYPES or end > len(data):
+            offset = start + 1
+            continue
+        checksum = 0
+        for byte in data[start + 2:end - 1]:
+            checksum ^= byte
+        if checksum != data[end - 1]:
+            skipped += 1
+            offset = start + 1
+            continue
+        timestamp = struct.unpack_from('<I', data, start + 4)[0]
+        yield record_type, timestamp, data[start + 8:end - 1]
+        offset = end
+    if skipped:
+        sys.stderr.write('Skipped %d records with a bad checksum\n' % skipped)
+
+
+def write_pcap(output, records):
+    """Write the frames out, unwrapping the 32-bit microsecond timestamps"""
+    output.write(struct.pack(
+        '<IHHiIII', 0xA1B2C3D4, 2, 4, 0, 0, PCAP_SNAPLEN, PCAP_LINKTYPE_USER0
+    ))
+    frames = 0
+    epoch = 0
+    last = None
+    for record_type, timestamp, payload in records:
+        if last is not None and timestamp < last:
+            epoch += TIMESTAMP_WRAP
+        last = timestamp
+        if record_type == RECORD_DROP:
+            dropped = struct.unpack('<I', payload)[0]
+            sys.stderr.write(
+                'BlueBus dropped %d records in total by %.6fs\n' %
+                (dropped, (epoch + timestamp) / 1e6)
+            )
+            continue
+        micros = epoch + timestamp
+        packet = bytes([record_type]) + payload
+        output.write(struct.pack(
+            '<IIII', micros // 1000000, micros % 1000000, len(packet), len(packet)
+        ))
+        output.write(packet)
+        frames += 1
+    return frames
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Capture IBus frames from the BlueBus to pcap')
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('--port', help='Serial port of the BlueBus')
+    source.add_argument('--input', help='A raw capture of the sniffer output')
+    parser.add_argument('--output', required=True, help='The pcap file to write')
+    args = parser.parse_args()
+
+    if args.port:
+        data = read_serial(args.port)
+    else:
+        with open(args.input, 'rb') as capture:
+            data = capture.read()
+    with open(args.output, 'wb') as output:
+        frames = write_pcap(output, parse_records(data))
+    if frames == 0:
+        sys.stderr.write('No sniffer records found\n')
+        return 2
+    sys.stderr.write('Wrote %d frames to %s\n' % (frames, args.output))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
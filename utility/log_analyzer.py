@@ -0,0 +1,1100 @@
+#!/usr/bin/env python3
+"""
+BlueBus log analyzer
+
+Decodes BlueBus session logs (IBus, BC127 and BM83 debug lines) into one
+readable event per line, like log_parser.pl, but built for multi-hour logs:
+
+- The log is memory-mapped and split into newline aligned chunks that are
+  decoded in parallel worker processes. Output order is preserved.
+- Commands are resolved through precompiled lookup tables and a per
+  (source, destination, command) cache, and payloads are handed to a
+  decoder table keyed by the resolved command name.
+- Time-range queries (--start / --end) use a sidecar index of per-block
+  timestamp bounds, so only the blocks that overlap the range are decoded.
+  The index is built on first use and rebuilt when the log changes.
+
+The payload decoders cover the commands that matter for most bug reports;
+commands without a decoder print their raw payload. log_parser.pl still
+carries the full set of payload decoders.
+
+Usage:
+    ./log_analyzer.py session.log | less
+    ./log_analyzer.py --stats --ignore-commands session.log
+    ./log_analyzer.py --ignore-device=GT,3F --no-time session.log
+    ./log_analyzer.py --start 1:02:00 --end 1:05:30 session.log
+    tail -f screenlog.0 | ./log_analyzer.py -
+"""
+import json
+import mmap
+import os
+import re
+import sys
+from argparse import ArgumentParser, BooleanOptionalAction
+from collections import Counter
+from datetime import datetime, timedelta
+from multiprocessing import Pool, cpu_count
+
+# Work unit handed to each worker process
+CHUNK_SIZE = 4 * 1024 * 1024
+# Granularity of the time index, and so of --start / --end seeks
+INDEX_BLOCK_SIZE = 256 * 1024
+INDEX_SUFFIX = '.idx.json'
+INDEX_VERSION = 1
+# log_parser.pl advances the clock by this much per raw, untimed IBus packet
+RAW_PACKET_INTERVAL = 10
+
+RECORD_EVENT = 0
+RECORD_LINE = 1
+
+DEFAULT_IGNORE_COMMANDS = (
+    'RAD_TMC_REQUEST',
+    'RAD_TMC_RESPONSE',
+    'TEL_TELEMATICS_LOCATION',
+    'TEL_TELEMATICS_COORDINATES',
+    'RAD_BMW_ASSIST_DATA',
+    'TEL_BMW_ASSIST_DATA',
+    'GM_RLS_STATUS',
+    'LCM_RLS_STATUS',
+    'IKE_BROADCAST_SPEED_RPM_UPDATE',
+    'IKE_BROADCAST_TEMP_UPDATE',
+    'LCM_BROADCAST_INSTRUMENT_BACKLIGHTING',
+    'LCM_BROADCAST_INDICATORS_RESP',
+    'GM_BROADCAST_DOORS_STATUS_RESP',
+    'IKE_BROADCAST_SENSOR_RESP',
+    'RAD_BROADCAST_STATUS_RESP',
+    'BC127_AVRCP_MEDIA_RESPONSE',
+    'IKE_83_UNK',
+)
+
+BROADCAST_DEVICES = frozenset(('LOC', 'GLO', 'GLOH', 'GLOL', 'MUL', 'ANZV'))
+
+DEVICES = {
+    '00': 'GM',  # Body module
+    '08': 'SDH',  # Tilt/Slide Sunroof
+    '18': 'CDC',  # CD Changer
+    '24': 'HKM',  # Trunk Lid Module
+    '28': 'FUH',  # Radio controlled clock
+    '2E': 'EDC',  # Electronic Damper Control
+    '30': 'CCM',  # Check control module
+    '3B': 'GT',  # Graphics driver (in navigation system)
+    '3F': 'DIA',  # Diagnostic
+    '40': 'FBZV',  # Remote Control for Central Locking [E38]
+    '43': 'GT2',  # Graphics driver for rear screen (in navigation system)
+    '44': 'EWS',  # EWS (Immobiliser)
+    '45': 'DWA',  # Anti-Theft System (DWA3, DWA4)
+    '47': 'RCM',  # Rear Compartment Monitor (FOND_BT) [E38]
+    '46': 'CID',  # Central information display (flip-up LCD screen)
+    '50': 'MFL',  # Multi function steering wheel
+    '51': 'MMP',  # Mirror Memory (Passenger) [ZKE5]
+    '53': 'MUL',  # Multicast, broadcast address
+    '57': 'LWS',  # Steering Angle Sensor (LWS) [D-BUS]
+    '5B': 'IHKA',  # HVAC
+    '60': 'PDC',  # Park Distance Control
+    '66': 'ALC',  # Active Light Control
+    '68': 'RAD',  # Radio
+    '69': 'EKM',  # Electronic Body Module
+    '6A': 'DSP',  # DSP
+    '6B': 'HEAT',  # Webasto
+    '70': 'RDC',  # Tire Pressure Control/Warning (RDC/W)
+    '71': 'SM0',  # Seat memory - 0
+    '72': 'SMD',  # Seat Memory (Driver) [SM] [ZKE5]
+    '73': 'SDRS',  # Sirius Radio
+    '76': 'CDCD',  # CD changer, DIN size.
+    '7F': 'NAV',  # Navigation (Europe)
+    '80': 'IKE',  # Instrument cluster electronics
+    '86': 'XENR',  # Xenon Light Right [E46?]
+    '98': 'XENL',  # Xenon Light Left [E46?]
+    '9B': 'MMD',  # Mirror Memory (Driver) [seat control, driver (SBFA)] [ZKE5]
+    '9C': 'CVM',  # The Convertible Top Module (CVM) [ZKE5]
+    '9E': 'RPS',  # Roll-over Protection System (RPS) [D-BUS] [E46?]
+    'A0': 'FMID',  # Rear Multi-info display
+    'A4': 'MRS',  # Multiple Restraint System
+    'A6': 'CC',  # GR2, FGR2, FGR2_5, FGR_KW
+    'A7': 'FHK',  # Rear compartment heating/air conditioning [E38]
+    'AC': 'EHC',  # Electronic Height Control (EHC), Self Leveling Suspension (SLS)
+    'B0': 'SES',  # Speech Input System
+    'B9': 'RC',  # compact radio/IR remote control (FUNKKOMP, IRS_KOMP)
+    'BB': 'NAVJ',  # Navigation (Japan)
+    'BF': 'GLO',  # Global, broadcast address
+    'C0': 'MID',  # Multi-info display
+    'C2': 'SVT',  # Servotronic for E83
+    'C8': 'TEL',  # Telephone
+    'CA': 'TCU',  # BMW Assist
+    'D0': 'LCM',  # Light control module
+    'DA': 'SMB',  # Seat Memory (Passenger)
+    'E0': 'IRIS',  # Integrated radio information system
+    'E7': 'ANZV',  # Displays Multicast
+    'E8': 'RLS',  # Rain/Driving Light Sensor
+    'EA': 'DSPC',  # DSP Controler
+    'ED': 'VMTV',  # Video Module, TV
+    'F0': 'BMBT',  # On-board monitor
+    'F5': 'SZM',  # Center Console Switch Center (SZM) [E38, E46], LKM2
+    'FF': 'LOC',  # Local
+}
+IBUS_COMMANDS = {
+    '00': 'GET_STATUS',
+    '01': 'STATUS_REQ',
+    '02': 'STATUS_RESP',
+    '07': 'PDC_STATUS',
+    '0B': 'DIA_STATUS',
+    '0C': 'DIA_JOB_REQUEST',
+    '10': 'IGN_STATUS_REQ',
+    '11': 'IGN_STATUS_RESP',
+    '12': 'SENSOR_REQ',
+    '13': 'SENSOR_RESP',
+    '14': 'REQ_VEHICLE_TYPE',
+    '15': 'RESP_VEHICLE_CONFIG',
+    '16': 'ODO_REQUEST',
+    '17': 'ODO_RESPONSE',
+    '18': 'SPEED_RPM_UPDATE',
+    '19': 'TEMP_UPDATE',
+    '1A': 'IKE_TEXT_DISPLAY_GONG',
+    '1B': 'IKE_TEXT_STATUS',
+    '1C': 'GONG',
+    '1D': 'TEMP_REQUEST',
+    '1F': 'GPS_TIMEDATE',
+    '20': 'MODE',
+    'GT_20': 'GT_CHANGE_UI_REQ',
+    '21': 'MAIN_MENU',
+    'GT_21': 'GT_WRITE_MENU',
+    'TEL_21': 'TEL_MAIN_MENU',
+    'RAD_21': 'RAD_C43_SCREEN_UPDATE',
+    'MID_21': 'RAD_WRITE_MID_MENU',
+    '22': 'WRITE_RESPONSE',
+    '23': 'WRITE_TITLE',
+    'IKE_23': 'IKE_WRITE_TITLE',
+    'GT_23': 'GT_WRITE_TITLE',
+    'TEL_23': 'TEL_TITLETEXT',
+    'RAD_23': 'RAD_UPDATE_MAIN_AREA',
+    '24': 'OBC_TEXT',
+    '27': 'SET_MODE',
+    '2A': 'OBC_STATUS',
+    '2B': 'LED_STATUS',
+    '2C': 'TEL_STATUS',
+    '31': 'MENU_SELECT',
+    '32': 'VOLUME',
+    '36': 'CONFIG_SET',
+    '37': 'DISPLAY_RADIO_TONE_SELECT',
+    '38': 'REQUEST',
+    '39': 'RESPONSE',
+    '3B': 'BTN_PRESS',
+    '40': 'OBC_INPUT',
+    '41': 'OBC_CONTROL',
+    '42': 'OBC_REMOTE_CONTROL',
+    '44': 'WRITE_NUMERIC',
+    '45': 'SCREEN_MODE_SET',
+    '46': 'SCREEN_MODE_REQUEST',
+    '47': 'SOFT_BUTTON',
+    '48': 'BUTTON',
+    '49': 'DIAL_KNOB',
+    '4A': 'LED_TAPE_CTRL',
+    '4E': 'TV_STATUS',
+    '4F': 'MONITOR_CONTROL',
+    '53': 'REQ_REDUNDANT_DATA',
+    '54': 'RESP_REDUNDANT_DATA',
+    '55': 'REPLICATE_REDUNDANT_DATA',
+    '58': 'RLS_STATUS',
+    '59': 'RLS_STATUS',
+    '5A': 'INDICATORS_REQ',
+    '5B': 'INDICATORS_RESP',
+    '5C': 'INSTRUMENT_BACKLIGHTING',
+    '5D': 'INSTRUMENT_BACKLIGHTING_REQUEST',
+    '60': 'WRITE_INDEX',
+    '61': 'WRITE_INDEX_TMC',
+    '62': 'WRITE_ZONE',
+    '63': 'WRITE_STATIC',
+    '72': 'KEYLESS_STATUS',
+    '74': 'IMMOBILISER_STATUS',
+    '75': 'RLS_REQUEST',
+    '76': 'VIS_ACK',
+    '77': 'RLS_RESPONSE',
+    '79': 'DOORS_STATUS_REQUEST',
+    '7A': 'DOORS_STATUS_RESP',
+    '9F': 'DIA_DIAG_TERMINATE',
+    'A0': 'DIA_DIAG_RESPONSE',
+    'A1': 'DIA_DIAG_RESPONSE_BUSY',
+    'A2': 'TELEMATICS_COORDINATES',
+    'A4': 'TELEMATICS_LOCATION',
+    'A5': 'WRITE_WITH_CURSOR',
+    'A7': 'TMC_REQUEST',
+    'A8': 'TMC_RESPONSE',
+    'A9': 'BMW_ASSIST_DATA',
+    'AA': 'NAV_CONTROL_REAR',
+    'AB': 'NAV_CONTROL_FRONT',
+    'C0': 'C43_SET_MENU_MODE',
+}
+BM83_COMMANDS = {
+    0x00: 'Make_Call',
+    0x01: 'Make_Extension_Call',
+    0x02: 'MMI_Action',
+    0x03: 'Event_Mask_Setting',
+    0x04: 'Music_Control',
+    0x05: 'Change_Device_Name',
+    0x06: 'Change_PIN_Code',
+    0x07: 'BTM_Parameter_Setting',
+    0x08: 'Read_BTM_Version',
+    0x0A: 'Vendor_AT_Command',
+    0x0B: 'AVC_Vendor_Dependent_Cmd',
+    0x0C: 'AVC_Group_Navigation',
+    0x0D: 'Read_Link_Status',
+    0x0E: 'Read_Paired_Device_Record',
+    0x0F: 'Read_Local_BD_Address',
+    0x10: 'Read_Local_Device_Name',
+    0x12: 'Send_SPP/iAP_Or_LE_Data',
+    0x13: 'BTM_Utility_Function',
+    0x14: 'Event_ACK',
+    0x15: 'Additional_Profiles_Link_Setup',
+    0x16: 'Read_Linked_Device_Information',
+    0x17: 'Profiles_Link_Back',
+    0x18: 'Disconnect',
+    0x19: 'MCU_Status_Indication',
+    0x1A: 'User_Confirm_SPP_Req_Reply',
+    0x1B: 'Set_HF_Speaker_Gain_Level',
+    0x1C: 'EQ_Mode_Setting',
+    0x1D: 'DSP_NR_CTRL',
+    0x1E: 'GPIO__Control',
+    0x1F: 'MC_UART_Rx_Buffer_Size',
+    0x20: 'Voice_Prompt_Cmd',
+    0x23: 'Set_Overall_Gain',
+    0x24: 'Read_BTM_Setting',
+    0x25: 'Read_BTM_Battery__Charge_Status',
+    0x26: 'MCU_Update_Cmd',
+    0x27: 'Report_Battery_Capacity',
+    0x28: 'LE_ANCS_Service_Cmd',
+    0x29: 'LE_Signaling_Cmd',
+    0x2A: 'MSPK_Vendor_Cmd',
+    0x2B: 'Read_MSPK_Link_Status',
+    0x2C: 'MSPK_Sync_Audio_Effect',
+    0x2D: 'LE__GATT_CMD',
+    0x2F: 'LE_App_CMD',
+    0x30: 'Dsp_Runtime_Program',
+    0x31: 'Read_Vendor_Stored_Data',
+    0x32: 'Read_IC_Version_linfo',
+    0x34: 'Read_BTM_Link_Mode',
+    0x35: 'Configure_Vendor_Parameter',
+    0x37: 'MSPK_Exchange_Link_Info_Cmd',
+    0x38: 'MSPK_Set_GIAC',
+    0x39: 'Read_Feature_List',
+    0x3A: 'Personal_MSPK_GROUP_Control',
+    0x3B: 'Test_Device',
+    0x3C: 'Read_EEPROM_Data',
+    0x3D: 'Write_EEPROM_Data',
+    0x3E: 'LE_Signaling2_Cmd',
+    0x3F: 'PBAPC_Cmd',
+    0x40: 'TWS_CMD',
+    0x41: 'AVRCP_Browsing_Cmd',
+    0x42: 'Read_Paired_Link_Key_lifo',
+    0x44: 'Audio_Transceiver_Cmd',
+    0x46: 'Button_MMI_Setting_Cmd',
+    0x47: 'Button_Operation_Cmd',
+    0x48: 'Read_Button_MMI_Setting_Cmd',
+    0x49: 'DFU',
+    0x4A: 'AVRCP_Vendor_Dependent_Cmd',
+    0x4B: 'Concert_Mode_Endless_Grouping',
+    0x4C: 'Read_Runtime_Latency',
+    0xCC: 'Toggle_Audio_Source',
+}
+BM83_EVENTS = {
+    0x00: 'Command_ACK',
+    0x01: 'BTM_Status',
+    0x02: 'Call_Status',
+    0x03: 'Caller_ID',
+    0x04: 'SMS_Received_Indication',
+    0x05: 'Missed_Call_Indication',
+    0x06: 'Phone_Max_Battery_Level',
+    0x07: 'Phone_Current_Battery_Level',
+    0x08: 'Roaming_Status',
+    0x09: 'Phone_Max_Signal_Strength_Level',
+    0x0A: 'Phone_Current_Signal_Strength_Level',
+    0x0B: 'Phone_Service_Status',
+    0x0C: 'BTM_Battery_Status',
+    0x0D: 'BTM_Charging_Status',
+    0x0E: 'Reset_To_Default',
+    0x0F: 'Report_HF_Gain_Level',
+    0x10: 'EQ_Mode_Indication',
+    0x17: 'Read_Linked_Device_Information_Reply',
+    0x18: 'Read_BTM_Version_Reply',
+    0x19: 'Call_List_Report',
+    0x1A: 'AVC_Specific_Rsp',
+    0x1B: 'BTM_Utility_Req',
+    0x1C: 'Vendor_AT_Cmd_Rsp',
+    0x1E: 'Read_Link_Status_Reply',
+    0x1F: 'Read_Paired_Device_Record_Reply',
+    0x20: 'Read_Local_BD_Address_Reply',
+    0x22: 'Report_SPP/iAP_Data',
+    0x23: 'Report_Link_Back_Status',
+    0x24: 'Report_Ring_Tone_Status',
+    0x26: 'Report_AVRCP_Vol_Ctrl',
+    0x28: 'Report_iAP_Info',
+    0x2A: 'Report_Voice_Prompt_Status',
+    0x2D: 'Report_Type_Codec',
+    0x2E: 'Report_Type_BTM_Setting',
+    0x30: 'Report_BTM_Initial_Status',
+    0x32: 'LE_Signaling_Event',
+    0x33: 'Report_MSPK_Link_Status',
+    0x34: 'Report_MSPK_Vendor_Event',
+    0x35: 'Report_MSPK_Audio_Setting',
+    0x36: 'Report_Sound_Effect_Status',
+    0x37: 'Report_Vendor_Stored_Data',
+    0x38: 'Report_IC_Version_Info',
+    0x39: 'Report_LE_GATT_Event',
+    0x3A: 'Report_BTM_Link_Mode',
+    0x3C: 'Reserved',
+    0x3D: 'Report_MSPK_Exchange_Link_Info',
+    0x3E: 'Report_Customized_Information',
+    0x3F: 'Report_CSB_CLK',
+    0x40: 'Report_Read_Feature_List_Reply',
+    0x41: 'Report_Test_Result_Reply',
+    0x42: 'Report_Read_EEPROM_Data',
+    0x43: 'PBAPC_Event',
+    0x44: 'AVRCP_Browsing_Event',
+    0x45: 'Report_Paired_Link_Key_Info',
+    0x53: 'Report_TWS_Rx_Vendor_Event',
+    0x54: 'Report_TWS_Local_Device_Status',
+    0x55: 'Report_TWS_VAD_Data',
+    0x56: 'Report_TWS_Radio_Condition',
+    0x57: 'Report_TWS_Ear_Bud_Position',
+    0x58: 'Report_TWS_Secondary_Device_Status',
+    0x59: 'Reserved',
+    0x5A: 'Audio_Transceiver_Event_Status',
+    0x5C: 'Read_Button_MMI_Setting_Reply',
+    0x5D: 'AVRCP_Vendor_Dependent_Rsp',
+    0x5E: 'Runtime_Latency',
+}
+
+
+IBUS_LINE = re.compile(rb'^\[(\d+)\]\s+DEBUG:\s+IBus:\s+RX\[\d+\]:\s*(.*?)\s*$')
+BC127_LINE = re.compile(rb"^\[(\d+)\]\s+DEBUG:\s+BT:\s+([RW]):\s+'(\S+)\s*(.*?)\s*'$")
+BM83_LINE = re.compile(rb'^\[(\d+)\]\s+DEBUG:\s+BM83:\s+([RT])X:\s+AA\s(.*?)\s*$')
+RAW_IBUS_LINE = re.compile(rb'^[0-9a-fA-F\s]+$')
+TIMESTAMP = re.compile(rb'^\[(\d+)\]')
+INDEX_TIMESTAMPS = re.compile(rb'^\[(\d+)\]', re.M)
+# Only the IKE broadcasts the clock, so the index pass can skip everything else
+INDEX_CLOCK_LINES = re.compile(rb'^\[(\d+)\]\s+DEBUG:\s+IBus:\s+RX\[\d+\]:\s*(80 .*?)\s*$', re.M)
+OBC_CLOCK_TEXT = re.compile(r'(\d+):(\d+)(.)')
+
+
+def lookup(value, table):
+    return table.get(value, '%02X' % value)
+
+
+def cleanup_string(data):
+    text = data.split(b'\x00')[0].decode('latin-1')
+    text = text.replace('\x06', '<nl>').replace('\r', '<cr>').replace('\n', '<nl>')
+    return ''.join(char if ord(char) < 0x80 else '~' for char in text)
+
+
+def unpack_bcd(value):
+    return (value >> 4) * 10 + (value & 0x0F)
+
+
+OBC_PROPERTIES = {
+    0x01: 'TIME',
+    0x02: 'DATE',
+    0x03: 'TEMP',
+    0x04: 'CONSUMPTION_1',
+    0x05: 'CONSUMPTION_2',
+    0x06: 'RANGE',
+    0x07: 'DISTANCE',
+    0x08: 'ARRIVAL',
+    0x09: 'LIMIT',
+    0x0A: 'AVG_SPEED',
+    0x0E: 'TIMER',
+    0x0F: 'AUX_TIMER_1',
+    0x10: 'AUX_TIMER_2',
+    0x16: 'CODE_EMERGENCY_DEACIVATION',
+    0x1A: 'TIMER_LAP',
+}
+MFL_BUTTONS = {0x01: 'FORWARD', 0x08: 'BACK', 0x40: 'RT', 0x80: 'TEL'}
+MFL_BUTTON_STATES = {0x00: 'PRESS', 0x10: 'HOLD', 0x20: 'RELEASE'}
+GEARS = {
+    0x00: 'GEAR_NONE',
+    0x0B: 'GEAR_PARK',
+    0x01: 'GEAR_REVERSE',
+    0x07: 'GEAR_NEUTRAL',
+    0x08: 'GEAR_DRIVE',
+    0x02: 'GEAR_FIRST',
+    0x06: 'GEAR_SECOND',
+    0x0D: 'GEAR_THIRD',
+    0x0C: 'GEAR_FOURTH',
+    0x0E: 'GEAR_FIFTH',
+    0x0F: 'GEAR_SIXTH',
+}
+IGNITION_POSITIONS = {0x00: 'POS_0', 0x01: 'POS_1', 0x03: 'POS_2', 0x07: 'POS_3'}
+BM83_CALL_STATES = {
+    0x00: 'IDLE',
+    0x01: 'VR',
+    0x02: 'INCOMING',
+    0x03: 'OUTGOING',
+    0x04: 'ACTIVE',
+    0x05: 'ACTIVE_CALL_WAITING',
+    0x06: 'ACTIVE_CALL_HOLD',
+}
+BM83_ACK_STATUS = {
+    0x00: 'COMPLETE',
+    0x01: 'NOT_ALLOWED',
+    0x02: 'UNKNOWN',
+    0x03: 'PARAMETER_ERROR',
+    0x04: 'BTM_BUSY',
+    0x05: 'BTM_MEMORY_FULL',
+}
+
+
+def decode_obc_text(data):
+    return 'property=%s, text="%s"' % (lookup(data[0], OBC_PROPERTIES), cleanup_string(data[2:]))
+
+
+def decode_gps_time(data):
+    hour = unpack_bcd(data[1])
+    minute = unpack_bcd(data[2])
+    day = unpack_bcd(data[3])
+    month = unpack_bcd(data[5])
+    year = unpack_bcd(data[6]) * 100 + unpack_bcd(data[7])
+    # The GPS week number rolled over, the receivers report dates 1024 weeks back
+    fixed = datetime(year, month, day, hour, minute) + timedelta(weeks=1024)
+    return 'UTC,24,dd.mm.yyyy time=%02d:%02d, date=%02d.%02d.%04d, gps_date=%02d.%02d.%04d' % (
+        hour, minute, fixed.day, fixed.month, fixed.year, day, month, year
+    )
+
+
+def decode_speed_rpm(data):
+    return 'speed=%d km/h, rpm=%d' % (data[0] * 2, data[1] * 100)
+
+
+def decode_temperature(data):
+    ambient = data[0] - 256 if data[0] > 127 else data[0]
+    return 'coolant=%d, amb=%d C' % (data[1], ambient)
+
+
+def decode_sensors(data):
+    return (
+        'handbrake=%d, ignition=%d, gear=%s, ?door=%d, , aux_vent=%d, '
+        'warn_oil_pressure=%d, warn_brake_pads=%d, warn_transmission=%d' % (
+            data[0] & 0x01,
+            data[1] & 0x01,
+            lookup((data[1] & 0xF0) >> 4, GEARS),
+            (data[1] & 0x02) >> 1,
+            (data[2] & 0x08) >> 3,
+            (data[0] & 0x02) >> 1,
+            (data[0] & 0x04) >> 2,
+            (data[0] & 0x10) >> 4
+        )
+    )
+
+
+def decode_ignition(data):
+    return 'ignition=%s' % lookup(data[0] & 0x07, IGNITION_POSITIONS)
+
+
+def decode_odometer(data):
+    return 'odo=%d km' % ((data[2] << 16) + (data[1] << 8) + data[0])
+
+
+def decode_mfl_button(data):
+    return 'button=%s, state=%s' % (
+        lookup(data[0] & 0xC9, MFL_BUTTONS),
+        lookup(data[0] & 0x30, MFL_BUTTON_STATES)
+    )
+
+
+def decode_volume(data):
+    return 'volume_change=%s%d' % ('+' if data[0] & 0x01 else '-', (data[0] & 0xF0) >> 4)
+
+
+def decode_dial_knob(data):
+    return 'turn=%s%d' % ('+' if data[0] & 0x80 else '-', data[0] & 0x0F)
+
+
+def decode_bm83_event_ack(data):
+    return 'event=%02X, name=%s' % (data[0], BM83_EVENTS.get(data[0], ''))
+
+
+def decode_bm83_command_ack(data):
+    return 'command=%02X, name=%s, status=%s' % (
+        data[0],
+        BM83_COMMANDS.get(data[0], ''),
+        lookup(data[1], BM83_ACK_STATUS)
+    )
+
+
+def decode_bm83_call_status(data):
+    return 'status=%s, db=%d' % (lookup(data[1], BM83_CALL_STATES), data[0])
+
+
+def decode_bm83_caller_id(data):
+    return 'caller_id="%s", db=%d' % (cleanup_string(data[1:]), data[0])
+
+
+DECODERS = {
+    'IKE_BROADCAST_OBC_TEXT': decode_obc_text,
+    'IKE_GPS_TIMEDATE': decode_gps_time,
+    'IKE_BROADCAST_SPEED_RPM_UPDATE': decode_speed_rpm,
+    'IKE_BROADCAST_TEMP_UPDATE': decode_temperature,
+    'IKE_BROADCAST_SENSOR_RESP': decode_sensors,
+    'IKE_BROADCAST_IGN_STATUS_RESP': decode_ignition,
+    'IKE_BROADCAST_ODO_RESPONSE': decode_odometer,
+    'TEL_BTN_PRESS': decode_mfl_button,
+    'RAD_BTN_PRESS': decode_mfl_button,
+    'RAD_VOLUME': decode_volume,
+    'TEL_VOLUME': decode_volume,
+    'BMBT_DIAL_KNOB': decode_dial_knob,
+    'GT_DIAL_KNOB': decode_dial_knob,
+    'BM83_CMD_Event_ACK': decode_bm83_event_ack,
+    'BM83_EVT_Command_ACK': decode_bm83_command_ack,
+    'BM83_EVT_Call_Status': decode_bm83_call_status,
+    'BM83_EVT_Caller_ID': decode_bm83_caller_id,
+}
+
+
+def obc_text_clock(data):
+    """Seconds since midnight from the IKE clock text, if this is the time field"""
+    if data[0] != 0x01:
+        return None
+    match = OBC_CLOCK_TEXT.search(cleanup_string(data[2:]))
+    if match is None:
+        return None
+    hour = int(match.group(1))
+    seconds = (hour * 60 + int(match.group(2))) * 60
+    if match.group(3) in 'Pp' and hour < 12:
+        seconds += 12 * 60 * 60
+    if match.group(3) in 'Aa' and hour == 12:
+        seconds -= 12 * 60 * 60
+    return seconds
+
+
+CLOCK_SOURCES = {
+    'IKE_BROADCAST_OBC_TEXT': obc_text_clock,
+}
+
+_ibus_command_cache = {}
+
+
+def resolve_ibus_command(src, dst, cmd_raw):
+    """
+    Name an IBus command the way log_parser.pl does: broadcasts are named for
+    the sender, responses for the responder and the rest for the receiver,
+    preferring device specific names from IBUS_COMMANDS
+    """
+    key = (src, dst, cmd_raw)
+    resolved = _ibus_command_cache.get(key)
+    if resolved is not None:
+        return resolved
+    generic = IBUS_COMMANDS.get(cmd_raw)
+    if dst in BROADCAST_DEVICES:
+        broadcast = 'B'
+        assumed = '%s_BROADCAST_%s' % (src, cmd_raw)
+        if assumed in IBUS_COMMANDS:
+            cmd = IBUS_COMMANDS[assumed]
+        elif generic:
+            cmd = '%s_BROADCAST_%s' % (src, generic)
+        else:
+            cmd = assumed + '_UNK'
+    else:
+        broadcast = ' '
+        if generic and 'RESP' in generic.upper():
+            cmd = '%s_%s' % (src, generic)
+        elif '%s_%s' % (dst, cmd_raw) in IBUS_COMMANDS:
+            cmd = IBUS_COMMANDS['%s_%s' % (dst, cmd_raw)]
+        elif '%s_%s' % (src, cmd_raw) in IBUS_COMMANDS:
+            cmd = IBUS_COMMANDS['%s_%s' % (src, cmd_raw)]
+        elif generic:
+            cmd = '%s_%s' % (dst, generic)
+        else:
+            cmd = '%s_%s_UNK' % (dst, cmd_raw)
+    resolved = (cmd, broadcast)
+    _ibus_command_cache[key] = resolved
+    return resolved
+
+
+def device_name(device_id):
+    return DEVICES.get(device_id, '0x' + device_id)
+
+
+def decode_payload(cmd, payload):
+    decoder = DECODERS.get(cmd)
+    if decoder is None:
+        return None
+    try:
+        data = bytes.fromhex(payload)
+        if not data:
+            return ''
+        return decoder(data)
+    except (IndexError, ValueError):
+        # Truncated or nonsensical payload, show it as is
+        return payload
+
+
+class LogDecoder(object):
+    """
+    Turns log lines into records. Each record is a tuple of
+    (kind, time in ms, text, original line, clock in seconds since midnight).
+    The time is None for untimed raw packets seen before any timestamp
+    """
+
+    def __init__(self, config, last_time=None):
+        self.config = config
+        self.last_time = last_time
+        self.commands = Counter()
+        self.payload_sizes = Counter()
+        self.devices = Counter()
+        self.frames = {}
+
+    def in_range(self, time):
+        start = self.config['start']
+        end = self.config['end']
+        if time is None or (start is None and end is None):
+            return True
+        return (start is None or time >= start) and (end is None or time <= end)
+
+    def is_ignored(self, cmd, *devices):
+        config = self.config
+        if cmd in config['ignore_commands']:
+            return True
+        return any(device in config['ignore_devices'] for device in devices)
+
+    def count(self, cmd, src, payload_size, decoded):
+        if decoded is None and payload_size:
+            cmd += ' (payload not processed)'
+        self.commands[cmd] += 1
+        self.payload_sizes[cmd] += payload_size
+        self.devices[src] += 1
+
+    def ibus_frame(self, src_id, dst_id, cmd_raw):
+        """Everything about a frame that only depends on its addressing, cached"""
+        key = (src_id, dst_id, cmd_raw)
+        frame = self.frames.get(key)
+        if frame is None:
+            src = device_name(src_id)
+            dst = device_name(dst_id)
+            cmd, broadcast = resolve_ibus_command(src, dst, cmd_raw)
+            ignored = (
+                self.is_ignored(cmd, src, dst, src_id, dst_id) or
+                cmd_raw in self.config['ignore_commands']
+            )
+            prefix = '%1s %4s -> %-4s %2s %s' % (broadcast, src, dst, cmd_raw, cmd)
+            frame = (src, cmd, ignored, prefix, CLOCK_SOURCES.get(cmd))
+            self.frames[key] = frame
+        return frame
+
+    def ibus_packet(self, time, tokens, line):
+        is_self = '*' if tokens and tokens[-1] == '[SELF]' else ' '
+        if is_self == '*':
+            tokens = tokens[:-1]
+        if len(tokens) < 4:
+            raise ValueError('Short IBus packet')
+        src, cmd, ignored, prefix, clock_source = self.ibus_frame(
+            tokens[0].upper(),
+            tokens[2].upper(),
+            tokens[3].upper()
+        )
+        payload = ' '.join(tokens[4:-1])
+        clock = None
+        if clock_source is not None and payload:
+            try:
+                clock = clock_source(bytes.fromhex(payload))
+            except (IndexError, ValueError):
+                clock = None
+        if not self.in_range(time):
+            # The clock still has to be carried into the range
+            return None if clock is None else (RECORD_EVENT, time, None, line, clock)
+        if ignored:
+            return (RECORD_EVENT, time, None, line, clock)
+        decoded = decode_payload(cmd, payload)
+        self.count(cmd, src, len(tokens) - 5 if len(tokens) > 5 else 0, decoded)
+        text = '%s %s (%s)' % (is_self, prefix, payload if decoded is None else decoded)
+        if self.config['payload']:
+            text += ' [%s]' % ' '.join(tokens)
+        return (RECORD_EVENT, time, text, line, clock)
+
+    def bc127_message(self, time, direction, name, data, line):
+        if direction == 'R':
+            src, dst, is_self, cmd = 'BT', 'BBUS', ' ', 'BC127_%s_RESPONSE' % name
+        else:
+            src, dst, is_self, cmd = 'BBUS', 'BT', '*', 'BC127_%s' % name
+        if not self.in_range(time):
+            return None
+        if self.is_ignored(cmd, src, dst):
+            return (RECORD_EVENT, time, None, line, None)
+        self.commands[cmd] += 1
+        self.devices[src] += 1
+        return (RECORD_EVENT, time, '%1s   %4s -> %-4s    %s %s' % (is_self, src, dst, cmd, data), line, None)
+
+    def bm83_frame(self, time, direction, tokens, line):
+        if len(tokens) < 3:
+            raise ValueError('Short BM83 frame')
+        length = (int(tokens[0], 16) << 8) + int(tokens[1], 16) - 1
+        cmd_raw = tokens[2].upper()
+        if direction == 'R':
+            src, dst, is_self = 'BT', 'BBUS', ' '
+            name = BM83_EVENTS.get(int(cmd_raw, 16))
+            cmd = 'BM83_EVT_%s' % (name or cmd_raw + '_UNK')
+        else:
+            src, dst, is_self = 'BBUS', 'BT', '*'
+            name = BM83_COMMANDS.get(int(cmd_raw, 16))
+            cmd = 'BM83_CMD_%s' % (name or cmd_raw + '_UNK')
+        if not self.in_range(time):
+            return None
+        if self.is_ignored(cmd, src, dst):
+            return (RECORD_EVENT, time, None, line, None)
+        payload = ' '.join(tokens[3:-1])
+        decoded = decode_payload(cmd, payload)
+        self.count(cmd, src, max(length, 0) if payload else 0, decoded)
+        text = '%1s   %4s -> %-4s %2s %s (%s)' % (
+            is_self, src, dst, cmd_raw, cmd, payload if decoded is None else decoded
+        )
+        if self.config['payload']:
+            text += ' [AA %s]' % ' '.join(tokens)
+        return (RECORD_EVENT, time, text, line, None)
+
+    def feed(self, raw):
+        try:
+            return self.decode_line(raw)
+        except ValueError:
+            # Garbled frame, keep the line as is
+            line = raw.rstrip(b'\r\n\t ').decode('latin-1')
+            self.commands['UNPROCESSED_LINE'] += 1
+            return (RECORD_LINE, self.last_time, line, line, None)
+
+    def decode_line(self, raw):
+        line = raw.rstrip(b'\r\n\t ').decode('latin-1')
+        if raw[:1] == b'[':
+            stamp = TIMESTAMP.match(raw)
+            if stamp is not None:
+                self.last_time = int(stamp.group(1))
+            if b'DEBUG: IBus: RX[' in raw:
+                match = IBUS_LINE.match(raw)
+                if match is not None:
+                    return self.ibus_packet(self.last_time, match.group(2).decode('latin-1').split(), line)
+            elif b'DEBUG: BM83: ' in raw:
+                match = BM83_LINE.match(raw)
+                if match is not None:
+                    direction = match.group(2).decode('ascii')
+                    return self.bm83_frame(self.last_time, direction, match.group(3).decode('latin-1').split(), line)
+            elif b'DEBUG: BT: ' in raw:
+                match = BC127_LINE.match(raw.rstrip(b'\r\n'))
+                if match is not None:
+                    return self.bc127_message(
+                        self.last_time,
+                        match.group(2).decode('ascii'),
+                        match.group(3).decode('latin-1'),
+                        match.group(4).decode('latin-1'),
+                        line
+                    )
+        elif line and RAW_IBUS_LINE.match(raw):
+            if self.last_time is not None:
+                self.last_time += RAW_PACKET_INTERVAL
+            return self.ibus_packet(self.last_time, line.split(), line)
+        if not line and not raw:
+            return None
+        if not self.in_range(self.last_time):
+            return None
+        self.commands['UNPROCESSED_LINE'] += 1
+        return (RECORD_LINE, self.last_time, line, line, None)
+
+
+CONFIG = {}
+
+
+def init_worker(config):
+    CONFIG.update(config)
+
+
+def decode_chunk(task):
+    """Worker: decode the lines in [start, end) of the log"""
+    path, start, end, seed_time, seed_offset = task
+    decoder = LogDecoder(CONFIG, seed_time)
+    records = []
+    with open(path, 'rb') as handle:
+        with mmap.mmap(handle.fileno(), 0, access=mmap.ACCESS_READ) as log:
+            for raw in log[start:end].split(b'\n'):
+                record = decoder.feed(raw)
+                if record is not None:
+                    records.append(record)
+    return (seed_time, seed_offset, records, decoder.commands, decoder.payload_sizes, decoder.devices)
+
+
+def index_block(task):
+    """Worker: timestamp bounds and the last clock sync of [start, end)"""
+    path, start, end = task
+    with open(path, 'rb') as handle:
+        with mmap.mmap(handle.fileno(), 0, access=mmap.ACCESS_READ) as log:
+            block = log[start:end]
+    stamps = [int(stamp) for stamp in INDEX_TIMESTAMPS.findall(block)]
+    sync = None
+    for stamp, packet in INDEX_CLOCK_LINES.findall(block):
+        tokens = packet.decode('latin-1').split()
+        if len(tokens) < 6 or tokens[-1] == '[SELF]':
+            continue
+        cmd, _ = resolve_ibus_command(device_name(tokens[0]), device_name(tokens[2]), tokens[3])
+        clock_source = CLOCK_SOURCES.get(cmd)
+        if clock_source is None:
+            continue
+        try:
+            clock = clock_source(bytes.fromhex(' '.join(tokens[4:-1])))
+        except (IndexError, ValueError):
+            continue
+        if clock is not None:
+            sync = clock * 1000 - int(stamp)
+    if not stamps:
+        return [start, end, None, None, None, sync]
+    return [start, end, min(stamps), max(stamps), stamps[-1], sync]
+
+
+def split_lines(log, block_size):
+    """Yield newline aligned (start, end) ranges of roughly block_size bytes"""
+    size = len(log)
+    start = 0
+    while start < size:
+        end = log.find(b'\n', min(start + block_size, size))
+        end = size if end == -1 else end + 1
+        yield (start, end)
+        start = end
+
+
+def load_index(path, jobs):
+    index_path = path + INDEX_SUFFIX
+    stat = os.stat(path)
+    if os.path.exists(index_path):
+        with open(index_path, 'r') as handle:
+            try:
+                index = json.load(handle)
+            except ValueError:
+                index = {}
+        if (
+            index.get('version') == INDEX_VERSION and
+            index.get('size') == stat.st_size and
+            index.get('mtime') == stat.st_mtime_ns and
+            index.get('block_size') == INDEX_BLOCK_SIZE
+        ):
+            return index['blocks']
+    with open(path, 'rb') as handle:
+        with mmap.mmap(handle.fileno(), 0, access=mmap.ACCESS_READ) as log:
+            tasks = [(path, start, end) for start, end in split_lines(log, INDEX_BLOCK_SIZE)]
+    with Pool(jobs) as pool:
+        blocks = pool.map(index_block, tasks)
+    try:
+        with open(index_path, 'w') as handle:
+            json.dump({
+                'version': INDEX_VERSION,
+                'size': stat.st_size,
+                'mtime': stat.st_mtime_ns,
+                'block_size': INDEX_BLOCK_SIZE,
+                'blocks': blocks,
+            }, handle)
+    except OSError:
+        sys.stderr.write('Unable to write the index to %s\n' % index_path)
+    return blocks
+
+
+def range_tasks(path, blocks, start, end):
+    """
+    Pick the blocks whose timestamps overlap [start, end] and merge runs of
+    them into chunks, seeded with the time and clock offset in effect where
+    each run begins. The uptime resets with the BlueBus, so a range can match
+    more than one run
+    """
+    tasks = []
+    last_time = None
+    offset = None
+    run = None
+    for block_start, block_end, low, high, last, sync in blocks:
+        if low is None:
+            low = high = last_time
+        selected = low is not None and (end is None or low <= end) and (start is None or high >= start)
+        if selected:
+            if run is not None and run[2] == block_start and run[2] - run[1] < CHUNK_SIZE:
+                run[2] = block_end
+            else:
+                if run is not None:
+                    tasks.append(tuple(run))
+                run = [path, block_start, block_end, last_time, offset]
+        elif run is not None:
+            tasks.append(tuple(run))
+            run = None
+        if last is not None:
+            last_time = last
+        if sync is not None:
+            offset = sync
+    if run is not None:
+        tasks.append(tuple(run))
+    return tasks
+
+
+def format_uptime(time):
+    return '%2d:%02d:%06.3f' % (time // 3600000, (time // 60000) % 60, (time % 60000) / 1000.0)
+
+
+def format_clock(time, offset):
+    if offset is None:
+        return ' ' * 8
+    local = (time + offset) // 1000
+    return '%2d:%02d:%02d' % ((local // 3600) % 24, (local // 60) % 60, local % 60)
+
+
+class Printer(object):
+    """Apply the running clock and write records out in log order"""
+
+    def __init__(self, config, output):
+        self.config = config
+        self.output = output
+        self.last_time = None
+        self.offset = None
+
+    def seed(self, last_time, offset):
+        self.last_time = last_time
+        self.offset = offset
+
+    def write(self, records):
+        config = self.config
+        lines = []
+        for kind, time, text, line, clock in records:
+            if kind == RECORD_LINE:
+                if config['unprocessed']:
+                    lines.append(text)
+                continue
+            if time is None:
+                time = (self.last_time or 0) + RAW_PACKET_INTERVAL
+            self.last_time = time
+            if clock is not None:
+                self.offset = clock * 1000 - time
+            if text is None:
+                continue
+            if config['raw']:
+                lines.append(line)
+            if config['time']:
+                lines.append('%s (%s) %s' % (format_uptime(time), format_clock(time, self.offset), text))
+            else:
+                lines.append('%s %s' % (format_uptime(time), text))
+        if lines:
+            self.output.write('\n'.join(lines))
+            self.output.write('\n')
+
+
+def print_stats(output, commands, payload_sizes, devices):
+    output.write('---------------\nStatistics:\n')
+    output.write('Count,\tAvg sz\tof non-ignored commands:\n')
+    for cmd, count in sorted(commands.items(), key=lambda item: -item[1]):
+        size = payload_sizes[cmd] // count if cmd in payload_sizes else ' '
+        output.write('%d\t%s\t%s\n' % (count, size, cmd))
+    output.write('\nCount\tof non-ignored devices sending packets:\n')
+    for device, count in sorted(devices.items(), key=lambda item: -item[1]):
+        output.write('%d\t%s\n' % (count, device))
+
+
+def parse_time(value):
+    """Uptime as milliseconds, or [H:]M:S[.mmm] as printed in the first column"""
+    if ':' not in value:
+        return int(value)
+    seconds = 0.0
+    for part in value.split(':'):
+        seconds = seconds * 60 + float(part)
+    return int(round(seconds * 1000))
+
+
+def parse_names(values):
+    names = set()
+    for value in values or ():
+        for name in value.split(','):
+            name = name.strip().upper()
+            if not name:
+                continue
+            names.add(name)
+            if re.match(r'^(0X)?[0-9A-F]{1,2}$', name):
+                names.add('%02X' % int(name, 16))
+    return names
+
+
+def main():
+    parser = ArgumentParser(description='Decode a BlueBus session log')
+    parser.add_argument('log', help='The log file, or - to read stdin')
+    parser.add_argument('--time', action=BooleanOptionalAction, default=True,
+                        help='Show the wall clock time set by the IKE')
+    parser.add_argument('--raw', action=BooleanOptionalAction, default=False,
+                        help='Print the original line above each event')
+    parser.add_argument('--payload', action=BooleanOptionalAction, default=False,
+                        help='Append the raw packet to decoded events')
+    parser.add_argument('--unprocessed', action=BooleanOptionalAction, default=True,
+                        help='Print lines that are not bus traffic')
+    parser.add_argument('--stats', action=BooleanOptionalAction, default=False,
+                        help='Print command and device counters at the end')
+    parser.add_argument('-i', '--ignore-commands', action='append', nargs='?', const='',
+                        help='Ignore commands by name or hex ID. Without a value, ignores the noisy broadcasts')
+    parser.add_argument('--ignore-device', action='append',
+                        help='Ignore devices by name or hex ID')
+    parser.add_argument('--start', type=parse_time, help='Uptime to start at, ms or H:MM:SS[.mmm]')
+    parser.add_argument('--end', type=parse_time, help='Uptime to stop at, ms or H:MM:SS[.mmm]')
+    parser.add_argument('--jobs', type=int, default=cpu_count(), help='Worker processes')
+    args = parser.parse_args()
+
+    ignore_commands = parse_names(args.ignore_commands)
+    if args.ignore_commands is not None and '' in args.ignore_commands:
+        ignore_commands.update(DEFAULT_IGNORE_COMMANDS)
+    config = {
+        'time': args.time,
+        'raw': args.raw,
+        'payload': args.payload,
+        'unprocessed': args.unprocessed,
+        'ignore_commands': ignore_commands,
+        'ignore_devices': parse_names(args.ignore_device),
+        'start': args.start,
+        'end': args.end,
+    }
+    output = sys.stdout
+    printer = Printer(config, output)
+    commands = Counter()
+    payload_sizes = Counter()
+    devices = Counter()
+
+    if args.log == '-':
+        # Live logs are followed line by line
+        decoder = LogDecoder(config)
+        for raw in sys.stdin.buffer:
+            record = decoder.feed(raw)
+            if record is not None:
+                printer.write([record])
+                output.flush()
+        commands, payload_sizes, devices = decoder.commands, decoder.payload_sizes, decoder.devices
+    else:
+        size = os.path.getsize(args.log)
+        if size == 0:
+            return 0
+        jobs = max(args.jobs, 1)
+        if args.start is not None or args.end is not None:
+            tasks = range_tasks(args.log, load_index(args.log, jobs), args.start, args.end)
+        else:
+            with open(args.log, 'rb') as handle:
+                with mmap.mmap(handle.fileno(), 0, access=mmap.ACCESS_READ) as log:
+                    tasks = [(args.log, start, end, None, None) for start, end in split_lines(log, CHUNK_SIZE)]
+        if jobs == 1 or len(tasks) < 2:
+            init_worker(config)
+            results = map(decode_chunk, tasks)
+            pool = None
+        else:
+            pool = Pool(jobs, initializer=init_worker, initargs=(config,))
+            results = pool.imap(decode_chunk, tasks)
+        try:
+            for seed_time, seed_offset, records, chunk_commands, chunk_sizes, chunk_devices in results:
+                if seed_time is not None:
+                    printer.seed(seed_time, seed_offset)
+                printer.write(records)
+                commands.update(chunk_commands)
+                payload_sizes.update(chunk_sizes)
+                devices.update(chunk_devices)
+        finally:
+            if pool is not None:
+                pool.close()
+                pool.join()
+
+    if args.stats:
+        print_stats(output, commands, payload_sizes, devices)
+    return 0
+
+
+if __name__ == '__main__':
+    try:
+        sys.exit(main())
+    except BrokenPipeError:
+        # Output piped to head / less that exited early
+        sys.stderr.close()
+        sys.exit(0)
@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+"""
+BlueBus telemetry exporter
+
+Pulls the telemetry ring out of the BlueBus with the "TELEMETRY DUMP" CLI
+command, either live over its USB serial port or from a captured log, and
+decodes it into columns: one row per sample time with the last known value of
+every signal, ready for a spreadsheet or pandas.
+
+Each page holds a header (sequence, session, start tick) followed by
+delta-encoded records, see firmware/application/lib/telemetry.h.
+
+Usage:
+    ./telemetry_export.py --port /dev/ttyUSB0 > trips.csv
+    ./telemetry_export.py --log session.log --session 12
+    ./telemetry_export.py --log session.log --format json --output trips.json
+"""
+import argparse
+import csv
+import json
+import sys
+from time import time
+
+BAUDRATE = 115200
+PREFIX = 'TLM:'
+TIMEOUT = 30
+PAGE_MAGIC = 0xB7
+PAGE_HEADER_SIZE = 8
+RECORD_END = 0xFF
+DEFAULT_TICK_MS = 100
+# Indexed by the firmware TELEMETRY_SIGNAL_* IDs
+SIGNALS = (
+    'speed_kmh',
+    'rpm',
+    'coolant_c',
+    'ambient_c',
+    'oil_c',
+    'gear',
+    'ignition',
+)
+COLUMNS = ('session', 'time_s') + SIGNALS
+
+
+def read_serial(port):
+    from serial import Serial
+    lines = []
+    with Serial(port, BAUDRATE, timeout=1) as serial_port:
+        serial_port.reset_input_buffer()
+        serial_port.write(b'TELEMETRY DUMP\r')
+        start = time()
+        while time() - start < TIMEOUT:
+            line = serial_port.readline().decode('ascii', errors='replace')
+            if not line:
+                continue
+            lines.append(line)
+            if (PREFIX + 'END') in line:
+                break
+    return lines
+
+
+def parse_lines(lines):
+    """Pull the pages and tick length out of the last complete dump"""
+    pages = None
+    complete = None
+    tick_ms = DEFAULT_TICK_MS
+    for line in lines:
+        idx = line.find(PREFIX)
+        if idx == -1:
+            continue
+        body = line[idx + len(PREFIX):].strip()
+        if body.startswith('BEGIN'):
+            fields = body.split(',')
+            if len(fields) > 2:
+                tick_ms = int(fields[2])
+            pages = []
+        elif body == 'END':
+            if pages is not None:
+                complete = pages
+            pages = None
+        elif pages is not None:
+            try:
+                pages.append(bytes.fromhex(body))
+            except ValueError:
+                sys.stderr.write('Skipping malformed page: %s\n' % body[:16])
+    return complete, tick_ms
+
+
+def read_varint(page, offset):
+    value = 0
+    shift = 0
+    while offset < len(page):
+        byte = page[offset]
+        offset += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, offset
+        shift += 7
+    raise ValueError('Truncated varint')
+
+
+def decode_page(page):
+    """Yield (sequence, session, tick, signal, value) for every record"""
+    if len(page) < PAGE_HEADER_SIZE or page[0] != PAGE_MAGIC:
+        return
+    sequence = page[1] | (page[2] << 8)
+    session = page[3]
+    tick = int.from_bytes(page[4:8], 'little')
+    values = [0] * len(SIGNALS)
+    offset = PAGE_HEADER_SIZE
+    while offset < len(page) and page[offset] != RECORD_END:
+        signal = page[offset]
+        try:
+            delta_tick, offset = read_varint(page, offset + 1)
+            zigzag, offset = read_varint(page, offset)
+        except ValueError:
+            return
+        if signal >= len(SIGNALS):
+            return
+        tick += delta_tick
+        values[signal] += (zigzag >> 1) ^ -(zigzag & 1)
+        yield sequence, session, tick, signal, values[signal]
+
+
+def order_pages(pages):
+    """Order pages by sequence number, which wraps at 16 bits"""
+    decoded = [page for page in pages if len(page) >= 3 and page[0] == PAGE_MAGIC]
+    if not decoded:
+        return []
+    sequences = [page[1] | (page[2] << 8) for page in decoded]
+    newest = sequences[0]
+    for sequence in sequences[1:]:
+        if ((sequence - newest) & 0xFFFF) < 0x8000:
+            newest = sequence
+    return [
+        page for _, page in
+        sorted(zip(sequences, decoded), key=lambda item: (item[0] - newest - 1) & 0xFFFF)
+    ]
+
+
+def to_rows(pages, tick_ms, session_filter=None):
+    """
+    Merge the records into rows. Records that share a tick land in the same
+    row, and every column carries its last value forward within a session.
+    """
+    rows = []
+    row = None
+    state = {}
+    current_session = None
+    for page in order_pages(pages):
+        for _, session, tick, signal, value in decode_page(page):
+            if session_filter is not None and session != session_filter:
+                continue
+            if session != current_session:
+                current_session = session
+                state = {}
+                row = None
+            state[SIGNALS[signal]] = value
+            time_s = round(tick * tick_ms / 1000.0, 3)
+            if row is None or row['time_s'] != time_s:
+                row = {'session': session, 'time_s': time_s}
+                rows.append(row)
+            row.update(state)
+    return rows
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Export the BlueBus telemetry ring')
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('--port', help='Serial port of the BlueBus')
+    source.add_argument('--log', help='A captured log containing TELEMETRY DUMP output')
+    parser.add_argument('--session', type=int, help='Only export the given session')
+    parser.add_argument('--format', choices=('csv', 'json'), default='csv')
+    parser.add_argument('--output', help='Write to a file instead of stdout')
+    args = parser.parse_args()
+
+    if args.port:
+        lines = read_serial(args.port)
+    else:
+        with open(args.log, 'r', errors='replace') as log:
+            lines = log.readlines()
+    pages, tick_ms = parse_lines(lines)
+    if pages is None:
+        sys.stderr.write('No complete TELEMETRY DUMP found\n')
+        return 2
+    rows = to_rows(pages, tick_ms, args.session)
+
+    output = open(args.output, 'w', newline='') if args.output else sys.stdout
+    try:
+        if args.format == 'json':
+            columns = {name: [row.get(name) for row in rows] for name in COLUMNS}
+            json.dump(columns, output)
+            output.write('\n')
+        else:
+            writer = csv.DictWriter(output, fieldnames=COLUMNS, restval='')
+            writer.writeheader()
+            writer.writerows(rows)
+    finally:
+        if args.output:
+            output.close()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())